@@ -17,6 +17,8 @@
 
 #cmakedefine ENABLE_UNFINISHEDFEATURES 1
 
+#cmakedefine ENABLE_SQLSTORAGE 1
+
 #cmakedefine ENABLE_SQLCIPHER 1
 
 #cmakedefine ENABLE_SQLTRACER 1
@@ -13,14 +13,22 @@
 #include "mymoneymoney.h"
 #include "mymoneyfile.h"
 #include "mymoneytransactionfilter.h"
+#include "transactionmatchindex.h"
 
-ExistingTransactionMatchFinder::ExistingTransactionMatchFinder(int matchWindow)
+ExistingTransactionMatchFinder::ExistingTransactionMatchFinder(int matchWindow, const TransactionMatchIndex* index)
     : TransactionMatchFinder(matchWindow)
+    , m_index(index)
 {
 }
 
 void ExistingTransactionMatchFinder::createListOfMatchCandidates()
 {
+    if (m_index && m_index->covers(importedTransaction.postDate(), m_matchWindow)) {
+        listOfMatchCandidates = m_index->candidates(m_importedSplit.accountId(), importedTransaction.postDate(), m_importedSplit.shares());
+        qDebug() << "Considering" << listOfMatchCandidates.size() << "indexed transaction(s) for matching";
+        return;
+    }
+
     MyMoneyTransactionFilter filter(m_importedSplit.accountId());
     filter.setReportAllSplits(false);
     filter.setDateFilter(importedTransaction.postDate().addDays(-m_matchWindow), importedTransaction.postDate().addDays(m_matchWindow));
@@ -13,6 +13,8 @@
 
 #include "transactionmatchfinder.h"
 
+class TransactionMatchIndex;
+
 /** Implements searching for a matching transaction in the ledger
  */
 class ExistingTransactionMatchFinder : public TransactionMatchFinder
@@ -20,12 +22,14 @@ class ExistingTransactionMatchFinder : public TransactionMatchFinder
 public:
     /** Ctor, initializes the match finder
      * @param matchWindow max number of days the transactions may vary and still be considered to be matching
+     * @param index optional index of the ledger used instead of scanning the ledger if it covers the transaction
      */
-    explicit ExistingTransactionMatchFinder(int m_matchWindow = 3);
+    explicit ExistingTransactionMatchFinder(int m_matchWindow = 3, const TransactionMatchIndex* index = nullptr);
 
 protected:
     typedef QPair<MyMoneyTransaction, MyMoneySplit> TransactionAndSplitPair;
     QList<TransactionAndSplitPair> listOfMatchCandidates;
+    const TransactionMatchIndex*   m_index;
 
     /** Creates a list of transactions within matchWindow range and with the same amount as the imported transaction we're trying to match
      */
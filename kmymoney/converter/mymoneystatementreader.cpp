@@ -56,6 +56,9 @@
 #include "kmymoneyaccountcombo.h"
 #include "accountsmodel.h"
 #include "existingtransactionmatchfinder.h"
+#include "payeematcher.h"
+#include "transactionmatchindex.h"
+#include "payeesmodel.h"
 #include "scheduledtransactionmatchfinder.h"
 #include "dialogenums.h"
 #include "mymoneyenums.h"
@@ -104,6 +107,8 @@ public:
     QMap<QString, bool>            uniqIds;
     QMap<QString, MyMoneySecurity> securitiesBySymbol;
     QMap<QString, MyMoneySecurity> securitiesByName;
+    PayeeMatcher                   payeeMatcher;
+    TransactionMatchIndex          matchIndex;
     bool                           m_skipCategoryMatching;
     void (*m_progressCallback)(int, int, const QString&);
 private:
@@ -339,6 +344,16 @@ MyMoneyStatementReader::MyMoneyStatementReader() :
     m_progressCallback(0)
 {
     m_askPayeeCategory = KMyMoneySettings::askForPayeeCategory();
+
+    // the payee matcher is rebuilt when needed after any payee changed
+    const auto payeesModel = MyMoneyFile::instance()->payeesModel();
+    const auto invalidatePayeeMatcher = [this]() {
+        d->payeeMatcher.invalidate();
+    };
+    connect(payeesModel, &QAbstractItemModel::rowsInserted, this, invalidatePayeeMatcher);
+    connect(payeesModel, &QAbstractItemModel::rowsRemoved, this, invalidatePayeeMatcher);
+    connect(payeesModel, &QAbstractItemModel::dataChanged, this, invalidatePayeeMatcher);
+    connect(payeesModel, &QAbstractItemModel::modelReset, this, invalidatePayeeMatcher);
 }
 
 MyMoneyStatementReader::~MyMoneyStatementReader()
@@ -512,6 +527,22 @@ bool MyMoneyStatementReader::import(const MyMoneyStatement& s, QStringList& mess
         try {
             qDebug("Processing transactions (%s)", qPrintable(d->m_account.name()));
             signalProgress(0, s.m_listTransactions.count(), "Importing Statement ...");
+
+            // the match candidates of all transactions are looked up in an
+            // index of the ledger instead of scanning it for each transaction
+            QDate firstDate;
+            QDate lastDate;
+            for (const auto& transaction : s.m_listTransactions) {
+                const auto& postDate = transaction.m_datePosted;
+                if (postDate.isValid()) {
+                    if (!firstDate.isValid() || postDate < firstDate)
+                        firstDate = postDate;
+                    if (!lastDate.isValid() || postDate > lastDate)
+                        lastDate = postDate;
+                }
+            }
+            d->matchIndex.build(firstDate, lastDate, KMyMoneySettings::matchInterval());
+
             progress = 0;
             QList<MyMoneyStatement::Transaction>::const_iterator it_t = s.m_listTransactions.begin();
             while (it_t != s.m_listTransactions.end() && !m_userAbort) {
@@ -527,6 +558,7 @@ bool MyMoneyStatementReader::import(const MyMoneyStatement& s, QStringList& mess
             else
                 qDebug("Caught exception from processTransactionEntry() not caused by USERABORT: %s", e.what());
         }
+        d->matchIndex.clear();
         signalProgress(-1, -1);
     }
 
@@ -936,55 +968,13 @@ void MyMoneyStatementReader::processTransactionEntry(const MyMoneyStatement::Tra
         qDebug() << QLatin1String("Start matching payee") << payeename;
         QString payeeid;
         try {
-            QList<MyMoneyPayee> pList = file->payeeList();
-            QList<MyMoneyPayee>::const_iterator it_p;
-            QMap<int, QString> matchMap;
-            for (it_p = pList.constBegin(); it_p != pList.constEnd(); ++it_p) {
-                bool ignoreCase;
-                QStringList keys;
-                QStringList::const_iterator it_s;
-                const auto matchType = (*it_p).matchData(ignoreCase, keys);
-                switch (matchType) {
-                case eMyMoney::Payee::MatchType::Disabled:
-                    break;
-
-                case eMyMoney::Payee::MatchType::Name:
-                case eMyMoney::Payee::MatchType::NameExact:
-                    keys << QString("%1").arg(QRegExp::escape((*it_p).name()));
-                    if(matchType == eMyMoney::Payee::MatchType::NameExact) {
-                        keys.clear();
-                        keys << QString("^%1$").arg(QRegExp::escape((*it_p).name()));
-                    }
-                // intentional fall through
-
-                case eMyMoney::Payee::MatchType::Key:
-                    for (it_s = keys.constBegin(); it_s != keys.constEnd(); ++it_s) {
-                        QRegExp exp(*it_s, ignoreCase ? Qt::CaseInsensitive : Qt::CaseSensitive);
-                        if (exp.indexIn(payeename) != -1) {
-                            qDebug("Found match with '%s' on '%s'", qPrintable(payeename), qPrintable((*it_p).name()));
-                            matchMap[exp.matchedLength()] = (*it_p).id();
-                        }
-                    }
-                    break;
-                }
+            // the match keys of all payees are only prepared once per import
+            if (!d->payeeMatcher.isValid()) {
+                d->payeeMatcher.build(file->payeeList());
             }
-
-            // at this point we can have several scenarios:
-            // a) multiple matches
-            // b) a single match
-            // c) no match at all
-            //
-            // for c) we just do nothing, for b) we take the one we found
-            // in case of a) we take the one with the largest matchedLength()
-            // which happens to be the last one in the map
-            if (matchMap.count() > 1) {
-                qDebug("Multiple matches");
-                QMap<int, QString>::const_iterator it_m = matchMap.constEnd();
-                --it_m;
-                payeeid = *it_m;
-            } else if (matchMap.count() == 1) {
-                qDebug("Single matches");
-                payeeid = *(matchMap.constBegin());
+            payeeid = d->payeeMatcher.match(payeename);
+            if (!payeeid.isEmpty()) {
+                qDebug("Found match with '%s' on '%s'", qPrintable(payeename), qPrintable(file->payee(payeeid).name()));
             }
 
             // if we did not find a matching payee, we throw an exception and try to create it
@@ -1272,7 +1262,7 @@ void MyMoneyStatementReader::processTransactionEntry(const MyMoneyStatement::Tra
         TransactionMatcher matcher;
         d->transactionsCount++;
 
-        ExistingTransactionMatchFinder existingTrMatchFinder(KMyMoneySettings::matchInterval());
+        ExistingTransactionMatchFinder existingTrMatchFinder(KMyMoneySettings::matchInterval(), &d->matchIndex);
         result = existingTrMatchFinder.findMatch(transactionUnderImport, s1);
         if (result != TransactionMatchFinder::MatchNotFound) {
             MyMoneyTransaction matchedTransaction = existingTrMatchFinder.getMatchedTransaction();
@@ -1465,6 +1455,8 @@ void MyMoneyStatementReader::handleMatchingOfExistingTransaction(TransactionMatc
         addTransaction(importedTransaction);
         qDebug("Detected as match to transaction '%s'", qPrintable(matchedTransaction.id()));
         matcher.match(matchedTransaction, matchedSplit, importedTransaction, importedSplit, true);
+        // the match may have changed the post date of the matched transaction
+        d->matchIndex.addTransaction(MyMoneyFile::instance()->transaction(matchedTransaction.id()));
         d->transactionsMatched++;
         break;
     }
@@ -1547,6 +1539,7 @@ void MyMoneyStatementReader::addTransaction(MyMoneyTransaction& transaction)
     MyMoneyFile* file = MyMoneyFile::instance();
 
     file->addTransaction(transaction);
+    d->matchIndex.addTransaction(transaction);
     d->transactionsAdded++;
 }
 
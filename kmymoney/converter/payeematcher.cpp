@@ -0,0 +1,338 @@
+/*
+    KMyMoney transaction importing module - matches imported payee names against the known payees
+
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "payeematcher.h"
+
+// ----------------------------------------------------------------------------
+// QT Includes
+
+#include <QHash>
+#include <QRegExp>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QVector>
+
+// ----------------------------------------------------------------------------
+// Project Includes
+
+#include "mymoneyenums.h"
+#include "mymoneypayee.h"
+
+namespace {
+/**
+ * A match candidate. @a order is the position of the key in the
+ * list of all keys and is used to select among matches of equal length.
+ */
+struct Match {
+    int length = -1;
+    int order = -1;
+    int payee = -1;
+
+    bool isBetterThan(const Match& other) const
+    {
+        return (length > other.length) || (length == other.length && order > other.order);
+    }
+};
+
+enum class KeyType {
+    Literal,
+    Exact,
+    RegExp,
+};
+
+/**
+ * Determines if @a pattern is plain text escaped with
+ * QRegExp::escape() and optionally anchored with ^ and $ on
+ * both ends. If so, the unescaped text is returned in @a text.
+ */
+KeyType classifyKey(const QString& pattern, QString& text)
+{
+    static const QString specialCharacters(QStringLiteral("$()*+.?[\\]^{|}"));
+
+    text.clear();
+    const auto end = pattern.length();
+    const auto anchoredStart = pattern.startsWith(QLatin1Char('^'));
+    auto anchoredEnd = false;
+    for (auto i = anchoredStart ? 1 : 0; i < end; ++i) {
+        const auto c = pattern.at(i);
+        if (c == QLatin1Char('\\')) {
+            if (i + 1 < end && specialCharacters.contains(pattern.at(i + 1))) {
+                text.append(pattern.at(++i));
+                continue;
+            }
+            return KeyType::RegExp;
+        }
+        if (c == QLatin1Char('$') && i == end - 1) {
+            anchoredEnd = true;
+            break;
+        }
+        if (specialCharacters.contains(c)) {
+            return KeyType::RegExp;
+        }
+        text.append(c);
+    }
+
+    if (anchoredStart && anchoredEnd)
+        return KeyType::Exact;
+    if (!anchoredStart && !anchoredEnd)
+        return KeyType::Literal;
+    return KeyType::RegExp;
+}
+
+/**
+ * An Aho-Corasick automaton that finds the best match of
+ * all plain text keys with a single scan over the text.
+ */
+class LiteralAutomaton
+{
+public:
+    LiteralAutomaton()
+        : m_nodes(1)
+    {
+    }
+
+    void clear()
+    {
+        m_nodes.clear();
+        m_nodes.resize(1);
+        m_matches.clear();
+    }
+
+    void addKey(const QString& text, const Match& match)
+    {
+        int state = 0;
+        for (const auto& c : text) {
+            const auto it = m_nodes.at(state).next.constFind(c.unicode());
+            if (it != m_nodes.at(state).next.constEnd()) {
+                state = *it;
+            } else {
+                m_nodes.append(Node());
+                const auto node = m_nodes.count() - 1;
+                m_nodes[state].next.insert(c.unicode(), node);
+                state = node;
+            }
+        }
+        m_matches.append(match);
+        m_matches.last().length = text.length();
+        if (isBetter(m_matches.count() - 1, m_nodes.at(state).best)) {
+            m_nodes[state].best = m_matches.count() - 1;
+        }
+    }
+
+    /**
+     * Sets up the failure links and stores in each node the best
+     * match of all keys which end in this node.
+     */
+    void finish()
+    {
+        QVector<int> queue;
+        for (const auto& child : qAsConst(m_nodes.first().next)) {
+            m_nodes[child].fail = 0;
+            queue.append(child);
+        }
+
+        // breadth first so that the failure node of a node is
+        // always processed before the node itself
+        for (int i = 0; i < queue.count(); ++i) {
+            const auto state = queue.at(i);
+            const auto failBest = m_nodes.at(m_nodes.at(state).fail).best;
+            if (isBetter(failBest, m_nodes.at(state).best)) {
+                m_nodes[state].best = failBest;
+            }
+
+            const auto& next = m_nodes.at(state).next;
+            for (auto it = next.constBegin(); it != next.constEnd(); ++it) {
+                auto fail = m_nodes.at(state).fail;
+                while (fail && !m_nodes.at(fail).next.contains(it.key())) {
+                    fail = m_nodes.at(fail).fail;
+                }
+                m_nodes[it.value()].fail = m_nodes.at(fail).next.value(it.key(), 0);
+                queue.append(it.value());
+            }
+        }
+    }
+
+    void search(const QString& text, Match& best) const
+    {
+        consider(0, best);
+        int state = 0;
+        for (const auto& c : text) {
+            const auto u = c.unicode();
+            auto it = m_nodes.at(state).next.constFind(u);
+            while (state && it == m_nodes.at(state).next.constEnd()) {
+                state = m_nodes.at(state).fail;
+                it = m_nodes.at(state).next.constFind(u);
+            }
+            state = (it != m_nodes.at(state).next.constEnd()) ? *it : 0;
+            consider(state, best);
+        }
+    }
+
+private:
+    bool isBetter(int a, int b) const
+    {
+        return (a != -1) && ((b == -1) || m_matches.at(a).isBetterThan(m_matches.at(b)));
+    }
+
+    void consider(int state, Match& best) const
+    {
+        const auto idx = m_nodes.at(state).best;
+        if (idx != -1 && m_matches.at(idx).isBetterThan(best)) {
+            best = m_matches.at(idx);
+        }
+    }
+
+    struct Node {
+        QHash<ushort, int> next;
+        int fail = 0;
+        int best = -1;
+    };
+
+    QVector<Node> m_nodes;
+    QVector<Match> m_matches;
+};
+
+struct RegExpKey {
+    QRegularExpression expression;
+    Match match;
+};
+} // namespace
+
+struct PayeeMatcher::Private
+{
+    Private()
+        : valid(false)
+    {
+    }
+
+    void clear()
+    {
+        payeeIds.clear();
+        for (auto& automaton : literals)
+            automaton.clear();
+        for (auto& hash : exactNames)
+            hash.clear();
+        regExps.clear();
+    }
+
+    bool valid;
+    QStringList payeeIds;
+    /// index 0 is case sensitive, index 1 contains case folded keys
+    LiteralAutomaton literals[2];
+    QHash<QString, Match> exactNames[2];
+    QVector<RegExpKey> regExps;
+};
+
+PayeeMatcher::PayeeMatcher()
+    : d(new Private)
+{
+}
+
+PayeeMatcher::~PayeeMatcher()
+{
+}
+
+void PayeeMatcher::build(const QList<MyMoneyPayee>& payees)
+{
+    d->clear();
+
+    int order = 0;
+    QString text;
+    for (const auto& payee : payees) {
+        bool ignoreCase;
+        QStringList keys;
+        const auto matchType = payee.matchData(ignoreCase, keys);
+        const auto caseIdx = ignoreCase ? 1 : 0;
+
+        switch (matchType) {
+        case eMyMoney::Payee::MatchType::Disabled:
+            continue;
+        case eMyMoney::Payee::MatchType::Name:
+            keys = QStringList { QRegExp::escape(payee.name()) };
+            break;
+        case eMyMoney::Payee::MatchType::NameExact:
+            keys = QStringList { QStringLiteral("^%1$").arg(QRegExp::escape(payee.name())) };
+            break;
+        case eMyMoney::Payee::MatchType::Key:
+            break;
+        }
+
+        d->payeeIds.append(payee.id());
+        Match match;
+        match.payee = d->payeeIds.count() - 1;
+        for (const auto& key : qAsConst(keys)) {
+            match.order = order++;
+            switch (classifyKey(key, text)) {
+            case KeyType::Literal:
+                d->literals[caseIdx].addKey(ignoreCase ? text.toCaseFolded() : text, match);
+                break;
+            case KeyType::Exact:
+                // a later key replaces an earlier one as it has a higher order
+                d->exactNames[caseIdx].insert(ignoreCase ? text.toCaseFolded() : text, match);
+                break;
+            case KeyType::RegExp:
+            {
+                QRegularExpression expression(key, ignoreCase ? QRegularExpression::CaseInsensitiveOption : QRegularExpression::NoPatternOption);
+                if (expression.isValid()) {
+                    expression.optimize();
+                    d->regExps.append(RegExpKey { expression, match });
+                } else {
+                    qDebug("Invalid match key '%s' for payee '%s'", qPrintable(key), qPrintable(payee.name()));
+                }
+                break;
+            }
+            }
+        }
+    }
+
+    for (auto& automaton : d->literals)
+        automaton.finish();
+    d->valid = true;
+}
+
+void PayeeMatcher::invalidate()
+{
+    d->valid = false;
+}
+
+bool PayeeMatcher::isValid() const
+{
+    return d->valid;
+}
+
+QString PayeeMatcher::match(const QString& payeeName) const
+{
+    Match best;
+    const auto foldedName = payeeName.toCaseFolded();
+
+    d->literals[0].search(payeeName, best);
+    d->literals[1].search(foldedName, best);
+
+    for (int caseIdx = 0; caseIdx < 2; ++caseIdx) {
+        const auto it = d->exactNames[caseIdx].constFind(caseIdx ? foldedName : payeeName);
+        if (it != d->exactNames[caseIdx].constEnd()) {
+            auto match = *it;
+            match.length = payeeName.length();
+            if (match.isBetterThan(best)) {
+                best = match;
+            }
+        }
+    }
+
+    for (const auto& key : qAsConst(d->regExps)) {
+        const auto result = key.expression.match(payeeName);
+        if (result.hasMatch()) {
+            auto match = key.match;
+            match.length = result.capturedLength();
+            if (match.isBetterThan(best)) {
+                best = match;
+            }
+        }
+    }
+
+    return (best.payee != -1) ? d->payeeIds.at(best.payee) : QString();
+}
@@ -0,0 +1,65 @@
+/*
+    KMyMoney transaction importing module - matches imported payee names against the known payees
+
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef PAYEEMATCHER_H
+#define PAYEEMATCHER_H
+
+#include <QList>
+#include <QScopedPointer>
+#include <QString>
+
+class MyMoneyPayee;
+
+/**
+ * This class finds the payee matching the payee name of an imported
+ * transaction according to the matching settings of all payees.
+ *
+ * The match keys of all payees are prepared once by build():
+ * keys which are plain text are collected in a single automaton
+ * which finds all of them in one scan over the name, keys which
+ * need to match the whole name are kept in a hash table and only
+ * the remaining keys are compiled into regular expressions.
+ *
+ * If multiple keys match, the one with the longest match wins. If
+ * there are several of them, the one found last in the payee list
+ * is used.
+ */
+class PayeeMatcher
+{
+public:
+    PayeeMatcher();
+    ~PayeeMatcher();
+
+    /**
+     * Prepares the match keys of the payees in @a payees
+     */
+    void build(const QList<MyMoneyPayee>& payees);
+
+    /**
+     * Marks the data as outdated. Call this whenever a payee changes.
+     */
+    void invalidate();
+
+    /**
+     * @retval true build() has been called and invalidate() has not been called since
+     * @retval false the data needs to be rebuilt before it can be used
+     */
+    bool isValid() const;
+
+    /**
+     * Returns the id of the payee which matches @a payeeName
+     * or an empty string if no payee matches.
+     */
+    QString match(const QString& payeeName) const;
+
+private:
+    Q_DISABLE_COPY(PayeeMatcher)
+    struct Private;
+    QScopedPointer<Private> d;
+};
+
+#endif
@@ -162,6 +162,13 @@ void MatchFinderTest::expectMatchWithScheduledTransaction(TransactionMatchFinder
     QCOMPARE(matchResult, expectedResult);
 }
 
+void MatchFinderTest::expectIndexedMatchWithExistingTransaction(const TransactionMatchIndex& index, TransactionMatchFinder::MatchResult expectedResult)
+{
+    ExistingTransactionMatchFinder finder(MATCH_WINDOW, &index);
+    matchResult = finder.findMatch(importTransaction, importTransaction.splits().first());
+    QCOMPARE(matchResult, expectedResult);
+}
+
 
 
 void MatchFinderTest::testDuplicate_allMatch()
@@ -416,6 +423,60 @@ void MatchFinderTest::testExistingTransactionMatch_multipleAccounts_noBankId()
     expectMatchWithExistingTransaction(TransactionMatchFinder::MatchNotFound);
 }
 
+void MatchFinderTest::testIndexedMatch_duplicate()
+{
+    addTransactionToLedger(ledgerTransaction);
+
+    TransactionMatchIndex index;
+    index.build(importTransaction.postDate(), importTransaction.postDate(), MATCH_WINDOW);
+    QVERIFY(index.covers(importTransaction.postDate(), MATCH_WINDOW));
+
+    expectIndexedMatchWithExistingTransaction(index, TransactionMatchFinder::MatchDuplicate);
+}
+
+void MatchFinderTest::testIndexedMatch_matchWindow()
+{
+    addTransactionToLedger(ledgerTransaction);
+
+    const auto postDate = ledgerTransaction.postDate();
+    TransactionMatchIndex index;
+    index.build(postDate.addDays(-2 * MATCH_WINDOW), postDate.addDays(2 * MATCH_WINDOW), MATCH_WINDOW);
+
+    importTransaction.setPostDate(postDate.addDays(-MATCH_WINDOW));
+    expectIndexedMatchWithExistingTransaction(index, TransactionMatchFinder::MatchDuplicate);
+
+    importTransaction.setPostDate(postDate.addDays(MATCH_WINDOW));
+    expectIndexedMatchWithExistingTransaction(index, TransactionMatchFinder::MatchDuplicate);
+
+    importTransaction.setPostDate(postDate.addDays(MATCH_WINDOW + 1));
+    expectIndexedMatchWithExistingTransaction(index, TransactionMatchFinder::MatchNotFound);
+}
+
+void MatchFinderTest::testIndexedMatch_addedTransaction()
+{
+    TransactionMatchIndex index;
+    index.build(importTransaction.postDate(), importTransaction.postDate(), MATCH_WINDOW);
+    expectIndexedMatchWithExistingTransaction(index, TransactionMatchFinder::MatchNotFound);
+
+    // transactions added after the index has been built are only found if reported
+    const auto id = addTransactionToLedger(ledgerTransaction);
+    expectIndexedMatchWithExistingTransaction(index, TransactionMatchFinder::MatchNotFound);
+
+    index.addTransaction(file->transaction(id));
+    expectIndexedMatchWithExistingTransaction(index, TransactionMatchFinder::MatchDuplicate);
+}
+
+void MatchFinderTest::testIndexedMatch_notCovered()
+{
+    addTransactionToLedger(ledgerTransaction);
+
+    // the index does not cover the date so the ledger is scanned
+    TransactionMatchIndex index;
+    index.build(importTransaction.postDate().addYears(-1), importTransaction.postDate().addYears(-1), MATCH_WINDOW);
+    QVERIFY(!index.covers(importTransaction.postDate(), MATCH_WINDOW));
+
+    expectIndexedMatchWithExistingTransaction(index, TransactionMatchFinder::MatchDuplicate);
+}
 
 void MatchFinderTest::testScheduleMatch_allMatch()
 {
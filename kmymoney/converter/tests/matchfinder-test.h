@@ -15,6 +15,7 @@
 #include "mymoneypayee.h"
 #include "existingtransactionmatchfinder.h"
 #include "scheduledtransactionmatchfinder.h"
+#include "transactionmatchindex.h"
 
 class MyMoneyFile;
 
@@ -52,6 +53,7 @@ private:
 
     void expectMatchWithExistingTransaction(TransactionMatchFinder::MatchResult expectedResult);
     void expectMatchWithScheduledTransaction(TransactionMatchFinder::MatchResult expectedResult);
+    void expectIndexedMatchWithExistingTransaction(const TransactionMatchIndex& index, TransactionMatchFinder::MatchResult expectedResult);
 
 private Q_SLOTS:
     void init();
@@ -86,6 +88,11 @@ private Q_SLOTS:
     void testExistingTransactionMatch_multipleAccounts_withBankId();
     void testExistingTransactionMatch_multipleAccounts_noBankId();
 
+    void testIndexedMatch_duplicate();
+    void testIndexedMatch_matchWindow();
+    void testIndexedMatch_addedTransaction();
+    void testIndexedMatch_notCovered();
+
     void testScheduleMatch_allMatch();
     void testScheduleMatch_dueDateWithinMatchWindow();
     void testScheduleMatch_amountWithinAllowedVariation();
@@ -0,0 +1,110 @@
+/*
+    KMyMoney transaction importing module - tests for PayeeMatcher
+
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "payeematcher-test.h"
+
+#include <QRegExp>
+#include <QTest>
+
+#include "mymoneyenums.h"
+#include "mymoneypayee.h"
+#include "payeematcher.h"
+
+QTEST_GUILESS_MAIN(PayeeMatcherTest)
+
+namespace {
+MyMoneyPayee createPayee(const QString& id, const QString& name, eMyMoney::Payee::MatchType type, bool ignoreCase, const QStringList& keys = QStringList())
+{
+    MyMoneyPayee payee;
+    payee.setName(name);
+    payee.setMatchData(type, ignoreCase, keys);
+    return MyMoneyPayee(id, payee);
+}
+
+QList<MyMoneyPayee> payeeList()
+{
+    return QList<MyMoneyPayee> {
+        createPayee("P000001", "Shell", eMyMoney::Payee::MatchType::Name, true),
+        createPayee("P000002", "Amazon", eMyMoney::Payee::MatchType::NameExact, false),
+        createPayee("P000003", "Amazon Market", eMyMoney::Payee::MatchType::Key, true, QStringList { "AMZN MKTP", "Marketplace" }),
+        createPayee("P000004", "Rewe", eMyMoney::Payee::MatchType::Key, true, QStringList { "^REWE [0-9]+" }),
+        createPayee("P000005", "Bank", eMyMoney::Payee::MatchType::Disabled, true),
+        createPayee("P000006", "Exact (Ltd.)", eMyMoney::Payee::MatchType::Key, false, QStringList { QString("^%1$").arg(QRegExp::escape("Exact (Ltd.)")) }),
+        createPayee("P000007", "Broken", eMyMoney::Payee::MatchType::Key, false, QStringList { "[unclosed" }),
+    };
+}
+}
+
+void PayeeMatcherTest::testMatch_data()
+{
+    QTest::addColumn<QString>("name");
+    QTest::addColumn<QString>("payeeId");
+
+    QTest::newRow("name anywhere") << QStringLiteral("SHELL STATION 123") << QStringLiteral("P000001");
+    QTest::newRow("exact name") << QStringLiteral("Amazon") << QStringLiteral("P000002");
+    QTest::newRow("exact name, other case") << QStringLiteral("amazon") << QString();
+    QTest::newRow("literal key") << QStringLiteral("Amazon Marketplace") << QStringLiteral("P000003");
+    QTest::newRow("literal key, ignore case") << QStringLiteral("amzn mktp de") << QStringLiteral("P000003");
+    QTest::newRow("regexp key") << QStringLiteral("rewe 4711 Berlin") << QStringLiteral("P000004");
+    QTest::newRow("regexp key, no match") << QStringLiteral("Supermarket REWE 4711") << QString();
+    QTest::newRow("matching disabled") << QStringLiteral("Bank") << QString();
+    QTest::newRow("escaped exact key") << QStringLiteral("Exact (Ltd.)") << QStringLiteral("P000006");
+    QTest::newRow("escaped exact key, longer") << QStringLiteral("Exact (Ltd.) 2") << QString();
+    QTest::newRow("no match") << QStringLiteral("Unknown") << QString();
+}
+
+void PayeeMatcherTest::testMatch()
+{
+    QFETCH(QString, name);
+    QFETCH(QString, payeeId);
+
+    PayeeMatcher matcher;
+    matcher.build(payeeList());
+    QCOMPARE(matcher.match(name), payeeId);
+}
+
+void PayeeMatcherTest::testPrecedence()
+{
+    PayeeMatcher matcher;
+    matcher.build(QList<MyMoneyPayee> {
+        createPayee("P000001", "Shell", eMyMoney::Payee::MatchType::Name, true),
+        createPayee("P000002", "Shell Station", eMyMoney::Payee::MatchType::Key, true, QStringList { "Shell Station" }),
+        createPayee("P000003", "Coffee", eMyMoney::Payee::MatchType::Key, false, QStringList { "Coffee" }),
+        createPayee("P000004", "Coffee Shop", eMyMoney::Payee::MatchType::Key, false, QStringList { "Coffee" }),
+        createPayee("P000005", "Tea", eMyMoney::Payee::MatchType::Key, false, QStringList { "T.a" }),
+    });
+
+    // the longest match wins
+    QCOMPARE(matcher.match("Shell Station 5"), QStringLiteral("P000002"));
+    QCOMPARE(matcher.match("Shell 5"), QStringLiteral("P000001"));
+
+    // for matches of the same length the last payee in the list wins
+    QCOMPARE(matcher.match("Coffee"), QStringLiteral("P000004"));
+
+    // a shorter match of a regular expression loses against a plain text key
+    QCOMPARE(matcher.match("Tea and Coffee"), QStringLiteral("P000004"));
+    QCOMPARE(matcher.match("Tea"), QStringLiteral("P000005"));
+}
+
+void PayeeMatcherTest::testInvalidate()
+{
+    PayeeMatcher matcher;
+    QVERIFY(!matcher.isValid());
+
+    auto payees = payeeList();
+    matcher.build(payees);
+    QVERIFY(matcher.isValid());
+    QCOMPARE(matcher.match("Unknown"), QString());
+
+    matcher.invalidate();
+    QVERIFY(!matcher.isValid());
+
+    payees.append(createPayee("P000008", "Unknown", eMyMoney::Payee::MatchType::Name, false));
+    matcher.build(payees);
+    QVERIFY(matcher.isValid());
+    QCOMPARE(matcher.match("Unknown"), QStringLiteral("P000008"));
+}
@@ -0,0 +1,24 @@
+/*
+    KMyMoney transaction importing module - tests for PayeeMatcher
+
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef PAYEEMATCHERTEST_H
+#define PAYEEMATCHERTEST_H
+
+#include <QObject>
+
+class PayeeMatcherTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testMatch_data();
+    void testMatch();
+    void testPrecedence();
+    void testInvalidate();
+};
+
+#endif // PAYEEMATCHERTEST_H
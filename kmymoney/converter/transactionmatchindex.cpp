@@ -0,0 +1,135 @@
+/*
+    KMyMoney transaction importing module - index of the ledger used to find match candidates
+
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "transactionmatchindex.h"
+
+#include <QDebug>
+#include <QMap>
+#include <QSet>
+
+#include "journalmodel.h"
+#include "mymoneyfile.h"
+#include "mymoneymoney.h"
+#include "mymoneytransactionfilter.h"
+
+TransactionMatchIndex::TransactionMatchIndex()
+    : m_matchWindow(-1)
+{
+}
+
+void TransactionMatchIndex::clear()
+{
+    m_firstDate = QDate();
+    m_lastDate = QDate();
+    m_matchWindow = -1;
+    m_index.clear();
+}
+
+void TransactionMatchIndex::build(const QDate& firstDate, const QDate& lastDate, int matchWindow)
+{
+    clear();
+    if (!firstDate.isValid() || !lastDate.isValid() || matchWindow < 0)
+        return;
+
+    m_matchWindow = matchWindow;
+    m_firstDate = firstDate.addDays(-matchWindow);
+    m_lastDate = lastDate.addDays(matchWindow);
+
+    MyMoneyTransactionFilter filter;
+    filter.setReportAllSplits(false);
+    filter.setDateFilter(m_firstDate, m_lastDate);
+
+    QList<MyMoneyTransaction> transactions;
+    MyMoneyFile::instance()->transactionList(transactions, filter);
+    for (const auto& transaction : qAsConst(transactions)) {
+        addTransaction(transaction);
+    }
+    qDebug() << "Indexed" << transactions.count() << "existing transaction(s) for matching";
+}
+
+int TransactionMatchIndex::bucket(const QDate& date) const
+{
+    // a match window covers at most two buckets
+    return static_cast<int>(date.toJulianDay() / (2 * m_matchWindow + 1));
+}
+
+void TransactionMatchIndex::addTransaction(const MyMoneyTransaction& transaction)
+{
+    if (m_matchWindow < 0 || transaction.id().isEmpty())
+        return;
+
+    const auto b = bucket(transaction.postDate());
+    const auto splits = transaction.splits();
+    for (const auto& split : splits) {
+        auto& accountIndex = m_index[split.accountId()];
+        const auto value = split.value().abs().toString();
+        const auto shares = split.shares().abs().toString();
+        for (const auto& amount : { value, shares }) {
+            auto& ids = accountIndex[qMakePair(amount, b)];
+            if (!ids.contains(transaction.id())) {
+                ids.append(transaction.id());
+            }
+        }
+    }
+}
+
+bool TransactionMatchIndex::covers(const QDate& date, int matchWindow) const
+{
+    return (matchWindow == m_matchWindow)
+           && m_firstDate.isValid()
+           && (date.addDays(-matchWindow) >= m_firstDate)
+           && (date.addDays(matchWindow) <= m_lastDate);
+}
+
+QList<TransactionMatchIndex::TransactionAndSplitPair> TransactionMatchIndex::candidates(const QString& accountId, const QDate& date, const MyMoneyMoney& amount) const
+{
+    QList<TransactionAndSplitPair> result;
+    const auto accountIndex = m_index.constFind(accountId);
+    if (accountIndex == m_index.constEnd())
+        return result;
+
+    const auto fromDate = date.addDays(-m_matchWindow);
+    const auto toDate = date.addDays(m_matchWindow);
+    const auto amountKey = amount.abs().toString();
+
+    QSet<QString> ids;
+    for (auto b = bucket(fromDate); b <= bucket(toDate); ++b) {
+        const auto it = accountIndex->constFind(qMakePair(amountKey, b));
+        if (it != accountIndex->constEnd()) {
+            for (const auto& id : *it) {
+                ids.insert(id);
+            }
+        }
+    }
+
+    // the index may contain outdated entries of transactions that have been
+    // modified or removed in the meantime, so we check them against the
+    // current data in the engine and return them in the order of the journal
+    const auto absAmount = amount.abs();
+    const auto journalModel = MyMoneyFile::instance()->journalModel();
+    QMap<QString, MyMoneyTransaction> sortedCandidates;
+    for (const auto& id : qAsConst(ids)) {
+        const auto transaction = journalModel->transactionById(id);
+        if (transaction.id().isEmpty())
+            continue;
+        if (transaction.postDate() < fromDate || transaction.postDate() > toDate)
+            continue;
+        const auto splits = transaction.splits();
+        for (const auto& split : splits) {
+            if (split.accountId() == accountId
+                    && (split.value().abs() == absAmount || split.shares().abs() == absAmount)) {
+                sortedCandidates.insert(transaction.uniqueSortKey(), transaction);
+                break;
+            }
+        }
+    }
+
+    for (const auto& transaction : qAsConst(sortedCandidates)) {
+        result.append(qMakePair(transaction, transaction.firstSplit()));
+    }
+    return result;
+}
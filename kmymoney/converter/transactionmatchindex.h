@@ -0,0 +1,78 @@
+/*
+    KMyMoney transaction importing module - index of the ledger used to find match candidates
+
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TRANSACTIONMATCHINDEX_H
+#define TRANSACTIONMATCHINDEX_H
+
+#include <QDate>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+#include "mymoneysplit.h"
+#include "mymoneytransaction.h"
+
+class MyMoneyMoney;
+
+/** Indexes the transactions of a date range so that the match candidates
+ * for a whole statement can be found without scanning the ledger for each
+ * imported transaction.
+ *
+ * The transactions are kept by account, absolute amount and a date bucket
+ * of the size of the match window. Only the ids are stored in the index, the
+ * candidates are always taken from the engine so that modifications made
+ * during the import are seen. Transactions added during the import must be
+ * reported using addTransaction().
+ */
+class TransactionMatchIndex
+{
+public:
+    typedef QPair<MyMoneyTransaction, MyMoneySplit> TransactionAndSplitPair;
+
+    TransactionMatchIndex();
+
+    /** Indexes the transactions which could be a match candidate for
+     * imported transactions posted between @a firstDate and @a lastDate
+     * @param matchWindow max number of days the transactions may vary and still be considered to be matching
+     */
+    void build(const QDate& firstDate, const QDate& lastDate, int matchWindow);
+
+    /** Removes all data from the index
+     */
+    void clear();
+
+    /** Adds @a transaction to the index or updates it if it was modified
+     */
+    void addTransaction(const MyMoneyTransaction& transaction);
+
+    /** Returns true, if the index contains all candidates for a transaction
+     * posted on @a date using a match window of @a matchWindow days
+     */
+    bool covers(const QDate& date, int matchWindow) const;
+
+    /** Returns the same list of match candidates as a MyMoneyFile::transactionList()
+     * call for the transactions between @a date -/+ the match window which have
+     * a split in @a accountId with a value or shares of the absolute @a amount would.
+     *
+     * @note covers() must be checked before
+     */
+    QList<TransactionAndSplitPair> candidates(const QString& accountId, const QDate& date, const MyMoneyMoney& amount) const;
+
+private:
+    typedef QPair<QString, int> AmountAndBucket;
+
+    int bucket(const QDate& date) const;
+
+    QDate m_firstDate;
+    QDate m_lastDate;
+    int m_matchWindow;
+    QHash<QString, QHash<AmountAndBucket, QVector<QString>>> m_index;
+};
+
+#endif // TRANSACTIONMATCHINDEX_H
@@ -389,11 +389,9 @@ void KEquityPriceUpdateDlg::storePrices()
 
     MyMoneyFileTransaction ft;
     try {
+        QList<MyMoneyPrice> prices;
         for (auto i = 0; i < d->ui->lvEquityList->invisibleRootItem()->childCount(); ++i) {
             QTreeWidgetItem* item = d->ui->lvEquityList->invisibleRootItem()->child(i);
-            // turn on signals before we modify the last entry in the list
-            file->blockSignals(i < d->ui->lvEquityList->invisibleRootItem()->childCount() - 1);
-
             MyMoneyMoney rate(item->text(PRICE_COL));
             if (!rate.isZero()) {
                 QString id = item->text(KMMID_COL);
@@ -415,9 +413,10 @@ void KEquityPriceUpdateDlg::storePrices()
                 // TODO (Ace) Better handling of the case where there is already a price
                 // for this date.  Currently, it just overrides the old value.  Really it
                 // should check to see if the price is the same and prompt the user.
-                file->addPrice(MyMoneyPrice(fromid, toid, QDate::fromString(item->text(DATE_COL), Qt::ISODate), rate, item->text(SOURCE_COL)));
+                prices.append(MyMoneyPrice(fromid, toid, QDate::fromString(item->text(DATE_COL), Qt::ISODate), rate, item->text(SOURCE_COL)));
             }
         }
+        file->addPrices(prices);
         ft.commit();
 
     } catch (const MyMoneyException &) {
@@ -30,15 +30,18 @@
 #include <QElapsedTimer>
 #include <QFileDialog>
 #include <QHBoxLayout>
+#include <QHash>
 #include <QIcon>
 #include <QInputDialog>
 #include <QKeySequence>
 #include <QLabel>
 #include <QList>
 #include <QListWidget>
+#include <QLoggingCategory>
 #include <QMenu>
 #include <QProgressBar>
 #include <QPushButton>
+#include <QSet>
 #include <QStatusBar>
 #include <QTimer>
 #include <QUrl>
@@ -200,6 +203,79 @@ enum backupStateE {
     BACKUP_UNMOUNTING,
 };
 
+Q_LOGGING_CATEGORY(STARTUP_PROFILE, "kmymoney.startup", QtInfoMsg)
+
+/**
+ * Collects the time spent in the phases of opening a file and
+ * writes them to the logging category @c kmymoney.startup. Use
+ * QT_LOGGING_RULES="kmymoney.startup.debug=true" to see the log.
+ */
+class StartupProfile
+{
+public:
+    void start()
+    {
+        m_phases.clear();
+        m_stages.clear();
+        m_totalTimer.start();
+        m_phaseTimer.start();
+    }
+
+    bool isRunning() const
+    {
+        return m_totalTimer.isValid();
+    }
+
+    /**
+     * Records the time since the end of the previous phase as @a name
+     */
+    void endPhase(const char* name)
+    {
+        if (isRunning()) {
+            m_phases.append(qMakePair(QByteArray(name), m_phaseTimer.restart()));
+        }
+    }
+
+    /**
+     * Records @a msecs as the time used by the fix-up stage @a name
+     */
+    void addStage(const char* name, qint64 msecs)
+    {
+        if (isRunning()) {
+            m_stages.append(qMakePair(QByteArray(name), msecs));
+        }
+    }
+
+    void report(const QString& source)
+    {
+        if (!isRunning()) {
+            return;
+        }
+        qCDebug(STARTUP_PROFILE) << "Startup profile for" << source;
+        for (const auto& phase : qAsConst(m_phases)) {
+            qCDebug(STARTUP_PROFILE, "  %-20s %8lld ms", phase.first.constData(), phase.second);
+            if (phase.first == "fix-ups") {
+                for (const auto& stage : qAsConst(m_stages)) {
+                    qCDebug(STARTUP_PROFILE, "    %-18s %8lld ms", stage.first.constData(), stage.second);
+                }
+            }
+        }
+        qCDebug(STARTUP_PROFILE, "  %-20s %8lld ms", "total", m_totalTimer.elapsed());
+        m_totalTimer.invalidate();
+    }
+
+    void cancel()
+    {
+        m_totalTimer.invalidate();
+    }
+
+private:
+    QElapsedTimer m_totalTimer;
+    QElapsedTimer m_phaseTimer;
+    QVector<QPair<QByteArray, qint64>> m_phases;
+    QVector<QPair<QByteArray, qint64>> m_stages;
+};
+
 class KMyMoneyApp::Private
 {
 public:
@@ -250,6 +326,7 @@ public:
     };
 
     storageInfo m_storageInfo;
+    StartupProfile m_startupProfile;
     /**
       * The public interface.
       */
@@ -413,56 +490,68 @@ public:
     bool applyFileFixes()
     {
         const auto file = MyMoneyFile::instance();
-        QSignalBlocker blocked(file);
         KSharedConfigPtr config = KSharedConfig::openConfig();
         KConfigGroup grp = config->group("General Options");
 
         // For debugging purposes, we can turn off the automatic fix manually
         // by setting the entry in kmymoneyrc to true
-        if (grp.readEntry("SkipFix", false) != true) {
-            MyMoneyFileTransaction ft;
-            try {
-                // Check if we have to modify the file before we allow to work with it
-                while (file->fileFixVersion() < file->availableFixVersion()) {
-                    qDebug() << "testing fileFixVersion" << file->fileFixVersion() << "<" << file->availableFixVersion();
-                    switch (file->fileFixVersion()) {
-                    case 0:
-                        fixFile_0();
-                        file->setFileFixVersion(1);
-                        break;
+        if (grp.readEntry("SkipFix", false) == true) {
+            qDebug() << "Skipping automatic transaction fix!";
+            return true;
+        }
 
-                    case 1:
-                        fixFile_1();
-                        file->setFileFixVersion(2);
-                        break;
+        // The fix level is stored with the data, so a file which has been
+        // saved by this version does not need any of the fix-ups below
+        const auto fixVersion = file->fileFixVersion();
+        if (fixVersion >= file->availableFixVersion()) {
+            return true;
+        }
+        qDebug() << "testing fileFixVersion" << fixVersion << "<" << file->availableFixVersion();
 
-                    case 2:
-                        fixFile_2();
-                        file->setFileFixVersion(3);
-                        break;
+        static_assert(MyMoneyFile::availableFixVersion() == 5, "add the new fixFile_n() stage to applyFileFixes()");
 
-                    case 3:
-                        fixFile_3();
-                        file->setFileFixVersion(4);
-                        break;
+        QSignalBlocker blocked(file);
+        MyMoneyFileTransaction ft;
+        try {
+            if (fixVersion < 0) {
+                throw MYMONEYEXCEPTION(QString::fromLatin1("Unknown fix level in input file"));
+            }
 
-                    case 4:
-                        fixFile_4();
-                        file->setFileFixVersion(5);
-                        break;
+            QElapsedTimer timer;
+            timer.start();
+            if (fixVersion < 1) {
+                fixFile_0();
+                m_startupProfile.addStage("fixFile_0", timer.restart());
+            }
 
-                    // add new levels above. Don't forget to increase currentFixVersion() for all
-                    // the storage backends this fix applies to
-                    default:
-                        throw MYMONEYEXCEPTION(QString::fromLatin1("Unknown fix level in input file"));
-                    }
-                }
-                ft.commit();
-            } catch (const MyMoneyException &) {
-                return false;
+            // the fix-ups of fix level 0 and 2 operating on transactions
+            // share a single pass over the journal
+            if (fixVersion < 3) {
+                fixJournal(fixVersion);
+                m_startupProfile.addStage("journal", timer.restart());
             }
-        } else {
-            qDebug() << "Skipping automatic transaction fix!";
+
+            if (fixVersion < 2) {
+                fixFile_1();
+                m_startupProfile.addStage("fixFile_1", timer.restart());
+            }
+
+            if (fixVersion < 4) {
+                fixFile_3();
+                m_startupProfile.addStage("fixFile_3", timer.restart());
+            }
+
+            if (fixVersion < 5) {
+                fixFile_4();
+                m_startupProfile.addStage("fixFile_4", timer.restart());
+            }
+
+            // add new levels above. Don't forget to increase availableFixVersion()
+            // for all the storage backends this fix applies to
+            file->setFileFixVersion(file->availableFixVersion());
+            ft.commit();
+        } catch (const MyMoneyException &) {
+            return false;
         }
         return true;
     }
@@ -587,8 +676,9 @@ public:
 
 
     /* DO NOT ADD code to this function or any of it's called ones.
-       Instead, create a new function, fixFile_n, and modify the initializeStorage()
-       logic above to call it */
+       Instead, create a new function, fixFile_n, and modify the applyFileFixes()
+       logic above to call it. Fix-ups which operate on transactions go into
+       a fixTransaction_n function called from fixJournal() */
 
     void fixFile_4()
     {
@@ -617,47 +707,41 @@ public:
         MyMoneyFile::instance()->storageId();
     }
 
-    void fixFile_2()
+    /**
+     * Modifies transactions with two splits which reference an account
+     * and a category to have the memo text of the account in both splits.
+     *
+     * @returns @c true if @a transaction has been modified
+     */
+    bool fixTransaction_2(MyMoneyTransaction& transaction, QHash<QString, MyMoneyAccount>& accounts)
     {
-        auto file = MyMoneyFile::instance();
-        MyMoneyTransactionFilter filter;
-        filter.setReportAllSplits(false);
-        QList<MyMoneyTransaction> transactionList;
-        file->transactionList(transactionList, filter);
-
-        // scan the transactions and modify transactions with two splits
-        // which reference an account and a category to have the memo text
-        // of the account.
-        auto count = 0;
-        foreach (const auto transaction, transactionList) {
-            if (transaction.splitCount() == 2) {
-                QString accountId;
-                QString categoryId;
-                QString accountMemo;
-                QString categoryMemo;
-                foreach (const auto split, transaction.splits()) {
-                    auto acc = file->account(split.accountId());
-                    if (acc.isIncomeExpense()) {
-                        categoryId = split.id();
-                        categoryMemo = split.memo();
-                    } else {
-                        accountId = split.id();
-                        accountMemo = split.memo();
-                    }
-                }
+        if (transaction.splitCount() != 2)
+            return false;
 
-                if (!accountId.isEmpty() && !categoryId.isEmpty()
-                        && accountMemo != categoryMemo) {
-                    MyMoneyTransaction t(transaction);
-                    MyMoneySplit s(t.splitById(categoryId));
-                    s.setMemo(accountMemo);
-                    t.modifySplit(s);
-                    file->modifyTransaction(t);
-                    ++count;
-                }
+        QString accountId;
+        QString categoryId;
+        QString accountMemo;
+        QString categoryMemo;
+        const auto splits = transaction.splits();
+        for (const auto& split : splits) {
+            const auto& acc = cachedAccount(accounts, split.accountId());
+            if (acc.isIncomeExpense()) {
+                categoryId = split.id();
+                categoryMemo = split.memo();
+            } else {
+                accountId = split.id();
+                accountMemo = split.memo();
             }
         }
-        qDebug("%d transactions fixed in fixFile_2", count);
+
+        if (!accountId.isEmpty() && !categoryId.isEmpty()
+                && accountMemo != categoryMemo) {
+            MyMoneySplit s(transaction.splitById(categoryId));
+            s.setMemo(accountMemo);
+            transaction.modifySplit(s);
+            return true;
+        }
+        return false;
     }
 
     void fixFile_1()
@@ -774,7 +858,7 @@ public:
             fixSchedule_0(*it_s);
         }
 
-        fixTransactions_0();
+        // the transactions are fixed in fixJournal()
     }
 
     void fixSchedule_0(MyMoneySchedule sched)
@@ -854,204 +938,253 @@ public:
         }
     }
 
-    void fixTransactions_0()
+    /**
+     * Returns the account with @a id and keeps a copy in @a cache
+     * so that the following lookups don't need to go to the engine.
+     */
+    const MyMoneyAccount& cachedAccount(QHash<QString, MyMoneyAccount>& cache, const QString& id)
     {
-        auto file = MyMoneyFile::instance();
-
-        QList<MyMoneySchedule> scheduleList = file->scheduleList();
-        MyMoneyTransactionFilter filter;
-        filter.setReportAllSplits(false);
-        QList<MyMoneyTransaction> transactionList;
-        file->transactionList(transactionList, filter);
-
-        QList<MyMoneySchedule>::Iterator it_x;
-        QStringList interestAccounts;
-
-        KMSTATUS(i18n("Fix transactions"));
-        q->slotStatusProgressBar(0, scheduleList.count() + transactionList.count());
+        auto it = cache.find(id);
+        if (it == cache.end()) {
+            it = cache.insert(id, MyMoneyFile::instance()->account(id));
+        }
+        return *it;
+    }
 
-        int cnt = 0;
-        // scan the schedules to find interest accounts
-        for (it_x = scheduleList.begin(); it_x != scheduleList.end(); ++it_x) {
-            MyMoneyTransaction t = (*it_x).transaction();
-            QList<MyMoneySplit>::ConstIterator it_s;
-            QStringList accounts;
+    /**
+     * Scans the schedules for duplicate accounts and
+     * returns the ids of the accounts used for interest.
+     */
+    QSet<QString> scanSchedules_0()
+    {
+        QSet<QString> interestAccounts;
+        const auto scheduleList = MyMoneyFile::instance()->scheduleList();
+        for (const auto& schedule : scheduleList) {
+            MyMoneyTransaction t = schedule.transaction();
+            const auto splits = t.splits();
+            QSet<QString> accounts;
             bool hasDuplicateAccounts = false;
 
-            foreach (const auto split, t.splits()) {
+            for (const auto& split : splits) {
                 if (accounts.contains(split.accountId())) {
                     hasDuplicateAccounts = true;
                     qDebug() << Q_FUNC_INFO << " " << t.id() << " has multiple splits with account " << split.accountId();
                 } else {
-                    accounts << split.accountId();
+                    accounts.insert(split.accountId());
                 }
 
                 if (split.action() == MyMoneySplit::actionName(eMyMoney::Split::Action::Interest)) {
-                    if (interestAccounts.contains(split.accountId()) == 0) {
-                        interestAccounts << split.accountId();
-                    }
+                    interestAccounts.insert(split.accountId());
                 }
             }
             if (hasDuplicateAccounts) {
                 fixDuplicateAccounts_0(t);
             }
-            ++cnt;
-            if (!(cnt % 10))
-                q->slotStatusProgressBar(cnt);
         }
+        return interestAccounts;
+    }
 
-        // scan the transactions and modify loan transactions
-        for (auto& transaction : transactionList) {
-            QString defaultAction;
-            QList<MyMoneySplit> splits = transaction.splits();
-            QStringList accounts;
-
-            // check if base commodity is set. if not, set baseCurrency
-            if (transaction.commodity().isEmpty()) {
-                qDebug() << Q_FUNC_INFO << " " << transaction.id() << " has no base currency";
-                transaction.setCommodity(file->baseCurrency().id());
-                file->modifyTransaction(transaction);
-            }
+    /**
+     * Fixes the commodity, the interest actions, the shares and the
+     * fractions of the splits of @a transaction.
+     *
+     * @returns @c true if @a transaction has been modified
+     */
+    bool fixTransaction_0(MyMoneyTransaction& transaction, const QSet<QString>& interestAccounts, QHash<QString, MyMoneyAccount>& accountCache)
+    {
+        auto file = MyMoneyFile::instance();
+        bool modified = false;
+        QString defaultAction;
+        QList<MyMoneySplit> splits = transaction.splits();
+
+        // check if base commodity is set. if not, set baseCurrency
+        if (transaction.commodity().isEmpty()) {
+            qDebug() << Q_FUNC_INFO << " " << transaction.id() << " has no base currency";
+            transaction.setCommodity(file->baseCurrency().id());
+            modified = true;
+        }
 
-            bool isLoan = false;
-            // Determine default action
-            if (transaction.splitCount() == 2) {
-                // check for transfer
-                int accountCount = 0;
-                MyMoneyMoney val;
-                foreach (const auto split, splits) {
-                    auto acc = file->account(split.accountId());
-                    if (acc.accountGroup() == eMyMoney::Account::Type::Asset //
-                            || acc.accountGroup() == eMyMoney::Account::Type::Liability) {
-                        val = split.value();
-                        accountCount++;
-                        if (acc.accountType() == eMyMoney::Account::Type::Loan //
-                                || acc.accountType() == eMyMoney::Account::Type::AssetLoan)
-                            isLoan = true;
-                    } else
-                        break;
-                }
-                if (accountCount == 2) {
-                    if (isLoan)
-                        defaultAction = MyMoneySplit::actionName(eMyMoney::Split::Action::Amortization);
-                    else
-                        defaultAction = MyMoneySplit::actionName(eMyMoney::Split::Action::Transfer);
-                } else {
-                    if (val.isNegative())
-                        defaultAction = MyMoneySplit::actionName(eMyMoney::Split::Action::Withdrawal);
-                    else
-                        defaultAction = MyMoneySplit::actionName(eMyMoney::Split::Action::Deposit);
-                }
+        bool isLoan = false;
+        // Determine default action
+        if (transaction.splitCount() == 2) {
+            // check for transfer
+            int accountCount = 0;
+            MyMoneyMoney val;
+            for (const auto& split : qAsConst(splits)) {
+                const auto& acc = cachedAccount(accountCache, split.accountId());
+                if (acc.accountGroup() == eMyMoney::Account::Type::Asset //
+                        || acc.accountGroup() == eMyMoney::Account::Type::Liability) {
+                    val = split.value();
+                    accountCount++;
+                    if (acc.accountType() == eMyMoney::Account::Type::Loan //
+                            || acc.accountType() == eMyMoney::Account::Type::AssetLoan)
+                        isLoan = true;
+                } else
+                    break;
             }
+            if (accountCount == 2) {
+                if (isLoan)
+                    defaultAction = MyMoneySplit::actionName(eMyMoney::Split::Action::Amortization);
+                else
+                    defaultAction = MyMoneySplit::actionName(eMyMoney::Split::Action::Transfer);
+            } else {
+                if (val.isNegative())
+                    defaultAction = MyMoneySplit::actionName(eMyMoney::Split::Action::Withdrawal);
+                else
+                    defaultAction = MyMoneySplit::actionName(eMyMoney::Split::Action::Deposit);
+            }
+        }
 
-            isLoan = false;
-            foreach (const auto split, splits) {
-                auto acc = file->account(split.accountId());
-                MyMoneyMoney val = split.value();
-                if (acc.accountGroup() == eMyMoney::Account::Type::Asset
-                        || acc.accountGroup() == eMyMoney::Account::Type::Liability) {
-                    if (!val.isPositive()) {
-                        defaultAction = MyMoneySplit::actionName(eMyMoney::Split::Action::Withdrawal);
-                        break;
-                    } else {
-                        defaultAction = MyMoneySplit::actionName(eMyMoney::Split::Action::Deposit);
-                        break;
-                    }
+        for (const auto& split : qAsConst(splits)) {
+            const auto& acc = cachedAccount(accountCache, split.accountId());
+            if (acc.accountGroup() == eMyMoney::Account::Type::Asset
+                    || acc.accountGroup() == eMyMoney::Account::Type::Liability) {
+                if (!split.value().isPositive()) {
+                    defaultAction = MyMoneySplit::actionName(eMyMoney::Split::Action::Withdrawal);
+                } else {
+                    defaultAction = MyMoneySplit::actionName(eMyMoney::Split::Action::Deposit);
                 }
+                break;
             }
+        }
 
 #if 0
-            // Check for correct actions in transactions referencing credit cards
-            bool needModify = false;
-            // The action fields are actually not used anymore in the ledger view logic
-            // so we might as well skip this whole thing here!
-            for (it_s = splits.begin(); needModify == false && it_s != splits.end(); ++it_s) {
-                auto acc = file->account((*it_s).accountId());
-                MyMoneyMoney val = (*it_s).value();
-                if (acc.accountType() == Account::Type::CreditCard) {
-                    if (val < 0 && (*it_s).action() != MyMoneySplit::actionName(eMyMoney::Split::Action::Withdrawal) && (*it_s).action() != MyMoneySplit::actionName(eMyMoney::Split::Action::Transfer))
-                        needModify = true;
-                    if (val >= 0 && (*it_s).action() != MyMoneySplit::actionName(eMyMoney::Split::Action::Deposit) && (*it_s).action() != MyMoneySplit::actionName(eMyMoney::Split::Action::Transfer))
-                        needModify = true;
-                }
+        // Check for correct actions in transactions referencing credit cards
+        bool needModify = false;
+        // The action fields are actually not used anymore in the ledger view logic
+        // so we might as well skip this whole thing here!
+        for (it_s = splits.begin(); needModify == false && it_s != splits.end(); ++it_s) {
+            auto acc = file->account((*it_s).accountId());
+            MyMoneyMoney val = (*it_s).value();
+            if (acc.accountType() == Account::Type::CreditCard) {
+                if (val < 0 && (*it_s).action() != MyMoneySplit::actionName(eMyMoney::Split::Action::Withdrawal) && (*it_s).action() != MyMoneySplit::actionName(eMyMoney::Split::Action::Transfer))
+                    needModify = true;
+                if (val >= 0 && (*it_s).action() != MyMoneySplit::actionName(eMyMoney::Split::Action::Deposit) && (*it_s).action() != MyMoneySplit::actionName(eMyMoney::Split::Action::Transfer))
+                    needModify = true;
             }
+        }
 
-            // (Ace) Extended the #endif down to cover this conditional, because as-written
-            // it will ALWAYS be skipped.
+        // (Ace) Extended the #endif down to cover this conditional, because as-written
+        // it will ALWAYS be skipped.
 
-            if (needModify == true) {
-                for (it_s = splits.begin(); it_s != splits.end(); ++it_s) {
-                    (*it_s).setAction(defaultAction);
-                    transaction.modifySplit(*it_s);
-                    file->modifyTransaction(transaction);
-                }
-                splits = transaction.splits();    // update local copy
-                qDebug("Fixed credit card assignment in %s", transaction.id().data());
+        if (needModify == true) {
+            for (it_s = splits.begin(); it_s != splits.end(); ++it_s) {
+                (*it_s).setAction(defaultAction);
+                transaction.modifySplit(*it_s);
+                modified = true;
             }
+            splits = transaction.splits();    // update local copy
+            qDebug("Fixed credit card assignment in %s", transaction.id().data());
+        }
 #endif
 
-            // Check for correct assignment of ActionInterest in all splits
-            // and check if there are any duplicates in this transactions
-            for (auto& split : splits) {
-                MyMoneyAccount splitAccount = file->account(split.accountId());
-                if (!accounts.contains(split.accountId())) {
-                    accounts << split.accountId();
-                }
-                // if this split references an interest account, the action
-                // must be of type ActionInterest
-                if (interestAccounts.contains(split.accountId())) {
-                    if (split.action() != MyMoneySplit::actionName(eMyMoney::Split::Action::Interest)) {
-                        qDebug() << Q_FUNC_INFO << " " << transaction.id() << " contains an interest account (" << split.accountId() << ") but does not have ActionInterest";
-                        split.setAction(MyMoneySplit::actionName(eMyMoney::Split::Action::Interest));
-                        transaction.modifySplit(split);
-                        file->modifyTransaction(transaction);
-                        qDebug("Fixed interest action in %s", qPrintable(transaction.id()));
-                    }
-                    // if it does not reference an interest account, it must not be
-                    // of type ActionInterest
-                } else {
-                    if (split.action() == MyMoneySplit::actionName(eMyMoney::Split::Action::Interest)) {
-                        qDebug() << Q_FUNC_INFO << " " << transaction.id() << " does not contain an interest account so it should not have ActionInterest";
-                        split.setAction(defaultAction);
-                        transaction.modifySplit(split);
-                        file->modifyTransaction(transaction);
-                        qDebug("Fixed interest action in %s", qPrintable(transaction.id()));
-                    }
+        // Check for correct assignment of ActionInterest in all splits
+        for (auto& split : splits) {
+            const auto& splitAccount = cachedAccount(accountCache, split.accountId());
+            // if this split references an interest account, the action
+            // must be of type ActionInterest
+            if (interestAccounts.contains(split.accountId())) {
+                if (split.action() != MyMoneySplit::actionName(eMyMoney::Split::Action::Interest)) {
+                    qDebug() << Q_FUNC_INFO << " " << transaction.id() << " contains an interest account (" << split.accountId() << ") but does not have ActionInterest";
+                    split.setAction(MyMoneySplit::actionName(eMyMoney::Split::Action::Interest));
+                    transaction.modifySplit(split);
+                    modified = true;
+                    qDebug("Fixed interest action in %s", qPrintable(transaction.id()));
                 }
-
-                // check that for splits referencing an account that has
-                // the same currency as the transactions commodity the value
-                // and shares field are the same.
-                if (transaction.commodity() == splitAccount.currencyId()
-                        && split.value() != split.shares()) {
-                    qDebug() << Q_FUNC_INFO << " " << transaction.id() << " " << split.id() << " uses the transaction currency, but shares != value";
-                    split.setShares(split.value());
+                // if it does not reference an interest account, it must not be
+                // of type ActionInterest
+            } else {
+                if (split.action() == MyMoneySplit::actionName(eMyMoney::Split::Action::Interest)) {
+                    qDebug() << Q_FUNC_INFO << " " << transaction.id() << " does not contain an interest account so it should not have ActionInterest";
+                    split.setAction(defaultAction);
                     transaction.modifySplit(split);
-                    file->modifyTransaction(transaction);
+                    modified = true;
+                    qDebug("Fixed interest action in %s", qPrintable(transaction.id()));
                 }
+            }
 
-                // fix the shares and values to have the correct fraction
-                if (!splitAccount.isInvest()) {
-                    try {
-                        int fract = splitAccount.fraction();
-                        if (split.shares() != split.shares().convert(fract)) {
-                            qDebug("adjusting fraction in %s,%s", qPrintable(transaction.id()), qPrintable(split.id()));
-                            split.setShares(split.shares().convert(fract));
-                            split.setValue(split.value().convert(fract));
-                            transaction.modifySplit(split);
-                            file->modifyTransaction(transaction);
-                        }
-                    } catch (const MyMoneyException &) {
-                        qDebug("Missing security '%s', split not altered", qPrintable(splitAccount.currencyId()));
+            // check that for splits referencing an account that has
+            // the same currency as the transactions commodity the value
+            // and shares field are the same.
+            if (transaction.commodity() == splitAccount.currencyId()
+                    && split.value() != split.shares()) {
+                qDebug() << Q_FUNC_INFO << " " << transaction.id() << " " << split.id() << " uses the transaction currency, but shares != value";
+                split.setShares(split.value());
+                transaction.modifySplit(split);
+                modified = true;
+            }
+
+            // fix the shares and values to have the correct fraction
+            if (!splitAccount.isInvest()) {
+                try {
+                    int fract = splitAccount.fraction();
+                    if (split.shares() != split.shares().convert(fract)) {
+                        qDebug("adjusting fraction in %s,%s", qPrintable(transaction.id()), qPrintable(split.id()));
+                        split.setShares(split.shares().convert(fract));
+                        split.setValue(split.value().convert(fract));
+                        transaction.modifySplit(split);
+                        modified = true;
                     }
+                } catch (const MyMoneyException &) {
+                    qDebug("Missing security '%s', split not altered", qPrintable(splitAccount.currencyId()));
                 }
             }
+        }
+        return modified;
+    }
+
+    /**
+     * Applies the transaction related fix-ups of all levels starting
+     * at @a fixVersion in a single pass over the journal. Each
+     * transaction is written back to the engine at most once.
+     */
+    void fixJournal(int fixVersion)
+    {
+        auto file = MyMoneyFile::instance();
+
+        const auto fixLevel0 = (fixVersion < 1);
+        const auto fixLevel2 = (fixVersion < 3);
+
+        QSet<QString> interestAccounts;
+        if (fixLevel0) {
+            interestAccounts = scanSchedules_0();
+        }
+
+        MyMoneyTransactionFilter filter;
+        filter.setReportAllSplits(false);
+        QList<MyMoneyTransaction> transactionList;
+        file->transactionList(transactionList, filter);
+
+        KMSTATUS(i18n("Fix transactions"));
+        const auto total = transactionList.count();
+        // updating the progress bar is expensive, so we do it about 100 times
+        const auto progressStep = qMax(1, total / 100);
+        q->slotStatusProgressBar(0, total);
+
+        QHash<QString, MyMoneyAccount> accountCache;
+        int cnt = 0;
+        int fixedLevel2 = 0;
+        for (auto& transaction : transactionList) {
+            bool modified = false;
+            if (fixLevel0) {
+                modified = fixTransaction_0(transaction, interestAccounts, accountCache);
+            }
+            if (fixLevel2 && fixTransaction_2(transaction, accountCache)) {
+                modified = true;
+                ++fixedLevel2;
+            }
+            if (modified) {
+                file->modifyTransaction(transaction);
+            }
 
             ++cnt;
-            if (!(cnt % 10))
+            if (!(cnt % progressStep))
                 q->slotStatusProgressBar(cnt);
         }
 
+        if (fixLevel2) {
+            qDebug("%d transactions fixed in fixFile_2", fixedLevel2);
+        }
         q->slotStatusProgressBar(-1, -1);
     }
 
@@ -1136,6 +1269,10 @@ public:
 
         switch (action) {
         case eKMyMoney::FileAction::Opened:
+            // a new file has not been read by a storage plugin
+            if (!m_startupProfile.isRunning()) {
+                m_startupProfile.start();
+            }
             q->actionCollection()->action(QString::fromLatin1(KStandardAction::name(KStandardAction::Save)))->setEnabled(false);
             updateAccountNames();
             updateCurrencyNames();
@@ -1143,8 +1280,11 @@ public:
 
             // setup the standard precision
             amountEdit.setStandardPrecision(MyMoneyMoney::denomToPrec(MyMoneyFile::instance()->baseCurrency().smallestAccountFraction()));
+            m_startupProfile.endPhase("model load");
 
             applyFileFixes();
+            m_startupProfile.endPhase("fix-ups");
+
             // setup internal data for which we need all models loaded
             MyMoneyFile::instance()->accountsModel()->setupAccountFractions();
 
@@ -1153,6 +1293,8 @@ public:
 
             // inform everyone about new data
             MyMoneyFile::instance()->modelsReadyToUse();
+            m_startupProfile.endPhase("balances");
+
             MyMoneyFile::instance()->forceDataChanged();
             // Enable save in case the fix changed the contents
             q->actionCollection()->action(QString::fromLatin1(KStandardAction::name(KStandardAction::Save)))->setEnabled(dirty());
@@ -1163,6 +1305,8 @@ public:
             onlineJobAdministration::instance()->updateActions();
             m_myMoneyView->enableViewsIfFileOpen(m_storageInfo.isOpened);
             onlineJobAdministration::instance()->updateOnlineTaskProperties();
+            m_startupProfile.endPhase("view setup");
+            m_startupProfile.report(m_storageInfo.url.toDisplayString(QUrl::PreferLocalFile));
 
             q->connect(MyMoneyFile::instance(), &MyMoneyFile::dataChanged, q, &KMyMoneyApp::slotDataChanged);
 
@@ -4187,6 +4331,7 @@ bool KMyMoneyApp::slotFileOpenRecent(const QUrl &url)
             return false;
 
     // open the database
+    d->m_startupProfile.start();
     d->m_storageInfo.type = eKMyMoney::StorageType::None;
     for (auto &plugin : pPlugins.storage) {
         try {
@@ -4205,15 +4350,19 @@ bool KMyMoneyApp::slotFileOpenRecent(const QUrl &url)
                 break;
             }
         } catch (const MyMoneyException &e) {
+            d->m_startupProfile.cancel();
             KMessageBox::detailedError(this, i18n("Cannot open file as requested."), QString::fromLatin1(e.what()));
             return false;
         }
     }
 
     if(d->m_storageInfo.type == eKMyMoney::StorageType::None) {
+        d->m_startupProfile.cancel();
         KMessageBox::error(this, i18n("Could not read your data source. Please check the KMyMoney settings that the necessary plugin is enabled."));
         return false;
     }
+    // the storage plugins populate the models while they parse the data
+    d->m_startupProfile.endPhase("read");
 
     d->fileAction(eKMyMoney::FileAction::Opened);
     return true;
@@ -285,15 +285,18 @@ QString KMyMoneyUtils::nextFreeCheckNumber(const MyMoneyAccount& acc)
 
     // now check if this number has been used already
     if (file->checkNoUsed(acc.id(), num)) {
+        // plain numbers are looked up in the index of the journal
+        const auto freeNum = file->journalModel()->nextFreeNumber(acc.id(), num);
+        if (!freeNum.isEmpty()) {
+            return freeNum;
+        }
+
         // if a number has been entered which is immediately prior to
         // an existing number, the next new number produced would clash
         // so need to look ahead for free next number
         // we limit that to a number of tries which depends on the
-        // number of splits in that account (we can't have more)
-        MyMoneyTransactionFilter filter(acc.id());
-        QList<MyMoneyTransaction> transactions;
-        file->transactionList(transactions, filter);
-        const int maxNumber = transactions.count();
+        // number of different numbers used in that account (we can't have more)
+        const int maxNumber = file->journalModel()->numberCount(acc.id());
         for (int i = 0; i < maxNumber; i++) {
             if (file->checkNoUsed(acc.id(), num)) {
                 //  increment and try again
@@ -451,6 +454,8 @@ void KMyMoneyUtils::processPriceList(const MyMoneyStatement &st)
         secByName[sec.name()] = sec;
     }
 
+    QList<MyMoneyPrice> prices;
+    prices.reserve(st.m_listPrices.count());
     for (const auto& stPrice : st.m_listPrices) {
         auto currency = file->baseCurrency().id();
         QString security;
@@ -465,14 +470,14 @@ void KMyMoneyUtils::processPriceList(const MyMoneyStatement &st)
             security = secByName[stPrice.m_strSecurity].id();
             currency = file->security(file->security(security).tradingCurrency()).id();
         } else
-            return;
+            break;
 
-        MyMoneyPrice price(security,
-                           currency,
-                           stPrice.m_date,
-                           stPrice.m_amount, stPrice.m_sourceName.isEmpty() ? i18n("Prices Importer") : stPrice.m_sourceName);
-        file->addPrice(price);
+        prices.append(MyMoneyPrice(security,
+                                   currency,
+                                   stPrice.m_date,
+                                   stPrice.m_amount, stPrice.m_sourceName.isEmpty() ? i18n("Prices Importer") : stPrice.m_sourceName));
     }
+    file->addPrices(prices);
 }
 
 void KMyMoneyUtils::deleteSecurity(const MyMoneySecurity& security, QWidget* parent)
@@ -0,0 +1,191 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "benchmarkdatagenerator.h"
+
+// ----------------------------------------------------------------------------
+// QT Includes
+
+#include <QtGlobal>
+
+// ----------------------------------------------------------------------------
+// Project Includes
+
+#include "mymoneyaccount.h"
+#include "mymoneyenums.h"
+#include "mymoneyfile.h"
+#include "mymoneymoney.h"
+#include "mymoneypayee.h"
+#include "mymoneyprice.h"
+#include "mymoneysecurity.h"
+#include "mymoneysplit.h"
+#include "mymoneytransaction.h"
+
+BenchmarkDataGenerator::Scale BenchmarkDataGenerator::Scale::fromSplitCount(int splits)
+{
+    Scale scale;
+    scale.transactions = qMax(1, splits / 2);
+    scale.accounts = qBound(10, splits / 2000, 500);
+    scale.payees = qBound(20, splits / 500, 5000);
+    scale.prices = qMax(100, splits / 10);
+    scale.securities = qMax(5, scale.prices / 2000);
+    return scale;
+}
+
+BenchmarkDataGenerator::Scale BenchmarkDataGenerator::Scale::fromEnvironment()
+{
+    bool ok = false;
+    const auto splits = qEnvironmentVariableIntValue("KMM_BENCHMARK_SPLITS", &ok);
+    return fromSplitCount((ok && splits > 0) ? splits : 10000);
+}
+
+BenchmarkDataGenerator::BenchmarkDataGenerator(const Scale& scale, quint32 seed)
+    : m_scale(scale)
+    , m_state(seed)
+    // the generated data covers the last ten years so that partial
+    // loading of the database finds transactions of the last year
+    , m_firstDate(QDate::currentDate().year() - 9, 1, 1)
+    , m_lastDate(QDate::currentDate().year(), 12, 31)
+{
+}
+
+quint32 BenchmarkDataGenerator::random(quint32 max)
+{
+    // a simple linear congruential generator is good enough here
+    // and produces the same sequence on all platforms and Qt versions
+    m_state = m_state * 1664525U + 1013904223U;
+    return (m_state >> 8) % max;
+}
+
+void BenchmarkDataGenerator::populate(MyMoneyFile* file, int chunkSize)
+{
+    addCurrencies(file);
+    addSecurities(file);
+    addAccounts(file);
+    addPayees(file);
+    addTransactions(file, qMax(1, chunkSize));
+}
+
+void BenchmarkDataGenerator::addCurrencies(MyMoneyFile* file)
+{
+    MyMoneyFileTransaction ft;
+    MyMoneySecurity base(QStringLiteral("EUR"), QStringLiteral("Euro"), QChar(0x20ac));
+    file->addCurrency(base);
+    file->setBaseCurrency(base);
+    ft.commit();
+}
+
+void BenchmarkDataGenerator::addSecurities(MyMoneyFile* file)
+{
+    const auto days = m_firstDate.daysTo(m_lastDate);
+    const auto pricesPerSecurity = qMax(1, m_scale.prices / qMax(1, m_scale.securities));
+
+    MyMoneyFileTransaction ft;
+    QList<MyMoneyPrice> prices;
+    for (int i = 0; i < m_scale.securities; ++i) {
+        MyMoneySecurity security;
+        security.setName(QStringLiteral("Security %1").arg(i));
+        security.setTradingSymbol(QStringLiteral("SEC%1").arg(i));
+        security.setSecurityType(eMyMoney::Security::Type::Stock);
+        security.setTradingCurrency(QStringLiteral("EUR"));
+        security.setSmallestAccountFraction(1000);
+        file->addSecurity(security);
+        m_securityIds.append(security.id());
+
+        // spread the prices evenly over the whole period
+        for (int j = 0; j < pricesPerSecurity; ++j) {
+            const auto date = m_lastDate.addDays(-(j * days / pricesPerSecurity));
+            const MyMoneyMoney rate(static_cast<qint64>(1000 + random(100000)), 100);
+            prices.append(MyMoneyPrice(security.id(), QStringLiteral("EUR"), date, rate, QStringLiteral("Benchmark")));
+        }
+    }
+    file->addPrices(prices);
+    ft.commit();
+}
+
+void BenchmarkDataGenerator::addAccounts(MyMoneyFile* file)
+{
+    const auto assetCount = qMax(1, m_scale.accounts / 4);
+    const auto categoryCount = qMax(2, m_scale.accounts - assetCount);
+
+    MyMoneyFileTransaction ft;
+    for (int i = 0; i < assetCount; ++i) {
+        MyMoneyAccount account;
+        account.setName(QStringLiteral("Checking %1").arg(i));
+        account.setAccountType(eMyMoney::Account::Type::Checkings);
+        account.setCurrencyId(QStringLiteral("EUR"));
+        account.setOpeningDate(m_firstDate);
+        auto parent = file->asset();
+        file->addAccount(account, parent);
+        m_assetIds.append(account.id());
+    }
+
+    // a third of the categories are income categories
+    for (int i = 0; i < categoryCount; ++i) {
+        const auto isIncome = (i % 3) == 0;
+        MyMoneyAccount account;
+        account.setName(QStringLiteral("Category %1").arg(i));
+        account.setAccountType(isIncome ? eMyMoney::Account::Type::Income : eMyMoney::Account::Type::Expense);
+        account.setCurrencyId(QStringLiteral("EUR"));
+        account.setOpeningDate(m_firstDate);
+        auto parent = isIncome ? file->income() : file->expense();
+        file->addAccount(account, parent);
+        m_categoryIds.append(account.id());
+    }
+    ft.commit();
+}
+
+void BenchmarkDataGenerator::addPayees(MyMoneyFile* file)
+{
+    MyMoneyFileTransaction ft;
+    for (int i = 0; i < m_scale.payees; ++i) {
+        MyMoneyPayee payee;
+        payee.setName(QStringLiteral("Payee %1").arg(i));
+        file->addPayee(payee);
+        m_payeeIds.append(payee.id());
+    }
+    ft.commit();
+}
+
+void BenchmarkDataGenerator::addTransactions(MyMoneyFile* file, int chunkSize)
+{
+    const auto days = m_firstDate.daysTo(m_lastDate) + 1;
+
+    int added = 0;
+    while (added < m_scale.transactions) {
+        MyMoneyFileTransaction ft;
+        const auto chunkEnd = qMin(added + chunkSize, m_scale.transactions);
+        for (; added < chunkEnd; ++added) {
+            const auto categoryIdx = random(m_categoryIds.count());
+            const auto isIncome = (categoryIdx % 3) == 0;
+            MyMoneyMoney amount(static_cast<qint64>(1 + random(100000)), 100);
+            if (!isIncome) {
+                amount = -amount;
+            }
+
+            MyMoneyTransaction t;
+            t.setCommodity(QStringLiteral("EUR"));
+            t.setPostDate(m_firstDate.addDays(random(days)));
+
+            MyMoneySplit sp;
+            sp.setAccountId(m_assetIds.at(random(m_assetIds.count())));
+            sp.setPayeeId(m_payeeIds.at(random(m_payeeIds.count())));
+            sp.setShares(amount);
+            sp.setValue(amount);
+            sp.setReconcileFlag((random(4) == 0) ? eMyMoney::Split::State::NotReconciled : eMyMoney::Split::State::Cleared);
+            t.addSplit(sp);
+
+            MyMoneySplit sc;
+            sc.setAccountId(m_categoryIds.at(categoryIdx));
+            sc.setPayeeId(sp.payeeId());
+            sc.setShares(-amount);
+            sc.setValue(-amount);
+            t.addSplit(sc);
+
+            file->addTransaction(t);
+        }
+        ft.commit();
+    }
+}
@@ -0,0 +1,132 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef BENCHMARKDATAGENERATOR_H
+#define BENCHMARKDATAGENERATOR_H
+
+// ----------------------------------------------------------------------------
+// QT Includes
+
+#include <QDate>
+#include <QStringList>
+
+// ----------------------------------------------------------------------------
+// Project Includes
+
+class MyMoneyFile;
+
+/**
+ * This class fills a MyMoneyFile with synthetic data for the benchmarks.
+ *
+ * The data only depends on the scale, the seed and the current year so
+ * that two runs with the same parameters operate on identical files.
+ * Each transaction consists of two splits, one in an asset account and
+ * one in an income or expense category.
+ */
+class BenchmarkDataGenerator
+{
+public:
+    struct Scale {
+        int accounts = 0;
+        int payees = 0;
+        int transactions = 0;
+        int securities = 0;
+        int prices = 0;
+
+        /**
+         * Returns a scale that produces approximately @a splits splits
+         * together with a proportional number of accounts and prices.
+         */
+        static Scale fromSplitCount(int splits);
+
+        /**
+         * Returns the scale selected by the environment variable
+         * @c KMM_BENCHMARK_SPLITS (e.g. 10000, 100000 or 1000000).
+         * If it is not set, 10000 splits are used.
+         */
+        static Scale fromEnvironment();
+
+        int splitCount() const
+        {
+            return 2 * transactions;
+        }
+    };
+
+    explicit BenchmarkDataGenerator(const Scale& scale, quint32 seed = 1);
+
+    /**
+     * Adds the base currency, securities, prices, accounts, payees
+     * and transactions to @a file. The transactions are added in
+     * chunks of @a chunkSize per engine transaction.
+     *
+     * @note @a file must be empty
+     */
+    void populate(MyMoneyFile* file, int chunkSize = 1000);
+
+    const Scale& scale() const
+    {
+        return m_scale;
+    }
+
+    /**
+     * The date of the first transaction
+     */
+    QDate firstDate() const
+    {
+        return m_firstDate;
+    }
+
+    /**
+     * The date of the last transaction
+     */
+    QDate lastDate() const
+    {
+        return m_lastDate;
+    }
+
+    const QStringList& assetAccountIds() const
+    {
+        return m_assetIds;
+    }
+
+    const QStringList& categoryIds() const
+    {
+        return m_categoryIds;
+    }
+
+    const QStringList& payeeIds() const
+    {
+        return m_payeeIds;
+    }
+
+    const QStringList& securityIds() const
+    {
+        return m_securityIds;
+    }
+
+    /**
+     * Returns the next pseudo random number in the range [0, @a max).
+     * The sequence is fully determined by the seed.
+     */
+    quint32 random(quint32 max);
+
+private:
+    void addCurrencies(MyMoneyFile* file);
+    void addSecurities(MyMoneyFile* file);
+    void addAccounts(MyMoneyFile* file);
+    void addPayees(MyMoneyFile* file);
+    void addTransactions(MyMoneyFile* file, int chunkSize);
+
+    Scale       m_scale;
+    quint32     m_state;
+    QDate       m_firstDate;
+    QDate       m_lastDate;
+    QStringList m_assetIds;
+    QStringList m_categoryIds;
+    QStringList m_payeeIds;
+    QStringList m_securityIds;
+};
+
+#endif
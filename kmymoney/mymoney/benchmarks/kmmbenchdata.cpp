@@ -0,0 +1,101 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// ----------------------------------------------------------------------------
+// QT Includes
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QExplicitlySharedDataPointer>
+#include <QFile>
+#include <QTextStream>
+#include <QUrl>
+
+// ----------------------------------------------------------------------------
+// KDE Includes
+
+#include <KCompressionDevice>
+
+// ----------------------------------------------------------------------------
+// Project Includes
+
+#include "config-kmymoney.h"
+#include "benchmarkdatagenerator.h"
+#include "misc/platformtools.h"
+#include "mymoneyexception.h"
+#include "mymoneyfile.h"
+#include "xml/mymoneystoragexml.h"
+#ifdef ENABLE_SQLSTORAGE
+#include "sql/mymoneystoragesql.h"
+#endif
+
+/**
+ * Writes the synthetic benchmark data as KMyMoney file (and as SQLite
+ * database if SQL storage support is available) so that the scaled
+ * files can be used to measure the application manually, e.g.
+ *
+ * kmmbenchdata --splits 1000000 /tmp/bench-1M
+ *
+ * creates /tmp/bench-1M.kmy and /tmp/bench-1M.sqlite
+ */
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Generates scaled KMyMoney files for benchmarking"));
+    parser.addHelpOption();
+    QCommandLineOption splitsOption(QStringLiteral("splits"), QStringLiteral("Number of splits to generate"), QStringLiteral("count"), QStringLiteral("10000"));
+    QCommandLineOption seedOption(QStringLiteral("seed"), QStringLiteral("Seed of the random number generator"), QStringLiteral("seed"), QStringLiteral("1"));
+    parser.addOption(splitsOption);
+    parser.addOption(seedOption);
+    parser.addPositionalArgument(QStringLiteral("basename"), QStringLiteral("Path and basename of the generated files"));
+    parser.process(app);
+
+    QTextStream out(stdout);
+    if (parser.positionalArguments().count() != 1) {
+        parser.showHelp(1);
+    }
+    const auto basename = QDir::current().absoluteFilePath(parser.positionalArguments().at(0));
+
+    auto file = MyMoneyFile::instance();
+    QElapsedTimer timer;
+    timer.start();
+    BenchmarkDataGenerator generator(BenchmarkDataGenerator::Scale::fromSplitCount(parser.value(splitsOption).toInt()), parser.value(seedOption).toUInt());
+    generator.populate(file);
+    out << "Generated " << generator.scale().splitCount() << " splits in " << timer.restart() << " ms" << '\n';
+
+    try {
+        KCompressionDevice device(basename + QStringLiteral(".kmy"), KCompressionDevice::GZip);
+        if (!device.open(QIODevice::WriteOnly)) {
+            out << "Unable to create " << device.fileName() << '\n';
+            return 1;
+        }
+        MyMoneyStorageXML writer;
+        writer.writeFile(&device, file);
+        device.close();
+        out << "Wrote " << basename << ".kmy in " << timer.restart() << " ms" << '\n';
+    } catch (const MyMoneyException& e) {
+        out << "Unable to write KMyMoney file: " << e.what() << '\n';
+        return 1;
+    }
+
+#ifdef ENABLE_SQLSTORAGE
+    const auto dbName = basename + QStringLiteral(".sqlite");
+    QFile::remove(dbName);
+    const QUrl url(QStringLiteral("sql://%1@localhost/%2?driver=QSQLITE&mode=single").arg(platformTools::osUsername(), dbName));
+    QExplicitlySharedDataPointer<MyMoneyStorageSql> writer(new MyMoneyStorageSql(file, url));
+    if (writer->open(url, QIODevice::WriteOnly, true) != 0 || !writer->writeFile()) {
+        out << "Unable to write database: " << writer->lastError() << '\n';
+        return 1;
+    }
+    writer->close(true);
+    out << "Wrote " << dbName << " in " << timer.restart() << " ms" << '\n';
+#endif
+
+    file->unload();
+    return 0;
+}
@@ -0,0 +1,238 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "mymoneyfile-bench.h"
+
+// ----------------------------------------------------------------------------
+// System Includes
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+// ----------------------------------------------------------------------------
+// QT Includes
+
+#include <QElapsedTimer>
+#include <QTest>
+
+// ----------------------------------------------------------------------------
+// Project Includes
+
+#include "mymoneyfile.h"
+#include "mymoneymoney.h"
+#include "mymoneyprice.h"
+#include "mymoneysplit.h"
+#include "mymoneytransaction.h"
+#include "mymoneytransactionfilter.h"
+
+QTEST_GUILESS_MAIN(MyMoneyFileBenchmark)
+
+namespace {
+enum FilterType {
+    AllTransactions,
+    SingleAccount,
+    SingleAccountLastYear,
+    SingleCategory,
+    SinglePayee,
+    LastMonth,
+};
+
+/**
+ * Returns the number of bytes currently allocated on the heap
+ * or -1 in case this information is not available.
+ */
+qint64 heapInUse()
+{
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 33)))
+    const auto info = mallinfo2();
+    return static_cast<qint64>(info.uordblks + info.hblkhd);
+#elif defined(__GLIBC__)
+    const auto info = mallinfo();
+    return static_cast<qint64>(static_cast<unsigned int>(info.uordblks)) + static_cast<unsigned int>(info.hblkhd);
+#else
+    return -1;
+#endif
+}
+}
+
+MyMoneyFileBenchmark::MyMoneyFileBenchmark()
+    : m_file(nullptr)
+    , m_generator(BenchmarkDataGenerator::Scale::fromEnvironment())
+{
+}
+
+void MyMoneyFileBenchmark::initTestCase()
+{
+    m_file = MyMoneyFile::instance();
+
+    QElapsedTimer timer;
+    const auto heapBefore = heapInUse();
+    timer.start();
+    m_generator.populate(m_file);
+    qDebug("Generated %d splits in %lld ms", m_generator.scale().splitCount(), timer.elapsed());
+
+    // drop the undo information kept for the generated objects
+    // as it is done after loading a file, so that only the data
+    // of the engine is left
+    m_file->finalizeFileOpen();
+
+    // the heap used for the data is the figure to watch
+    // when changing the memory layout of the journal
+    if (heapBefore >= 0) {
+        const auto heapUsed = heapInUse() - heapBefore;
+        qDebug("Heap used by the engine: %lld bytes, %lld bytes per split", heapUsed, heapUsed / qMax(1, m_generator.scale().splitCount()));
+    }
+}
+
+void MyMoneyFileBenchmark::cleanupTestCase()
+{
+    m_file->unload();
+}
+
+void MyMoneyFileBenchmark::benchBalance_data()
+{
+    QTest::addColumn<QDate>("date");
+
+    QTest::newRow("current") << QDate();
+    QTest::newRow("last year") << m_generator.lastDate().addYears(-1);
+    QTest::newRow("first year") << m_generator.firstDate().addYears(1);
+}
+
+void MyMoneyFileBenchmark::benchBalance()
+{
+    QFETCH(QDate, date);
+
+    const auto& accountIds = m_generator.assetAccountIds();
+    MyMoneyMoney total;
+    QBENCHMARK {
+        // make sure we measure the calculation and not the cache
+        m_file->clearCache();
+        for (const auto& id : accountIds) {
+            total += m_file->balance(id, date);
+        }
+    }
+    Q_UNUSED(total)
+}
+
+void MyMoneyFileBenchmark::benchTransactionList_data()
+{
+    QTest::addColumn<int>("filterType");
+
+    QTest::newRow("all") << static_cast<int>(AllTransactions);
+    QTest::newRow("account") << static_cast<int>(SingleAccount);
+    QTest::newRow("account last year") << static_cast<int>(SingleAccountLastYear);
+    QTest::newRow("category") << static_cast<int>(SingleCategory);
+    QTest::newRow("payee") << static_cast<int>(SinglePayee);
+    QTest::newRow("last month") << static_cast<int>(LastMonth);
+}
+
+void MyMoneyFileBenchmark::benchTransactionList()
+{
+    QFETCH(int, filterType);
+
+    MyMoneyTransactionFilter filter;
+    switch (static_cast<FilterType>(filterType)) {
+    case AllTransactions:
+        break;
+    case SingleAccount:
+        filter.addAccount(m_generator.assetAccountIds().first());
+        break;
+    case SingleAccountLastYear:
+        filter.addAccount(m_generator.assetAccountIds().first());
+        filter.setDateFilter(m_generator.lastDate().addYears(-1), m_generator.lastDate());
+        break;
+    case SingleCategory:
+        filter.addCategory(m_generator.categoryIds().first());
+        break;
+    case SinglePayee:
+        filter.addPayee(m_generator.payeeIds().first());
+        break;
+    case LastMonth:
+        filter.setDateFilter(m_generator.lastDate().addMonths(-1), m_generator.lastDate());
+        break;
+    }
+
+    int count = 0;
+    QBENCHMARK {
+        QList<QPair<MyMoneyTransaction, MyMoneySplit>> list;
+        m_file->transactionList(list, filter);
+        count = list.count();
+    }
+    QVERIFY(count > 0);
+}
+
+void MyMoneyFileBenchmark::benchPrice_data()
+{
+    QTest::addColumn<QDate>("date");
+    QTest::addColumn<bool>("exactDate");
+
+    QTest::newRow("most recent") << QDate() << false;
+    QTest::newRow("exact date") << m_generator.lastDate() << true;
+    QTest::newRow("historic") << m_generator.firstDate().addYears(2) << false;
+}
+
+void MyMoneyFileBenchmark::benchPrice()
+{
+    QFETCH(QDate, date);
+    QFETCH(bool, exactDate);
+
+    const auto& securityIds = m_generator.securityIds();
+    int found = 0;
+    QBENCHMARK {
+        found = 0;
+        for (const auto& id : securityIds) {
+            if (m_file->price(id, QStringLiteral("EUR"), date, exactDate).isValid()) {
+                ++found;
+            }
+        }
+    }
+    QCOMPARE(found, securityIds.count());
+}
+
+void MyMoneyFileBenchmark::benchCommitTransaction_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+}
+
+void MyMoneyFileBenchmark::benchCommitTransaction()
+{
+    QFETCH(int, count);
+
+    // prepare the transactions upfront so that only the engine is measured
+    QList<MyMoneyTransaction> transactions;
+    for (int i = 0; i < count; ++i) {
+        const auto categoryIdx = m_generator.random(m_generator.categoryIds().count());
+        MyMoneyMoney amount(static_cast<qint64>(1 + m_generator.random(100000)), 100);
+
+        MyMoneyTransaction t;
+        t.setCommodity(QStringLiteral("EUR"));
+        t.setPostDate(m_generator.lastDate().addDays(-static_cast<int>(m_generator.random(365))));
+
+        MyMoneySplit sp;
+        sp.setAccountId(m_generator.assetAccountIds().at(m_generator.random(m_generator.assetAccountIds().count())));
+        sp.setShares(-amount);
+        sp.setValue(-amount);
+        t.addSplit(sp);
+
+        MyMoneySplit sc;
+        sc.setAccountId(m_generator.categoryIds().at(categoryIdx));
+        sc.setShares(amount);
+        sc.setValue(amount);
+        t.addSplit(sc);
+        transactions.append(t);
+    }
+
+    QBENCHMARK_ONCE {
+        MyMoneyFileTransaction ft;
+        for (auto& t : transactions) {
+            m_file->addTransaction(t);
+        }
+        ft.commit();
+    }
+}
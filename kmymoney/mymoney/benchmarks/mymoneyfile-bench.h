@@ -0,0 +1,40 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef MYMONEYFILE_BENCH_H
+#define MYMONEYFILE_BENCH_H
+
+#include <QObject>
+
+#include "benchmarkdatagenerator.h"
+
+class MyMoneyFile;
+
+class MyMoneyFileBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    MyMoneyFileBenchmark();
+
+private:
+    MyMoneyFile*            m_file;
+    BenchmarkDataGenerator  m_generator;
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void benchBalance_data();
+    void benchBalance();
+    void benchTransactionList_data();
+    void benchTransactionList();
+    void benchPrice_data();
+    void benchPrice();
+    // must be the last one as it adds transactions to the file
+    void benchCommitTransaction_data();
+    void benchCommitTransaction();
+};
+
+#endif
@@ -0,0 +1,95 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "mymoneystoragesql-bench.h"
+
+// ----------------------------------------------------------------------------
+// QT Includes
+
+#include <QExplicitlySharedDataPointer>
+#include <QFileInfo>
+#include <QTest>
+#include <QUrlQuery>
+
+// ----------------------------------------------------------------------------
+// Project Includes
+
+#include "benchmarkdatagenerator.h"
+#include "journalmodel.h"
+#include "misc/platformtools.h"
+#include "mymoneyfile.h"
+#include "sql/mymoneystoragesql.h"
+
+QTEST_GUILESS_MAIN(MyMoneyStorageSqlBenchmark)
+
+void MyMoneyStorageSqlBenchmark::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    m_url = QUrl(QStringLiteral("sql://%1@localhost/%2?driver=QSQLITE&mode=single")
+                 .arg(platformTools::osUsername(), m_dir.filePath(QStringLiteral("benchmark.sqlite"))));
+
+    BenchmarkDataGenerator generator(BenchmarkDataGenerator::Scale::fromEnvironment());
+    generator.populate(MyMoneyFile::instance());
+    m_splitCount = generator.scale().splitCount();
+
+    writeDatabase();
+    qDebug("SQLite file size for %d splits: %lld bytes", m_splitCount,
+           QFileInfo(m_dir.filePath(QStringLiteral("benchmark.sqlite"))).size());
+}
+
+void MyMoneyStorageSqlBenchmark::cleanupTestCase()
+{
+    MyMoneyFile::instance()->unload();
+}
+
+void MyMoneyStorageSqlBenchmark::writeDatabase()
+{
+    QExplicitlySharedDataPointer<MyMoneyStorageSql> writer(new MyMoneyStorageSql(MyMoneyFile::instance(), m_url));
+    QCOMPARE(writer->open(m_url, QIODevice::WriteOnly, true), 0);
+    QVERIFY2(writer->writeFile(), qPrintable(writer->lastError()));
+    writer->close(true);
+}
+
+void MyMoneyStorageSqlBenchmark::readDatabase(const QUrl& url)
+{
+    auto file = MyMoneyFile::instance();
+    // the file must be empty before reading
+    file->unload();
+    QExplicitlySharedDataPointer<MyMoneyStorageSql> reader(new MyMoneyStorageSql(file, url));
+    QCOMPARE(reader->open(url, QIODevice::ReadWrite), 0);
+    QVERIFY2(reader->readFile(), qPrintable(reader->lastError()));
+}
+
+void MyMoneyStorageSqlBenchmark::benchWrite()
+{
+    QBENCHMARK {
+        writeDatabase();
+    }
+}
+
+void MyMoneyStorageSqlBenchmark::benchRead()
+{
+    QBENCHMARK {
+        readDatabase(m_url);
+    }
+    // the journal contains one row per split
+    QCOMPARE(MyMoneyFile::instance()->journalModel()->rowCount(), m_splitCount);
+}
+
+void MyMoneyStorageSqlBenchmark::benchReadPartial()
+{
+    auto url(m_url);
+    QUrlQuery query(url);
+    query.addQueryItem(QStringLiteral("options"), QStringLiteral("partial"));
+    url.setQuery(query);
+
+    QBENCHMARK {
+        readDatabase(url);
+    }
+    QVERIFY(MyMoneyFile::instance()->journalModel()->rowCount() > 0);
+
+    // leave a completely loaded file behind
+    readDatabase(m_url);
+}
@@ -0,0 +1,33 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef MYMONEYSTORAGESQL_BENCH_H
+#define MYMONEYSTORAGESQL_BENCH_H
+
+#include <QObject>
+#include <QTemporaryDir>
+#include <QUrl>
+
+class MyMoneyStorageSqlBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    void writeDatabase();
+    void readDatabase(const QUrl& url);
+
+    QTemporaryDir   m_dir;
+    QUrl            m_url;
+    int             m_splitCount = 0;
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void benchWrite();
+    void benchRead();
+    void benchReadPartial();
+};
+
+#endif
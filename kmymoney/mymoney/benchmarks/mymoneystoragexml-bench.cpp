@@ -0,0 +1,76 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "mymoneystoragexml-bench.h"
+
+// ----------------------------------------------------------------------------
+// QT Includes
+
+#include <QBuffer>
+#include <QTest>
+
+// ----------------------------------------------------------------------------
+// Project Includes
+
+#include "benchmarkdatagenerator.h"
+#include "journalmodel.h"
+#include "mymoneyexception.h"
+#include "mymoneyfile.h"
+#include "xml/mymoneystoragexml.h"
+
+QTEST_GUILESS_MAIN(MyMoneyStorageXMLBenchmark)
+
+void MyMoneyStorageXMLBenchmark::initTestCase()
+{
+    auto file = MyMoneyFile::instance();
+    BenchmarkDataGenerator generator(BenchmarkDataGenerator::Scale::fromEnvironment());
+    generator.populate(file);
+    m_splitCount = generator.scale().splitCount();
+
+    QBuffer buffer(&m_xml);
+    buffer.open(QIODevice::WriteOnly);
+    MyMoneyStorageXML writer;
+    writer.writeFile(&buffer, file);
+    qDebug("XML file size for %d splits: %d bytes", generator.scale().splitCount(), m_xml.size());
+}
+
+void MyMoneyStorageXMLBenchmark::cleanupTestCase()
+{
+    MyMoneyFile::instance()->unload();
+}
+
+void MyMoneyStorageXMLBenchmark::benchWrite()
+{
+    auto file = MyMoneyFile::instance();
+    QByteArray data;
+    data.reserve(m_xml.size());
+    QBENCHMARK {
+        data.clear();
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        MyMoneyStorageXML writer;
+        writer.writeFile(&buffer, file);
+    }
+    QCOMPARE(data.size(), m_xml.size());
+}
+
+void MyMoneyStorageXMLBenchmark::benchRead()
+{
+    auto file = MyMoneyFile::instance();
+    QBENCHMARK {
+        // the file must be empty before reading
+        file->unload();
+        QBuffer buffer(&m_xml);
+        buffer.open(QIODevice::ReadOnly);
+        MyMoneyStorageXML reader;
+        try {
+            reader.readFile(&buffer, file);
+        } catch (const MyMoneyException& e) {
+            QFAIL(e.what());
+        }
+    }
+    // the journal contains one row per split
+    QCOMPARE(file->journalModel()->rowCount(), m_splitCount);
+}
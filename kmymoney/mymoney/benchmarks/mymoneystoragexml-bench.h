@@ -0,0 +1,27 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef MYMONEYSTORAGEXML_BENCH_H
+#define MYMONEYSTORAGEXML_BENCH_H
+
+#include <QByteArray>
+#include <QObject>
+
+class MyMoneyStorageXMLBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    QByteArray  m_xml;
+    int         m_splitCount = 0;
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void benchWrite();
+    void benchRead();
+};
+
+#endif
@@ -0,0 +1,153 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef MYMONEYCHANGESET_H
+#define MYMONEYCHANGESET_H
+
+// ----------------------------------------------------------------------------
+// QT Includes
+
+#include <QList>
+#include <QMap>
+#include <QSet>
+#include <QString>
+
+// ----------------------------------------------------------------------------
+// KDE Includes
+
+// ----------------------------------------------------------------------------
+// Project Includes
+
+#include "mymoneyenums.h"
+
+/**
+ * This class contains all changes of a single engine transaction
+ * grouped by object type. It is sent out by MyMoneyFile::changesCommitted()
+ * so that receivers can update themselves once per transaction instead
+ * of once per object.
+ *
+ * An object removed within the transaction is only reported as removed
+ * and an object added within the transaction is not reported as modified.
+ */
+class MyMoneyChangeSet
+{
+public:
+    /**
+     * Records the change @a mode for the object of type @a type with @a id
+     */
+    void addChange(eMyMoney::File::Mode mode, eMyMoney::File::Object type, const QString& id)
+    {
+        switch (mode) {
+        case eMyMoney::File::Mode::Remove:
+            remove(m_added, type, id);
+            remove(m_modified, type, id);
+            m_removed[type].insert(id);
+            break;
+        case eMyMoney::File::Mode::Add:
+            if (!m_removed.value(type).contains(id)) {
+                remove(m_modified, type, id);
+                m_added[type].insert(id);
+            }
+            break;
+        case eMyMoney::File::Mode::Modify:
+            if (!m_removed.value(type).contains(id) && !m_added.value(type).contains(id)) {
+                m_modified[type].insert(id);
+            }
+            break;
+        }
+    }
+
+    /**
+     * Records the ids of the accounts whose balance has changed
+     */
+    void setBalanceChangedAccounts(const QSet<QString>& ids)
+    {
+        m_balanceChanged = ids;
+    }
+
+    /**
+     * Records the ids of the accounts whose value (but not
+     * the balance) has changed due to a price change
+     */
+    void setValueChangedAccounts(const QSet<QString>& ids)
+    {
+        m_valueChanged = ids;
+    }
+
+    QSet<QString> addedObjects(eMyMoney::File::Object type) const
+    {
+        return m_added.value(type);
+    }
+
+    QSet<QString> modifiedObjects(eMyMoney::File::Object type) const
+    {
+        return m_modified.value(type);
+    }
+
+    QSet<QString> removedObjects(eMyMoney::File::Object type) const
+    {
+        return m_removed.value(type);
+    }
+
+    const QSet<QString>& balanceChangedAccounts() const
+    {
+        return m_balanceChanged;
+    }
+
+    const QSet<QString>& valueChangedAccounts() const
+    {
+        return m_valueChanged;
+    }
+
+    /**
+     * Returns @c true if any object of type @a type
+     * has been added, modified or removed
+     */
+    bool contains(eMyMoney::File::Object type) const
+    {
+        return m_added.contains(type) || m_modified.contains(type) || m_removed.contains(type);
+    }
+
+    /**
+     * Returns the types of all objects that have been
+     * added, modified or removed
+     */
+    QList<eMyMoney::File::Object> objectTypes() const
+    {
+        QList<eMyMoney::File::Object> types = m_added.keys();
+        for (const auto& type : m_modified.keys() + m_removed.keys()) {
+            if (!types.contains(type)) {
+                types.append(type);
+            }
+        }
+        return types;
+    }
+
+    bool isEmpty() const
+    {
+        return m_added.isEmpty() && m_modified.isEmpty() && m_removed.isEmpty()
+               && m_balanceChanged.isEmpty() && m_valueChanged.isEmpty();
+    }
+
+private:
+    static void remove(QMap<eMyMoney::File::Object, QSet<QString>>& map, eMyMoney::File::Object type, const QString& id)
+    {
+        auto it = map.find(type);
+        if (it != map.end()) {
+            (*it).remove(id);
+            if ((*it).isEmpty()) {
+                map.erase(it);
+            }
+        }
+    }
+
+    QMap<eMyMoney::File::Object, QSet<QString>> m_added;
+    QMap<eMyMoney::File::Object, QSet<QString>> m_modified;
+    QMap<eMyMoney::File::Object, QSet<QString>> m_removed;
+    QSet<QString> m_balanceChanged;
+    QSet<QString> m_valueChanged;
+};
+
+#endif // MYMONEYCHANGESET_H
@@ -12,6 +12,7 @@
 
 #include "mymoneyfile.h"
 
+#include <algorithm>
 #include <utility>
 
 // ----------------------------------------------------------------------------
@@ -25,6 +26,10 @@
 #include <QAction>
 #include <QTimer>
 #include <QDebug>
+#include <QHash>
+#include <QSet>
+#include <QUndoStack>
+#include <QMetaMethod>
 
 // ----------------------------------------------------------------------------
 // KDE Includes
@@ -50,6 +55,7 @@
 #include "mymoneycostcenter.h"
 #include "mymoneyexception.h"
 #include "mymoneyforecast.h"
+#include "mymoneychangeset.h"
 #include "onlinejob.h"
 #include "storageenums.h"
 #include "mymoneyenums.h"
@@ -134,6 +140,7 @@ public:
         : m_file(qq)
         , m_dirty(false)
         , m_inTransaction(false)
+        , m_changeTrackingComplete(false)
         , payeesModel(qq, &undoStack)
         , userModel(qq, &undoStack)
         , costCenterModel(qq, &undoStack)
@@ -229,6 +236,50 @@ public:
         /// @note add new models here
     }
 
+    /**
+      * Forget about all unsaved changes. In case @a complete is @c true
+      * the engine's data is considered to be identical to the storage.
+      */
+    void resetUnsavedChanges(bool complete)
+    {
+        m_unsavedChanges.clear();
+        m_unsavedPriceChanges.clear();
+        m_changeTrackingComplete = complete;
+    }
+
+    /**
+      * Merge the @a change into the list of unsaved changes so that
+      * it reflects the difference to the data found in the storage.
+      */
+    void recordUnsavedChange(const MyMoneyNotification& change)
+    {
+        auto& changes = m_unsavedChanges[change.objectType()];
+        const auto it = changes.find(change.id());
+        if (it == changes.end()) {
+            changes.insert(change.id(), change.notificationMode());
+            return;
+        }
+
+        switch (change.notificationMode()) {
+        case File::Mode::Add:
+        case File::Mode::Modify:
+            // an object removed before still exists in the storage
+            if (*it == File::Mode::Remove) {
+                *it = File::Mode::Modify;
+            }
+            break;
+        case File::Mode::Remove:
+            // an object that never made it into the storage
+            // does not need to be removed from it
+            if (*it == File::Mode::Add) {
+                changes.erase(it);
+            } else {
+                *it = File::Mode::Remove;
+            }
+            break;
+        }
+    }
+
     /**
       * This method is used to add an id to the list of objects
       * to be removed from the cache. If id is empty, then nothing is added to the list.
@@ -338,6 +389,29 @@ public:
       */
     QList<MyMoneyNotification> m_changeSet;
 
+    /**
+      * This member keeps the price pairs modified
+      * within the current transaction.
+      */
+    QSet<MyMoneySecurityPair> m_priceChangeSet;
+
+    /**
+      * This member keeps the changes of the engine objects since
+      * the data has been loaded from or saved to the storage the
+      * last time. It is updated from m_changeSet and m_priceChangeSet
+      * when a transaction is committed.
+      *
+      * @sa MyMoneyFile::unsavedChanges()
+      */
+    QMap<File::Object, QHash<QString, File::Mode>> m_unsavedChanges;
+    QSet<MyMoneySecurityPair> m_unsavedPriceChanges;
+
+    /**
+      * This member is @c true if m_unsavedChanges and m_unsavedPriceChanges
+      * cover all modifications made since the last load or save.
+      */
+    bool m_changeTrackingComplete;
+
     // the engine's undo stack
     QUndoStack          undoStack;
 
@@ -388,6 +462,14 @@ MyMoneyFile::MyMoneyFile() :
 {
     reloadSpecialDates();
     connect(&d->journalModel, &JournalModel::balanceChanged, &d->m_balanceCache, QOverload<const QString&>::of(&MyMoneyBalanceCache::clear));
+    // undo and redo outside of a transaction are not reported in the
+    // change set, so we lose track of the unsaved changes. Clearing the
+    // undo stack does not modify any data and can be ignored.
+    connect(&d->undoStack, &QUndoStack::indexChanged, this, [&]() {
+        if (!d->m_inTransaction && (d->undoStack.count() > 0)) {
+            d->m_changeTrackingComplete = false;
+        }
+    });
 }
 
 MyMoneyFile::~MyMoneyFile()
@@ -458,6 +540,7 @@ void MyMoneyFile::unload()
     d->m_priceCache.clear();
     d->undoStack.clear();
     d->m_dirty = false;
+    d->resetUnsavedChanges(false);
 }
 
 int MyMoneyFile::fileFixVersion() const
@@ -524,9 +607,11 @@ void MyMoneyFile::startTransaction(const QString& undoActionText)
         throw MYMONEYEXCEPTION_CSTRING("Already started a transaction!");
     }
 
-    d->undoStack.beginMacro(undoActionText);
     d->m_inTransaction = true;
+    d->undoStack.beginMacro(undoActionText);
     d->m_changeSet.clear();
+    d->m_priceChangeSet.clear();
+    d->journalModel.deferBalanceNotifications(true);
 }
 
 bool MyMoneyFile::hasTransaction() const
@@ -543,13 +628,17 @@ void MyMoneyFile::commitTransaction()
     auto changed = false;
     d->m_inTransaction = false;
 
+    // now that all modifications are done, the accounts model
+    // receives the new balances of all changed accounts at once
+    d->journalModel.deferBalanceNotifications(false);
+
     // collect notifications about removed objects
-    QStringList removedObjects;
+    QSet<QString> removedObjects;
     const auto& set = d->m_changeSet;
     for (const auto& change : set) {
         switch (change.notificationMode()) {
         case File::Mode::Remove:
-            removedObjects += change.id();
+            removedObjects.insert(change.id());
             break;
         default:
             break;
@@ -559,6 +648,9 @@ void MyMoneyFile::commitTransaction()
     // inform the outside world about the beginning of notifications
     emit beginChangeNotification();
 
+    // the changes grouped by object type for changesCommitted()
+    MyMoneyChangeSet changeSet;
+
     // Now it's time to send out some signals to the outside world
     // First we go through the d->m_changeSet and emit respective
     // signals about addition, modification and removal of engine objects
@@ -588,6 +680,8 @@ void MyMoneyFile::commitTransaction()
             break;
         }
 
+        changeSet.addChange(change.notificationMode(), change.objectType(), change.id());
+
         switch (change.notificationMode()) {
         case File::Mode::Remove:
             emit objectRemoved(change.objectType(), change.id());
@@ -608,34 +702,53 @@ void MyMoneyFile::commitTransaction()
         }
     }
 
+    // keep track of the changes not yet written to the storage
+    for (const auto& change : changes) {
+        d->recordUnsavedChange(change);
+    }
+    d->m_unsavedPriceChanges.unite(d->m_priceChangeSet);
+
     // we're done with the change set, so we clear it
     d->m_changeSet.clear();
+    d->m_priceChangeSet.clear();
 
     // now send out the balanceChanged signal for all those
     // accounts for which we have an indication about a possible
-    // change.
+    // change. Loading the account object is skipped if nobody
+    // is interested in the signal.
+    const auto notifyBalanceChange = isSignalConnected(QMetaMethod::fromSignal(&MyMoneyFile::balanceChanged));
+    const auto notifyValueChange = isSignalConnected(QMetaMethod::fromSignal(&MyMoneyFile::valueChanged));
+    d->m_balanceChangedSet.subtract(removedObjects);
+    d->m_valueChangedSet.subtract(removedObjects);
+
     const auto& balanceChanges = d->m_balanceChangedSet;
     for (const auto& id : balanceChanges) {
-        if (!removedObjects.contains(id)) {
-            // if we notify about balance change we don't need to notify about value change
-            // for the same account since a balance change implies a value change
-            d->m_valueChangedSet.remove(id);
+        // if we notify about balance change we don't need to notify about value change
+        // for the same account since a balance change implies a value change
+        d->m_valueChangedSet.remove(id);
+        if (notifyBalanceChange) {
             emit balanceChanged(account(id));
         }
     }
-    d->m_balanceChangedSet.clear();
 
     // now notify about the remaining value changes
     const auto& m_valueChanges = d->m_valueChangedSet;
     for (const auto& id : m_valueChanges) {
-        if (!removedObjects.contains(id)) {
-            changed = true;
+        changed = true;
+        if (notifyValueChange) {
             emit valueChanged(account(id));
         }
     }
 
+    changeSet.setBalanceChangedAccounts(d->m_balanceChangedSet);
+    changeSet.setValueChangedAccounts(d->m_valueChangedSet);
+    d->m_balanceChangedSet.clear();
     d->m_valueChangedSet.clear();
 
+    if (!changeSet.isEmpty()) {
+        emit changesCommitted(changeSet);
+    }
+
     // as a last action, send out the global dataChanged signal
     if (changed)
         emit dataChanged();
@@ -655,11 +768,13 @@ void MyMoneyFile::rollbackTransaction()
     // and undo it immediately
     d->undoStack.undo();
     qDebug() << "Rolled back transaction with now" << d->undoStack.count() << "commands on stack at index" << d->undoStack.index();
+    d->journalModel.deferBalanceNotifications(false);
 
     d->m_inTransaction = false;
     d->m_balanceChangedSet.clear();
     d->m_valueChangedSet.clear();
     d->m_changeSet.clear();
+    d->m_priceChangeSet.clear();
 }
 
 void MyMoneyFile::addInstitution(MyMoneyInstitution& institution)
@@ -1384,17 +1499,14 @@ QString MyMoneyFile::openingBalanceTransaction(const MyMoneyAccount& acc) const
     // acc.id(), the other openAcc.id()
     int matchCount = 0;
     QString lastTxId;
-    QString txId;
-    QString splitAccoountId;
-    QModelIndex idx;
     for (int row = start; row < end; ++row) {
-        idx = d->journalModel.index(row, 0);
-        txId = idx.data(eMyMoney::Model::JournalTransactionIdRole).toString();
+        const auto& journalEntry = d->journalModel.constItemAt(row);
+        const auto& txId = journalEntry.transaction().id();
         if (lastTxId != txId) {
             matchCount = 0;
             lastTxId = txId;
         }
-        splitAccoountId = idx.data(eMyMoney::Model::SplitAccountIdRole).toString();
+        const auto& splitAccoountId = journalEntry.split().accountId();
         if (splitAccoountId == acc.id())
             ++matchCount;
         else if(splitAccoountId == openAcc.id())
@@ -1868,6 +1980,7 @@ void MyMoneyFile::setDirty(bool dirty) const
 {
     if (!dirty) {
         d->markModelsAsClean();
+        d->resetUnsavedChanges(true);
     }
     d->m_dirty = dirty;
 }
@@ -1961,33 +2074,13 @@ MyMoneyMoney MyMoneyFile::balance(const QString& id) const
 
 MyMoneyMoney MyMoneyFile::clearedBalance(const QString &id, const QDate& date) const
 {
-    MyMoneyMoney cleared;
-    QList<MyMoneyTransaction> list;
-
-    cleared = balance(id, date);
-
     MyMoneyAccount account = this->account(id);
     MyMoneyMoney factor(1, 1);
     if (account.accountGroup() == Account::Type::Liability || account.accountGroup() == Account::Type::Equity)
         factor = -factor;
 
-    MyMoneyTransactionFilter filter;
-    filter.addAccount(id);
-    filter.setDateFilter(QDate(), date);
-    filter.setReportAllSplits(false);
-    filter.addState((int)TransactionFilter::State::NotReconciled);
-    transactionList(list, filter);
-
-    for (QList<MyMoneyTransaction>::const_iterator it_t = list.constBegin(); it_t != list.constEnd(); ++it_t) {
-        const QList<MyMoneySplit>& splits = (*it_t).splits();
-        for (QList<MyMoneySplit>::const_iterator it_s = splits.constBegin(); it_s != splits.constEnd(); ++it_s) {
-            const MyMoneySplit &split = (*it_s);
-            if (split.accountId() != id)
-                continue;
-            cleared -= split.shares();
-        }
-    }
-    return cleared * factor;
+    // the journal keeps a running cleared balance per account
+    return d->journalModel.clearedBalance(id, date) * factor;
 }
 
 MyMoneyMoney MyMoneyFile::totalBalance(const QString& id, const QDate& date) const
@@ -2024,12 +2117,11 @@ QStringList MyMoneyFile::journalEntryIds(MyMoneyTransactionFilter filter) const
     QStringList list;
     const auto rows = d->journalModel.rowCount();
     for (int row = 0; row < rows;) {
-        auto idx = d->journalModel.index(row, 0);
-        const auto cnt = idx.data(eMyMoney::Model::TransactionSplitCountRole).toInt();
-        if (d->journalModel.matchTransaction(idx, filter)) {
+        const auto& journalEntry = d->journalModel.constItemAt(row);
+        const auto cnt = static_cast<int>(journalEntry.transaction().splitCount());
+        if (filter.match(journalEntry.transaction())) {
             for (int i = 0; i < cnt; ++i) {
-                idx = d->journalModel.index(row + i, 0);
-                list.append(idx.data(eMyMoney::Model::IdRole).toString());
+                list.append(d->journalModel.constItemAt(row + i).id());
             }
         }
         // we can skip to the first journalEntry of the next transaction directly
@@ -3438,16 +3530,41 @@ void MyMoneyFile::addPrice(const MyMoneyPrice& price)
 
     // store the account's which are affected by this price regarding their value
     d->priceChanged(price);
+    d->m_priceChangeSet.insert(qMakePair(price.from(), price.to()));
 
     d->priceModel.addPrice(price);
 }
 
+void MyMoneyFile::addPrices(const QList<MyMoneyPrice>& prices)
+{
+    d->checkTransaction(Q_FUNC_INFO);
+
+    QList<MyMoneyPrice> validPrices;
+    validPrices.reserve(prices.count());
+    for (const auto& price : prices) {
+        if (price.rate(QString()).isZero())
+            continue;
+        validPrices.append(price);
+
+        // store the account's which are affected by the prices
+        // regarding their value, once for each pair
+        const auto pair = qMakePair(price.from(), price.to());
+        if (!d->m_priceChangeSet.contains(pair)) {
+            d->priceChanged(price);
+            d->m_priceChangeSet.insert(pair);
+        }
+    }
+
+    d->priceModel.addPrices(validPrices);
+}
+
 void MyMoneyFile::removePrice(const MyMoneyPrice& price)
 {
     d->checkTransaction(Q_FUNC_INFO);
 
     // store the account's which are affected by this price regarding their value
     d->priceChanged(price);
+    d->m_priceChangeSet.insert(qMakePair(price.from(), price.to()));
 
     d->priceModel.removePrice(price);
 }
@@ -3468,37 +3585,35 @@ MyMoneyPrice MyMoneyFile::price(const QString& fromId, const QString& toId, cons
         return MyMoneyPrice(fromId, toId, date, MyMoneyMoney::ONE, "KMyMoney");
     }
 
-    // if not asking for exact date, try to find the exact date match first,
-    // either the requested price or its reciprocal value. If unsuccessful, it will move
-    // on and look for prices of previous dates
-    MyMoneyPrice rc = d->priceModel.price(fromId, to, date, true);
-    if (!rc.isValid()) {
-        // not found, search 'to-from' rate and use reciprocal value
-        rc = d->priceModel.price(to, fromId, date, true);
-
-        // not found, search previous dates, if exact date is not needed
-        if (!exactDate && !rc.isValid()) {
-            // search 'from-to' and 'to-from', select the most recent one
-            MyMoneyPrice fromPrice = d->priceModel.price(fromId, to, date, exactDate);
-            MyMoneyPrice toPrice = d->priceModel.price(to, fromId, date, exactDate);
-
-            // check first whether both prices are valid
-            if (fromPrice.isValid() && toPrice.isValid()) {
-                if (fromPrice.date() >= toPrice.date()) {
-                    // if 'from-to' is newer or the same date, prefer that one
-                    rc = fromPrice;
-                } else {
-                    // otherwise, use the reciprocal price
-                    rc = toPrice;
-                }
-            } else if (fromPrice.isValid()) { // check if any of the prices is valid, return that one
-                rc = fromPrice;
-            } else if (toPrice.isValid()) {
-                rc = toPrice;
-            }
+    // the price model looks at the 'from-to' and the 'to-from' rates
+    // at the same time. An exact date match is preferred over
+    // prices of previous dates and 'from-to' over 'to-from'
+    // if both exist for the same date.
+    return d->priceModel.priceSeries(fromId, to, { date }, exactDate).first();
+}
+
+QVector<MyMoneyPrice> MyMoneyFile::priceSeries(const QString& fromId, const QString& toId, const QVector<QDate>& dates, const bool exactDate) const
+{
+    QString to(toId);
+    if (to.isEmpty()) {
+        to = value("kmm-baseCurrency");
+    }
+    // if any id is missing at that point,
+    // we can safely return empty price objects
+    if (fromId.isEmpty() || to.isEmpty())
+        return QVector<MyMoneyPrice>(dates.count());
+
+    // we don't interrogate our tables if someone asks stupid stuff
+    if (fromId == toId) {
+        QVector<MyMoneyPrice> prices;
+        prices.reserve(dates.count());
+        for (const auto& date : dates) {
+            prices.append(MyMoneyPrice(fromId, toId, date, MyMoneyMoney::ONE, "KMyMoney"));
         }
+        return prices;
     }
-    return rc;
+
+    return d->priceModel.priceSeries(fromId, to, dates, exactDate);
 }
 
 MyMoneyPrice MyMoneyFile::price(const QString& fromId, const QString& toId) const
@@ -3789,11 +3904,8 @@ bool MyMoneyFile::isReferenced(const MyMoneyObject& obj, const QBitArray& skipCh
 
     const auto& id = obj.id();
 
-    // FIXME optimize the list of objects we have to checks
-    //       with a bit of knowledge of the internal structure, we
-    //       could optimize the number of objects we check for references
-
-    // Scan all engine objects for a reference
+    // Each model keeps an index of the ids referenced by its objects,
+    // so checking a model does not require to scan all of its objects
     if (!skipCheck.testBit((int)eStorage::Reference::Transaction))
         if (d->journalModel.hasReferenceTo(id))
             return true;
@@ -3868,47 +3980,15 @@ QSet<QString> MyMoneyFile::referencedObjects() const
 bool MyMoneyFile::checkNoUsed(const QString& accId, const QString& no) const
 {
     // by definition, an empty string or a non-numeric string is not used
-    QRegExp exp(QString("(.*\\D)?(\\d+)(\\D.*)?"));
-    if (no.isEmpty() || exp.indexIn(no) == -1)
+    if (std::none_of(no.constBegin(), no.constEnd(), [](const QChar& c) { return c.isDigit(); }))
         return false;
 
-    const auto model = &d->journalModel;
-    const auto rows = model->rowCount();
-    for (int row = 0; row < rows; ++row) {
-        const auto idx = model->index(row, 0);
-        if (idx.data(eMyMoney::Model::JournalSplitAccountIdRole).toString() == accId) {
-            const auto number = idx.data(eMyMoney::Model::JournalSplitNumberRole).toString();
-            if (!number.isEmpty() && number == no) {
-                return true;
-            }
-        }
-    }
-    return false;
+    return d->journalModel.isNumberUsed(accId, no);
 }
 
 QString MyMoneyFile::highestCheckNo(const QString& accId) const
 {
-    unsigned64 lno = 0;
-    unsigned64 cno;
-    QString no;
-
-    const auto model = &d->journalModel;
-    const auto rows = model->rowCount();
-    for (int row = 0; row < rows; ++row) {
-        const auto idx = model->index(row, 0);
-        if (idx.data(eMyMoney::Model::JournalSplitAccountIdRole).toString() == accId) {
-            const auto number = idx.data(eMyMoney::Model::JournalSplitNumberRole).toString();
-            if (!number.isEmpty()) {
-                // non-numerical values stored in number will return 0 in the next line
-                cno = number.toULongLong();
-                if (cno > lno) {
-                    lno = cno;
-                    no = number;
-                }
-            }
-        }
-    }
-    return no;
+    return d->journalModel.highestNumber(accId);
 }
 
 bool MyMoneyFile::hasNewerTransaction(const QString& accId, const QDate& date) const
@@ -3919,9 +3999,9 @@ bool MyMoneyFile::hasNewerTransaction(const QString& accId, const QDate& date) c
     // the end towards the front. Upon the first transaction we find for
     // the account we can provide an answer
     for (int row = rows - 1; row >= 0; --row) {
-        const auto idx = model->index(row, 0);
-        if (idx.data(eMyMoney::Model::JournalSplitAccountIdRole).toString() == accId) {
-            return idx.data(eMyMoney::Model::TransactionPostDateRole).toDate() > date;
+        const auto& journalEntry = model->constItemAt(row);
+        if (journalEntry.split().accountId() == accId) {
+            return journalEntry.transaction().postDate() > date;
         }
     }
     return false;
@@ -4016,17 +4096,16 @@ bool MyMoneyFile::hasMatchingOnlineBalance(const MyMoneyAccount& _acc) const
 
 int MyMoneyFile::countTransactionsWithSpecificReconciliationState(const QString& accId, TransactionFilter::State state) const
 {
-    /// @todo port to new model code
     int rc = 0;
     const auto model = &d->journalModel;
     const auto rows = model->rowCount();
     for (int row = 0; row < rows; ++row) {
-        const auto idx = model->index(row, 0);
-        if (idx.data(eMyMoney::Model::JournalSplitAccountIdRole).toString() == accId) {
+        const auto& split = model->constItemAt(row).split();
+        if (split.accountId() == accId) {
             if (state == TransactionFilter::State::All) {
                 rc++;
             } else {
-                const auto reconciliationState = idx.data(eMyMoney::Model::SplitReconcileFlagRole).value<eMyMoney::Split::State>();
+                const auto reconciliationState = split.reconcileFlag();
                 switch (reconciliationState) {
                 case eMyMoney::Split::State::NotReconciled:
                     rc += (state == TransactionFilter::State::NotReconciled) ? 1 : 0;
@@ -4061,11 +4140,10 @@ QMap<QString, QVector<int> > MyMoneyFile::countTransactionsWithSpecificReconcili
     }
 
     const auto rows = d->journalModel.rowCount();
-    QModelIndex idx;
     for (int row = 0; row < rows; ++row) {
-        idx = d->journalModel.index(row, 0);
-        const auto accountId = idx.data(eMyMoney::Model::SplitAccountIdRole).toString();
-        const auto flag = idx.data(eMyMoney::Model::SplitReconcileFlagRole).value<eMyMoney::Split::State>();
+        const auto& split = d->journalModel.constItemAt(row).split();
+        const auto& accountId = split.accountId();
+        const auto flag = split.reconcileFlag();
         switch (flag) {
         case eMyMoney::Split::State::NotReconciled:
         case eMyMoney::Split::State::Cleared:
@@ -4117,6 +4195,22 @@ void MyMoneyFile::reloadSpecialDates()
 void MyMoneyFile::fileSaved()
 {
     d->markModelsAsClean();
+    d->resetUnsavedChanges(true);
+}
+
+QMap<eMyMoney::File::Object, QHash<QString, eMyMoney::File::Mode>> MyMoneyFile::unsavedChanges() const
+{
+    return d->m_unsavedChanges;
+}
+
+QSet<MyMoneySecurityPair> MyMoneyFile::unsavedPriceChanges() const
+{
+    return d->m_unsavedPriceChanges;
+}
+
+bool MyMoneyFile::hasCompleteChangeTracking() const
+{
+    return d->m_changeTrackingComplete;
 }
 
 QUndoStack* MyMoneyFile::undoStack() const
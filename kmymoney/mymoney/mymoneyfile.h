@@ -112,6 +112,8 @@
   * describes the problem.
   */
 template <class Key, class T> class QMap;
+template <class Key, class T> class QHash;
+template <class T> class QSet;
 class QString;
 class QStringList;
 class QBitArray;
@@ -136,6 +138,7 @@ class MyMoneyObject;
 class MyMoneyTransaction;
 class MyMoneyTransactionFilter;
 class onlineJob;
+class MyMoneyChangeSet;
 
 // the models
 class PayeesModel;
@@ -166,6 +169,7 @@ enum class Type;
 }
 namespace File {
 enum class Object;
+enum class Mode;
 }
 namespace Schedule {
 enum class Type;
@@ -1412,6 +1416,14 @@ public:
       */
     void addPrice(const MyMoneyPrice& price);
 
+    /**
+      * This method adds/replaces all @p prices to/from the price list.
+      * Use it instead of addPrice() when storing many prices at once
+      * as they are merged into the price list in a single pass.
+      * Prices with a zero rate are ignored.
+      */
+    void addPrices(const QList<MyMoneyPrice>& prices);
+
     /**
       * This method removes a price from the price list
       */
@@ -1436,6 +1448,21 @@ public:
     MyMoneyPrice price(const QString& fromId, const QString& toId) const;
     MyMoneyPrice price(const QString& fromId) const;
 
+    /**
+      * This method is used to retrieve the prices for a specific security
+      * on a list of dates. It follows the same rules as price() but
+      * resolves all @p dates in a single pass over the prices of the pair.
+      *
+      * @param fromId the id of the currency in question
+      * @param toId the id of the currency to convert to (if empty, baseCurrency)
+      * @param dates the dates for which the prices should be returned
+      * @param exactDate if true, entry for date must exist, if false any price information
+      *                  with a date less or equal to the date will be returned
+      *
+      * @return vector of MyMoneyPrice objects, one for each entry in @p dates
+      */
+    QVector<MyMoneyPrice> priceSeries(const QString& fromId, const QString& toId, const QVector<QDate>& dates, const bool exactDate = false) const;
+
     /**
       * This method returns a list of all prices.
       *
@@ -1758,6 +1785,41 @@ public:
      */
     void fileSaved();
 
+    /**
+     * This method returns the objects which have been added, modified
+     * or removed since the data was loaded from or saved to the storage
+     * the last time. The information is collected from the changes
+     * reported by commitTransaction(). The inner hash maps the id of
+     * each object to the effective change with respect to the storage,
+     * i.e. an object that was added and modified afterwards is reported
+     * as added and an object that was added and removed again is not
+     * reported at all.
+     *
+     * @note The information is only complete if hasCompleteChangeTracking()
+     *       returns @c true.
+     *
+     * @sa unsavedPriceChanges(), fileSaved()
+     */
+    QMap<eMyMoney::File::Object, QHash<QString, eMyMoney::File::Mode>> unsavedChanges() const;
+
+    /**
+     * This method returns the price pairs for which at least one price
+     * has been added, modified or removed since the data was loaded from
+     * or saved to the storage the last time.
+     *
+     * @sa unsavedChanges()
+     */
+    QSet<MyMoneySecurityPair> unsavedPriceChanges() const;
+
+    /**
+     * Returns @c true if unsavedChanges() and unsavedPriceChanges()
+     * cover all modifications made since the data was loaded from or
+     * saved to the storage the last time. This is not the case if no
+     * data has been loaded yet or if the undo stack has been used to
+     * change the data outside of a transaction.
+     */
+    bool hasCompleteChangeTracking() const;
+
     /**
      * This returns the string for specific parameters
      */
@@ -1837,6 +1899,14 @@ Q_SIGNALS:
       */
     void valueChanged(const MyMoneyAccount& acc);
 
+    /**
+     * This signal is emitted once per committed transaction after the
+     * signals for the single objects have been sent out. @a changes
+     * contains all changes of the transaction grouped by object type
+     * so that receivers can update themselves in one go.
+     */
+    void changesCommitted(const MyMoneyChangeSet& changes);
+
     /**
      * This signal is emitted once all data of a new backend is loaded.
      */
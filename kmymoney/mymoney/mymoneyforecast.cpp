@@ -13,6 +13,9 @@
 #include <QList>
 #include <QDebug>
 #include <QDate>
+#include <QHash>
+#include <QThread>
+#include <QVector>
 
 // ----------------------------------------------------------------------------
 // KDE Includes
@@ -34,18 +37,125 @@
 #include "mymoneyfinancialcalculator.h"
 #include "mymoneyexception.h"
 #include "mymoneyenums.h"
+#include "mymoneyutils.h"
 
 enum class eForecastMethod {Scheduled = 0, Historic = 1, };
 
+namespace {
+/**
+ * Forecasting a single account is cheap, so a handful
+ * of accounts is computed in the calling thread.
+ */
+const int parallelComputationThreshold = 16;
+
+/**
+ * Calls @a function for each entry of @a items, on the thread pool
+ * if there are enough of them. See MyMoneyUtils::forEachParallel().
+ */
+template<typename T, typename Func>
+void forEachAccount(QVector<T>& items, Func function)
+{
+    if (QThread::idealThreadCount() < 2 || items.count() < parallelComputationThreshold) {
+        for (auto& item : items) {
+            function(item);
+        }
+        return;
+    }
+    MyMoneyUtils::forEachParallel(items, function);
+}
+} // namespace
+
 /**
  * daily balances of an account
+ *
+ * The balances are kept in a contiguous array indexed by the offset
+ * of the day to the first day of the array. Only days that have been
+ * accessed using operator[] are reported by contains().
  */
-typedef QMap<QDate, MyMoneyMoney> dailyBalances;
+class DailyBalances
+{
+public:
+    DailyBalances()
+        : m_firstDay(0)
+    {
+    }
+
+    /**
+     * Makes room for the days from @a first to @a last so
+     * that they can be filled without reallocating the array
+     */
+    void reserve(const QDate& first, const QDate& last)
+    {
+        if (first.isValid() && last.isValid() && first <= last) {
+            grow(first.toJulianDay(), last.toJulianDay());
+        }
+    }
+
+    bool contains(const QDate& date) const
+    {
+        const auto idx = index(date);
+        return (idx != -1) && m_days.at(idx).used;
+    }
+
+    MyMoneyMoney value(const QDate& date) const
+    {
+        const auto idx = index(date);
+        return (idx != -1) ? m_days.at(idx).balance : MyMoneyMoney();
+    }
+
+    MyMoneyMoney& operator[](const QDate& date)
+    {
+        // invalid dates are not stored as they do not have an offset
+        if (!date.isValid()) {
+            m_invalid = MyMoneyMoney();
+            return m_invalid;
+        }
+        const auto day = date.toJulianDay();
+        grow(day, day);
+        auto& entry = m_days[static_cast<int>(day - m_firstDay)];
+        entry.used = true;
+        return entry.balance;
+    }
+
+private:
+    struct Day {
+        MyMoneyMoney balance;
+        bool used = false;
+    };
+
+    int index(const QDate& date) const
+    {
+        if (!date.isValid() || m_days.isEmpty())
+            return -1;
+        const auto offset = date.toJulianDay() - m_firstDay;
+        return (offset >= 0 && offset < m_days.count()) ? static_cast<int>(offset) : -1;
+    }
+
+    void grow(qint64 first, qint64 last)
+    {
+        if (m_days.isEmpty()) {
+            m_firstDay = first;
+            m_days.resize(static_cast<int>(last - first + 1));
+            return;
+        }
+        if (first < m_firstDay) {
+            m_days.insert(0, static_cast<int>(m_firstDay - first), Day());
+            m_firstDay = first;
+        }
+        if (last >= m_firstDay + m_days.count()) {
+            m_days.resize(static_cast<int>(last - m_firstDay + 1));
+        }
+    }
+
+    qint64 m_firstDay;
+    QVector<Day> m_days;
+    MyMoneyMoney m_invalid;
+};
 
 /**
- * map of trends of an account
+ * trends of an account indexed by the day of the accounts cycle
  */
-typedef QMap<int, MyMoneyMoney> trendBalances;
+typedef QVector<MyMoneyMoney> trendBalances;
 
 class MyMoneyForecastPrivate
 {
@@ -98,6 +208,97 @@ public:
         return accList;
     }
 
+    /**
+     * The data of an account used to compute its forecast on the thread pool.
+     * The balances and trends point into the lists of the forecast.
+     */
+    struct AccountSeries {
+        MyMoneyAccount account;
+        DailyBalances* balances = nullptr;
+        DailyBalances* pastBalances = nullptr;
+        trendBalances* trend = nullptr;
+        MyMoneyMoney startBalance;
+        QVector<MyMoneyMoney> rates;
+        qint64 forecastTerms = 0;
+        qint64 totalWeight = 0;
+    };
+
+    /**
+     * Returns the daily forecast balances of account @a id. The balances
+     * are created with room for the whole forecast period if they do not exist.
+     */
+    DailyBalances& forecastSeries(const QString& id)
+    {
+        Q_Q(MyMoneyForecast);
+        auto it = m_accountList.find(id);
+        if (it == m_accountList.end()) {
+            it = m_accountList.insert(id, DailyBalances());
+            // the historic methods compute full account cycles which may end after the forecast end date
+            it->reserve(qMin(QDate::currentDate(), q->forecastStartDate()), q->forecastEndDate().addDays(q->accountsCycle()));
+        }
+        return *it;
+    }
+
+    /**
+     * Returns the daily past balances of account @a id. The balances
+     * are created with room for the whole history period if they do not exist.
+     */
+    DailyBalances& pastSeries(const QString& id)
+    {
+        Q_Q(MyMoneyForecast);
+        auto it = m_accountListPast.find(id);
+        if (it == m_accountListPast.end()) {
+            it = m_accountListPast.insert(id, DailyBalances());
+            it->reserve(q->historyStartDate().addDays(-1), q->historyEndDate());
+        }
+        return *it;
+    }
+
+    /**
+     * Returns the opening date of account @a acc. For stock accounts
+     * the opening date of the parent account is returned.
+     */
+    QDate accountOpeningDate(const MyMoneyAccount& acc) const
+    {
+        //FIXME workaround for stock accounts which have faulty opening dates
+        if (acc.accountType() == eMyMoney::Account::Type::Stock) {
+            return MyMoneyFile::instance()->account(acc.parentAccountId()).openingDate();
+        }
+        return acc.openingDate();
+    }
+
+    /**
+     * Returns the price of the security of the investment account @a acc
+     * in its trading currency for each day from @a first to @a last.
+     * The list is empty if @a acc is not an investment in a security.
+     */
+    QVector<MyMoneyMoney> investmentRates(const MyMoneyAccount& acc, const QDate& first, const QDate& last) const
+    {
+        QVector<MyMoneyMoney> rates;
+        if (acc.isInvest()) {
+            auto file = MyMoneyFile::instance();
+            //get the id of the security for that account
+            MyMoneySecurity undersecurity = file->security(acc.currencyId());
+
+            //only do it if the security is not an actual currency
+            if (! undersecurity.isCurrency()) {
+                //set the default value
+                MyMoneyMoney rate = MyMoneyMoney::ONE;
+
+                rates.reserve(first.daysTo(last) + 1);
+                for (QDate it_day = first; it_day <= last; it_day = it_day.addDays(1)) {
+                    //get the price for the tradingCurrency that day
+                    const MyMoneyPrice &price = file->price(undersecurity.id(), undersecurity.tradingCurrency(), it_day);
+                    if (price.isValid()) {
+                        rate = price.rate(undersecurity.tradingCurrency());
+                    }
+                    rates.append(rate);
+                }
+            }
+        }
+        return rates;
+    }
+
     /**
      * calculate daily forecast balance based on historic transactions
      */
@@ -108,49 +309,63 @@ public:
 
         calculateAccountTrendList();
 
-        //Calculate account daily balances
-        QSet<QString>::ConstIterator it_n;
-        for (it_n = m_forecastAccounts.constBegin(); it_n != m_forecastAccounts.constEnd(); ++it_n) {
-            auto acc = file->account(*it_n);
-
-            //set the starting balance of the account
-            setStartingBalance(acc);
+        //set the starting balance of the accounts and collect
+        //their data as the engine must not be used on the thread pool
+        QVector<AccountSeries> series;
+        series.reserve(m_forecastAccounts.count());
+        for (const auto& id : qAsConst(m_forecastAccounts)) {
+            AccountSeries entry;
+            entry.account = file->account(id);
+            setStartingBalance(entry.account);
+            entry.balances = &forecastSeries(id);
+            entry.pastBalances = &pastSeries(id);
+            entry.trend = &m_accountTrendList[id];
+            series.append(entry);
+        }
 
-            switch (q->historyMethod()) {
+        //Calculate account daily balances
+        const auto today = QDate::currentDate();
+        const auto historyMethod = q->historyMethod();
+        const auto accountsCycle = q->accountsCycle();
+        const auto forecastStartDate = q->forecastStartDate();
+        const auto forecastEndDate = q->forecastEndDate();
+        forEachAccount(series, [&](AccountSeries& entry) {
+            auto& balances = *entry.balances;
+            const auto& trend = *entry.trend;
+            const auto fraction = entry.account.fraction();
+
+            switch (historyMethod) {
             case 0:
             case 1: {
-                for (QDate f_day = q->forecastStartDate(); f_day <= q->forecastEndDate();) {
-                    for (auto t_day = 1; t_day <= q->accountsCycle(); ++t_day) {
-                        MyMoneyMoney balanceDayBefore = m_accountList[acc.id()][(f_day.addDays(-1))];//balance of the day before
-                        MyMoneyMoney accountDailyTrend = m_accountTrendList[acc.id()][t_day]; //trend for that day
-                        //balance of the day is the balance of the day before multiplied by the trend for the day
-                        m_accountList[acc.id()][f_day] = balanceDayBefore;
-                        m_accountList[acc.id()][f_day] += accountDailyTrend; //movement trend for that particular day
-                        m_accountList[acc.id()][f_day] = m_accountList[acc.id()][f_day].convert(acc.fraction());
-                        //m_accountList[acc.id()][f_day] += m_accountListPast[acc.id()][f_day.addDays(-q->historyDays())];
+                for (QDate f_day = forecastStartDate; f_day <= forecastEndDate;) {
+                    for (auto t_day = 1; t_day <= accountsCycle; ++t_day) {
+                        MyMoneyMoney balanceDayBefore = balances[f_day.addDays(-1)];//balance of the day before
+                        MyMoneyMoney accountDailyTrend = trend.at(t_day); //trend for that day
+                        //balance of the day is the balance of the day before plus the movement trend for that particular day
+                        balances[f_day] = (balanceDayBefore + accountDailyTrend).convert(fraction);
                         f_day = f_day.addDays(1);
                     }
                 }
             }
             break;
             case 2: {
-                QDate baseDate = QDate::currentDate().addDays(-q->accountsCycle());
-                for (auto t_day = 1; t_day <= q->accountsCycle(); ++t_day) {
+                const auto& pastBalances = *entry.pastBalances;
+                QDate baseDate = today.addDays(-accountsCycle);
+                for (auto t_day = 1; t_day <= accountsCycle; ++t_day) {
                     auto f_day = 1;
-                    QDate fDate = baseDate.addDays(q->accountsCycle() + 1);
-                    while (fDate <= q->forecastEndDate()) {
+                    QDate fDate = baseDate.addDays(accountsCycle + 1);
+                    while (fDate <= forecastEndDate) {
 
                         //the calculation is based on the balance for the last month, that is then multiplied by the trend
-                        m_accountList[acc.id()][fDate] = m_accountListPast[acc.id()][baseDate] + (m_accountTrendList[acc.id()][t_day] * MyMoneyMoney(f_day, 1));
-                        m_accountList[acc.id()][fDate] = m_accountList[acc.id()][fDate].convert(acc.fraction());
+                        balances[fDate] = (pastBalances.value(baseDate) + (trend.at(t_day) * MyMoneyMoney(f_day, 1))).convert(fraction);
                         ++f_day;
-                        fDate = baseDate.addDays(q->accountsCycle() * f_day);
+                        fDate = baseDate.addDays(accountsCycle * f_day);
                     }
                     baseDate = baseDate.addDays(1);
                 }
             }
             }
-        }
+        });
     }
 
     /**
@@ -165,14 +380,16 @@ public:
         QSet<QString>::ConstIterator it_n;
         for (it_n = m_forecastAccounts.constBegin(); it_n != m_forecastAccounts.constEnd(); ++it_n) {
             auto acc = file->account(*it_n);
+            auto& balances = forecastSeries(acc.id());
+            const auto trend = m_accountTrendList.value(acc.id());
 
             for (QDate f_date = q->forecastStartDate(); f_date <= q->forecastEndDate();) {
                 for (auto f_day = 1; f_day <= q->accountsCycle() && f_date <= q->forecastEndDate(); ++f_day) {
-                    MyMoneyMoney accountDailyTrend = m_accountTrendList[acc.id()][f_day]; //trend for that day
+                    MyMoneyMoney accountDailyTrend = trend.value(f_day); //trend for that day
                     //check for leap year
                     if (f_date.month() == 2 && f_date.day() == 29)
                         f_date = f_date.addDays(1); //skip 1 day
-                    m_accountList[acc.id()][QDate(f_date.year(), f_date.month(), 1)] += accountDailyTrend; //movement trend for that particular day
+                    balances[QDate(f_date.year(), f_date.month(), 1)] += accountDailyTrend; //movement trend for that particular day
                     f_date = f_date.addDays(1);
                 }
             }
@@ -191,15 +408,16 @@ public:
         QSet<QString>::ConstIterator it_n;
         for (it_n = m_forecastAccounts.constBegin(); it_n != m_forecastAccounts.constEnd(); ++it_n) {
             auto acc = file->account(*it_n);
+            auto& balances = forecastSeries(acc.id());
 
             for (QDate f_date = q->forecastStartDate(); f_date <= q->forecastEndDate(); f_date = f_date.addDays(1)) {
                 //get the trend for the day
-                MyMoneyMoney accountDailyBalance = m_accountList[acc.id()][f_date];
+                MyMoneyMoney accountDailyBalance = balances[f_date];
 
                 //do not add if it is the beginning of the month
                 //otherwise we end up with duplicated values as reported by Marko Käning
                 if (f_date != QDate(f_date.year(), f_date.month(), 1))
-                    m_accountList[acc.id()][QDate(f_date.year(), f_date.month(), 1)] += accountDailyBalance;
+                    balances[QDate(f_date.year(), f_date.month(), 1)] += accountDailyBalance;
             }
         }
     }
@@ -227,25 +445,14 @@ public:
         for (it_n = m_forecastAccounts.constBegin(); it_n != m_forecastAccounts.constEnd(); ++it_n) {
             auto acc = file->account(*it_n);
 
-            if (acc.isInvest()) {
-                //get the id of the security for that account
-                MyMoneySecurity undersecurity = file->security(acc.currencyId());
-
-                //only do it if the security is not an actual currency
-                if (! undersecurity.isCurrency()) {
-                    //set the default value
-                    MyMoneyMoney rate = MyMoneyMoney::ONE;
-
-                    for (QDate it_day = QDate::currentDate(); it_day <= q->forecastEndDate();) {
-                        //get the price for the tradingCurrency that day
-                        const MyMoneyPrice &price = file->price(undersecurity.id(), undersecurity.tradingCurrency(), it_day);
-                        if (price.isValid()) {
-                            rate = price.rate(undersecurity.tradingCurrency());
-                        }
-                        //value is the amount of shares multiplied by the rate of the deep currency
-                        m_accountList[acc.id()][it_day] = m_accountList[acc.id()][it_day] * rate;
-                        it_day = it_day.addDays(1);
-                    }
+            const auto rates = investmentRates(acc, QDate::currentDate(), q->forecastEndDate());
+            if (!rates.isEmpty()) {
+                auto& balances = forecastSeries(acc.id());
+                auto it_day = QDate::currentDate();
+                for (const auto& rate : rates) {
+                    //value is the amount of shares multiplied by the rate of the deep currency
+                    balances[it_day] = balances[it_day] * rate;
+                    it_day = it_day.addDays(1);
                 }
             }
         }
@@ -272,15 +479,13 @@ public:
                 if (!split.shares().isZero()) {
                     auto acc = file->account(split.accountId());
                     if (q->isForecastAccount(acc)) {
-                        dailyBalances balance;
-                        balance = m_accountList[acc.id()];
+                        auto& balance = forecastSeries(acc.id());
                         //if it is income, the balance is stored as negative number
                         if (acc.accountType() == eMyMoney::Account::Type::Income) {
                             balance[transaction.postDate()] += (split.shares() * MyMoneyMoney::MINUS_ONE);
                         } else {
                             balance[transaction.postDate()] += split.shares();
                         }
-                        m_accountList[acc.id()] = balance;
                     }
                 }
             }
@@ -293,7 +498,7 @@ public:
 
         {
             s << "Already present transactions\n";
-            QMap<QString, dailyBalances>::Iterator it_a;
+            QMap<QString, DailyBalances>::Iterator it_a;
             QSet<QString>::ConstIterator it_n;
             for (it_n = m_nameIdx.begin(); it_n != m_nameIdx.end(); ++it_n) {
                 auto acc = file->account(*it_n);
@@ -372,10 +577,9 @@ public:
                                         if (QDate::currentDate() >= nextDate)
                                             forecastDate = QDate::currentDate().addDays(1);
 
-                                        dailyBalances balance;
-                                        balance = m_accountList[accountFromSplit.id()];
+                                        auto& balance = forecastSeries(accountFromSplit.id());
                                         for (QDate f_day = QDate::currentDate(); f_day < forecastDate;) {
-                                            balanceMap[accountFromSplit.id()] += m_accountList[accountFromSplit.id()][f_day];
+                                            balanceMap[accountFromSplit.id()] += balance[f_day];
                                             f_day = f_day.addDays(1);
                                         }
                                     }
@@ -388,8 +592,7 @@ public:
                                 foreach (const auto split, t.splits()) {
                                     auto accountFromSplit = file->account(split.accountId());
                                     if (q->isForecastAccount(accountFromSplit)) {
-                                        dailyBalances balance;
-                                        balance = m_accountList[accountFromSplit.id()];
+                                        auto& balance = forecastSeries(accountFromSplit.id());
                                         //auto offset = QDate::currentDate().daysTo(nextDate);
                                         //if(offset <= 0) {  // collect all overdues on the first day
                                         //  offset = 1;
@@ -404,7 +607,6 @@ public:
                                         } else {
                                             balance[forecastDate] += split.shares();
                                         }
-                                        m_accountList[accountFromSplit.id()] = balance;
                                     }
                                 }
                             }
@@ -426,7 +628,7 @@ public:
 #if 0
         {
             s << "\n\nAdded scheduled transactions\n";
-            QMap<QString, dailyBalances>::Iterator it_a;
+            QMap<QString, DailyBalances>::Iterator it_a;
             QSet<QString>::ConstIterator it_n;
             for (it_n = m_nameIdx.begin(); it_n != m_nameIdx.end(); ++it_n) {
                 auto acc = file->account(*it_n);
@@ -449,20 +651,28 @@ public:
         Q_Q(MyMoneyForecast);
         auto file = MyMoneyFile::instance();
 
-        //Calculate account daily balances
-        QSet<QString>::ConstIterator it_n;
-        for (it_n = m_forecastAccounts.constBegin(); it_n != m_forecastAccounts.constEnd(); ++it_n) {
-            auto acc = file->account(*it_n);
-
-            //set the starting balance of the account
-            setStartingBalance(acc);
+        //set the starting balance of the accounts
+        QVector<AccountSeries> series;
+        series.reserve(m_forecastAccounts.count());
+        for (const auto& id : qAsConst(m_forecastAccounts)) {
+            AccountSeries entry;
+            entry.account = file->account(id);
+            setStartingBalance(entry.account);
+            entry.balances = &forecastSeries(id);
+            series.append(entry);
+        }
 
-            for (QDate f_day = q->forecastStartDate(); f_day <= q->forecastEndDate();) {
-                MyMoneyMoney balanceDayBefore = m_accountList[acc.id()][(f_day.addDays(-1))];//balance of the day before
-                m_accountList[acc.id()][f_day] += balanceDayBefore; //running sum
+        //Calculate account daily balances
+        const auto forecastStartDate = q->forecastStartDate();
+        const auto forecastEndDate = q->forecastEndDate();
+        forEachAccount(series, [&](AccountSeries& entry) {
+            auto& balances = *entry.balances;
+            for (QDate f_day = forecastStartDate; f_day <= forecastEndDate;) {
+                MyMoneyMoney balanceDayBefore = balances[f_day.addDays(-1)];//balance of the day before
+                balances[f_day] += balanceDayBefore; //running sum
                 f_day = f_day.addDays(1);
             }
-        }
+        });
     }
 
     /**
@@ -487,22 +697,15 @@ public:
                 if (price.isValid()) {
                     rate = price.rate(undersecurity.tradingCurrency());
                 }
-                m_accountList[acc.id()][QDate::currentDate()] = file->balance(acc.id(), QDate::currentDate()) * rate;
+                forecastSeries(acc.id())[QDate::currentDate()] = file->balance(acc.id(), QDate::currentDate()) * rate;
             }
         } else {
-            m_accountList[acc.id()][QDate::currentDate()] = file->balance(acc.id(), QDate::currentDate());
+            forecastSeries(acc.id())[QDate::currentDate()] = file->balance(acc.id(), QDate::currentDate());
         }
 
         //if the method is linear regression, we have to add the opening balance to m_accountListPast
         if (forecastMethod() == eForecastMethod::Historic && q->historyMethod() == 2) {
-            //FIXME workaround for stock opening dates
-            QDate openingDate;
-            if (acc.accountType() == eMyMoney::Account::Type::Stock) {
-                auto parentAccount = file->account(acc.parentAccountId());
-                openingDate = parentAccount.openingDate();
-            } else {
-                openingDate = acc.openingDate();
-            }
+            const auto openingDate = accountOpeningDate(acc);
 
             //add opening balance only if it opened after the history start
             if (openingDate >= q->historyStartDate()) {
@@ -511,27 +714,23 @@ public:
 
                 openingBalance = file->balance(acc.id(), openingDate);
 
-                //calculate running sum
-                for (QDate it_date = openingDate; it_date <= q->historyEndDate(); it_date = it_date.addDays(1)) {
-                    //investments require special treatment
-                    if (acc.isInvest()) {
-                        //get the security id of that account
-                        MyMoneySecurity undersecurity = file->security(acc.currencyId());
-
-                        //only do it if the security is not an actual currency
-                        if (! undersecurity.isCurrency()) {
-                            //set the default value
-                            MyMoneyMoney rate = MyMoneyMoney::ONE;
-
-                            //get the rate for that specific date
-                            const MyMoneyPrice &price = file->price(undersecurity.id(), undersecurity.tradingCurrency(), it_date);
-                            if (price.isValid()) {
-                                rate = price.rate(undersecurity.tradingCurrency());
-                            }
-                            m_accountListPast[acc.id()][it_date] += openingBalance * rate;
+                //investments require special treatment
+                if (acc.isInvest()) {
+                    //only do it if the security is not an actual currency
+                    const auto rates = investmentRates(acc, openingDate, q->historyEndDate());
+                    if (!rates.isEmpty()) {
+                        auto& balances = pastSeries(acc.id());
+                        auto it_date = openingDate;
+                        for (const auto& rate : rates) {
+                            balances[it_date] += openingBalance * rate;
+                            it_date = it_date.addDays(1);
                         }
-                    } else {
-                        m_accountListPast[acc.id()][it_date] += openingBalance;
+                    }
+                } else {
+                    //calculate running sum
+                    auto& balances = pastSeries(acc.id());
+                    for (QDate it_date = openingDate; it_date <= q->historyEndDate(); it_date = it_date.addDays(1)) {
+                        balances[it_date] += openingBalance;
                     }
                 }
             }
@@ -539,22 +738,22 @@ public:
     }
 
     /**
-     * Returns the day moving average for the account @a acc based on the daily balances of a given number of @p forecastTerms
+     * Returns the day moving average of an account based on its daily @a pastBalances of a given number of @p forecastTerms
      * It returns the moving average for a given @p trendDay of the forecastTerm
      * With a term of 1 month and 3 terms, it calculates the trend taking the transactions occurred
      * at that day and the day before,for the last 3 months
      */
-    MyMoneyMoney accountMovingAverage(const MyMoneyAccount& acc, const qint64 trendDay, const int forecastTerms)
+    MyMoneyMoney accountMovingAverage(const DailyBalances& pastBalances, const qint64 trendDay, const int forecastTerms) const
     {
-        Q_Q(MyMoneyForecast);
+        Q_Q(const MyMoneyForecast);
         //Calculate a daily trend for the account based on the accounts of a given number of terms
         //With a term of 1 month and 3 terms, it calculates the trend taking the transactions occurred at that day and the day before,
         //for the last 3 months
         MyMoneyMoney balanceVariation;
 
         for (auto it_terms = 0; (trendDay + (q->accountsCycle()*it_terms)) <= q->historyDays(); ++it_terms) { //sum for each term
-            MyMoneyMoney balanceBefore = m_accountListPast[acc.id()][q->historyStartDate().addDays(trendDay+(q->accountsCycle()*it_terms)-2)]; //get balance for the day before
-            MyMoneyMoney balanceAfter = m_accountListPast[acc.id()][q->historyStartDate().addDays(trendDay+(q->accountsCycle()*it_terms)-1)];
+            MyMoneyMoney balanceBefore = pastBalances.value(q->historyStartDate().addDays(trendDay+(q->accountsCycle()*it_terms)-2)); //get balance for the day before
+            MyMoneyMoney balanceAfter = pastBalances.value(q->historyStartDate().addDays(trendDay+(q->accountsCycle()*it_terms)-1));
             balanceVariation += (balanceAfter - balanceBefore); //add the balance variation between days
         }
         //calculate average of the variations
@@ -564,14 +763,14 @@ public:
     /**
      * Returns the weighted moving average for a given @p trendDay
      */
-    MyMoneyMoney accountWeightedMovingAverage(const MyMoneyAccount& acc, const qint64 trendDay, const int totalWeight)
+    MyMoneyMoney accountWeightedMovingAverage(const DailyBalances& pastBalances, const qint64 trendDay, const int totalWeight) const
     {
-        Q_Q(MyMoneyForecast);
+        Q_Q(const MyMoneyForecast);
         MyMoneyMoney balanceVariation;
 
         for (auto it_terms = 0, weight = 1; (trendDay + (q->accountsCycle()*it_terms)) <= q->historyDays(); ++it_terms, ++weight) { //sum for each term multiplied by weight
-            MyMoneyMoney balanceBefore = m_accountListPast[acc.id()][q->historyStartDate().addDays(trendDay+(q->accountsCycle()*it_terms)-2)]; //get balance for the day before
-            MyMoneyMoney balanceAfter = m_accountListPast[acc.id()][q->historyStartDate().addDays(trendDay+(q->accountsCycle()*it_terms)-1)];
+            MyMoneyMoney balanceBefore = pastBalances.value(q->historyStartDate().addDays(trendDay+(q->accountsCycle()*it_terms)-2)); //get balance for the day before
+            MyMoneyMoney balanceAfter = pastBalances.value(q->historyStartDate().addDays(trendDay+(q->accountsCycle()*it_terms)-1));
             balanceVariation += ((balanceAfter - balanceBefore) * MyMoneyMoney(weight, 1));   //add the balance variation between days multiplied by its weight
         }
         //calculate average of the variations
@@ -581,15 +780,15 @@ public:
     /**
      * Returns the linear regression for a given @p trendDay
      */
-    MyMoneyMoney accountLinearRegression(const MyMoneyAccount &acc, const qint64 trendDay, const qint64 actualTerms, const MyMoneyMoney& meanTerms)
+    MyMoneyMoney accountLinearRegression(const DailyBalances& pastBalances, const qint64 trendDay, const qint64 actualTerms, const MyMoneyMoney& meanTerms) const
     {
-        Q_Q(MyMoneyForecast);
+        Q_Q(const MyMoneyForecast);
         MyMoneyMoney meanBalance, totalBalance, totalTerms;
         totalTerms = MyMoneyMoney(actualTerms, 1);
 
         //calculate mean balance
         for (auto it_terms = q->forecastCycles() - actualTerms; (trendDay + (q->accountsCycle()*it_terms)) <= q->historyDays(); ++it_terms) { //sum for each term
-            totalBalance += m_accountListPast[acc.id()][q->historyStartDate().addDays(trendDay+(q->accountsCycle()*it_terms)-1)];
+            totalBalance += pastBalances.value(q->historyStartDate().addDays(trendDay+(q->accountsCycle()*it_terms)-1));
         }
         meanBalance = totalBalance / MyMoneyMoney(actualTerms, 1);
         meanBalance = meanBalance.convert(10000);
@@ -600,7 +799,7 @@ public:
         MyMoneyMoney totalXY, totalSqX;
         auto term = 1;
         for (auto it_terms = q->forecastCycles() - actualTerms; (trendDay + (q->accountsCycle()*it_terms)) <= q->historyDays(); ++it_terms, ++term) { //sum for each term
-            MyMoneyMoney balance = m_accountListPast[acc.id()][q->historyStartDate().addDays(trendDay+(q->accountsCycle()*it_terms)-1)];
+            MyMoneyMoney balance = pastBalances.value(q->historyStartDate().addDays(trendDay+(q->accountsCycle()*it_terms)-1));
 
             MyMoneyMoney balMeanBal = balance - meanBalance;
             MyMoneyMoney termMeanTerm = (MyMoneyMoney(term, 1) - meanTerms);
@@ -631,38 +830,27 @@ public:
         qint64 auxForecastTerms;
         qint64 totalWeight = 0;
 
-        //Calculate account trends
-        QSet<QString>::ConstIterator it_n;
-        for (it_n = m_forecastAccounts.begin(); it_n != m_forecastAccounts.end(); ++it_n) {
-            auto acc = file->account(*it_n);
-            m_accountTrendList[acc.id()][0] = MyMoneyMoney(); // for today, the trend is 0
+        //Collect the number of terms of each account
+        QVector<AccountSeries> series;
+        series.reserve(m_forecastAccounts.count());
+        for (const auto& id : qAsConst(m_forecastAccounts)) {
+            AccountSeries entry;
+            entry.account = file->account(id);
+            entry.pastBalances = &pastSeries(id);
+            entry.trend = &m_accountTrendList[id];
+            // for today, the trend is 0
+            entry.trend->fill(MyMoneyMoney(), static_cast<int>(q->accountsCycle() + 1));
 
             auxForecastTerms = q->forecastCycles();
             if (q->skipOpeningDate()) {
-
-                QDate openingDate;
-                if (acc.accountType() == eMyMoney::Account::Type::Stock) {
-                    auto parentAccount = file->account(acc.parentAccountId());
-                    openingDate = parentAccount.openingDate();
-                } else {
-                    openingDate = acc.openingDate();
-                }
-
+                const auto openingDate = accountOpeningDate(entry.account);
                 if (openingDate > q->historyStartDate()) { //if acc opened after forecast period
                     auxForecastTerms = 1 + ((openingDate.daysTo(q->historyEndDate()) + 1) / q->accountsCycle()); // set forecastTerms to a lower value, to calculate only based on how long this account was opened
                 }
             }
 
-            switch (q->historyMethod()) {
-            //moving average
-            case 0: {
-                for (auto t_day = 1; t_day <= q->accountsCycle(); ++t_day)
-                    m_accountTrendList[acc.id()][t_day] = accountMovingAverage(acc, t_day, auxForecastTerms); //moving average
-                break;
-            }
-            //weighted moving average
-            case 1: {
-                //calculate total weight for moving average
+            //calculate total weight for weighted moving average
+            if (q->historyMethod() == 1) {
                 if (auxForecastTerms == q->forecastCycles()) {
                     totalWeight = (auxForecastTerms * (auxForecastTerms + 1)) / 2; //totalWeight is the triangular number of auxForecastTerms
                 } else {
@@ -671,22 +859,44 @@ public:
                     for (qint64 w = q->forecastCycles(); i <= auxForecastTerms; ++i, --w)
                         totalWeight += w;
                 }
-                for (auto t_day = 1; t_day <= q->accountsCycle(); ++t_day)
-                    m_accountTrendList[acc.id()][t_day] = accountWeightedMovingAverage(acc, t_day, totalWeight);
+            }
+            entry.forecastTerms = auxForecastTerms;
+            entry.totalWeight = totalWeight;
+            series.append(entry);
+        }
+
+        //Calculate account trends
+        const auto historyMethod = q->historyMethod();
+        const auto accountsCycle = q->accountsCycle();
+        forEachAccount(series, [&](AccountSeries& entry) {
+            const auto& pastBalances = *entry.pastBalances;
+            auto& trend = *entry.trend;
+
+            switch (historyMethod) {
+            //moving average
+            case 0: {
+                for (auto t_day = 1; t_day <= accountsCycle; ++t_day)
+                    trend[t_day] = accountMovingAverage(pastBalances, t_day, entry.forecastTerms); //moving average
+                break;
+            }
+            //weighted moving average
+            case 1: {
+                for (auto t_day = 1; t_day <= accountsCycle; ++t_day)
+                    trend[t_day] = accountWeightedMovingAverage(pastBalances, t_day, entry.totalWeight);
                 break;
             }
             case 2: {
                 //calculate mean term
-                MyMoneyMoney meanTerms = MyMoneyMoney((auxForecastTerms * (auxForecastTerms + 1)) / 2, 1) / MyMoneyMoney(auxForecastTerms, 1);
+                MyMoneyMoney meanTerms = MyMoneyMoney((entry.forecastTerms * (entry.forecastTerms + 1)) / 2, 1) / MyMoneyMoney(entry.forecastTerms, 1);
 
-                for (auto t_day = 1; t_day <= q->accountsCycle(); ++t_day)
-                    m_accountTrendList[acc.id()][t_day] = accountLinearRegression(acc, t_day, auxForecastTerms, meanTerms);
+                for (auto t_day = 1; t_day <= accountsCycle; ++t_day)
+                    trend[t_day] = accountLinearRegression(pastBalances, t_day, entry.forecastTerms, meanTerms);
                 break;
             }
             default:
                 break;
             }
-        }
+        });
     }
 
     /**
@@ -732,36 +942,34 @@ public:
         filter.setDateFilter(q->historyStartDate(), q->historyEndDate());
         filter.setReportAllSplits(false);
 
+        // the accounts found in the splits and their opening date
+        QHash<QString, QPair<MyMoneyAccount, QDate>> accounts;
+
         //Check past transactions
         QList<MyMoneyTransaction> list;
         file->transactionList(list, filter);
         for (const auto& transaction : list) {
             for (const auto& split : transaction.splits()) {
                 if (!split.shares().isZero()) {
-                    auto acc = file->account(split.accountId());
-
-                    //workaround for stock accounts which have faulty opening dates
-                    QDate openingDate;
-                    if (acc.accountType() == eMyMoney::Account::Type::Stock) {
-                        auto parentAccount = file->account(acc.parentAccountId());
-                        openingDate = parentAccount.openingDate();
-                    } else {
-                        openingDate = acc.openingDate();
+                    auto it = accounts.find(split.accountId());
+                    if (it == accounts.end()) {
+                        const auto acc = file->account(split.accountId());
+                        //workaround for stock accounts which have faulty opening dates
+                        it = accounts.insert(acc.id(), qMakePair(acc, accountOpeningDate(acc)));
                     }
+                    const auto& acc = it->first;
+                    const auto& openingDate = it->second;
 
                     if (q->isForecastAccount(acc) //If it is one of the accounts we are checking, add the amount of the transaction
                             && ((openingDate < transaction.postDate() && q->skipOpeningDate())
                                 || !q->skipOpeningDate())) {  //don't take the opening day of the account to calculate balance
-                        dailyBalances balance;
                         //FIXME deal with leap years
-                        balance = m_accountListPast[acc.id()];
+                        auto& balance = pastSeries(acc.id());
                         if (acc.accountType() == eMyMoney::Account::Type::Income) {//if it is income, the balance is stored as negative number
                             balance[transaction.postDate()] += (split.shares() * MyMoneyMoney::MINUS_ONE);
                         } else {
                             balance[transaction.postDate()] += split.shares();
                         }
-                        // check if this is a new account for us
-                        m_accountListPast[acc.id()] = balance;
                     }
                 }
             }
@@ -771,40 +979,38 @@ public:
         if (q->isIncludingUnusedAccounts() == false)
             purgeForecastAccountsList(m_accountListPast);
 
+        //collect the balances before the history start and the
+        //prices of the investments as the engine must not be used on the thread pool
+        QVector<AccountSeries> series;
+        series.reserve(m_forecastAccounts.count());
+        for (const auto& id : qAsConst(m_forecastAccounts)) {
+            AccountSeries entry;
+            entry.account = file->account(id);
+            entry.pastBalances = &pastSeries(id);
+            entry.startBalance = file->balance(id, q->historyStartDate().addDays(-1));
+            //adjust value of investments to deep currency
+            entry.rates = investmentRates(entry.account, q->historyStartDate().addDays(-1), q->historyEndDate());
+            series.append(entry);
+        }
+
         //calculate running sum
-        QSet<QString>::ConstIterator it_n;
-        for (it_n = m_forecastAccounts.begin(); it_n != m_forecastAccounts.end(); ++it_n) {
-            auto acc = file->account(*it_n);
-            m_accountListPast[acc.id()][q->historyStartDate().addDays(-1)] = file->balance(acc.id(), q->historyStartDate().addDays(-1));
-            for (QDate it_date = q->historyStartDate(); it_date <= q->historyEndDate();) {
-                m_accountListPast[acc.id()][it_date] += m_accountListPast[acc.id()][it_date.addDays(-1)]; //Running sum
+        const auto historyStartDate = q->historyStartDate();
+        const auto historyEndDate = q->historyEndDate();
+        forEachAccount(series, [&](AccountSeries& entry) {
+            auto& balances = *entry.pastBalances;
+            balances[historyStartDate.addDays(-1)] = entry.startBalance;
+            for (QDate it_date = historyStartDate; it_date <= historyEndDate;) {
+                balances[it_date] += balances[it_date.addDays(-1)]; //Running sum
                 it_date = it_date.addDays(1);
             }
-        }
 
-        //adjust value of investments to deep currency
-        for (it_n = m_forecastAccounts.begin(); it_n != m_forecastAccounts.end(); ++it_n) {
-            auto acc = file->account(*it_n);
-
-            if (acc.isInvest()) {
-                //get the id of the security for that account
-                MyMoneySecurity undersecurity = file->security(acc.currencyId());
-                if (! undersecurity.isCurrency()) { //only do it if the security is not an actual currency
-                    MyMoneyMoney rate = MyMoneyMoney::ONE;    //set the default value
-
-                    for (QDate it_date = q->historyStartDate().addDays(-1) ; it_date <= q->historyEndDate();) {
-                        //get the price for the tradingCurrency that day
-                        const MyMoneyPrice &price = file->price(undersecurity.id(), undersecurity.tradingCurrency(), it_date);
-                        if (price.isValid()) {
-                            rate = price.rate(undersecurity.tradingCurrency());
-                        }
-                        //value is the amount of shares multiplied by the rate of the deep currency
-                        m_accountListPast[acc.id()][it_date] = m_accountListPast[acc.id()][it_date] * rate;
-                        it_date = it_date.addDays(1);
-                    }
-                }
+            //value is the amount of shares multiplied by the rate of the deep currency
+            auto it_date = historyStartDate.addDays(-1);
+            for (const auto& rate : qAsConst(entry.rates)) {
+                balances[it_date] = balances[it_date] * rate;
+                it_date = it_date.addDays(1);
             }
-        }
+        });
     }
 
     /**
@@ -867,7 +1073,7 @@ public:
      * remove accounts from the list if the accounts has no transactions in the forecast timeframe.
      * Used for scheduled-forecast method.
      */
-    void purgeForecastAccountsList(QMap<QString, dailyBalances>& accountList)
+    void purgeForecastAccountsList(QMap<QString, DailyBalances>& accountList)
     {
         m_forecastAccounts.intersect(accountList.keys().toSet());
     }
@@ -877,12 +1083,12 @@ public:
     /**
      * daily forecast balance of accounts
      */
-    QMap<QString, dailyBalances> m_accountList;
+    QMap<QString, DailyBalances> m_accountList;
 
     /**
      * daily past balance of accounts
      */
-    QMap<QString, dailyBalances> m_accountListPast;
+    QMap<QString, DailyBalances> m_accountListPast;
 
     /**
      * daily forecast trends of accounts
@@ -1147,7 +1353,6 @@ MyMoneyMoney MyMoneyForecast::calculateAccountTrend(const MyMoneyAccount& acc, q
 MyMoneyMoney MyMoneyForecast::forecastBalance(const MyMoneyAccount& acc, const QDate &forecastDate)
 {
     Q_D(MyMoneyForecast);
-    dailyBalances balance;
     MyMoneyMoney MM_amount = MyMoneyMoney();
 
     //Check if acc is not a forecast account, return 0
@@ -1155,11 +1360,9 @@ MyMoneyMoney MyMoneyForecast::forecastBalance(const MyMoneyAccount& acc, const Q
         return MM_amount;
     }
 
-    if (d->m_accountList.contains(acc.id())) {
-        balance = d->m_accountList.value(acc.id());
-    }
-    if (balance.contains(forecastDate)) { //if the date is not in the forecast, it returns 0
-        MM_amount = balance.value(forecastDate);
+    const auto balance = d->m_accountList.constFind(acc.id());
+    if (balance != d->m_accountList.constEnd() && balance->contains(forecastDate)) { //if the date is not in the forecast, it returns 0
+        MM_amount = balance->value(forecastDate);
     }
     return MM_amount;
 }
@@ -1180,17 +1383,16 @@ qint64 MyMoneyForecast::daysToMinimumBalance(const MyMoneyAccount& acc)
     Q_D(MyMoneyForecast);
     QString minimumBalance = acc.value("minBalanceAbsolute");
     MyMoneyMoney minBalance = MyMoneyMoney(minimumBalance);
-    dailyBalances balance;
 
     //Check if acc is not a forecast account, return -1
     if (!isForecastAccount(acc)) {
         return -1;
     }
 
-    balance = d->m_accountList[acc.id()];
+    const auto balance = d->m_accountList.value(acc.id());
 
     for (QDate it_day = QDate::currentDate() ; it_day <= forecastEndDate();) {
-        if (minBalance > balance[it_day]) {
+        if (minBalance > balance.value(it_day)) {
             return QDate::currentDate().daysTo(it_day);
         }
         it_day = it_day.addDays(1);
@@ -1201,25 +1403,24 @@ qint64 MyMoneyForecast::daysToMinimumBalance(const MyMoneyAccount& acc)
 qint64 MyMoneyForecast::daysToZeroBalance(const MyMoneyAccount& acc)
 {
     Q_D(MyMoneyForecast);
-    dailyBalances balance;
 
     //Check if acc is not a forecast account, return -1
     if (!isForecastAccount(acc)) {
         return -2;
     }
 
-    balance = d->m_accountList[acc.id()];
+    const auto balance = d->m_accountList.value(acc.id());
 
     if (acc.accountGroup() == eMyMoney::Account::Type::Asset) {
         for (QDate it_day = QDate::currentDate() ; it_day <= forecastEndDate();) {
-            if (balance[it_day] < MyMoneyMoney()) {
+            if (balance.value(it_day) < MyMoneyMoney()) {
                 return QDate::currentDate().daysTo(it_day);
             }
             it_day = it_day.addDays(1);
         }
     } else if (acc.accountGroup() == eMyMoney::Account::Type::Liability) {
         for (QDate it_day = QDate::currentDate() ; it_day <= forecastEndDate();) {
-            if (balance[it_day] > MyMoneyMoney()) {
+            if (balance.value(it_day) > MyMoneyMoney()) {
                 return QDate::currentDate().daysTo(it_day);
             }
             it_day = it_day.addDays(1);
@@ -1238,8 +1439,9 @@ MyMoneyMoney MyMoneyForecast::accountCycleVariation(const MyMoneyAccount& acc)
         switch (historyMethod()) {
         case 0:
         case 1: {
+            const auto trend = d->m_accountTrendList.value(acc.id());
             for (auto t_day = 1; t_day <= accountsCycle() ; ++t_day) {
-                cycleVariation += d->m_accountTrendList[acc.id()][t_day];
+                cycleVariation += trend.value(t_day);
             }
         }
         break;
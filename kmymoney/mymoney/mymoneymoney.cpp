@@ -18,6 +18,7 @@
 #include "mymoneymoney.h"
 
 #include <stdint.h>
+#include <climits>
 #include <gmpxx.h>
 
 // ----------------------------------------------------------------------------
@@ -54,6 +55,153 @@ eMyMoney::Money::fileVersionE _fileVersion = fileVersionE::FILE_4_BYTE_VALUE;
 }
 }
 
+namespace {
+/**
+ * A value in canonical form (the denominator is positive and has
+ * no common divisor with the numerator) where both parts fit into
+ * a long int. Calculations with these values avoid the temporary
+ * mpq_class objects of the GMP arithmetic.
+ */
+struct SmallValue
+{
+    long int num;
+    long int den;
+};
+
+inline bool toSmallValue(const mpq_class& value, SmallValue& small)
+{
+    if (mpz_fits_slong_p(value.get_num_mpz_t()) && mpz_fits_slong_p(value.get_den_mpz_t())) {
+        small.num = mpz_get_si(value.get_num_mpz_t());
+        small.den = mpz_get_si(value.get_den_mpz_t());
+        // keep away from LONG_MIN so that the absolute value can be taken
+        return small.num != LONG_MIN;
+    }
+    return false;
+}
+
+inline void fromSmallValue(mpq_class& value, const SmallValue& small)
+{
+    // small is canonical, so there is no need to call mpq_canonicalize()
+    mpq_set_si(value.get_mpq_t(), small.num, static_cast<unsigned long int>(small.den));
+}
+
+inline bool addOverflow(long int a, long int b, long int& result)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_add_overflow(a, b, &result);
+#else
+    if ((b > 0 && a > LONG_MAX - b) || (b < 0 && a < LONG_MIN - b))
+        return true;
+    result = a + b;
+    return false;
+#endif
+}
+
+inline bool mulOverflow(long int a, long int b, long int& result)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_mul_overflow(a, b, &result);
+#else
+    if (a != 0 && b != 0) {
+        if ((a == -1 && b == LONG_MIN) || (b == -1 && a == LONG_MIN))
+            return true;
+        if ((a > 0) == (b > 0) ? (a > 0 ? a > LONG_MAX / b : a < LONG_MAX / b)
+                               : (a > 0 ? b < LONG_MIN / a : a < LONG_MIN / b))
+            return true;
+    }
+    result = a * b;
+    return false;
+#endif
+}
+
+inline long int gcd(long int a, long int b)
+{
+    a = (a < 0) ? -a : a;
+    while (b != 0) {
+        const auto t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+inline void canonicalize(SmallValue& value)
+{
+    if (value.num == 0) {
+        value.den = 1;
+    } else {
+        const auto divisor = gcd(value.num, value.den);
+        if (divisor > 1) {
+            value.num /= divisor;
+            value.den /= divisor;
+        }
+    }
+}
+
+/**
+ * Calculates @a a + @a b or @a a - @a b depending on @a negate into
+ * @a result. Returns @c false in case the result does not fit.
+ */
+bool addSmallValues(const SmallValue& a, SmallValue b, SmallValue& result, bool negate)
+{
+    if (negate) {
+        b.num = -b.num;
+    }
+    // most of the time the denominators are identical or one
+    // is a multiple of the other (e.g. 1/2 and 3/100)
+    if (a.den == b.den) {
+        if (addOverflow(a.num, b.num, result.num))
+            return false;
+        result.den = a.den;
+    } else {
+        const auto divisor = gcd(a.den, b.den);
+        const auto factorA = b.den / divisor;
+        const auto factorB = a.den / divisor;
+        long int numA, numB;
+        if (mulOverflow(a.den, factorA, result.den)
+                || mulOverflow(a.num, factorA, numA)
+                || mulOverflow(b.num, factorB, numB)
+                || addOverflow(numA, numB, result.num))
+            return false;
+    }
+    if (result.num == LONG_MIN)
+        return false;
+    canonicalize(result);
+    return true;
+}
+
+/**
+ * Calculates @a a * @a b into @a result. Returns @c false in case
+ * the result does not fit.
+ */
+bool mulSmallValues(const SmallValue& a, const SmallValue& b, SmallValue& result)
+{
+    if (a.num == 0 || b.num == 0) {
+        result.num = 0;
+        result.den = 1;
+        return true;
+    }
+    // cancel crosswise first so that the result is canonical
+    const auto divisor1 = gcd(a.num, b.den);
+    const auto divisor2 = gcd(b.num, a.den);
+    return !mulOverflow(a.num / divisor1, b.num / divisor2, result.num)
+           && !mulOverflow(a.den / divisor2, b.den / divisor1, result.den);
+}
+
+/**
+ * Sets @a value to @a amount / @a denom without the detour through
+ * a string as long as @a amount fits into a long int.
+ */
+bool setSmallValue(mpq_class& value, qint64 amount, unsigned int denom)
+{
+    if (amount < LONG_MIN || amount > LONG_MAX)
+        return false;
+    mpq_set_si(value.get_mpq_t(), static_cast<long int>(amount), denom);
+    value.canonicalize();
+    return true;
+}
+} // namespace
+
 MyMoneyMoney MyMoneyMoney::maxValue = MyMoneyMoney(INT64_MAX, 100);
 MyMoneyMoney MyMoneyMoney::minValue = MyMoneyMoney(INT64_MIN, 100);
 MyMoneyMoney MyMoneyMoney::autoCalc = MyMoneyMoney(INT64_MIN + 1, 100);
@@ -143,7 +291,8 @@ MyMoneyMoney::MyMoneyMoney(qint64 Amount, const unsigned int denom)
     if (denom == 0)
         throw MYMONEYEXCEPTION_CSTRING("Denominator 0 not allowed!");
 
-    *this = AlkValue(QString::fromLatin1("%1/%2").arg(Amount).arg(denom), eMyMoney::Money::_decimalSeparator);
+    if (!setSmallValue(valueRef(), Amount, denom))
+        *this = AlkValue(QString::fromLatin1("%1/%2").arg(Amount).arg(denom), eMyMoney::Money::_decimalSeparator);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -175,7 +324,8 @@ MyMoneyMoney::MyMoneyMoney(const long int iAmount, const unsigned int denom)
 {
     if (denom == 0)
         throw MYMONEYEXCEPTION_CSTRING("Denominator 0 not allowed!");
-    *this = AlkValue(QString::fromLatin1("%1/%2").arg(iAmount).arg(denom), eMyMoney::Money::_decimalSeparator);
+    if (!setSmallValue(valueRef(), iAmount, denom))
+        *this = AlkValue(QString::fromLatin1("%1/%2").arg(iAmount).arg(denom), eMyMoney::Money::_decimalSeparator);
 }
 
 
@@ -330,6 +480,12 @@ QString MyMoneyMoney::formatMoney(const QString& currency, const int prec, bool
 ////////////////////////////////////////////////////////////////////////////////
 const MyMoneyMoney MyMoneyMoney::operator+(const MyMoneyMoney& _b) const
 {
+    SmallValue a, b, r;
+    if (toSmallValue(valueRef(), a) && toSmallValue(_b.valueRef(), b) && addSmallValues(a, b, r, false)) {
+        MyMoneyMoney result;
+        fromSmallValue(result.valueRef(), r);
+        return result;
+    }
     return static_cast<const MyMoneyMoney>(AlkValue::operator+(_b));
 }
 
@@ -344,6 +500,12 @@ const MyMoneyMoney MyMoneyMoney::operator+(const MyMoneyMoney& _b) const
 ////////////////////////////////////////////////////////////////////////////////
 const MyMoneyMoney MyMoneyMoney::operator-(const MyMoneyMoney& _b) const
 {
+    SmallValue a, b, r;
+    if (toSmallValue(valueRef(), a) && toSmallValue(_b.valueRef(), b) && addSmallValues(a, b, r, true)) {
+        MyMoneyMoney result;
+        fromSmallValue(result.valueRef(), r);
+        return result;
+    }
     return static_cast<const MyMoneyMoney>(AlkValue::operator-(_b));
 }
 
@@ -357,9 +519,48 @@ const MyMoneyMoney MyMoneyMoney::operator-(const MyMoneyMoney& _b) const
 ////////////////////////////////////////////////////////////////////////////////
 const MyMoneyMoney MyMoneyMoney::operator*(const MyMoneyMoney& _b) const
 {
+    SmallValue a, b, r;
+    if (toSmallValue(valueRef(), a) && toSmallValue(_b.valueRef(), b) && mulSmallValues(a, b, r)) {
+        MyMoneyMoney result;
+        fromSmallValue(result.valueRef(), r);
+        return result;
+    }
     return static_cast<const MyMoneyMoney>(AlkValue::operator*(_b));
 }
 
+MyMoneyMoney& MyMoneyMoney::operator+=(const MyMoneyMoney& _b)
+{
+    SmallValue a, b, r;
+    if (toSmallValue(valueRef(), a) && toSmallValue(_b.valueRef(), b) && addSmallValues(a, b, r, false)) {
+        fromSmallValue(valueRef(), r);
+    } else {
+        AlkValue::operator+=(_b);
+    }
+    return *this;
+}
+
+MyMoneyMoney& MyMoneyMoney::operator-=(const MyMoneyMoney& _b)
+{
+    SmallValue a, b, r;
+    if (toSmallValue(valueRef(), a) && toSmallValue(_b.valueRef(), b) && addSmallValues(a, b, r, true)) {
+        fromSmallValue(valueRef(), r);
+    } else {
+        AlkValue::operator-=(_b);
+    }
+    return *this;
+}
+
+MyMoneyMoney& MyMoneyMoney::operator*=(const MyMoneyMoney& _b)
+{
+    SmallValue a, b, r;
+    if (toSmallValue(valueRef(), a) && toSmallValue(_b.valueRef(), b) && mulSmallValues(a, b, r)) {
+        fromSmallValue(valueRef(), r);
+    } else {
+        AlkValue::operator*=(_b);
+    }
+    return *this;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //      Name: operator/
 //   Purpose: Division operator - divides the object by the input amount
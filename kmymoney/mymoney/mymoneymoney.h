@@ -35,6 +35,12 @@ enum signPosition : int;
 /**
   * This class represents a value within the MyMoney Engine
   *
+  * The value is kept as a GMP rational by AlkValue. Addition, subtraction
+  * and multiplication of values whose numerator and denominator fit into
+  * a long int are carried out on integers and only fall back to the
+  * rational arithmetic of AlkValue in case of an overflow. The results
+  * are identical in both cases.
+  *
   * @author Michael Edwardes
   * @author Thomas Baumgart
   */
@@ -140,6 +146,13 @@ public:
     const MyMoneyMoney operator-() const;
     const MyMoneyMoney operator*(int factor) const;
 
+    using AlkValue::operator+=;
+    using AlkValue::operator-=;
+    using AlkValue::operator*=;
+    MyMoneyMoney& operator+=(const MyMoneyMoney& Amount);
+    MyMoneyMoney& operator-=(const MyMoneyMoney& Amount);
+    MyMoneyMoney& operator*=(const MyMoneyMoney& factor);
+
     static MyMoneyMoney maxValue;
     static MyMoneyMoney minValue;
     static MyMoneyMoney autoCalc;
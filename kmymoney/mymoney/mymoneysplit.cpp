@@ -417,23 +417,24 @@ void MyMoneySplit::addMatch(const MyMoneyTransaction& _t)
 {
     Q_D(MyMoneySplit);
     //  now we allow matching of two manual transactions
-    d->m_matchedTransaction = _t;
-    d->m_matchedTransaction.clearId();
+    auto matchedTransaction = new MyMoneyTransaction(_t);
+    matchedTransaction->clearId();
+    d->m_matchedTransaction.reset(matchedTransaction);
     d->m_isMatched = true;
 }
 
 void MyMoneySplit::removeMatch()
 {
     Q_D(MyMoneySplit);
-    d->m_matchedTransaction = MyMoneyTransaction();
+    d->m_matchedTransaction.reset();
     d->m_isMatched = false;
 }
 
 MyMoneyTransaction MyMoneySplit::matchedTransaction() const
 {
     Q_D(const MyMoneySplit);
-    if (d->m_isMatched)
-        return d->m_matchedTransaction;
+    if (d->m_isMatched && d->m_matchedTransaction)
+        return *d->m_matchedTransaction;
 
     return MyMoneyTransaction();
 }
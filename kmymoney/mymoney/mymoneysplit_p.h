@@ -16,6 +16,7 @@
 
 #include <QString>
 #include <QDate>
+#include <QSharedPointer>
 
 // ----------------------------------------------------------------------------
 // KDE Includes
@@ -124,7 +125,12 @@ public:
       */
     QString        m_transactionId;
 
-    MyMoneyTransaction m_matchedTransaction;
+    /**
+      * Only very few splits are matched, so the matched transaction is kept
+      * out of line. It is never modified once set, which allows copies of
+      * the split to share it.
+      */
+    QSharedPointer<const MyMoneyTransaction> m_matchedTransaction;
     bool m_isMatched;
 
 };
@@ -122,6 +122,12 @@ uint MyMoneyTransaction::splitCount() const
     return d->m_splits.count();
 }
 
+const MyMoneySplit& MyMoneyTransaction::splitAt(int idx) const
+{
+    Q_D(const MyMoneyTransaction);
+    return d->m_splits.at(idx);
+}
+
 QString MyMoneyTransaction::commodity() const
 {
     Q_D(const MyMoneyTransaction);
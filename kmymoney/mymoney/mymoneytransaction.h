@@ -80,6 +80,13 @@ public:
     MyMoneySplit firstSplit() const;
     uint splitCount() const;
 
+    /**
+     * Returns a reference to the split at position @a idx of splits()
+     * without copying it. The reference stays valid as long as the
+     * splits of the transaction are not modified.
+     */
+    const MyMoneySplit& splitAt(int idx) const;
+
     QString commodity() const;
     void setCommodity(const QString& commodityId);
 
@@ -66,6 +66,18 @@ public:
     QString             m_fromNr, m_toNr;
     QDate               m_fromDate, m_toDate;
     MyMoneyMoney        m_fromAmount, m_toAmount;
+    QSharedPointer<const QHash<QString, MyMoneyAccount>> m_accountSnapshot;
+
+    MyMoneyAccount account(const QString& id) const
+    {
+        if (m_accountSnapshot) {
+            const auto it = m_accountSnapshot->constFind(id);
+            if (it != m_accountSnapshot->constEnd()) {
+                return *it;
+            }
+        }
+        return MyMoneyFile::instance()->account(id);
+    }
 };
 
 MyMoneyTransactionFilter::MyMoneyTransactionFilter() :
@@ -275,6 +287,12 @@ void MyMoneyTransactionFilter::setTreatTransfersAsIncomeExpense(const bool check
     d->m_treatTransfersAsIncomeExpense = check;
 }
 
+void MyMoneyTransactionFilter::setAccountSnapshot(const QSharedPointer<const QHash<QString, MyMoneyAccount>>& accounts)
+{
+    Q_D(MyMoneyTransactionFilter);
+    d->m_accountSnapshot = accounts;
+}
+
 bool MyMoneyTransactionFilter::treatTransfersAsIncomeExpense() const
 {
     Q_D(const MyMoneyTransactionFilter);
@@ -295,8 +313,6 @@ QVector<MyMoneySplit> MyMoneyTransactionFilter::matchingSplits(const MyMoneyTran
     Q_D(MyMoneyTransactionFilter);
 
     QVector<MyMoneySplit> matchingSplits;
-    const auto file = MyMoneyFile::instance();
-
     // qDebug("T: %s", transaction.id().data());
     // if no filter is set, we can safely return a match
     // if we should report all splits, then we collect them
@@ -352,7 +368,7 @@ QVector<MyMoneySplit> MyMoneyTransactionFilter::matchingSplits(const MyMoneyTran
             if (needAccountMatch || needCategoryMatch) {
                 auto removeSplit = true;
                 if (d->m_considerCategory) {
-                    switch (file->account(s.accountId()).accountGroup()) {
+                    switch (d->account(s.accountId()).accountGroup()) {
                     case eMyMoney::Account::Type::Income:
                     case eMyMoney::Account::Type::Expense:
                         isTransfer = false;
@@ -399,7 +415,7 @@ QVector<MyMoneySplit> MyMoneyTransactionFilter::matchingSplits(const MyMoneyTran
 
             // check if less frequent filters are active
             if (extendedFilter != 0) {
-                const auto acc = file->account(s.accountId());
+                const auto acc = d->account(s.accountId());
                 if (!(matchAmount(s) && matchText(s, acc)))
                     continue;
 
@@ -579,7 +595,8 @@ bool MyMoneyTransactionFilter::matchAmount(const MyMoneySplit& s) const
 
 bool MyMoneyTransactionFilter::match(const MyMoneySplit& s) const
 {
-    const auto& acc = MyMoneyFile::instance()->account(s.accountId());
+    Q_D(const MyMoneyTransactionFilter);
+    const auto acc = d->account(s.accountId());
     return matchText(s, acc) && matchAmount(s);
 }
 
@@ -615,9 +632,8 @@ int MyMoneyTransactionFilter::splitType(const MyMoneyTransaction& t, const MyMon
 
     if (t.splitCount() == 2 && !d->m_treatTransfersAsIncomeExpense) {
         const auto& splits = t.splits();
-        const auto file = MyMoneyFile::instance();
-        const auto& a = splits.at(0).id().compare(split.id()) == 0 ? acc : file->account(splits.at(0).accountId());
-        const auto& b = splits.at(1).id().compare(split.id()) == 0 ? acc : file->account(splits.at(1).accountId());
+        const auto& a = splits.at(0).id().compare(split.id()) == 0 ? acc : d->account(splits.at(0).accountId());
+        const auto& b = splits.at(1).id().compare(split.id()) == 0 ? acc : d->account(splits.at(1).accountId());
 
         if (!a.isIncomeExpense() && !b.isIncomeExpense())
             return (int)eMyMoney::TransactionFilter::Type::Transfers;
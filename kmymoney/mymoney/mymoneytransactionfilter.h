@@ -15,6 +15,7 @@
 // QT Includes
 
 #include <QMetaType>
+#include <QSharedPointer>
 
 // ----------------------------------------------------------------------------
 // KDE Includes
@@ -26,6 +27,7 @@ class QString;
 class QDate;
 
 template <typename T> class QList;
+template <class Key, class T> class QHash;
 
 class MyMoneyMoney;
 class MyMoneySplit;
@@ -306,6 +308,15 @@ public:
 
     void setTreatTransfersAsIncomeExpense(const bool check = true);
 
+    /**
+     * Use @a accounts to look up the accounts referenced by the splits
+     * instead of asking MyMoneyFile for each of them. Unless a text filter
+     * is active, this way copies of the filter can be evaluated in several
+     * threads at the same time. Accounts not contained in @a accounts are
+     * still looked up in MyMoneyFile.
+     */
+    void setAccountSnapshot(const QSharedPointer<const QHash<QString, MyMoneyAccount>>& accounts);
+
     /**
      * This method is to avoid returning matching splits list
      * if only its count is needed
@@ -14,6 +14,11 @@
 #include <QRegExp>
 #include <QDate>
 #include <QLocale>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+
+#include <exception>
 
 // ----------------------------------------------------------------------------
 // KDE Headers
@@ -33,6 +38,26 @@
 #include "mymoneysplit.h"
 #include "mymoneytransaction.h"
 
+namespace {
+class FunctionRunnable : public QRunnable
+{
+public:
+    explicit FunctionRunnable(const std::function<void()>& function)
+        : m_function(function)
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override
+    {
+        m_function();
+    }
+
+private:
+    std::function<void()> m_function;
+};
+} // namespace
+
 QString MyMoneyUtils::getFileExtension(QString strFileName)
 {
     QString strTemp;
@@ -205,3 +230,30 @@ modifyTransactionWarnLevel_t MyMoneyUtils::transactionWarnLevel(const QString& j
 {
     return transactionWarnLevel(QStringList(journalEntryId));
 }
+
+void MyMoneyUtils::runParallel(const QVector<std::function<void()>>& tasks)
+{
+    // the pool is shared with others, so only
+    // wait for the tasks started here to finish
+    QSemaphore finished;
+    QVector<std::exception_ptr> errors(tasks.count());
+    for (int i = 0; i < tasks.count(); ++i) {
+        const auto& task = tasks.at(i);
+        auto* error = &errors[i];
+        QThreadPool::globalInstance()->start(new FunctionRunnable([&task, error, &finished]() {
+            try {
+                task();
+            } catch (...) {
+                *error = std::current_exception();
+            }
+            finished.release();
+        }));
+    }
+    finished.acquire(tasks.count());
+
+    for (const auto& error : qAsConst(errors)) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
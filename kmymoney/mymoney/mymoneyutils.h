@@ -9,7 +9,10 @@
 #ifndef MYMONEYUTILS_H
 #define MYMONEYUTILS_H
 
+#include <functional>
+
 #include <QString>
+#include <QVector>
 #include "kmm_mymoney_export.h"
 
 #include "mymoneyenums.h"
@@ -100,6 +103,34 @@ KMM_MYMONEY_EXPORT QString paymentMethodToString(eMyMoney::Schedule::PaymentType
 
 KMM_MYMONEY_EXPORT modifyTransactionWarnLevel_t transactionWarnLevel(const QString& transactionId);
 KMM_MYMONEY_EXPORT modifyTransactionWarnLevel_t transactionWarnLevel(const QStringList& transactionIds);
+
+/**
+ * Runs the @a tasks on the global thread pool and returns once all
+ * of them are finished. Other work on the pool is not waited for.
+ * If tasks throw an exception, the one thrown by the first of them
+ * in @a tasks is rethrown in the calling thread.
+ */
+KMM_MYMONEY_EXPORT void runParallel(const QVector<std::function<void()>>& tasks);
+
+/**
+ * Calls @a function for each entry of @a items using runParallel().
+ * @a function must only modify the data referenced by the entry
+ * passed to it. Whether the overhead of the thread pool pays off
+ * is up to the caller.
+ */
+template<typename T, typename Func>
+void forEachParallel(QVector<T>& items, Func function)
+{
+    QVector<std::function<void()>> tasks;
+    tasks.reserve(items.count());
+    for (int i = 0; i < items.count(); ++i) {
+        auto* item = &items[i];
+        tasks.append([function, item]() {
+            function(*item);
+        });
+    }
+    runParallel(tasks);
+}
 }
 
 #endif
@@ -902,7 +902,14 @@ void AccountsModel::removeFavorite(const QString& id)
 int AccountsModel::processItems(Worker *worker)
 {
     // make sure to work only on real entries and not on favorites
-    return MyMoneyModel<MyMoneyAccount>::processItems(worker, match(assetIndex(), eMyMoney::Model::IdRole, m_idLeadin, -1, Qt::MatchStartsWith | Qt::MatchRecursive));
+    int count = 0;
+    forEachItem([&](const MyMoneyAccount& account) {
+        if (account.id().startsWith(m_idLeadin)) {
+            worker->operator()(account);
+            ++count;
+        }
+    }, assetIndex().row());
+    return count;
 }
 
 QString AccountsModel::indexToHierarchicalName(const QModelIndex& _idx, bool includeStandardAccounts) const
@@ -1095,8 +1102,11 @@ void AccountsModel::doReparentItem(const MyMoneyAccount& before, const MyMoneyAc
     QModelIndex oldParentIdx = itemIdx.parent();
     QModelIndex newParentIdx = indexById(after.parentAccountId());
 
+    auto& account = static_cast<TreeItem<MyMoneyAccount>*>(itemIdx.internalPointer())->dataRef();
     static_cast<TreeItem<MyMoneyAccount>*>(oldParentIdx.internalPointer())->dataRef().removeAccountId(before.id());
-    static_cast<TreeItem<MyMoneyAccount>*>(itemIdx.internalPointer())->dataRef().setParentAccountId(after.parentAccountId());
+    removeReferences(account.referencedObjects());
+    account.setParentAccountId(after.parentAccountId());
+    addReferences(account.referencedObjects());
 
     reparentRow(oldParentIdx, itemIdx.row(), newParentIdx);
 
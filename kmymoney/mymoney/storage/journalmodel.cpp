@@ -12,6 +12,10 @@
 #include <QString>
 #include <QDate>
 #include <QSize>
+#include <QThread>
+
+#include <algorithm>
+#include <limits>
 
 // ----------------------------------------------------------------------------
 // KDE Includes
@@ -31,6 +35,15 @@
 #include "mymoneymoney.h"
 #include "mymoneytransactionfilter.h"
 #include "mymoneyutils.h"
+#include "mymoneysecurity.h"
+
+namespace {
+/**
+ * Filters with less candidate transactions are evaluated in the
+ * calling thread as splitting them up does not pay off.
+ */
+const int defaultParallelEvaluationThreshold = 10000;
+} // namespace
 
 struct JournalModel::Private
 {
@@ -39,9 +52,43 @@ struct JournalModel::Private
         Fees,
     } category_t;
 
+    /**
+     * An entry of the per account balance index. The entries of an
+     * account are kept in journal order and carry the running balance
+     * (and cleared balance) including the split they represent.
+     */
+    struct BalanceIndexEntry
+    {
+        QString         journalId;
+        QDate           postDate;
+        MyMoneyMoney    shares;
+        MyMoneyMoney    balance;
+        MyMoneyMoney    clearedBalance;
+        bool            isStockSplit;
+        bool            isCleared;
+    };
+    typedef QVector<BalanceIndexEntry> BalanceIndex;
+
+    /**
+     * The part of the journal to be checked against a filter: either
+     * the rows between @a firstRow and @a endRow or the ids of the
+     * journal entries in @a candidates (in journal order).
+     */
+    struct QueryPlan
+    {
+        int                 firstRow = 0;
+        int                 endRow = 0;
+        bool                useCandidates = false;
+        QVector<QString>    candidates;
+    };
+
     Private(JournalModel* qq)
         : q(qq)
         , newTransactionModel(nullptr)
+        , balanceIndexValid(false)
+        , postingIndexValid(false)
+        , numberIndexValid(false)
+        , balanceNotificationsDeferred(false)
         , headerData(QHash<Column, QString> ({
         { Number, i18nc("Cheque Number", "No.") },
         { Date, i18n("Date") },
@@ -58,6 +105,8 @@ struct JournalModel::Private
         { Value, i18n("Value") },
         { Balance, i18n("Balance") },
     }))
+        , parallelEvaluationThreshold((QThread::idealThreadCount() > 1) ? defaultParallelEvaluationThreshold : std::numeric_limits<int>::max())
+        , historyTransactionCount(0)
     {
     }
 
@@ -138,22 +187,17 @@ struct JournalModel::Private
         const int rows = transaction.splitCount();
         if(rows > 2) {
             // find the first entry of the transaction
-            QModelIndex idx = index;
-            int row = index.row() - 1;
-            for (; row >= 0; --row) {
-                idx = q->index(row, 0);
-                if (idx.data(eMyMoney::Model::JournalTransactionIdRole).toString() != transaction.id()) {
-                    idx = q->index(row++, 0);
-                    break;
-                }
+            QModelIndex idx;
+            int row = index.row();
+            while ((row > 0) && (q->constItemAt(row - 1).transaction().id() == transaction.id())) {
+                --row;
             }
 
             QString txt, sep;
             const auto endRow = row + rows;
             for (; row < endRow; ++row) {
-                idx = q->index(row, index.column());
-                if (idx != index) {
-                    const auto accountId = idx.data(eMyMoney::Model::SplitAccountIdRole).toString();
+                if (row != index.row()) {
+                    const auto& accountId = q->constItemAt(row).split().accountId();
                     idx = MyMoneyFile::instance()->accountsModel()->indexById(accountId);
                     txt += sep + idx.data(eMyMoney::Model::AccountNameRole).toString();
                     sep = QStringLiteral(", ");
@@ -272,6 +316,50 @@ struct JournalModel::Private
         return transactionIdKeyMap.value(id);
     }
 
+    /**
+     * Returns the transactions matching @a filter which are not kept
+     * in memory because the journal has been loaded partially. The
+     * transactions are not checked against the filter.
+     */
+    QList<MyMoneyTransaction> olderTransactions(const MyMoneyTransactionFilter& filter) const
+    {
+        QList<MyMoneyTransaction> list;
+        if (!loader || (filter.fromDate().isValid() && (filter.fromDate() >= firstLoadedDate))) {
+            return list;
+        }
+
+        // restrict the storage to the entries not kept in memory
+        MyMoneyTransactionFilter olderFilter(filter);
+        auto toDate = firstLoadedDate.addDays(-1);
+        if (filter.toDate().isValid() && (filter.toDate() < toDate)) {
+            toDate = filter.toDate();
+        }
+        olderFilter.setDateFilter(filter.fromDate(), toDate);
+
+        const auto transactions = loader->transactions(olderFilter);
+        for (const auto& transaction : transactions) {
+            if ((transaction.postDate() < firstLoadedDate) && !transactionIdKeyMap.contains(transaction.id())) {
+                list.append(transaction);
+            }
+        }
+        return list;
+    }
+
+    /**
+     * Makes sure that the transaction with @a id is kept in memory
+     * in case the journal has been loaded partially so that it can
+     * be modified or removed.
+     */
+    void loadTransaction(const QString& id)
+    {
+        if (loader && !id.isEmpty() && !transactionIdKeyMap.contains(id)) {
+            const auto transaction = loader->transaction(id);
+            if (transaction.postDate().isValid()) {
+                q->loadOlderEntries(transaction.postDate());
+            }
+        }
+    }
+
     void loadAccountCache()
     {
         accountCache.clear();
@@ -281,16 +369,331 @@ struct JournalModel::Private
         }
     }
 
+    BalanceIndexEntry balanceIndexEntry(const JournalEntry& journalEntry) const
+    {
+        BalanceIndexEntry entry;
+        entry.journalId = journalEntry.id();
+        entry.postDate = journalEntry.transaction().postDate();
+        entry.shares = journalEntry.split().shares();
+        entry.isStockSplit = journalEntry.transaction().isStockSplit();
+        entry.isCleared = (journalEntry.split().reconcileFlag() != eMyMoney::Split::State::NotReconciled);
+        return entry;
+    }
+
+    /**
+     * Recalculates the running balances of @a entries of account
+     * @a accountId starting at position @a startPos using the balances
+     * stored in the entry before @a startPos as starting point. The first
+     * entry starts with the balances of the entries not kept in memory.
+     */
+    void recalculateBalanceIndex(const QString& accountId, BalanceIndex& entries, int startPos) const
+    {
+        MyMoneyMoney balance;
+        MyMoneyMoney clearedBalance;
+        if (startPos > 0) {
+            balance = entries.at(startPos-1).balance;
+            clearedBalance = entries.at(startPos-1).clearedBalance;
+        } else {
+            const auto it = history.constFind(accountId);
+            if (it != history.constEnd()) {
+                balance = (*it).balance;
+                clearedBalance = (*it).clearedBalance;
+            }
+        }
+        const auto count = entries.count();
+        for (int pos = startPos; pos < count; ++pos) {
+            auto& entry = entries[pos];
+            if (Q_UNLIKELY(entry.isStockSplit)) {
+                balance *= entry.shares;
+                if (entry.isCleared) {
+                    clearedBalance *= entry.shares;
+                }
+            } else {
+                balance += entry.shares;
+                if (entry.isCleared) {
+                    clearedBalance += entry.shares;
+                }
+            }
+            entry.balance = balance;
+            entry.clearedBalance = clearedBalance;
+        }
+    }
+
+    void buildBalanceIndex()
+    {
+        balanceIndex.clear();
+        balanceIndexRecalc.clear();
+
+        // the journal is sorted, so we simply append
+        const int rows = q->rowCount();
+        for (int row = 0; row < rows; ++row) {
+            const JournalEntry& journalEntry = q->constItemAt(row);
+            balanceIndex[journalEntry.split().accountId()].append(balanceIndexEntry(journalEntry));
+        }
+
+        for (auto it = balanceIndex.begin(); it != balanceIndex.end(); ++it) {
+            recalculateBalanceIndex(it.key(), *it, 0);
+        }
+        balanceIndexValid = true;
+    }
+
+    void invalidateBalanceIndex()
+    {
+        balanceIndex.clear();
+        balanceIndexRecalc.clear();
+        balanceIndexValid = false;
+    }
+
+    /**
+     * Returns the position of the first entry in @a entries which
+     * has a journalId equal or higher than @a journalId.
+     */
+    int balanceIndexLowerBound(const BalanceIndex& entries, const QString& journalId) const
+    {
+        const auto it = std::lower_bound(entries.constBegin(), entries.constEnd(), journalId, [&](const BalanceIndexEntry& entry, const QString& id) {
+            return entry.journalId < id;
+        });
+        return static_cast<int>(it - entries.constBegin());
+    }
+
+    /**
+     * Returns the position of the first entry in @a entries which
+     * has been posted after @a date.
+     */
+    int balanceIndexUpperBound(const BalanceIndex& entries, const QDate& date) const
+    {
+        const auto it = std::upper_bound(entries.constBegin(), entries.constEnd(), date, [&](const QDate& dt, const BalanceIndexEntry& entry) {
+            return dt < entry.postDate;
+        });
+        return static_cast<int>(it - entries.constBegin());
+    }
+
+    void markBalanceIndexForRecalc(const QString& accountId, int pos)
+    {
+        auto it = balanceIndexRecalc.find(accountId);
+        if (it == balanceIndexRecalc.end()) {
+            balanceIndexRecalc.insert(accountId, pos);
+        } else if (pos < *it) {
+            *it = pos;
+        }
+    }
+
+    void addToBalanceIndex(const JournalEntry& journalEntry)
+    {
+        if (!balanceIndexValid) {
+            return;
+        }
+        auto& entries = balanceIndex[journalEntry.split().accountId()];
+        const auto pos = balanceIndexLowerBound(entries, journalEntry.id());
+        entries.insert(pos, balanceIndexEntry(journalEntry));
+        markBalanceIndexForRecalc(journalEntry.split().accountId(), pos);
+    }
+
+    void removeFromBalanceIndex(const JournalEntry& journalEntry)
+    {
+        if (!balanceIndexValid) {
+            return;
+        }
+        auto it = balanceIndex.find(journalEntry.split().accountId());
+        if (it != balanceIndex.end()) {
+            const auto pos = balanceIndexLowerBound(*it, journalEntry.id());
+            if ((pos < (*it).count()) && ((*it).at(pos).journalId == journalEntry.id())) {
+                (*it).remove(pos);
+                markBalanceIndexForRecalc(journalEntry.split().accountId(), pos);
+            }
+        }
+    }
+
+    /**
+     * Returns the range [@a first, @a last) of @a entries which
+     * contains the ids between @a fromKey (inclusive) and
+     * @a toKey (exclusive). An empty key does not limit the range.
+     */
+    void postingListRange(const QVector<QString>& entries, const QString& fromKey, const QString& toKey, int& first, int& last) const
+    {
+        first = fromKey.isEmpty() ? 0 : static_cast<int>(std::lower_bound(entries.constBegin(), entries.constEnd(), fromKey) - entries.constBegin());
+        last = toKey.isEmpty() ? entries.count() : static_cast<int>(std::lower_bound(entries.constBegin(), entries.constEnd(), toKey) - entries.constBegin());
+    }
+
+    void buildPostingIndex()
+    {
+        payeeIndex.clear();
+        tagIndex.clear();
+
+        // the journal is sorted, so we simply append
+        const int rows = q->rowCount();
+        for (int row = 0; row < rows; ++row) {
+            const JournalEntry& journalEntry = q->constItemAt(row);
+            const auto& split = journalEntry.split();
+            if (!split.payeeId().isEmpty()) {
+                payeeIndex[split.payeeId()].append(journalEntry.id());
+            }
+            for (const auto& tagId : split.tagIdList()) {
+                tagIndex[tagId].append(journalEntry.id());
+            }
+        }
+        postingIndexValid = true;
+    }
+
+    void invalidatePostingIndex()
+    {
+        payeeIndex.clear();
+        tagIndex.clear();
+        postingIndexValid = false;
+    }
+
+    static void addToPostingList(QHash<QString, QVector<QString>>& index, const QString& key, const QString& journalId)
+    {
+        auto& entries = index[key];
+        entries.insert(std::lower_bound(entries.begin(), entries.end(), journalId), journalId);
+    }
+
+    static void removeFromPostingList(QHash<QString, QVector<QString>>& index, const QString& key, const QString& journalId)
+    {
+        auto it = index.find(key);
+        if (it != index.end()) {
+            const auto entryIt = std::lower_bound((*it).begin(), (*it).end(), journalId);
+            if ((entryIt != (*it).end()) && (*entryIt == journalId)) {
+                (*it).erase(entryIt);
+                if ((*it).isEmpty()) {
+                    index.erase(it);
+                }
+            }
+        }
+    }
+
+    void addToPostingIndex(const JournalEntry& journalEntry)
+    {
+        if (!postingIndexValid) {
+            return;
+        }
+        const auto& split = journalEntry.split();
+        if (!split.payeeId().isEmpty()) {
+            addToPostingList(payeeIndex, split.payeeId(), journalEntry.id());
+        }
+        for (const auto& tagId : split.tagIdList()) {
+            addToPostingList(tagIndex, tagId, journalEntry.id());
+        }
+    }
+
+    void removeFromPostingIndex(const JournalEntry& journalEntry)
+    {
+        if (!postingIndexValid) {
+            return;
+        }
+        const auto& split = journalEntry.split();
+        if (!split.payeeId().isEmpty()) {
+            removeFromPostingList(payeeIndex, split.payeeId(), journalEntry.id());
+        }
+        for (const auto& tagId : split.tagIdList()) {
+            removeFromPostingList(tagIndex, tagId, journalEntry.id());
+        }
+    }
+
+    /**
+     * The numbers used by the splits of an account. @a transactions
+     * contains the ids of the transactions using a number, once for
+     * each split. @a values contains the numbers by their numeric
+     * value, non-numeric numbers have a value of 0.
+     */
+    struct NumberIndex {
+        QHash<QString, QVector<QString>> transactions;
+        QMap<quint64, QStringList> values;
+    };
+
+    void buildNumberIndex()
+    {
+        numberIndex.clear();
+        numberIndexValid = true;
+        const int rows = q->rowCount();
+        for (int row = 0; row < rows; ++row) {
+            addToNumberIndex(q->constItemAt(row));
+        }
+    }
+
+    void invalidateNumberIndex()
+    {
+        numberIndex.clear();
+        numberIndexValid = false;
+    }
+
+    void addToNumberIndex(const JournalEntry& journalEntry)
+    {
+        if (!numberIndexValid) {
+            return;
+        }
+        const auto& split = journalEntry.split();
+        const auto& number = split.number();
+        if (!number.isEmpty()) {
+            auto& index = numberIndex[split.accountId()];
+            index.transactions[number].append(journalEntry.transaction().id());
+            index.values[number.toULongLong()].append(number);
+        }
+    }
+
+    void removeFromNumberIndex(const JournalEntry& journalEntry)
+    {
+        if (!numberIndexValid) {
+            return;
+        }
+        const auto& split = journalEntry.split();
+        const auto& number = split.number();
+        if (number.isEmpty()) {
+            return;
+        }
+        auto indexIt = numberIndex.find(split.accountId());
+        if (indexIt == numberIndex.end()) {
+            return;
+        }
+        auto transactionsIt = (*indexIt).transactions.find(number);
+        if (transactionsIt != (*indexIt).transactions.end()) {
+            (*transactionsIt).removeOne(journalEntry.transaction().id());
+            if ((*transactionsIt).isEmpty()) {
+                (*indexIt).transactions.erase(transactionsIt);
+            }
+        }
+        auto valuesIt = (*indexIt).values.find(number.toULongLong());
+        if (valuesIt != (*indexIt).values.end()) {
+            (*valuesIt).removeOne(number);
+            if ((*valuesIt).isEmpty()) {
+                (*indexIt).values.erase(valuesIt);
+            }
+        }
+        if ((*indexIt).transactions.isEmpty()) {
+            numberIndex.erase(indexIt);
+        }
+    }
+
+    void finishBalanceIndexOperation()
+    {
+        for (auto it = balanceIndexRecalc.constBegin(); it != balanceIndexRecalc.constEnd(); ++it) {
+            auto entryIt = balanceIndex.find(it.key());
+            if (entryIt != balanceIndex.end()) {
+                if ((*entryIt).isEmpty()) {
+                    balanceIndex.erase(entryIt);
+                } else {
+                    recalculateBalanceIndex(it.key(), *entryIt, qMin(it.value(), (*entryIt).count()));
+                }
+            }
+        }
+        balanceIndexRecalc.clear();
+    }
+
     void startBalanceCacheOperation()
     {
         balanceChangedSet.clear();
         fullBalanceRecalc.clear();
+        balanceIndexRecalc.clear();
     }
 
     void removeTransactionFromBalance(int startRow, int rows)
     {
         for (int row = 0; row < rows; ++row)  {
-            const auto journalEntry = static_cast<TreeItem<JournalEntry>*>(q->index(startRow, 0).internalPointer())->constDataRef();
+            const auto& journalEntry = q->constItemAt(startRow);
+            removeFromBalanceIndex(journalEntry);
+            removeFromPostingIndex(journalEntry);
+            removeFromNumberIndex(journalEntry);
+            investmentLedger.remove(journalEntry.split().accountId());
             balanceChangedSet.insert(journalEntry.split().accountId());
             if (Q_UNLIKELY(journalEntry.transaction().isStockSplit())) {
                 fullBalanceRecalc.insert(journalEntry.split().accountId());
@@ -304,7 +707,11 @@ struct JournalModel::Private
     void addTransactionToBalance(int startRow, int rows)
     {
         for (int row = 0; row < rows; ++row)  {
-            const auto journalEntry = static_cast<TreeItem<JournalEntry>*>(q->index(startRow, 0).internalPointer())->constDataRef();
+            const auto& journalEntry = q->constItemAt(startRow);
+            addToBalanceIndex(journalEntry);
+            addToPostingIndex(journalEntry);
+            addToNumberIndex(journalEntry);
+            investmentLedger.remove(journalEntry.split().accountId());
             balanceChangedSet.insert(journalEntry.split().accountId());
             if (Q_UNLIKELY(journalEntry.transaction().isStockSplit())) {
                 fullBalanceRecalc.insert(journalEntry.split().accountId());
@@ -317,14 +724,16 @@ struct JournalModel::Private
 
     void finishBalanceCacheOperation()
     {
+        finishBalanceIndexOperation();
+
         if (!fullBalanceRecalc.isEmpty()) {
             const auto journalRows = q->rowCount();
             for (const auto& accountId : qAsConst(fullBalanceRecalc)) {
-                balanceCache[accountId] = MyMoneyMoney();
+                balanceCache[accountId] = history.value(accountId).balance;
             }
 
             for (int row = 0; row < journalRows; ++row) {
-                const JournalEntry& journalEntry = static_cast<TreeItem<JournalEntry>*>(q->index(row, 0).internalPointer())->constDataRef();
+                const JournalEntry& journalEntry = q->constItemAt(row);
                 if (fullBalanceRecalc.contains(journalEntry.split().accountId())) {
                     if (journalEntry.transaction().isStockSplit()) {
                         balanceCache[journalEntry.split().accountId()] *= journalEntry.split().shares();
@@ -341,7 +750,302 @@ struct JournalModel::Private
             balances.insert(accountId, balanceCache.value(accountId));
             emit q->balanceChanged(accountId);
         }
-        emit q->balancesChanged(balances);
+        if (balanceNotificationsDeferred) {
+            // keep only the latest balance of each account
+            for (auto it = balances.constBegin(); it != balances.constEnd(); ++it) {
+                pendingBalances.insert(it.key(), it.value());
+            }
+        } else {
+            emit q->balancesChanged(balances);
+        }
+    }
+
+    /**
+     * Determines which part of the journal needs to be checked
+     * against a MyMoneyTransactionFilter. The date range of the filter
+     * limits the rows of the journal to be scanned. In case the filter
+     * also asks for specific accounts, categories, payees or tags, the
+     * posting lists of the most selective criterion provide the ids
+     * of the candidate journal entries instead. Each of the criteria is
+     * necessary for a match, so the candidates of any of them contain
+     * all matching transactions.
+     */
+    QueryPlan planQuery(const MyMoneyTransactionFilter& filter)
+    {
+        QueryPlan plan;
+        plan.endRow = q->rowCount();
+
+        QString fromKey;
+        QString toKey;
+        if (filter.filterSet().testFlag(MyMoneyTransactionFilter::dateFilterActive)) {
+            const auto fromDate = filter.fromDate();
+            const auto toDate = filter.toDate();
+            if (fromDate.isValid()) {
+                fromKey = q->keyForDate(fromDate);
+                const auto idx = q->MyMoneyModelBase::lowerBound(fromKey);
+                plan.firstRow = idx.isValid() ? idx.row() : plan.endRow;
+            }
+            if (toDate.isValid()) {
+                toKey = q->keyForDate(toDate.addDays(1));
+                const auto idx = q->MyMoneyModelBase::lowerBound(toKey);
+                if (idx.isValid()) {
+                    plan.endRow = idx.row();
+                }
+            }
+            if (plan.firstRow >= plan.endRow) {
+                plan.endRow = plan.firstRow;
+                return plan;
+            }
+        }
+
+        // collect the posting lists of each criterion and keep the
+        // one with the least number of entries in the date range
+        int bestCount = plan.endRow - plan.firstRow;
+        QVector<QPair<const QVector<QString>*, QPair<int, int>>> bestLists;
+        QVector<QPair<const BalanceIndex*, QPair<int, int>>> bestAccountLists;
+
+        auto checkAccounts = [&](const QStringList& ids) {
+            if (!balanceIndexValid) {
+                buildBalanceIndex();
+            }
+            QVector<QPair<const BalanceIndex*, QPair<int, int>>> lists;
+            int count = 0;
+            for (const auto& id : ids) {
+                const auto it = balanceIndex.constFind(id);
+                if (it != balanceIndex.constEnd()) {
+                    const auto first = fromKey.isEmpty() ? 0 : balanceIndexLowerBound(*it, fromKey);
+                    const auto last = toKey.isEmpty() ? (*it).count() : balanceIndexLowerBound(*it, toKey);
+                    if (first < last) {
+                        lists.append(qMakePair(&(*it), qMakePair(first, last)));
+                        count += last - first;
+                    }
+                }
+            }
+            if (count < bestCount) {
+                bestCount = count;
+                bestAccountLists = lists;
+                bestLists.clear();
+            }
+        };
+
+        auto checkPostings = [&](const QHash<QString, QVector<QString>>& index, const QStringList& ids) {
+            QVector<QPair<const QVector<QString>*, QPair<int, int>>> lists;
+            int count = 0;
+            for (const auto& id : ids) {
+                const auto it = index.constFind(id);
+                if (it != index.constEnd()) {
+                    int first, last;
+                    postingListRange(*it, fromKey, toKey, first, last);
+                    if (first < last) {
+                        lists.append(qMakePair(&(*it), qMakePair(first, last)));
+                        count += last - first;
+                    }
+                }
+            }
+            if (count < bestCount) {
+                bestCount = count;
+                bestLists = lists;
+                bestAccountLists.clear();
+            }
+        };
+
+        bool usePostings = false;
+        QStringList accountIds;
+        if (filter.accounts(accountIds)) {
+            // without accounts in the list, nothing matches
+            if (accountIds.isEmpty()) {
+                plan.endRow = plan.firstRow;
+                return plan;
+            }
+            checkAccounts(accountIds);
+            usePostings = true;
+        }
+        // an empty list searches for transactions without category
+        QStringList categoryIds;
+        if (filter.categories(categoryIds) && !categoryIds.isEmpty()) {
+            checkAccounts(categoryIds);
+            usePostings = true;
+        }
+        QStringList payeeIds;
+        QStringList tagIds;
+        const auto checkPayees = filter.payees(payeeIds) && !payeeIds.isEmpty();
+        const auto checkTags = filter.tags(tagIds) && !tagIds.isEmpty();
+        if (checkPayees || checkTags) {
+            if (!postingIndexValid) {
+                buildPostingIndex();
+            }
+            if (checkPayees) {
+                checkPostings(payeeIndex, payeeIds);
+            }
+            if (checkTags) {
+                checkPostings(tagIndex, tagIds);
+            }
+            usePostings = true;
+        }
+
+        if (!usePostings || (bestCount >= plan.endRow - plan.firstRow)) {
+            return plan;
+        }
+
+        plan.useCandidates = true;
+        plan.candidates.reserve(bestCount);
+        for (const auto& list : qAsConst(bestAccountLists)) {
+            for (int i = list.second.first; i < list.second.second; ++i) {
+                plan.candidates.append(list.first->at(i).journalId);
+            }
+        }
+        for (const auto& list : qAsConst(bestLists)) {
+            for (int i = list.second.first; i < list.second.second; ++i) {
+                plan.candidates.append(list.first->at(i));
+            }
+        }
+        // bring the entries of multiple lists in journal order
+        std::sort(plan.candidates.begin(), plan.candidates.end());
+        return plan;
+    }
+
+    /**
+     * Calls @a func for each transaction selected by @a plan
+     * exactly once and in journal order.
+     */
+    template<typename Func>
+    void forEachTransaction(const QueryPlan& plan, Func func) const
+    {
+        if (plan.useCandidates) {
+            // the entries of a transaction are adjacent in the sorted list
+            const MyMoneyTransaction* lastTransaction = nullptr;
+            for (const auto& journalId : plan.candidates) {
+                const auto idx = q->indexById(journalId);
+                if (idx.isValid()) {
+                    const auto& transaction = q->constItemAt(idx.row()).transaction();
+                    if (&transaction != lastTransaction) {
+                        lastTransaction = &transaction;
+                        func(transaction);
+                    }
+                }
+            }
+        } else {
+            for (int row = plan.firstRow; row < plan.endRow;) {
+                const auto& transaction = q->constItemAt(row).transaction();
+                func(transaction);
+                row += transaction.splitCount();
+            }
+        }
+    }
+
+    /**
+     * Evaluates @a filter for each transaction selected by @a plan by
+     * calling @a evaluate with the filter, the transaction and @a list.
+     * The results are appended to @a list in journal order.
+     *
+     * Large sets of candidates are split into chunks which are evaluated
+     * using MyMoneyUtils::forEachParallel(). Since MyMoneyTransactionFilter
+     * keeps state while matching, each chunk uses its own copy of the
+     * filter which looks up the accounts in a snapshot of the accounts
+     * model instead of MyMoneyFile. Text filters need access to payees,
+     * tags and securities in MyMoneyFile and are always evaluated in
+     * the calling thread.
+     */
+    template<typename Result, typename Func>
+    void evaluateQuery(const QueryPlan& plan, MyMoneyTransactionFilter& filter, QList<Result>& list, Func evaluate)
+    {
+        QVector<const MyMoneyTransaction*> transactions;
+        const auto canRunParallel = (parallelEvaluationThreshold < std::numeric_limits<int>::max()) && !filter.filterSet().testFlag(MyMoneyTransactionFilter::textFilterActive);
+        if (canRunParallel) {
+            forEachTransaction(plan, [&](const MyMoneyTransaction& transaction) {
+                transactions.append(&transaction);
+            });
+        }
+
+        if (transactions.isEmpty() || transactions.count() < parallelEvaluationThreshold) {
+            if (transactions.isEmpty()) {
+                forEachTransaction(plan, [&](const MyMoneyTransaction& transaction) {
+                    evaluate(filter, transaction, list);
+                });
+            } else {
+                for (const auto transaction : qAsConst(transactions)) {
+                    evaluate(filter, *transaction, list);
+                }
+            }
+            return;
+        }
+
+        auto accounts = QSharedPointer<QHash<QString, MyMoneyAccount>>::create();
+        const auto accountList = MyMoneyFile::instance()->accountsModel()->itemList();
+        accounts->reserve(accountList.count());
+        for (const auto& account : accountList) {
+            accounts->insert(account.id(), account);
+        }
+
+        struct Chunk {
+            int                         first;
+            int                         last;
+            MyMoneyTransactionFilter    filter;
+            QList<Result>               result;
+        };
+
+        // use more chunks than threads so that uneven chunks even out
+        const auto chunkCount = qMax(QThread::idealThreadCount(), 1) * 4;
+        const auto chunkSize = (transactions.count() + chunkCount - 1) / chunkCount;
+        QVector<Chunk> chunks;
+        chunks.reserve(chunkCount);
+        for (int first = 0; first < transactions.count(); first += chunkSize) {
+            Chunk chunk { first, qMin(first + chunkSize, transactions.count()), filter, QList<Result>() };
+            chunk.filter.setAccountSnapshot(accounts);
+            chunks.append(chunk);
+        }
+
+        MyMoneyUtils::forEachParallel(chunks, [&transactions, evaluate](Chunk& chunk) {
+            for (int i = chunk.first; i < chunk.last; ++i) {
+                evaluate(chunk.filter, *transactions.at(i), chunk.result);
+            }
+        });
+
+        for (const auto& chunk : qAsConst(chunks)) {
+            list += chunk.result;
+        }
+    }
+
+    /**
+     * Returns the copy of @a str kept in the string pool. This way the
+     * ids and actions which are repeated in many splits share a single
+     * allocation instead of each split keeping its own.
+     */
+    QString internString(const QString& str)
+    {
+        if (str.isEmpty()) {
+            return str;
+        }
+        auto it = stringPool.constFind(str);
+        if (it == stringPool.constEnd()) {
+            it = stringPool.insert(str);
+        }
+        return *it;
+    }
+
+    /**
+     * Replaces the strings of the splits of @a transaction with
+     * their pooled copies before it is added to the journal.
+     */
+    void internStrings(MyMoneyTransaction& transaction)
+    {
+        const auto transactionId = transaction.id();
+        for (auto& split : transaction.splits()) {
+            split.setAccountId(internString(split.accountId()));
+            split.setPayeeId(internString(split.payeeId()));
+            split.setCostCenterId(internString(split.costCenterId()));
+            split.setAction(internString(split.action()));
+            if (!split.tagIdList().isEmpty()) {
+                auto tagIdList = split.tagIdList();
+                for (auto& tagId : tagIdList) {
+                    tagId = internString(tagId);
+                }
+                split.setTagIdList(tagIdList);
+            }
+            if (split.transactionId() == transactionId) {
+                split.setTransactionId(transactionId);
+            }
+        }
     }
 
     QString formatValue(const MyMoneyTransaction& t, const MyMoneySplit& s, const MyMoneyMoney& factor = MyMoneyMoney::ONE)
@@ -365,6 +1069,37 @@ struct JournalModel::Private
     QHash<QString, MyMoneyAccount>  accountCache;
     QSet<QString>                   fullBalanceRecalc;
     QSet<QString>                   balanceChangedSet;
+    QHash<QString, BalanceIndex>    balanceIndex;
+    QHash<QString, int>             balanceIndexRecalc;
+    bool                            balanceIndexValid;
+    QHash<QString, QVector<QString>> payeeIndex;
+    QHash<QString, QVector<QString>> tagIndex;
+    bool                            postingIndexValid;
+    QHash<QString, NumberIndex>     numberIndex;
+    bool                            numberIndexValid;
+    /**
+     * The activities of the stock accounts built by
+     * JournalModel::investmentActivities() on demand
+     */
+    QHash<QString, QVector<JournalModel::InvestmentActivity>> investmentLedger;
+    bool                            balanceNotificationsDeferred;
+    QHash<QString, MyMoneyMoney>    pendingBalances;
+    /**
+     * The minimum number of candidate transactions
+     * to evaluate a filter using the thread pool
+     */
+    int                             parallelEvaluationThreshold;
+    QSet<QString>                   stringPool;
+
+    /**
+     * In case the journal is loaded partially, @a loader provides
+     * access to the transactions posted before @a firstLoadedDate
+     * and @a history contains their summary per account.
+     */
+    QSharedPointer<JournalLoader>   loader;
+    QDate                           firstLoadedDate;
+    QHash<QString, JournalLoader::AccountHistory> history;
+    unsigned int                    historyTransactionCount;
 };
 
 JournalModelNewTransaction::JournalModelNewTransaction(QObject* parent)
@@ -879,6 +1614,15 @@ void JournalModel::load(const QMap<QString, MyMoneyTransaction>& list)
     beginResetModel();
     // first get rid of any existing entries
     clearModelItems();
+    d->invalidateBalanceIndex();
+    d->invalidatePostingIndex();
+    d->invalidateNumberIndex();
+    d->investmentLedger.clear();
+    d->stringPool.clear();
+    d->loader.clear();
+    d->firstLoadedDate = QDate();
+    d->history.clear();
+    d->historyTransactionCount = 0;
 
     // create the number of required items
     int itemCount = 0;
@@ -896,8 +1640,10 @@ void JournalModel::load(const QMap<QString, MyMoneyTransaction>& list)
         updateNextObjectId(id);
         d->addIdKeyMapping(id, it.key());
         auto transaction = QSharedPointer<MyMoneyTransaction>(new MyMoneyTransaction(*it));
+        d->internStrings(*transaction);
+        int splitIndex = 0;
         for (const auto& split : (*transaction).splits()) {
-            const JournalEntry journalEntry(QString("%1-%2").arg(it.key(), split.id()), transaction, split);
+            const JournalEntry journalEntry(QString("%1-%2").arg(it.key(), split.id()), transaction, splitIndex++);
             const auto newIdx = index(row, 0);
             static_cast<TreeItem<JournalEntry>*>(newIdx.internalPointer())->dataRef() = journalEntry;
             if (m_idToItemMapper) {
@@ -916,17 +1662,147 @@ void JournalModel::load(const QMap<QString, MyMoneyTransaction>& list)
     qDebug() << "Model for" << m_idLeadin << "loaded with" << rowCount() << "items in" << t.elapsed() << "ms";
 }
 
+void JournalModel::loadPartial(const QMap<QString, MyMoneyTransaction>& list, const QDate& firstDate, QSharedPointer<JournalLoader> loader)
+{
+    load(list);
+
+    if (loader && firstDate.isValid()) {
+        d->loader = loader;
+        d->firstLoadedDate = firstDate;
+        d->history = loader->history(firstDate);
+        d->historyTransactionCount = loader->transactionCount(firstDate);
+        // new transactions must not reuse the id of one not kept in memory
+        updateNextObjectId(loader->lastTransactionId());
+    }
+}
+
 void JournalModel::unload()
 {
     d->balanceCache.clear();
     d->accountCache.clear();
     d->transactionIdKeyMap.clear();
+    d->invalidateBalanceIndex();
+    d->invalidatePostingIndex();
+    d->invalidateNumberIndex();
+    d->investmentLedger.clear();
+    d->pendingBalances.clear();
+    d->stringPool.clear();
+    d->loader.clear();
+    d->firstLoadedDate = QDate();
+    d->history.clear();
+    d->historyTransactionCount = 0;
     MyMoneyModel::unload();
 }
 
+QDate JournalModel::firstLoadedDate() const
+{
+    return d->firstLoadedDate;
+}
+
+void JournalModel::loadOlderEntries(const QDate& date)
+{
+    if (!d->loader || (date.isValid() && (date >= d->firstLoadedDate))) {
+        return;
+    }
+
+    QElapsedTimer t;
+    t.start();
+
+    const auto list = d->loader->transactions(date, d->firstLoadedDate);
+
+    // transactions added with an old post date have been loaded
+    // in advance (see addTransaction()) and are skipped here
+    QVector<TreeItem<JournalEntry>*> items;
+    QMap<QString, MyMoneyTransaction>::const_iterator it;
+    for (it = list.constBegin(); it != list.constEnd(); ++it) {
+        const QString& id = (*it).id();
+        if (d->transactionIdKeyMap.contains(id)) {
+            continue;
+        }
+        updateNextObjectId(id);
+        d->addIdKeyMapping(id, it.key());
+        auto transaction = QSharedPointer<MyMoneyTransaction>(new MyMoneyTransaction(*it));
+        d->internStrings(*transaction);
+        int splitIndex = 0;
+        for (const auto& split : (*transaction).splits()) {
+            items.append(new TreeItem<JournalEntry>(JournalEntry(QString("%1-%2").arg(it.key(), split.id()), transaction, splitIndex++), m_rootItem));
+        }
+        addReferences((*transaction).referencedObjects());
+    }
+
+    if (date.isValid()) {
+        d->firstLoadedDate = date;
+        d->history = d->loader->history(date);
+        d->historyTransactionCount = d->loader->transactionCount(date);
+    } else {
+        // the journal is complete now so we don't need the loader anymore
+        d->loader.clear();
+        d->firstLoadedDate = QDate();
+        d->history.clear();
+        d->historyTransactionCount = 0;
+    }
+
+    if (!items.isEmpty()) {
+        // all entries are older than the ones we have so far
+        beginInsertRows(QModelIndex(), 0, items.count() - 1);
+        m_rootItem->insertChildren(0, items);
+        if (m_idToItemMapper) {
+            for (const auto& item : qAsConst(items)) {
+                m_idToItemMapper->insert(item->constDataRef().id(), item);
+            }
+        }
+        endInsertRows();
+    }
+
+    // the running balances need to be rebuilt based on the new history,
+    // the current balances are not affected by paging in older entries
+    d->invalidateBalanceIndex();
+    d->invalidatePostingIndex();
+    d->invalidateNumberIndex();
+    d->investmentLedger.clear();
+
+    qDebug() << "Loaded" << items.count() << "older journal entries for" << m_idLeadin << "in" << t.elapsed() << "ms";
+}
+
+MyMoneyMoney JournalModel::openingBalance(const QString& accountId) const
+{
+    return d->history.value(accountId).balance;
+}
+
+void JournalModel::doUpdateReferencedObjects()
+{
+    // all entries of a transaction share the same references,
+    // so they are counted only once per transaction
+    m_referenceCount.clear();
+    forEachItem([&](const JournalEntry& entry) {
+        if (entry.m_splitIndex == 0) {
+            addReferences(entry.referencedObjects());
+        }
+    });
+}
+
+bool JournalModel::hasReferenceTo(const QString& id) const
+{
+    if (MyMoneyModel::hasReferenceTo(id)) {
+        return true;
+    }
+    // references in transactions not kept in memory are checked by the storage
+    return d->loader && d->loader->hasReferenceTo(id, d->firstLoadedDate);
+}
+
 MyMoneyTransaction JournalModel::transactionById(const QString& id) const
 {
     const QModelIndex idx = firstIndexById(id);
+    if (!idx.isValid() && d->loader && !id.isEmpty()) {
+        // the transaction may not be kept in memory. Those posted on or after
+        // the first loaded date are all in memory, so a stored one with such
+        // a date has been removed in the meantime.
+        const auto transaction = d->loader->transaction(id);
+        if (transaction.postDate().isValid() && (transaction.postDate() < d->firstLoadedDate)) {
+            return transaction;
+        }
+        return {};
+    }
     if (idx.isValid()) {
         return static_cast<TreeItem<JournalEntry>*>(idx.internalPointer())->constDataRef().transaction();
     }
@@ -956,10 +1832,12 @@ QModelIndex JournalModel::firstIndexById(const QString& id) const
 QModelIndexList JournalModel::indexesByTransactionId(const QString& id) const
 {
     QModelIndexList indexes;
-    QModelIndex idx = firstIndexById(id);
-    while (idx.isValid() && (idx.data(eMyMoney::Model::JournalTransactionIdRole).toString() == id)) {
-        indexes.append(idx);
-        idx = index(idx.row()+1, 0);
+    const QModelIndex idx = firstIndexById(id);
+    if (idx.isValid()) {
+        const auto rows = rowCount();
+        for (int row = idx.row(); (row < rows) && (constItemAt(row).transaction().id() == id); ++row) {
+            indexes.append(index(row, 0));
+        }
     }
     return indexes;
 }
@@ -971,9 +1849,13 @@ QString JournalModel::keyForDate(const QDate& date) const
 
 void JournalModel::addTransaction(MyMoneyTransaction& item)
 {
+    // make sure the entries around the new one are in memory
+    if (item.postDate().isValid()) {
+        loadOlderEntries(item.postDate());
+    }
     item = MyMoneyTransaction(nextId(), item);
     auto transaction = QSharedPointer<MyMoneyTransaction>(new MyMoneyTransaction(item));
-    JournalEntry entry(QString(), transaction, MyMoneySplit());
+    JournalEntry entry(QString(), transaction, -1);
 
     m_undoStack->push(new UndoCommand(this, JournalEntry(), entry));
 }
@@ -982,6 +1864,7 @@ void JournalModel::doAddItem(const JournalEntry& item, const QModelIndex& parent
 {
     Q_UNUSED(parentIdx);
     auto transaction = item.sharedtransactionPtr();
+    d->internStrings(*transaction);
     QString key = (*transaction).uniqueSortKey();
 
     // add mapping
@@ -1003,8 +1886,9 @@ void JournalModel::doAddItem(const JournalEntry& item, const QModelIndex& parent
     d->startBalanceCacheOperation();
 
     const auto originalStartRow = startRow;
+    int splitIndex = 0;
     for (const auto& split : (*transaction).splits()) {
-        const JournalEntry journalEntry(QString("%1-%2").arg(key, split.id()), transaction, split);
+        const JournalEntry journalEntry(QString("%1-%2").arg(key, split.id()), transaction, splitIndex++);
         const auto newIdx = index(startRow, 0);
         static_cast<TreeItem<JournalEntry>*>(newIdx.internalPointer())->dataRef() = journalEntry;
         if (m_idToItemMapper) {
@@ -1016,6 +1900,7 @@ void JournalModel::doAddItem(const JournalEntry& item, const QModelIndex& parent
 
     // add the splits to the balance cache
     d->addTransactionToBalance(originalStartRow, rows);
+    addReferences((*transaction).referencedObjects());
 
     emit dataChanged(startIdx, endIdx);
 
@@ -1025,6 +1910,7 @@ void JournalModel::doAddItem(const JournalEntry& item, const QModelIndex& parent
 
 void JournalModel::removeTransaction(const MyMoneyTransaction& item)
 {
+    d->loadTransaction(item.id());
     const auto idx = firstIndexById(item.id());
     if (idx.isValid()) {
         const auto currentItem = static_cast<TreeItem<JournalEntry>*>(idx.internalPointer())->constDataRef();
@@ -1038,6 +1924,7 @@ void JournalModel::doRemoveItem(const JournalEntry& before)
     const auto& transaction = before.transaction();
     const auto idx = firstIndexById(transaction.id());
     const auto rows = transaction.splitCount();
+    removeReferences(static_cast<TreeItem<JournalEntry>*>(idx.internalPointer())->constDataRef().transaction().referencedObjects());
     d->startBalanceCacheOperation();
     d->removeTransactionFromBalance(idx.row(), rows);
 
@@ -1051,10 +1938,15 @@ void JournalModel::doRemoveItem(const JournalEntry& before)
 
 void JournalModel::modifyTransaction(const MyMoneyTransaction& newTransaction)
 {
+    if (newTransaction.postDate().isValid()) {
+        loadOlderEntries(newTransaction.postDate());
+    }
+    // the stored version may be older than the new one
+    d->loadTransaction(newTransaction.id());
     const auto idx = firstIndexById(newTransaction.id());
     if (idx.isValid()) {
         auto transaction = QSharedPointer<MyMoneyTransaction>(new MyMoneyTransaction(newTransaction));
-        JournalEntry entry(QString(), transaction, MyMoneySplit());
+        JournalEntry entry(QString(), transaction, -1);
 
         const auto currentItem = static_cast<TreeItem<JournalEntry>*>(idx.internalPointer())->constDataRef();
         m_undoStack->push(new UndoCommand(this, currentItem, entry));
@@ -1081,6 +1973,8 @@ void JournalModel::doModifyItem(const JournalEntry& before, const JournalEntry&
 
     d->startBalanceCacheOperation();
     d->removeTransactionFromBalance(srcIdx.row(), oldSplitCount);
+    removeReferences(oldTransaction.referencedObjects());
+    addReferences(newTransaction.referencedObjects());
 
     // we have to deal with several cases here. The first differentiation
     // is the unique key. It remains the same as long as the postDate()
@@ -1109,11 +2003,13 @@ void JournalModel::doModifyItem(const JournalEntry& before, const JournalEntry&
 
     // Step 2
     auto transaction = after.sharedtransactionPtr();
+    d->internStrings(*transaction);
 
     // use the oldKey for now to keep sorting in a correct state
     int row = srcIdx.row();
+    int splitIndex = 0;
     for (const auto& split : newTransaction.splits()) {
-        const JournalEntry journalEntry(QString("%1-%2").arg(oldKey, split.id()), transaction, split);
+        const JournalEntry journalEntry(QString("%1-%2").arg(oldKey, split.id()), transaction, splitIndex++);
         const auto newIdx = index(row, 0);
         static_cast<TreeItem<JournalEntry>*>(newIdx.internalPointer())->dataRef() = journalEntry;
         if (m_idToItemMapper) {
@@ -1142,15 +2038,13 @@ void JournalModel::doModifyItem(const JournalEntry& before, const JournalEntry&
 
             // take the items out of their old location
             // and update the key (kept in their m_id)
-            QVector<TreeItem<JournalEntry>*> entries;
             const int srcRow = srcIdx.row();
-            for (int rows = newSplitCount; rows > 0; --rows) {
-                auto journalEntry = m_rootItem->takeChild(srcRow);
+            const auto entries = m_rootItem->takeChildren(srcRow, newSplitCount);
+            for (const auto& journalEntry : entries) {
                 if (m_idToItemMapper) {
                     m_idToItemMapper->remove(journalEntry->dataRef().m_id);
                 }
-                journalEntry->dataRef().m_id = QString("%1-%2").arg(newKey, journalEntry->constDataRef().m_split.id());
-                entries.append(journalEntry);
+                journalEntry->dataRef().m_id = QString("%1-%2").arg(newKey, journalEntry->constDataRef().split().id());
             }
             // check if the destination row must be adjusted
             // since we removed the splits already
@@ -1164,8 +2058,8 @@ void JournalModel::doModifyItem(const JournalEntry& before, const JournalEntry&
             if (m_idToItemMapper) {
                 const int lastRow = destRow + entries.count() - 1;
                 for (row = destRow; row <= lastRow; ++row) {
-                    const auto idx = index(row, 0);
-                    m_idToItemMapper->insert(idx.data(eMyMoney::Model::IdRole).toString(), static_cast<TreeItem<JournalEntry>*>(idx.internalPointer()));
+                    const auto item = m_rootItem->childAt(row);
+                    m_idToItemMapper->insert(item->constDataRef().id(), item);
                 }
             }
 
@@ -1194,46 +2088,207 @@ void JournalModel::doModifyItem(const JournalEntry& before, const JournalEntry&
     setDirty();
 }
 
+JournalModel::InvestmentActivity JournalModel::investmentActivity(const MyMoneyTransaction& transaction, const MyMoneySplit& split)
+{
+    MyMoneySplit assetAccountSplit;
+    QList<MyMoneySplit> feeSplits;
+    QList<MyMoneySplit> interestSplits;
+    MyMoneySecurity security;
+    MyMoneySecurity currency;
+    InvestmentActivity activity;
+    MyMoneyUtils::dissectTransaction(transaction, split, assetAccountSplit, feeSplits, interestSplits, security, currency, activity.type);
+
+    activity.postDate = transaction.postDate();
+    activity.shares = split.shares();
+    activity.value = assetAccountSplit.value();
+    for (const auto& interestSplit : qAsConst(interestSplits)) {
+        activity.interestValue += interestSplit.value();
+    }
+    return activity;
+}
+
+QVector<JournalModel::InvestmentActivity> JournalModel::investmentActivities(const QString& accountId) const
+{
+    const auto it = d->investmentLedger.constFind(accountId);
+    if (it != d->investmentLedger.constEnd()) {
+        return *it;
+    }
+
+    if (!d->balanceIndexValid) {
+        d->buildBalanceIndex();
+    }
+
+    QVector<InvestmentActivity> activities;
+
+    // the activities cover the complete history of the account,
+    // the part not kept in memory is provided by the storage
+    MyMoneyTransactionFilter filter;
+    filter.addAccount(accountId);
+    const auto olderTransactions = d->olderTransactions(filter);
+    for (const auto& transaction : olderTransactions) {
+        // the storage may return more than asked for
+        const auto splits = transaction.splits();
+        const auto split = std::find_if(splits.cbegin(), splits.cend(), [&](const MyMoneySplit& sp) {
+            return sp.accountId() == accountId;
+        });
+        if (split != splits.cend()) {
+            activities.append(investmentActivity(transaction, *split));
+        }
+    }
+
+    const auto entries = d->balanceIndex.constFind(accountId);
+    if (entries != d->balanceIndex.constEnd()) {
+        activities.reserve(activities.count() + (*entries).count());
+        // only the first split of the account in a transaction counts
+        const MyMoneyTransaction* lastTransaction = nullptr;
+        for (const auto& entry : *entries) {
+            const auto idx = indexById(entry.journalId);
+            if (idx.isValid()) {
+                const auto& journalEntry = constItemAt(idx.row());
+                if (&journalEntry.transaction() != lastTransaction) {
+                    lastTransaction = &journalEntry.transaction();
+                    activities.append(investmentActivity(journalEntry.transaction(), journalEntry.split()));
+                }
+            }
+        }
+    }
+    d->investmentLedger.insert(accountId, activities);
+    return activities;
+}
+
+bool JournalModel::isNumberUsed(const QString& accountId, const QString& number, const QString& skipTransactionId) const
+{
+    if (number.isEmpty()) {
+        return false;
+    }
+    if (!d->numberIndexValid) {
+        d->buildNumberIndex();
+    }
+    const auto indexIt = d->numberIndex.constFind(accountId);
+    if (indexIt == d->numberIndex.constEnd()) {
+        return false;
+    }
+    const auto transactionsIt = (*indexIt).transactions.constFind(number);
+    if (transactionsIt == (*indexIt).transactions.constEnd()) {
+        return false;
+    }
+    for (const auto& id : *transactionsIt) {
+        if (id != skipTransactionId) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QString JournalModel::highestNumber(const QString& accountId) const
+{
+    if (!d->numberIndexValid) {
+        d->buildNumberIndex();
+    }
+    const auto indexIt = d->numberIndex.constFind(accountId);
+    if (indexIt == d->numberIndex.constEnd() || (*indexIt).values.isEmpty()) {
+        return QString();
+    }
+    // non-numeric numbers do not count
+    const auto& values = (*indexIt).values;
+    if (values.lastKey() == 0) {
+        return QString();
+    }
+    return values.last().first();
+}
+
+QString JournalModel::nextFreeNumber(const QString& accountId, const QString& number) const
+{
+    bool ok;
+    auto value = number.toULongLong(&ok);
+    if (!ok || (value == 0) || (number != QString::number(value))) {
+        return QString();
+    }
+    if (!d->numberIndexValid) {
+        d->buildNumberIndex();
+    }
+    const auto indexIt = d->numberIndex.constFind(accountId);
+    if (indexIt == d->numberIndex.constEnd()) {
+        return number;
+    }
+    // the values are ordered, so the used numbers following
+    // the given one are found next to each other
+    const auto& values = (*indexIt).values;
+    auto valuesIt = values.constFind(value);
+    while (valuesIt != values.constEnd() && valuesIt.key() == value && (*valuesIt).contains(QString::number(value))) {
+        valuesIt = values.upperBound(value);
+        ++value;
+    }
+    return QString::number(value);
+}
+
+int JournalModel::numberCount(const QString& accountId) const
+{
+    if (!d->numberIndexValid) {
+        d->buildNumberIndex();
+    }
+    return d->numberIndex.value(accountId).transactions.count();
+}
+
 bool JournalModel::matchTransaction(const QModelIndex& idx, MyMoneyTransactionFilter& filter) const
 {
     if (idx.row() < 0 || idx.row() > rowCount() - 1)
         return false;
 
-    const auto journalEntry = static_cast<TreeItem<JournalEntry>*>(idx.internalPointer())->constDataRef();
+    const auto& journalEntry = constItemAt(idx.row());
     return filter.match(journalEntry.transaction());
 }
 
-void JournalModel::transactionList(QList<MyMoneyTransaction>& list, MyMoneyTransactionFilter& filter) const
+void JournalModel::setParallelEvaluationThreshold(int threshold)
 {
-    list.clear();
+    d->parallelEvaluationThreshold = threshold;
+}
 
-    const int rows = rowCount();
-    for (int row = 0; row < rows;) {
-        const auto journalEntry = static_cast<TreeItem<JournalEntry>*>(index(row, 0).internalPointer())->constDataRef();
-        const auto cnt = filter.matchingSplitsCount(journalEntry.transaction());
+int JournalModel::parallelEvaluationThreshold() const
+{
+    return d->parallelEvaluationThreshold;
+}
+
+void JournalModel::transactionList(QList<MyMoneyTransaction>& list, MyMoneyTransactionFilter& filter) const
+{
+    const auto evaluate = [](MyMoneyTransactionFilter& f, const MyMoneyTransaction& transaction, QList<MyMoneyTransaction>& result) {
+        const auto cnt = f.matchingSplitsCount(transaction);
         for (uint i = 0; i < cnt; ++i) {
-            list.append(journalEntry.transaction());
+            result.append(transaction);
         }
-        row += journalEntry.transaction().splitCount();
+    };
+
+    list.clear();
+    // entries not kept in memory are provided by the storage
+    const auto olderTransactions = d->olderTransactions(filter);
+    for (const auto& transaction : olderTransactions) {
+        evaluate(filter, transaction, list);
     }
+
+    // only the candidates need to be checked against the filter
+    const auto plan = d->planQuery(filter);
+    d->evaluateQuery(plan, filter, list, evaluate);
 }
 
 void JournalModel::transactionList(QList< QPair<MyMoneyTransaction, MyMoneySplit> >& list, MyMoneyTransactionFilter& filter) const
 {
-    list.clear();
-
-    const int rows = rowCount();
-    QVector<MyMoneySplit> splits;
-    for (int row = 0; row < rows; ) {
-        const JournalEntry& journalEntry = static_cast<TreeItem<JournalEntry>*>(index(row, 0).internalPointer())->constDataRef();
-        splits = filter.matchingSplits(journalEntry.transaction());
-        if (!splits.isEmpty()) {
-            for (const auto& split : qAsConst(splits)) {
-                list.append(qMakePair(journalEntry.transaction(), split));
-            }
+    const auto evaluate = [](MyMoneyTransactionFilter& f, const MyMoneyTransaction& transaction, QList<QPair<MyMoneyTransaction, MyMoneySplit>>& result) {
+        const auto splits = f.matchingSplits(transaction);
+        for (const auto& split : splits) {
+            result.append(qMakePair(transaction, split));
         }
-        row += journalEntry.transaction().splitCount();
+    };
+
+    list.clear();
+    // entries not kept in memory are provided by the storage
+    const auto olderTransactions = d->olderTransactions(filter);
+    for (const auto& transaction : olderTransactions) {
+        evaluate(filter, transaction, list);
     }
+
+    // only the candidates need to be checked against the filter
+    const auto plan = d->planQuery(filter);
+    d->evaluateQuery(plan, filter, list, evaluate);
 }
 
 unsigned int JournalModel::transactionCount(const QString& accountid) const
@@ -1241,16 +2296,14 @@ unsigned int JournalModel::transactionCount(const QString& accountid) const
     unsigned int result = 0;
 
     if (accountid.isEmpty()) {
-        result = d->transactionIdKeyMap.count();
+        result = d->transactionIdKeyMap.count() + d->historyTransactionCount;
 
     } else {
-        const int rows = rowCount();
-        for (int row = 0; row < rows; ++row) {
-            const JournalEntry& journalEntry = static_cast<TreeItem<JournalEntry>*>(index(row, 0).internalPointer())->constDataRef();
-            if (journalEntry.split().accountId() == accountid) {
-                ++result;
-            }
+        // the balance index keeps one entry per split of the account
+        if (!d->balanceIndexValid) {
+            d->buildBalanceIndex();
         }
+        result = d->history.value(accountid).splitCount + d->balanceIndex.value(accountid).count();
     }
     return result;
 }
@@ -1264,9 +2317,10 @@ QString JournalModel::updateJournalId(const QString& journalId) const
         const auto splitId = expMatch.captured(2);
         const auto indeces = indexesByTransactionId(transactionId);
         for (const auto& idx : indeces) {
-            if (idx.data(eMyMoney::Model::JournalSplitIdRole).toString() == splitId) {
-                qDebug() << "converted" << journalId << "to" << idx.data(eMyMoney::Model::IdRole).toString();
-                return idx.data(eMyMoney::Model::IdRole).toString();
+            const auto& journalEntry = constItemAt(idx.row());
+            if (journalEntry.split().id() == splitId) {
+                qDebug() << "converted" << journalId << "to" << journalEntry.id();
+                return journalEntry.id();
             }
         }
     }
@@ -1278,15 +2332,17 @@ void JournalModel::updateBalances()
     d->loadAccountCache();
 
     // calculate the balances
+    qDebug() << "Start calculating balances:" << rowCount() << "splits";
+    d->buildBalanceIndex();
+
+    // the last entry of each account in the index carries its current balance
     d->balanceCache.clear();
-    const int rows = rowCount();
-    qDebug() << "Start calculating balances:" << rows << "splits";
-    for (int row = 0; row < rows; ++row) {
-        const JournalEntry& journalEntry = static_cast<TreeItem<JournalEntry>*>(index(row, 0).internalPointer())->constDataRef();
-        if (journalEntry.transaction().isStockSplit()) {
-            d->balanceCache[journalEntry.split().accountId()] *= journalEntry.split().shares();
-        } else {
-            d->balanceCache[journalEntry.split().accountId()] += journalEntry.split().shares();
+    for (auto it = d->history.constBegin(); it != d->history.constEnd(); ++it) {
+        d->balanceCache.insert(it.key(), (*it).balance);
+    }
+    for (auto it = d->balanceIndex.constBegin(); it != d->balanceIndex.constEnd(); ++it) {
+        if (!(*it).isEmpty()) {
+            d->balanceCache.insert(it.key(), (*it).constLast().balance);
         }
     }
     qDebug() << "End calculating balances";
@@ -1295,78 +2351,67 @@ void JournalModel::updateBalances()
     emit balancesChanged(d->balanceCache);
 }
 
+void JournalModel::deferBalanceNotifications(bool defer)
+{
+    d->balanceNotificationsDeferred = defer;
+    if (!defer && !d->pendingBalances.isEmpty()) {
+        const auto balances = d->pendingBalances;
+        d->pendingBalances.clear();
+        emit balancesChanged(balances);
+    }
+}
+
 MyMoneyMoney JournalModel::clearedBalance(const QString& accountId, const QDate& date) const
 {
-    MyMoneyMoney balance;
-    const int rows = rowCount();
-    for (int row = 0; row < rows; ++row) {
-        const JournalEntry& journalEntry = static_cast<TreeItem<JournalEntry>*>(index(row, 0).internalPointer())->constDataRef();
-        const auto split(journalEntry.split());
-        if (Q_UNLIKELY(!date.isValid()) || Q_LIKELY(journalEntry.transaction().postDate() <= date)) {
-            if ((split.accountId() == accountId) && (split.reconcileFlag() != eMyMoney::Split::State::NotReconciled)) {
-                if (journalEntry.transaction().isStockSplit()) {
-                    balance *= journalEntry.split().shares();
-                } else {
-                    balance += journalEntry.split().shares();
-                }
-            }
-        }
+    // balances before the first loaded transaction are provided by the loader
+    if (d->loader && date.isValid() && (date < d->firstLoadedDate)) {
+        return d->loader->history(date.addDays(1), QStringList(accountId)).value(accountId).clearedBalance;
+    }
+
+    if (!d->balanceIndexValid) {
+        d->buildBalanceIndex();
+    }
+
+    const auto it = d->balanceIndex.constFind(accountId);
+    if (it == d->balanceIndex.constEnd() || (*it).isEmpty()) {
+        return d->history.value(accountId).clearedBalance;
+    }
+
+    if (Q_UNLIKELY(!date.isValid())) {
+        return (*it).constLast().clearedBalance;
+    }
+
+    const auto pos = d->balanceIndexUpperBound(*it, date);
+    if (pos == 0) {
+        return d->history.value(accountId).clearedBalance;
     }
-    return balance;
+    return (*it).at(pos-1).clearedBalance;
 }
 
 MyMoneyMoney JournalModel::balance(const QString& accountId, const QDate& date) const
 {
     if (date.isValid()) {
-        MyMoneyMoney balance;
-        QModelIndex lastIdx = upperBound(MyMoneyTransaction::uniqueSortKey(date, QStringLiteral("x")), 0, rowCount()-1);
-        // in case the index is invalid, we search for a data past
-        // the end of the journal, so we can simply use the cached
-        // balance if it is available. Otherwise, we have to go
-        // through the journal
-        if (lastIdx.isValid() || !d->balanceCache.contains(accountId)) {
-            // in case the entry is in the first half,
-            // we start from the beginning and go forward
-            auto lastRow = lastIdx.row();
-
-            // if the lastRow is -1 we have an invalid index which means,
-            // that the balance cache is not filled and we have to scan
-            // all journal entries.
-            if (lastRow == -1) {
-                lastRow = rowCount();
-            }
+        // balances before the first loaded transaction are provided by the loader
+        if (d->loader && (date < d->firstLoadedDate)) {
+            return d->loader->history(date.addDays(1), QStringList(accountId)).value(accountId).balance;
+        }
 
-            // invalid index or first half?
-            if (lastIdx.row() < rowCount()/2)  {
-                for (int row = 0; row < lastRow; ++row) {
-                    const JournalEntry& journalEntry = static_cast<TreeItem<JournalEntry>*>(index(row, 0).internalPointer())->constDataRef();
-                    if (journalEntry.split().accountId() == accountId) {
-                        if (journalEntry.transaction().isStockSplit()) {
-                            balance *= journalEntry.split().shares();
-                        } else {
-                            balance += journalEntry.split().shares();
-                        }
-                    }
-                }
-            } else {
-                // in case the entry is in the second half,
-                // we start at the end and go backwards
-                // This requires the balance cache to always
-                // be up-to-date
-                balance = d->balanceCache.value(accountId);
-                for (int row = rowCount()-1; row >= lastIdx.row(); --row) {
-                    const JournalEntry& journalEntry = static_cast<TreeItem<JournalEntry>*>(index(row, 0).internalPointer())->constDataRef();
-                    if (journalEntry.split().accountId() == accountId) {
-                        if (journalEntry.transaction().isStockSplit()) {
-                            balance /= journalEntry.split().shares();
-                        } else {
-                            balance -= journalEntry.split().shares();
-                        }
-                    }
-                }
-            }
-            return balance;
+        if (!d->balanceIndexValid) {
+            d->buildBalanceIndex();
+        }
+
+        // the index keeps the running balance of each account,
+        // so we only need to find the last entry posted on
+        // or before the given date
+        const auto it = d->balanceIndex.constFind(accountId);
+        if (it == d->balanceIndex.constEnd()) {
+            return d->history.value(accountId).balance;
+        }
+        const auto pos = d->balanceIndexUpperBound(*it, date);
+        if (pos == 0) {
+            return d->history.value(accountId).balance;
         }
+        return (*it).at(pos-1).balance;
     }
     return d->balanceCache.value(accountId);
 }
@@ -1400,15 +2445,12 @@ QModelIndex JournalModel::adjustToFirstSplitIdx(const QModelIndex& index) const
         return {};
     }
 
-    const auto id = index.data(eMyMoney::Model::IdRole).toString();
+    const auto& id = constItemAt(index.row()).id();
 
     // find the first split of this transaction in the journal
-    QModelIndex idx;
     int startRow;
     for (startRow = index.row()-1; startRow >= 0; --startRow) {
-        idx = index.model()->index(startRow, 0);
-        const auto cid = idx.data(eMyMoney::Model::IdRole).toString();
-        if (cid != id)
+        if (constItemAt(startRow).id() != id)
             break;
     }
     startRow++;
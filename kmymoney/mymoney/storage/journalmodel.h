@@ -10,6 +10,11 @@
 // QT Includes
 
 #include <QSharedDataPointer>
+#include <QSharedPointer>
+#include <QHash>
+#include <QMap>
+#include <QStringList>
+#include <QVector>
 
 // ----------------------------------------------------------------------------
 // KDE Includes
@@ -32,6 +37,10 @@ class QUndoStack;
 
 /**
  * The class representing a single journal entry (one split of a transaction)
+ *
+ * The entry does not keep a copy of its split but refers to it by its
+ * position in the transaction, which is shared between all entries of
+ * the transaction and never modified while it is part of the journal.
  */
 class /* no export here on purpose */ JournalEntry
 {
@@ -39,6 +48,8 @@ public:
     friend class JournalModel;
 
     explicit JournalEntry()
+        : m_splitIndex(-1)
+        , m_linesInLedger(0)
     {
     }
     friend void swap(JournalEntry& first, JournalEntry& second);
@@ -46,16 +57,21 @@ public:
     explicit JournalEntry(const QString& id, const JournalEntry& other)
         : m_id(id)
         , m_transaction(other.m_transaction)
-        , m_split(other.m_split)
+        , m_splitIndex(other.m_splitIndex)
         , m_balance(other.m_balance)
         , m_linesInLedger(other.m_linesInLedger)
     {
     }
 
-    JournalEntry(QString id, QSharedPointer<MyMoneyTransaction> t, const MyMoneySplit& sp)
+    /**
+     * Creates the journal entry for the split at position @a splitIndex
+     * of transaction @a t. A @a splitIndex of -1 creates an entry
+     * which refers to the whole transaction but not to a split.
+     */
+    JournalEntry(QString id, QSharedPointer<MyMoneyTransaction> t, int splitIndex)
         : m_id(id)
         , m_transaction(t)
-        , m_split(sp)
+        , m_splitIndex(splitIndex)
         , m_linesInLedger(0)
     {}
 
@@ -73,7 +89,10 @@ public:
     }
     inline const MyMoneySplit& split() const
     {
-        return m_split;
+        if (Q_UNLIKELY(m_splitIndex < 0 || m_transaction.isNull())) {
+            return emptySplit();
+        }
+        return m_transaction->splitAt(m_splitIndex);
     }
     inline const MyMoneyMoney& balance() const
     {
@@ -109,9 +128,15 @@ public:
     }
 
 private:
+    static const MyMoneySplit& emptySplit()
+    {
+        static const MyMoneySplit split;
+        return split;
+    }
+
     QString m_id;
     QSharedPointer<MyMoneyTransaction> m_transaction;
-    MyMoneySplit m_split;
+    int m_splitIndex;
     MyMoneyMoney m_balance;
     uint8_t m_linesInLedger;
 };
@@ -121,13 +146,78 @@ inline void swap(JournalEntry& first, JournalEntry& second)
     using std::swap;
     swap(first.m_id, second.m_id);
     swap(first.m_transaction, second.m_transaction);
-    swap(first.m_split, second.m_split);
+    swap(first.m_splitIndex, second.m_splitIndex);
     swap(first.m_balance, second.m_balance);
     swap(first.m_linesInLedger, second.m_linesInLedger);
 }
 
 class JournalModelNewTransaction;
 
+/**
+ * Interface used by the JournalModel to retrieve the journal entries
+ * that are not kept in memory because the journal has been loaded
+ * partially (see JournalModel::loadPartial()).
+ */
+class KMM_MYMONEY_EXPORT JournalLoader
+{
+public:
+    /**
+     * Summary of the journal entries of an account
+     * which are not kept in memory
+     */
+    struct AccountHistory
+    {
+        MyMoneyMoney    balance;
+        MyMoneyMoney    clearedBalance;
+        unsigned int    splitCount = 0;
+    };
+
+    virtual ~JournalLoader() = default;
+
+    /**
+     * Returns all transactions posted on or after @a from and before @a to.
+     * An invalid @a from returns all transactions posted before @a to.
+     * The key of the map is the unique sort key of the transaction.
+     */
+    virtual QMap<QString, MyMoneyTransaction> transactions(const QDate& from, const QDate& to) const = 0;
+
+    /**
+     * Returns the transactions matching @a filter. The result may contain
+     * more transactions than the ones matching, but not less. The key
+     * of the map is the unique sort key of the transaction.
+     */
+    virtual QMap<QString, MyMoneyTransaction> transactions(const MyMoneyTransactionFilter& filter) const = 0;
+
+    /**
+     * Returns the transaction with @a id or an empty
+     * transaction in case it is not found.
+     */
+    virtual MyMoneyTransaction transaction(const QString& id) const = 0;
+
+    /**
+     * Returns @c true if any transaction posted before @a date
+     * references the object with @a id.
+     */
+    virtual bool hasReferenceTo(const QString& id, const QDate& date) const = 0;
+
+    /**
+     * Returns the summary of all transactions posted before @a date
+     * for each account. In case @a accountIds is not empty, only
+     * the accounts listed in it are returned.
+     */
+    virtual QHash<QString, AccountHistory> history(const QDate& date, const QStringList& accountIds = QStringList()) const = 0;
+
+    /**
+     * Returns the number of transactions posted before @a date
+     */
+    virtual unsigned int transactionCount(const QDate& date) const = 0;
+
+    /**
+     * Returns the highest transaction id used in the storage
+     */
+    virtual QString lastTransactionId() const = 0;
+};
+
 /**
   */
 class KMM_MYMONEY_EXPORT JournalModel : public MyMoneyModel<JournalEntry>
@@ -155,6 +245,20 @@ public:
     };
     Q_ENUMS(Column);
 
+    /**
+     * The parts of an investment transaction which are needed
+     * to calculate the performance and capital gains of a
+     * stock account.
+     */
+    struct InvestmentActivity
+    {
+        QDate                                       postDate;
+        eMyMoney::Split::InvestmentTransactionType  type;
+        MyMoneyMoney                                shares;         ///< shares of the stock account's split
+        MyMoneyMoney                                value;          ///< value of the asset account's split
+        MyMoneyMoney                                interestValue;  ///< sum of the values of the income splits
+    };
+
     explicit JournalModel(QObject* parent = nullptr, QUndoStack* undoStack = nullptr);
     virtual ~JournalModel();
 
@@ -187,11 +291,104 @@ public:
     void transactionList(QList< QPair<MyMoneyTransaction, MyMoneySplit> >& list, MyMoneyTransactionFilter& filter) const;
     unsigned int transactionCount(const QString& accountid) const;
 
+    /**
+     * Sets the minimum number of candidate transactions for which
+     * transactionList() evaluates the filter on the thread pool to
+     * @a threshold. The default depends on the number of cores and
+     * is only changed by tests to cover the parallel evaluation.
+     */
+    void setParallelEvaluationThreshold(int threshold);
+    int parallelEvaluationThreshold() const;
+
     bool setData(const QModelIndex& idx, const QVariant& value, int role = Qt::EditRole) override;
 
     void load(const QMap<QString, MyMoneyTransaction>& list);
+
+    /**
+     * Loads the transactions found in @a list which must contain all
+     * transactions posted on or after @a firstDate. Older journal entries
+     * are retrieved on demand using @a loader which is owned by the model
+     * from now on until it is unloaded or completely loaded.
+     */
+    void loadPartial(const QMap<QString, MyMoneyTransaction>& list, const QDate& firstDate, QSharedPointer<JournalLoader> loader);
     void unload();
 
+    /**
+     * Returns the post date of the oldest transaction kept in memory
+     * in case the journal has been loaded partially. Returns an
+     * invalid date if the journal is loaded completely.
+     */
+    QDate firstLoadedDate() const;
+
+    /**
+     * Makes sure that all transactions posted on or after @a date are
+     * kept in memory. An invalid @a date loads the complete journal.
+     * Journal entries loaded by this method are not considered a
+     * modification of the model.
+     *
+     * @note The const methods of the model never call this method but
+     * query the loader for entries not kept in memory, so that rows are
+     * not inserted while a view accesses the model. It is meant to be
+     * used by the ledger views when older entries need to be shown.
+     */
+    void loadOlderEntries(const QDate& date);
+
+    /**
+     * Returns the balance of the account @a accountId built from
+     * all transactions not kept in memory. This is zero in case
+     * the journal is loaded completely.
+     */
+    MyMoneyMoney openingBalance(const QString& accountId) const;
+
+    /**
+     * Overridden to cover the transactions not kept in memory as well
+     */
+    bool hasReferenceTo(const QString& id) const;
+
+    /**
+     * Returns @c true if @a number is used as number by a split of
+     * account @a accountId. Splits of the transaction with the id
+     * @a skipTransactionId are not taken into account.
+     */
+    bool isNumberUsed(const QString& accountId, const QString& number, const QString& skipTransactionId = QString()) const;
+
+    /**
+     * Returns the number with the highest numeric value used by
+     * a split of account @a accountId or an empty string if none
+     * of them is numeric.
+     */
+    QString highestNumber(const QString& accountId) const;
+
+    /**
+     * Returns the first number not used by a split of account
+     * @a accountId starting at @a number and counting upwards.
+     * Only plain numbers without leading zeros are supported, for
+     * all others an empty string is returned.
+     */
+    QString nextFreeNumber(const QString& accountId, const QString& number) const;
+
+    /**
+     * Returns the number of different numbers used
+     * by the splits of account @a accountId
+     */
+    int numberCount(const QString& accountId) const;
+
+    /**
+     * Returns the activity of the stock account's @a split
+     * found in @a transaction.
+     */
+    static InvestmentActivity investmentActivity(const MyMoneyTransaction& transaction, const MyMoneySplit& split);
+
+    /**
+     * Returns the activities of the stock account @a accountId in
+     * journal order, one for each transaction referencing the account.
+     * The list is built on first use and kept until a transaction
+     * referencing the account is changed. In case the journal is
+     * loaded partially, the activities of the transactions not kept
+     * in memory are taken from the storage without loading them.
+     */
+    QVector<InvestmentActivity> investmentActivities(const QString& accountId) const;
+
     JournalModelNewTransaction* newTransaction();
 
     MyMoneyMoney balance(const QString& accountId, const QDate& date) const;
@@ -223,6 +420,14 @@ public:
 
     MyMoneyMoney clearedBalance(const QString& accountId, const QDate& date) const;
 
+    /**
+     * While @a defer is @c true, balancesChanged() is not emitted for
+     * each modification of the journal. The balances of all accounts
+     * changed in the meantime are sent out with a single balancesChanged()
+     * once deferring is turned off again. balanceChanged() is not affected.
+     */
+    void deferBalanceNotifications(bool defer);
+
     bool matchTransaction(const QModelIndex& idx, MyMoneyTransactionFilter& filter) const;
 
 protected:
@@ -232,6 +437,7 @@ protected:
     void doAddItem(const JournalEntry& item, const QModelIndex& parentIdx) override;
     void doRemoveItem(const JournalEntry& before) override;
     void doModifyItem(const JournalEntry& before, const JournalEntry& after) override;
+    void doUpdateReferencedObjects() override;
 
 public Q_SLOTS:
     void updateBalances();
@@ -11,6 +11,8 @@
 // QT Includes
 
 #include <QObject>
+#include <QHash>
+#include <QSet>
 #include <QSharedData>
 #include <QSharedDataPointer>
 #include <QVariant>
@@ -43,6 +45,7 @@ public:
     {
         parentItem = parent;
         object = data;
+        rowInParent = 0;
     }
 
     ~TreeItem()
@@ -58,6 +61,15 @@ public:
         return nullptr;
     }
 
+    /**
+     * Same as child() but without range checking. The caller
+     * must make sure that @a row is valid.
+     */
+    inline TreeItem<T>* childAt(int row) const
+    {
+        return childItems.at(row);
+    }
+
     int childCount() const
     {
         return childItems.count();
@@ -67,11 +79,14 @@ public:
     void appendChild(TreeItem<T>* item)
     {
         childItems.append(item);
+        updateRows(childItems.count() - 1);
     }
 
     void appendChildren(QVector<TreeItem<T>*> items)
     {
+        const auto firstRow = childItems.count();
         childItems.append(items);
+        updateRows(firstRow);
     }
 
     bool insertChildren(int row, QVector<TreeItem<T>*> items)
@@ -88,6 +103,7 @@ public:
             childItems[row + i] = items[i];
             items[i] = nullptr;
         }
+        updateRows(row);
         return true;
     }
 
@@ -97,6 +113,7 @@ public:
             return false;
 
         childItems.insert(row, item);
+        updateRows(row);
         return true;
     }
 
@@ -107,12 +124,41 @@ public:
         return child != nullptr;
     }
 
+    /**
+     * Removes @a count children starting at @a row and
+     * deletes them. Returns @c false if the range is invalid.
+     */
+    bool removeChildren(int row, int count)
+    {
+        const auto items = takeChildren(row, count);
+        qDeleteAll(items);
+        return !items.isEmpty() || (count == 0);
+    }
+
     TreeItem<T>* takeChild(int row)
     {
         if (row < 0 || row >= childItems.count())
             return nullptr;
 
-        return childItems.takeAt(row);
+        const auto item = childItems.takeAt(row);
+        updateRows(row);
+        return item;
+    }
+
+    /**
+     * Takes @a count children starting at @a row out of
+     * this item and returns them. In case the range is
+     * invalid, an empty vector is returned.
+     */
+    QVector<TreeItem<T>*> takeChildren(int row, int count)
+    {
+        if (row < 0 || count < 0 || (row + count) > childItems.count())
+            return {};
+
+        const auto items = childItems.mid(row, count);
+        childItems.remove(row, count);
+        updateRows(row);
+        return items;
     }
 
     void reparent(TreeItem<T>* newParent)
@@ -128,7 +174,7 @@ public:
     int row() const
     {
         if (parentItem)
-            return parentItem->childItems.indexOf(const_cast<TreeItem<T>*>(this));
+            return rowInParent;
 
         return 0;
     }
@@ -154,10 +200,24 @@ public:
         object = value;
     }
 
+private:
+    /**
+     * Updates the stored row of all children starting at @a firstRow.
+     * Modifications of the child list call this once per operation.
+     */
+    void updateRows(int firstRow)
+    {
+        const auto count = childItems.count();
+        for (int row = firstRow; row < count; ++row) {
+            childItems[row]->rowInParent = row;
+        }
+    }
+
 private:
     T                                       object;
     QVector<TreeItem<T> *>                  childItems;
     TreeItem<T> *                           parentItem;
+    int                                     rowInParent;
 };
 
 template <typename T> class MyMoneyEmptyModel;
@@ -349,14 +409,13 @@ public:
 
         beginRemoveRows(parent, startRow, startRow + rows - 1);
 
-        for (int row = 0; row < rows; ++row) {
-            if (m_idToItemMapper) {
-                const auto idx = index(startRow, 0, parent);
-                m_idToItemMapper->remove(idx.data(eMyMoney::Model::IdRole).toString());
+        const auto lastRow = qMin(startRow + rows, parentItem->childCount());
+        if (m_idToItemMapper) {
+            for (int row = startRow; row < lastRow; ++row) {
+                m_idToItemMapper->remove(parentItem->childAt(row)->constDataRef().id());
             }
-            if (!parentItem->removeChild(startRow))
-                break;
         }
+        parentItem->removeChildren(startRow, lastRow - startRow);
 
         endRemoveRows();
         setDirty();
@@ -484,10 +543,52 @@ public:
                 return createIndex(item->row(), 0, item);
             }
         }
-        const QModelIndexList indexes = match(index(0, 0), eMyMoney::Model::Roles::IdRole, id, 1, Qt::MatchFixedString | Qt::MatchRecursive);
-        if (indexes.isEmpty())
+        const auto item = findItem([&](const T& object) {
+            return object.id() == id;
+        });
+        if (item == nullptr)
             return QModelIndex();
-        return indexes.first();
+        return createIndex(item->row(), 0, item);
+    }
+
+    /**
+     * Returns a reference to the object stored in @a row of
+     * the top level of the model. The caller must make sure
+     * that @a row is valid. Other than itemByIndex() this
+     * neither creates a QModelIndex nor a copy of the object.
+     */
+    inline const T& constItemAt(int row) const
+    {
+        return m_rootItem->childAt(row)->constDataRef();
+    }
+
+    /**
+     * Calls @a function for each object found in the model. The objects
+     * are visited depth first in the same order as a recursive match()
+     * on the model would return them. The object is passed to @a function
+     * as const reference. Visiting starts with the top level item
+     * in @a firstRow.
+     */
+    template <typename Function>
+    void forEachItem(Function function, int firstRow = 0) const
+    {
+        const auto rows = m_rootItem->childCount();
+        for (int row = firstRow; row < rows; ++row) {
+            const auto item = m_rootItem->childAt(row);
+            function(item->constDataRef());
+            forEachChildItem(item, function);
+        }
+    }
+
+    /**
+     * Returns the first item for which @a predicate returns @c true
+     * or @c nullptr if no such item exists. The items are searched
+     * in the same order as with forEachItem().
+     */
+    template <typename Predicate>
+    TreeItem<T>* findItem(Predicate predicate) const
+    {
+        return findChildItem(m_rootItem, predicate);
     }
 
     T itemByIndex(const QModelIndex& idx) const
@@ -572,7 +673,14 @@ public:
 
     virtual int processItems(Worker *worker)
     {
-        return processItems(worker, match(index(0, 0), eMyMoney::Model::Roles::IdRole, m_idLeadin, -1, Qt::MatchStartsWith | Qt::MatchRecursive));
+        int count = 0;
+        forEachItem([&](const T& item) {
+            if (item.id().startsWith(m_idLeadin)) {
+                worker->operator()(item);
+                ++count;
+            }
+        });
+        return count;
     }
 
     int processItems(Worker *worker, const QModelIndexList& indexes)
@@ -583,29 +691,34 @@ public:
         return indexes.count();
     }
 
+    /**
+     * Returns @c true if any item of the model refers to @a id.
+     * The lookup is based on the reference index which is kept
+     * up to date by doAddItem(), doModifyItem() and doRemoveItem().
+     */
     bool hasReferenceTo(const QString& id) const
     {
-        bool rc = false;
-        QModelIndexList indexes = match(index(0, 0), eMyMoney::Model::Roles::IdRole, "*", -1, Qt::MatchWildcard | Qt::MatchRecursive);
-        for (const auto idx : indexes) {
-            if ((rc |= static_cast<TreeItem<T>*>(idx.internalPointer())->constDataRef().hasReferenceTo(id)) == true)
-                break;
-        }
-        return rc;
+        return m_referenceCount.contains(id);
     }
 
     QSet<QString> referencedObjects() const
     {
-        return m_referencedObjects;
+        QSet<QString> ids;
+        ids.reserve(m_referenceCount.count());
+        for (auto it = m_referenceCount.constBegin(); it != m_referenceCount.constEnd(); ++it) {
+            ids.insert(it.key());
+        }
+        return ids;
     }
 
     QList<T> itemList() const
     {
         QList<T> list;
-        QModelIndexList indexes = match(index(0, 0), eMyMoney::Model::Roles::IdRole, m_idLeadin, -1, Qt::MatchStartsWith | Qt::MatchRecursive);
-        foreach (const auto idx, indexes) {
-            list.append(static_cast<TreeItem<T>*>(idx.internalPointer())->constDataRef());
-        }
+        forEachItem([&](const T& item) {
+            if (item.id().startsWith(m_idLeadin)) {
+                list.append(item);
+            }
+        });
         return list;
     }
 
@@ -717,7 +830,7 @@ protected:
             m_idToItemMapper->insert(item.id(), static_cast<TreeItem<T>*>(idx.internalPointer()));
         }
         setDirty();
-        doUpdateReferencedObjects();
+        addReferences(item.referencedObjects());
         emit dataChanged(idx, index(row, columnCount()-1, parentIdx));
     }
 
@@ -730,9 +843,12 @@ protected:
                 m_idToItemMapper->remove(static_cast<const TreeItem<T>*>(idx.internalPointer())->constDataRef().id());
                 m_idToItemMapper->insert(after.id(), static_cast<TreeItem<T>*>(idx.internalPointer()));
             }
+            // the references are taken from the stored item
+            // as it is not guaranteed to be identical to before
+            removeReferences(static_cast<const TreeItem<T>*>(idx.internalPointer())->constDataRef().referencedObjects());
             static_cast<TreeItem<T>*>(idx.internalPointer())->dataRef() = after;
+            addReferences(after.referencedObjects());
             setDirty();
-            doUpdateReferencedObjects();
             emit dataChanged(idx, index(idx.row(), columnCount(idx.parent())-1));
         }
     }
@@ -744,8 +860,8 @@ protected:
             if (m_idToItemMapper) {
                 m_idToItemMapper->remove(static_cast<const TreeItem<T>*>(idx.internalPointer())->constDataRef().id());
             }
+            removeReferences(static_cast<const TreeItem<T>*>(idx.internalPointer())->constDataRef().referencedObjects());
             removeRow(idx.row(), idx.parent());
-            doUpdateReferencedObjects();
             setDirty();
         }
     }
@@ -769,21 +885,70 @@ protected:
         }
     }
 
+    /**
+     * Rebuilds the reference index from scratch. This is only
+     * needed when the model has been reset.
+     */
     virtual void doUpdateReferencedObjects() override
     {
-        const int rows = rowCount();
-        m_referencedObjects.clear();
-        if (m_idToItemMapper) {
-            for(const auto item : qAsConst(*m_idToItemMapper)) {
-                m_referencedObjects.unite(item->constDataRef().referencedObjects());
+        m_referenceCount.clear();
+        forEachItem([&](const T& item) {
+            addReferences(item.referencedObjects());
+        });
+    }
+
+    /**
+     * Counts one reference to each of the @a ids in the reference index.
+     * Empty ids are not counted.
+     */
+    void addReferences(const QSet<QString>& ids)
+    {
+        for (const auto& id : ids) {
+            if (!id.isEmpty()) {
+                ++m_referenceCount[id];
             }
-        } else {
-            QModelIndex idx;
-            for (int row = 0; row < rows; ++row) {
-                idx = index(row, 0);
-                m_referencedObjects.unite(static_cast<TreeItem<T>*>(idx.internalPointer())->constDataRef().referencedObjects());
+        }
+    }
+
+    /**
+     * Removes one reference to each of the @a ids from the reference
+     * index. Ids without any remaining reference are removed.
+     */
+    void removeReferences(const QSet<QString>& ids)
+    {
+        for (const auto& id : ids) {
+            const auto it = m_referenceCount.find(id);
+            if (it != m_referenceCount.end() && --(*it) <= 0) {
+                m_referenceCount.erase(it);
+            }
+        }
+    }
+
+    template <typename Function>
+    static void forEachChildItem(const TreeItem<T>* parentItem, Function& function)
+    {
+        const auto rows = parentItem->childCount();
+        for (int row = 0; row < rows; ++row) {
+            const auto item = parentItem->childAt(row);
+            function(item->constDataRef());
+            forEachChildItem(item, function);
+        }
+    }
+
+    template <typename Predicate>
+    static TreeItem<T>* findChildItem(const TreeItem<T>* parentItem, Predicate& predicate)
+    {
+        const auto rows = parentItem->childCount();
+        for (int row = 0; row < rows; ++row) {
+            const auto item = parentItem->childAt(row);
+            if (predicate(item->constDataRef())) {
+                return item;
+            }
+            if (const auto childItem = findChildItem(item, predicate)) {
+                return childItem;
             }
         }
+        return nullptr;
     }
 
 protected:
@@ -791,7 +956,11 @@ protected:
     KConcatenateRowsProxyModel*   m_emptyItemModel;
     QUndoStack*                   m_undoStack;
     QHash<QString, TreeItem<T>*>* m_idToItemMapper;
-    QSet<QString>                 m_referencedObjects;
+    /**
+     * The reference index: the number of items which refer
+     * to an object id, e.g. by using it as account or payee
+     */
+    QHash<QString, int>           m_referenceCount;
 
 };
 
@@ -11,6 +11,9 @@
 #include <QDebug>
 #include <QString>
 #include <QDate>
+#include <QUndoCommand>
+
+#include <algorithm>
 
 // ----------------------------------------------------------------------------
 // KDE Includes
@@ -31,6 +34,18 @@ PriceEntry::PriceEntry(const MyMoneyPrice& price)
 
 struct PriceModel::Private
 {
+    /**
+     * An entry of the per pair price index. The entries of
+     * a pair are kept sorted by date.
+     */
+    struct PriceIndexEntry
+    {
+        QDate           date;
+        MyMoneyMoney    rate;
+        QString         source;
+    };
+    typedef QVector<PriceIndexEntry> PriceIndex;
+
     Private()
         : headerData(QHash<Column, QString> ({
         { Commodity, i18n("Commodity") },
@@ -44,11 +59,146 @@ struct PriceModel::Private
     }
 
 
+    PriceIndexEntry priceIndexEntry(const MyMoneyPrice& price) const
+    {
+        return { price.date(), price.rate(QString()), price.source() };
+    }
+
+    /**
+     * Returns the position of the first entry in @a entries
+     * which has a date later than @a date.
+     */
+    int upperBound(const PriceIndex& entries, const QDate& date) const
+    {
+        const auto it = std::upper_bound(entries.constBegin(), entries.constEnd(), date, [&](const QDate& dt, const PriceIndexEntry& entry) {
+            return dt < entry.date;
+        });
+        return static_cast<int>(it - entries.constBegin());
+    }
+
+    void addToPriceIndex(const MyMoneyPrice& price)
+    {
+        auto& entries = priceIndex[qMakePair(price.from(), price.to())];
+        const auto pos = upperBound(entries, price.date());
+        if ((pos > 0) && (entries.at(pos-1).date == price.date())) {
+            entries[pos-1] = priceIndexEntry(price);
+        } else {
+            entries.insert(pos, priceIndexEntry(price));
+        }
+    }
+
+    /**
+     * Merges the @a updates sorted by date into the index of @a pair
+     * in a single pass. An update replaces the entry of the same date.
+     */
+    void mergeIntoPriceIndex(const MyMoneySecurityPair& pair, const PriceIndex& updates)
+    {
+        auto& entries = priceIndex[pair];
+        PriceIndex merged;
+        merged.reserve(entries.count() + updates.count());
+        auto it = entries.constBegin();
+        for (const auto& update : updates) {
+            while ((it != entries.constEnd()) && ((*it).date < update.date)) {
+                merged.append(*it);
+                ++it;
+            }
+            if ((it != entries.constEnd()) && ((*it).date == update.date)) {
+                ++it;
+            }
+            merged.append(update);
+        }
+        for (; it != entries.constEnd(); ++it) {
+            merged.append(*it);
+        }
+        entries = merged;
+    }
+
+    void removeFromPriceIndex(const MyMoneyPrice& price)
+    {
+        const auto pair = qMakePair(price.from(), price.to());
+        auto it = priceIndex.find(pair);
+        if (it != priceIndex.end()) {
+            const auto pos = upperBound(*it, price.date());
+            if ((pos > 0) && ((*it).at(pos-1).date == price.date())) {
+                (*it).remove(pos-1);
+                if ((*it).isEmpty()) {
+                    priceIndex.erase(it);
+                }
+            }
+        }
+    }
+
+    /**
+     * Returns the position of the entry in @a entries which
+     * is valid for @a date or -1 if there is none. In case
+     * @a exactDate is @c true, only an entry with the
+     * same date is reported.
+     */
+    int findEntry(const PriceIndex& entries, const QDate& date, bool exactDate) const
+    {
+        const auto pos = upperBound(entries, date) - 1;
+        if (pos < 0) {
+            return -1;
+        }
+        if (exactDate && (entries.at(pos).date != date)) {
+            return -1;
+        }
+        return pos;
+    }
+
+    MyMoneyPrice priceFromIndex(const MyMoneySecurityPair& pair, const PriceIndexEntry& entry) const
+    {
+        return MyMoneyPrice(pair.first, pair.second, entry.date, entry.rate, entry.source);
+    }
+
     QHash<Column, QString>          headerData;
+    QHash<MyMoneySecurityPair, PriceIndex> priceIndex;
 };
 
 
 
+/**
+ * The undo command of PriceModel::addPrices(). It keeps the
+ * entries replaced by the batch so that they can be restored.
+ */
+class PriceModel::AddPricesCommand : public QUndoCommand
+{
+public:
+    explicit AddPricesCommand(PriceModel* model, const QVector<PriceEntry>& entries, QUndoCommand* parent = nullptr)
+        : QUndoCommand(parent)
+        , m_model(model)
+        , m_after(entries)
+    {
+    }
+
+    void redo() override
+    {
+        m_before.clear();
+        m_model->mergePrices(m_after, QStringList(), &m_before);
+    }
+
+    void undo() override
+    {
+        // remove the entries which did not exist before
+        // and restore the ones which have been replaced
+        QStringList addedIds;
+        auto it = m_before.constBegin();
+        for (const auto& entry : qAsConst(m_after)) {
+            if ((it != m_before.constEnd()) && ((*it).id() == entry.id())) {
+                ++it;
+            } else {
+                addedIds.append(entry.id());
+            }
+        }
+        m_model->mergePrices(m_before, addedIds, nullptr);
+    }
+
+private:
+    PriceModel*         m_model;
+    QVector<PriceEntry> m_after;
+    QVector<PriceEntry> m_before;
+};
+
 PriceModel::PriceModel(QObject* parent, QUndoStack* undoStack)
     : MyMoneyModel<PriceEntry>(parent, QStringLiteral("p"), PriceModel::ID_SIZE, undoStack)
     , d(new Private)
@@ -150,6 +300,12 @@ bool PriceModel::setData(const QModelIndex& idx, const QVariant& value, int role
     return QAbstractItemModel::setData(idx, value, role);
 }
 
+void PriceModel::clearModelItems()
+{
+    d->priceIndex.clear();
+    MyMoneyModel<PriceEntry>::clearModelItems();
+}
+
 void PriceModel::load(const QMap<MyMoneySecurityPair, MyMoneyPriceEntries>& list)
 {
     QElapsedTimer t;
@@ -170,15 +326,22 @@ void PriceModel::load(const QMap<MyMoneySecurityPair, MyMoneyPriceEntries>& list
     QMap<MyMoneySecurityPair, MyMoneyPriceEntries>::const_iterator itPairs;
     for (itPairs = list.constBegin(); itPairs != list.constEnd(); ++itPairs) {
         QDate lastDate(1900, 1, 1);
+        auto& entries = d->priceIndex[itPairs.key()];
+        entries.reserve((*itPairs).count());
         for (const auto& priceInfo : *itPairs) {
             if (lastDate > priceInfo.date()) {
                 qDebug() << "Price loader: dates not sorted as needed" << priceInfo.date() << "older than" << lastDate;
             }
             PriceEntry newEntry(priceInfo);
             static_cast<TreeItem<PriceEntry>*>(index(row, 0).internalPointer())->dataRef() = newEntry;
+            // the entries of a QMap are sorted by date
+            entries.append(d->priceIndexEntry(priceInfo));
             lastDate = priceInfo.date();
             ++row;
         }
+        if (entries.isEmpty()) {
+            d->priceIndex.remove(itPairs.key());
+        }
     }
     endResetModel();
 
@@ -206,11 +369,138 @@ void PriceModel::addPrice(const MyMoneyPrice& price)
 
     if (static_cast<TreeItem<PriceEntry>*>(index(row, 0).internalPointer())->dataRef() != newEntry) {
         static_cast<TreeItem<PriceEntry>*>(index(row, 0).internalPointer())->dataRef() = newEntry;
+        d->addToPriceIndex(newEntry);
         emit dataChanged(idx, index(row, columnCount()-1));
         setDirty();
     }
 }
 
+void PriceModel::addPrices(const QList<MyMoneyPrice>& prices)
+{
+    QVector<PriceEntry> entries;
+    entries.reserve(prices.count());
+    for (const auto& price : prices) {
+        entries.append(PriceEntry(price));
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](const PriceEntry& left, const PriceEntry& right) {
+        return left.id() < right.id();
+    });
+
+    // only keep the last one of multiple prices for the same id
+    QVector<PriceEntry> uniqueEntries;
+    uniqueEntries.reserve(entries.count());
+    const auto count = entries.count();
+    for (int i = 0; i < count; ++i) {
+        if ((i + 1 < count) && (entries.at(i + 1).id() == entries.at(i).id())) {
+            continue;
+        }
+        uniqueEntries.append(entries.at(i));
+    }
+
+    if (uniqueEntries.isEmpty()) {
+        return;
+    }
+
+    if (m_undoStack) {
+        m_undoStack->push(new AddPricesCommand(this, uniqueEntries));
+    } else {
+        mergePrices(uniqueEntries, QStringList(), nullptr);
+    }
+}
+
+void PriceModel::mergePrices(const QVector<PriceEntry>& entries, const QStringList& removeIds, QVector<PriceEntry>* previous)
+{
+    const auto rows = m_rootItem->childCount();
+    QVector<TreeItem<PriceEntry>*> items;
+    items.reserve(rows + entries.count());
+    QVector<TreeItem<PriceEntry>*> removedItems;
+    QVector<QPair<TreeItem<PriceEntry>*, const PriceEntry*>> changedItems;
+    QHash<MyMoneySecurityPair, Private::PriceIndex> indexUpdates;
+    auto rowsChanged = false;
+    int firstChangedRow = -1;
+    int lastChangedRow = -1;
+
+    auto entryIt = entries.constBegin();
+    auto removeIt = removeIds.constBegin();
+
+    const auto addEntry = [&]() {
+        items.append(new TreeItem<PriceEntry>(*entryIt, m_rootItem));
+        indexUpdates[(*entryIt).pricePair()].append(d->priceIndexEntry(*entryIt));
+        rowsChanged = true;
+        ++entryIt;
+    };
+
+    // both the model and the entries are sorted by id so
+    // that a single pass over both of them is sufficient
+    for (int row = 0; row < rows; ++row) {
+        const auto item = m_rootItem->childAt(row);
+        const auto& id = item->constDataRef().id();
+        while ((entryIt != entries.constEnd()) && ((*entryIt).id() < id)) {
+            addEntry();
+        }
+
+        while ((removeIt != removeIds.constEnd()) && (*removeIt < id)) {
+            ++removeIt;
+        }
+        if ((removeIt != removeIds.constEnd()) && (*removeIt == id)) {
+            if (previous) {
+                previous->append(item->constDataRef());
+            }
+            removedItems.append(item);
+            rowsChanged = true;
+            ++removeIt;
+            continue;
+        }
+
+        if ((entryIt != entries.constEnd()) && ((*entryIt).id() == id)) {
+            if (previous) {
+                previous->append(item->constDataRef());
+            }
+            if (item->constDataRef() != *entryIt) {
+                changedItems.append(qMakePair(item, &(*entryIt)));
+                indexUpdates[(*entryIt).pricePair()].append(d->priceIndexEntry(*entryIt));
+                if (firstChangedRow == -1) {
+                    firstChangedRow = items.count();
+                }
+                lastChangedRow = items.count();
+            }
+            ++entryIt;
+        }
+        items.append(item);
+    }
+    while (entryIt != entries.constEnd()) {
+        addEntry();
+    }
+
+    if (!rowsChanged && changedItems.isEmpty()) {
+        return;
+    }
+
+    if (rowsChanged) {
+        beginResetModel();
+    }
+
+    for (const auto& change : qAsConst(changedItems)) {
+        change.first->dataRef() = *change.second;
+    }
+    for (const auto& item : qAsConst(removedItems)) {
+        d->removeFromPriceIndex(item->constDataRef());
+    }
+    for (auto it = indexUpdates.constBegin(); it != indexUpdates.constEnd(); ++it) {
+        d->mergeIntoPriceIndex(it.key(), *it);
+    }
+
+    if (rowsChanged) {
+        m_rootItem->takeChildren(0, rows);
+        m_rootItem->appendChildren(items);
+        qDeleteAll(removedItems);
+        endResetModel();
+    } else {
+        emit dataChanged(index(firstChangedRow, 0), index(lastChangedRow, columnCount()-1));
+    }
+    setDirty();
+}
+
 void PriceModel::removePrice(const MyMoneyPrice& price)
 {
     PriceEntry newEntry(price);
@@ -219,6 +509,7 @@ void PriceModel::removePrice(const MyMoneyPrice& price)
     QModelIndex idx = MyMoneyModelBase::lowerBound(newEntry.id());
     if (idx.data(eMyMoney::Model::IdRole).toString() == newEntry.id()) {
         removeRow(idx.row());
+        d->removeFromPriceIndex(newEntry);
         setDirty();
     }
 }
@@ -227,53 +518,87 @@ MyMoneyPrice PriceModel::price(const QString& from, const QString& to, const QDa
 {
     // if no valid date is passed, we use today's date.
     const QDate &date = _date.isValid() ? _date : QDate::currentDate();
-    QString fullId(createId(from, to, date));
-    QString pricePair(createId(from, to, QDate()));
+    const auto pair = qMakePair(from, to);
 
     // check if we have a price for this price pair at all
-    QModelIndex idx = MyMoneyModelBase::lowerBound(pricePair);
-    if (!idx.isValid()) {
+    const auto it = d->priceIndex.constFind(pair);
+    if (it == d->priceIndex.constEnd()) {
         return {};
     }
 
-    // find the last matching price
-    idx = lowerBound(fullId, idx.row(), rowCount()-1);
-    int row = idx.row();
-    if (!idx.isValid()) {
-        // if we found a price pair but get an invalid index here
-        // we don't have an exact match. In case we look for the
-        // exact match, we can return right away.
-        if (exactDate) {
-            return {};
-        }
-        // the last row is the one we look for. We
-        row = rowCount()-1;
-        auto priceEntry = static_cast<TreeItem<PriceEntry>*>(index(row, 0).internalPointer())->data();
-        return std::move(priceEntry);
+    // find the last price on or before the date
+    const auto pos = d->findEntry(*it, date, exactDate);
+    if (pos == -1) {
+        return {};
     }
+    return d->priceFromIndex(pair, (*it).at(pos));
+}
 
-    auto priceEntry = static_cast<TreeItem<PriceEntry>*>(index(row, 0).internalPointer())->data();
+QVector<MyMoneyPrice> PriceModel::priceSeries(const QString& from, const QString& to, const QVector<QDate>& dates, bool exactDate) const
+{
+    QVector<MyMoneyPrice> result(dates.count());
+
+    const auto fromToPair = qMakePair(from, to);
+    const auto toFromPair = qMakePair(to, from);
+    const auto itFromTo = d->priceIndex.constFind(fromToPair);
+    const auto itToFrom = d->priceIndex.constFind(toFromPair);
+    const Private::PriceIndex emptyIndex;
+    const auto& fromToEntries = (itFromTo != d->priceIndex.constEnd()) ? *itFromTo : emptyIndex;
+    const auto& toFromEntries = (itToFrom != d->priceIndex.constEnd()) ? *itToFrom : emptyIndex;
+
+    if (fromToEntries.isEmpty() && toFromEntries.isEmpty()) {
+        return result;
+    }
 
-    // in case we have an exact match, we report it
-    if (priceEntry.id() == fullId) {
-        return std::move(priceEntry);
+    // if no valid date is passed, we use today's date
+    QVector<QDate> effectiveDates(dates);
+    for (auto& date : effectiveDates) {
+        if (!date.isValid()) {
+            date = QDate::currentDate();
+        }
     }
 
-    // in case the caller wanted the exact date we are done
-    if (exactDate) {
-        return {};
+    // visit the dates in ascending order so that we can
+    // merge them with the price entries in a single pass
+    QVector<int> order(effectiveDates.count());
+    for (int i = 0; i < order.count(); ++i) {
+        order[i] = i;
     }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return effectiveDates.at(a) < effectiveDates.at(b);
+    });
+
+    int fromToPos = 0;
+    int toFromPos = 0;
+    const auto fromToCount = fromToEntries.count();
+    const auto toFromCount = toFromEntries.count();
+    for (const auto i : qAsConst(order)) {
+        const QDate& date = effectiveDates.at(i);
+        while ((fromToPos < fromToCount) && !(date < fromToEntries.at(fromToPos).date)) {
+            ++fromToPos;
+        }
+        while ((toFromPos < toFromCount) && !(date < toFromEntries.at(toFromPos).date)) {
+            ++toFromPos;
+        }
+
+        // the entries before the positions are the candidates
+        const Private::PriceIndexEntry* fromToEntry = (fromToPos > 0) ? &fromToEntries.at(fromToPos-1) : nullptr;
+        const Private::PriceIndexEntry* toFromEntry = (toFromPos > 0) ? &toFromEntries.at(toFromPos-1) : nullptr;
+        if (exactDate) {
+            if (fromToEntry && fromToEntry->date != date)
+                fromToEntry = nullptr;
+            if (toFromEntry && toFromEntry->date != date)
+                toFromEntry = nullptr;
+        }
 
-    // since lower bound returns the first item with a larger key (we already know that
-    // the exact key is not present) we need to return the previous item (the model
-    // is not empty so there is one)
-    if (row > 0) {
-        priceEntry = static_cast<TreeItem<PriceEntry>*>(index(row-1, 0).internalPointer())->data();
-        if ((priceEntry.from() == from) && (priceEntry.to() == to)) {
-            return std::move(priceEntry);
+        // prefer 'from-to' if it is the more recent one or has the same date
+        if (fromToEntry && (!toFromEntry || (fromToEntry->date >= toFromEntry->date))) {
+            result[i] = d->priceFromIndex(fromToPair, *fromToEntry);
+        } else if (toFromEntry) {
+            result[i] = d->priceFromIndex(toFromPair, *toFromEntry);
         }
     }
-    return {};
+    return result;
 }
 
 MyMoneyPriceList PriceModel::priceList() const
@@ -301,3 +626,16 @@ MyMoneyPriceList PriceModel::priceList() const
     }
     return priceList;
 }
+
+MyMoneyPriceEntries PriceModel::priceEntries(const QString& from, const QString& to) const
+{
+    MyMoneyPriceEntries entries;
+    const auto pair = qMakePair(from, to);
+    const auto it = d->priceIndex.constFind(pair);
+    if (it != d->priceIndex.constEnd()) {
+        for (const auto& entry : *it) {
+            entries.insert(entry.date, d->priceFromIndex(pair, entry));
+        }
+    }
+    return entries;
+}
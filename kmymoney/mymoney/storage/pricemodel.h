@@ -100,20 +100,74 @@ public:
      */
     MyMoneyPrice price(const QString& from, const QString& to, const QDate& date, bool exactDate) const;
 
+    /**
+     * Returns the prices to convert @a from into @a to for each date
+     * found in @a dates. The n-th entry of the returned vector contains
+     * the price for the n-th date in @a dates. Prices for both directions
+     * (@a from -> @a to and @a to -> @a from) are considered using the
+     * same rules as MyMoneyFile::price(). Use MyMoneyPrice::rate(@a to)
+     * to get the conversion rate independent of the direction.
+     *
+     * The prices for all dates are collected in a single pass over the
+     * prices of the pair, so this is the method of choice if many dates
+     * need to be resolved for the same pair.
+     *
+     * @param from id of the security to convert from
+     * @param to id of the security to convert to
+     * @param dates list of dates (needs not be sorted)
+     * @param exactDate if @c true only prices with the exact date are returned
+     *
+     * @return vector of prices. Invalid prices are returned for dates
+     *         without a matching price.
+     */
+    QVector<MyMoneyPrice> priceSeries(const QString& from, const QString& to, const QVector<QDate>& dates, bool exactDate) const;
+
     void addPrice(const MyMoneyPrice& price);
+
+    /**
+     * Adds all @a prices to the model. A price replaces an existing
+     * one for the same pair and date. If @a prices contains more than
+     * one price for the same pair and date, the last one is used.
+     *
+     * Other than calling addPrice() for each price, the prices are
+     * sorted and merged into the model in a single pass, views
+     * receive a single notification and the operation is recorded
+     * as one command on the undo stack.
+     */
+    void addPrices(const QList<MyMoneyPrice>& prices);
+
     void removePrice(const MyMoneyPrice& price);
     MyMoneyPriceList priceList() const;
 
+    /**
+     * Returns all prices stored to convert @a from into @a to.
+     * Other than priceList() this does not scan the whole model.
+     */
+    MyMoneyPriceEntries priceEntries(const QString& from, const QString& to) const;
+
     bool setData(const QModelIndex& idx, const QVariant& value, int role = Qt::EditRole) override;
 
     void load(const QMap<MyMoneySecurityPair, MyMoneyPriceEntries>& list);
 
+protected:
+    void clearModelItems() override;
+
 private:
     QModelIndex firstIndexById(const QString& id) const;
     QModelIndex firstIndexByKey(const QString& key) const;
 
     static QString createId(const QString& from, const QString& to, const QDate& date);
 
+    class AddPricesCommand;
+
+    /**
+     * Merges the @a entries sorted by id into the model and removes
+     * the entries with the ids found in the sorted list @a removeIds.
+     * If @a previous is not @c nullptr, the entries which are
+     * replaced or removed are returned in it.
+     */
+    void mergePrices(const QVector<PriceEntry>& entries, const QStringList& removeIds, QVector<PriceEntry>* previous);
+
 public Q_SLOTS:
 
 private:
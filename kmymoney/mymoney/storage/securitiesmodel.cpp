@@ -220,6 +220,7 @@ void SecuritiesModel::addCurrency(const MyMoneySecurity& currency)
             insertRows(row, 1);
             const QModelIndex index = SecuritiesModel::index(row, 0);
             static_cast<TreeItem<MyMoneySecurity>*>(index.internalPointer())->dataRef() = currency;
+            addReferences(currency.referencedObjects());
             setDirty();
             emit dataChanged(index, SecuritiesModel::index(row, columnCount()-1));
         } else {
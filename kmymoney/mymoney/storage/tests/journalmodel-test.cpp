@@ -0,0 +1,410 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "journalmodel-test.h"
+
+#include <QTest>
+#include <QElapsedTimer>
+#include <QUndoStack>
+
+#include "journalmodel.h"
+#include "mymoneymodel.h"
+#include "mymoneytransaction.h"
+#include "mymoneysplit.h"
+#include "mymoneymoney.h"
+#include "mymoneytransactionfilter.h"
+
+QTEST_GUILESS_MAIN(JournalModelTest)
+
+namespace
+{
+/**
+ * Provides the transactions of @a m_list which are
+ * not loaded into the model under test
+ */
+class TestJournalLoader : public JournalLoader
+{
+public:
+    explicit TestJournalLoader(const QMap<QString, MyMoneyTransaction>& list)
+        : m_list(list)
+    {
+    }
+
+    QMap<QString, MyMoneyTransaction> transactions(const QDate& from, const QDate& to) const override
+    {
+        QMap<QString, MyMoneyTransaction> result;
+        for (auto it = m_list.constBegin(); it != m_list.constEnd(); ++it) {
+            if ((!from.isValid() || (*it).postDate() >= from) && ((*it).postDate() < to)) {
+                result.insert(it.key(), *it);
+            }
+        }
+        return result;
+    }
+
+    QMap<QString, MyMoneyTransaction> transactions(const MyMoneyTransactionFilter& filter) const override
+    {
+        QMap<QString, MyMoneyTransaction> result;
+        for (auto it = m_list.constBegin(); it != m_list.constEnd(); ++it) {
+            if ((!filter.fromDate().isValid() || (*it).postDate() >= filter.fromDate())
+                    && (!filter.toDate().isValid() || (*it).postDate() <= filter.toDate())) {
+                result.insert(it.key(), *it);
+            }
+        }
+        return result;
+    }
+
+    MyMoneyTransaction transaction(const QString& id) const override
+    {
+        for (const auto& t : m_list) {
+            if (t.id() == id)
+                return t;
+        }
+        return MyMoneyTransaction();
+    }
+
+    bool hasReferenceTo(const QString& id, const QDate& date) const override
+    {
+        for (const auto& t : m_list) {
+            if ((t.postDate() < date) && t.hasReferenceTo(id))
+                return true;
+        }
+        return false;
+    }
+
+    QHash<QString, AccountHistory> history(const QDate& date, const QStringList& accountIds) const override
+    {
+        QHash<QString, AccountHistory> result;
+        for (const auto& t : m_list) {
+            if (t.postDate() >= date)
+                continue;
+            for (const auto& split : t.splits()) {
+                if (!accountIds.isEmpty() && !accountIds.contains(split.accountId()))
+                    continue;
+                auto& entry = result[split.accountId()];
+                entry.balance += split.shares();
+                if (split.reconcileFlag() != eMyMoney::Split::State::NotReconciled)
+                    entry.clearedBalance += split.shares();
+                ++entry.splitCount;
+            }
+        }
+        return result;
+    }
+
+    unsigned int transactionCount(const QDate& date) const override
+    {
+        unsigned int count = 0;
+        for (const auto& t : m_list) {
+            if (t.postDate() < date)
+                ++count;
+        }
+        return count;
+    }
+
+    QString lastTransactionId() const override
+    {
+        return m_list.isEmpty() ? QString() : m_list.last().id();
+    }
+
+private:
+    QMap<QString, MyMoneyTransaction> m_list;
+};
+} // namespace
+
+QMap<QString, MyMoneyTransaction> JournalModelTest::createJournal(int count, const std::function<void(int, MyMoneyTransaction&, MyMoneySplit&)>& setup) const
+{
+    QMap<QString, MyMoneyTransaction> list;
+    for (int i = 0; i < count; ++i) {
+        MyMoneyTransaction t;
+        MyMoneySplit sp1;
+        // create a new string for each split
+        sp1.setAccountId(QString("A%1").arg(1, 6, 10, QLatin1Char('0')));
+        setup(i, t, sp1);
+        t.addSplit(sp1);
+        MyMoneySplit sp2;
+        sp2.setAccountId(QString("A%1").arg(2, 6, 10, QLatin1Char('0')));
+        sp2.setShares(-sp1.shares());
+        sp2.setValue(-sp1.value());
+        t.addSplit(sp2);
+        t = MyMoneyTransaction(QString("T%1").arg(i + 1, 18, 10, QLatin1Char('0')), t);
+        list[t.uniqueSortKey()] = t;
+    }
+    return list;
+}
+
+void JournalModelTest::testTreeItemRows()
+{
+    TreeItem<int> root(0);
+
+    QVector<TreeItem<int>*> items;
+    for (int i = 0; i < 10; ++i) {
+        items.append(new TreeItem<int>(i, &root));
+    }
+    root.appendChildren(items);
+
+    // insert some in the middle
+    items.clear();
+    for (int i = 10; i < 13; ++i) {
+        items.append(new TreeItem<int>(i, &root));
+    }
+    QVERIFY(root.insertChildren(4, items));
+    QCOMPARE(root.childCount(), 13);
+    for (int row = 0; row < root.childCount(); ++row) {
+        QCOMPARE(root.child(row)->row(), row);
+    }
+    QCOMPARE(root.child(4)->data(), 10);
+
+    // take some out
+    items = root.takeChildren(2, 5);
+    QCOMPARE(items.count(), 5);
+    QCOMPARE(root.childCount(), 8);
+    for (int row = 0; row < root.childCount(); ++row) {
+        QCOMPARE(root.child(row)->row(), row);
+    }
+
+    // and add them at the end again
+    root.appendChildren(items);
+    QCOMPARE(root.childCount(), 13);
+    for (int row = 0; row < root.childCount(); ++row) {
+        QCOMPARE(root.child(row)->row(), row);
+    }
+
+    // remove a few
+    QVERIFY(root.removeChildren(0, 3));
+    QVERIFY(root.removeChild(5));
+    QCOMPARE(root.childCount(), 9);
+    for (int row = 0; row < root.childCount(); ++row) {
+        QCOMPARE(root.child(row)->row(), row);
+    }
+
+    // an invalid range does not modify anything
+    QVERIFY(root.takeChildren(8, 2).isEmpty());
+    QCOMPARE(root.childCount(), 9);
+}
+
+void JournalModelTest::testRowsOfLargeJournal()
+{
+    const int transactionCount = 250000;
+
+    const QDate date(2000, 1, 1);
+    const auto list = createJournal(transactionCount, [&](int i, MyMoneyTransaction& t, MyMoneySplit& sp1) {
+        t.setPostDate(date.addDays(i / 100));
+        sp1.setShares(MyMoneyMoney(-100, 100));
+        sp1.setValue(MyMoneyMoney(-100, 100));
+    });
+
+    JournalModel model;
+    model.load(list);
+    const auto rows = model.rowCount();
+    QCOMPARE(rows, 2 * transactionCount);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int row = 0; row < rows; ++row) {
+        const auto idx = model.index(row, 0);
+        QVERIFY(!model.parent(idx).isValid());
+        QCOMPARE(static_cast<TreeItem<JournalEntry>*>(idx.internalPointer())->row(), row);
+    }
+
+    // looking up the index through the id mapper uses the row as well
+    for (int row = rows - 1000; row < rows; ++row) {
+        QCOMPARE(model.indexById(model.constItemAt(row).id()).row(), row);
+    }
+
+    // with a linear row() the above takes minutes
+    QVERIFY2(timer.elapsed() < 10000, qPrintable(QString("Took %1 ms").arg(timer.elapsed())));
+}
+
+void JournalModelTest::testPartialLoad()
+{
+    // one transaction on the 15th of each month in 2020 and 2021
+    const auto list = createJournal(24, [&](int i, MyMoneyTransaction& t, MyMoneySplit& sp1) {
+        t.setPostDate(QDate(2020, 1, 15).addMonths(i));
+        sp1.setShares(MyMoneyMoney(10, 1));
+        sp1.setValue(MyMoneyMoney(10, 1));
+        // every other one is cleared
+        if (i % 2) {
+            sp1.setReconcileFlag(eMyMoney::Split::State::Cleared);
+        }
+        // only the oldest one references a payee
+        if (i == 0) {
+            sp1.setPayeeId(QStringLiteral("P000001"));
+        }
+    });
+
+    QMap<QString, MyMoneyTransaction> recentList;
+    const QDate firstDate(2021, 1, 1);
+    for (auto it = list.constBegin(); it != list.constEnd(); ++it) {
+        if ((*it).postDate() >= firstDate) {
+            recentList.insert(it.key(), *it);
+        }
+    }
+
+    JournalModel model;
+    model.loadPartial(recentList, firstDate, QSharedPointer<JournalLoader>(new TestJournalLoader(list)));
+    QCOMPARE(model.rowCount(), 2 * 12);
+    QCOMPARE(model.firstLoadedDate(), firstDate);
+    QVERIFY(!model.isDirty());
+
+    // new ids must not collide with the ones not loaded
+    QCOMPARE(model.peekNextId(), QString("T%1").arg(25, 18, 10, QLatin1Char('0')));
+
+    // balances cover the transactions not loaded
+    QCOMPARE(model.openingBalance(QStringLiteral("A000001")), MyMoneyMoney(120, 1));
+    QCOMPARE(model.balance(QStringLiteral("A000001"), QDate(2021, 12, 31)), MyMoneyMoney(240, 1));
+    QCOMPARE(model.balance(QStringLiteral("A000002"), QDate(2021, 1, 31)), MyMoneyMoney(-130, 1));
+    QCOMPARE(model.balance(QStringLiteral("A000001"), QDate(2020, 6, 30)), MyMoneyMoney(60, 1));
+    QCOMPARE(model.clearedBalance(QStringLiteral("A000001"), QDate(2021, 12, 31)), MyMoneyMoney(120, 1));
+    QCOMPARE(model.clearedBalance(QStringLiteral("A000001"), QDate(2020, 6, 30)), MyMoneyMoney(30, 1));
+    QCOMPARE(model.transactionCount(QStringLiteral("A000001")), 24u);
+    QCOMPARE(model.transactionCount(QString()), 24u);
+
+    // lists cover the transactions not loaded without paging them in
+    JournalModel completeModel;
+    completeModel.load(list);
+    MyMoneyTransactionFilter filter;
+    filter.setDateFilter(QDate(2020, 6, 1), QDate());
+    QList<MyMoneyTransaction> transactions;
+    QList<MyMoneyTransaction> expectedTransactions;
+    model.transactionList(transactions, filter);
+    completeModel.transactionList(expectedTransactions, filter);
+    QCOMPARE(transactions.count(), expectedTransactions.count());
+    for (int i = 0; i < transactions.count(); ++i) {
+        QCOMPARE(transactions.at(i).id(), expectedTransactions.at(i).id());
+    }
+    QCOMPARE(model.firstLoadedDate(), firstDate);
+    QCOMPARE(model.rowCount(), 2 * 12);
+
+    // so do lookups and reference checks
+    const auto t = model.transactionById(QString("T%1").arg(1, 18, 10, QLatin1Char('0')));
+    QCOMPARE(t.postDate(), QDate(2020, 1, 15));
+    QVERIFY(model.hasReferenceTo(QStringLiteral("P000001")));
+    QVERIFY(!model.hasReferenceTo(QStringLiteral("P000002")));
+    QCOMPARE(model.firstLoadedDate(), firstDate);
+    QCOMPARE(model.rowCount(), 2 * 12);
+
+    // paging in older transactions
+    model.loadOlderEntries(QDate(2020, 6, 1));
+    QCOMPARE(model.firstLoadedDate(), QDate(2020, 6, 1));
+    QCOMPARE(model.rowCount(), 2 * 19);
+    QVERIFY(!model.isDirty());
+    for (int row = 1; row < model.rowCount(); ++row) {
+        QVERIFY(model.constItemAt(row - 1).id() < model.constItemAt(row).id());
+    }
+    QCOMPARE(model.openingBalance(QStringLiteral("A000001")), MyMoneyMoney(50, 1));
+    QCOMPARE(model.balance(QStringLiteral("A000001"), QDate(2020, 6, 30)), MyMoneyMoney(60, 1));
+    QCOMPARE(model.balance(QStringLiteral("A000001"), QDate(2021, 12, 31)), MyMoneyMoney(240, 1));
+    QCOMPARE(model.clearedBalance(QStringLiteral("A000001"), QDate(2020, 6, 30)), MyMoneyMoney(30, 1));
+    QCOMPARE(model.transactionCount(QStringLiteral("A000001")), 24u);
+
+    // an invalid date loads the complete journal
+    model.loadOlderEntries(QDate());
+    QVERIFY(!model.firstLoadedDate().isValid());
+    QCOMPARE(model.rowCount(), 2 * 24);
+    QVERIFY(!model.isDirty());
+    QCOMPARE(model.openingBalance(QStringLiteral("A000001")), MyMoneyMoney());
+    QCOMPARE(model.balance(QStringLiteral("A000001"), QDate(2020, 6, 30)), MyMoneyMoney(60, 1));
+    QCOMPARE(model.transactionCount(QStringLiteral("A000001")), 24u);
+    QCOMPARE(model.transactionCount(QString()), 24u);
+}
+
+void JournalModelTest::testCompactEntries()
+{
+    // createJournal() uses a new string for the account id of each split
+    const auto list = createJournal(10, [&](int i, MyMoneyTransaction& t, MyMoneySplit& sp1) {
+        t.setPostDate(QDate(2021, 1, 1).addDays(i));
+        sp1.setPayeeId(QString("P%1").arg(1, 6, 10, QLatin1Char('0')));
+        sp1.setShares(MyMoneyMoney(i, 1));
+        sp1.setValue(MyMoneyMoney(i, 1));
+    });
+
+    JournalModel model;
+    model.load(list);
+    QCOMPARE(model.rowCount(), 2 * 10);
+
+    for (int row = 0; row < model.rowCount(); row += 2) {
+        const auto& first = model.constItemAt(row);
+        const auto& second = model.constItemAt(row + 1);
+        // the entries refer to the splits of their shared transaction
+        QCOMPARE(&first.transaction(), &second.transaction());
+        QCOMPARE(&first.split(), &first.transaction().splitAt(0));
+        QCOMPARE(&second.split(), &second.transaction().splitAt(1));
+        QCOMPARE(first.split(), list.value(first.transaction().uniqueSortKey()).splits().at(0));
+        QCOMPARE(second.split(), list.value(second.transaction().uniqueSortKey()).splits().at(1));
+
+        // and the ids of all splits share the same data
+        QCOMPARE(first.split().accountId().constData(), model.constItemAt(0).split().accountId().constData());
+        QCOMPARE(first.split().payeeId().constData(), model.constItemAt(0).split().payeeId().constData());
+        QCOMPARE(second.split().accountId().constData(), model.constItemAt(1).split().accountId().constData());
+    }
+}
+
+void JournalModelTest::testNumberIndex()
+{
+    const QStringList numbers = { QStringLiteral("100"), QStringLiteral("102"), QStringLiteral("ABC"), QStringLiteral("101"), QStringLiteral("102") };
+    const auto list = createJournal(numbers.count(), [&](int i, MyMoneyTransaction& t, MyMoneySplit& sp1) {
+        t.setPostDate(QDate(2021, 1, 1).addDays(i));
+        sp1.setNumber(numbers.at(i));
+        sp1.setShares(MyMoneyMoney(i, 1));
+        sp1.setValue(MyMoneyMoney(i, 1));
+    });
+
+    QUndoStack undoStack;
+    JournalModel model(nullptr, &undoStack);
+    model.load(list);
+
+    QVERIFY(model.isNumberUsed(QStringLiteral("A000001"), QStringLiteral("100")));
+    QVERIFY(model.isNumberUsed(QStringLiteral("A000001"), QStringLiteral("ABC")));
+    QVERIFY(!model.isNumberUsed(QStringLiteral("A000001"), QStringLiteral("103")));
+    QVERIFY(!model.isNumberUsed(QStringLiteral("A000002"), QStringLiteral("100")));
+    QVERIFY(!model.isNumberUsed(QStringLiteral("A000001"), QString()));
+    QCOMPARE(model.highestNumber(QStringLiteral("A000001")), QStringLiteral("102"));
+    QCOMPARE(model.highestNumber(QStringLiteral("A000002")), QString());
+    QCOMPARE(model.numberCount(QStringLiteral("A000001")), 4);
+    QCOMPARE(model.numberCount(QStringLiteral("A000002")), 0);
+
+    // the next free number skips the block of used numbers
+    QCOMPARE(model.nextFreeNumber(QStringLiteral("A000001"), QStringLiteral("100")), QStringLiteral("103"));
+    QCOMPARE(model.nextFreeNumber(QStringLiteral("A000001"), QStringLiteral("101")), QStringLiteral("103"));
+    QCOMPARE(model.nextFreeNumber(QStringLiteral("A000001"), QStringLiteral("99")), QStringLiteral("99"));
+    QCOMPARE(model.nextFreeNumber(QStringLiteral("A000002"), QStringLiteral("100")), QStringLiteral("100"));
+    QCOMPARE(model.nextFreeNumber(QStringLiteral("A000001"), QStringLiteral("ABC")), QString());
+    QCOMPARE(model.nextFreeNumber(QStringLiteral("A000001"), QStringLiteral("0100")), QString());
+
+    // a number is not in use if only the skipped transaction uses it
+    const auto id100 = QString("T%1").arg(1, 18, 10, QLatin1Char('0'));
+    const auto id102 = QString("T%1").arg(2, 18, 10, QLatin1Char('0'));
+    QVERIFY(!model.isNumberUsed(QStringLiteral("A000001"), QStringLiteral("100"), id100));
+    QVERIFY(model.isNumberUsed(QStringLiteral("A000001"), QStringLiteral("102"), id102));
+
+    // the index follows modifications of the journal
+    auto t = model.transactionById(id100);
+    auto split = t.splits().first();
+    split.setNumber(QStringLiteral("110"));
+    t.modifySplit(split);
+    model.modifyTransaction(t);
+    QVERIFY(!model.isNumberUsed(QStringLiteral("A000001"), QStringLiteral("100")));
+    QVERIFY(model.isNumberUsed(QStringLiteral("A000001"), QStringLiteral("110")));
+    QCOMPARE(model.highestNumber(QStringLiteral("A000001")), QStringLiteral("110"));
+
+    model.removeTransaction(model.transactionById(id100));
+    QVERIFY(!model.isNumberUsed(QStringLiteral("A000001"), QStringLiteral("110")));
+    QCOMPARE(model.highestNumber(QStringLiteral("A000001")), QStringLiteral("102"));
+    QCOMPARE(model.numberCount(QStringLiteral("A000001")), 3);
+
+    // a number used twice remains in use until both are gone
+    model.removeTransaction(model.transactionById(id102));
+    QVERIFY(model.isNumberUsed(QStringLiteral("A000001"), QStringLiteral("102")));
+    QCOMPARE(model.highestNumber(QStringLiteral("A000001")), QStringLiteral("102"));
+
+    MyMoneyTransaction t2;
+    t2.setPostDate(QDate(2021, 2, 1));
+    MyMoneySplit sp;
+    sp.setAccountId(QStringLiteral("A000002"));
+    sp.setNumber(QStringLiteral("7"));
+    t2.addSplit(sp);
+    model.addTransaction(t2);
+    QVERIFY(model.isNumberUsed(QStringLiteral("A000002"), QStringLiteral("7")));
+    QCOMPARE(model.highestNumber(QStringLiteral("A000002")), QStringLiteral("7"));
+}
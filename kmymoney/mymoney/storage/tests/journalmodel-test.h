@@ -0,0 +1,40 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef JOURNALMODELTEST_H
+#define JOURNALMODELTEST_H
+
+#include <functional>
+
+#include <QObject>
+#include <QMap>
+#include <QString>
+
+class MyMoneyTransaction;
+class MyMoneySplit;
+
+class JournalModelTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    /**
+     * Creates a journal of @a count transactions each moving money
+     * from account A000002 to account A000001. Before the transaction
+     * receives its id, @a setup is called with the index of the
+     * transaction, the transaction and the split of A000001. The
+     * split of A000002 balances the one of A000001.
+     */
+    QMap<QString, MyMoneyTransaction> createJournal(int count, const std::function<void(int, MyMoneyTransaction&, MyMoneySplit&)>& setup) const;
+
+private Q_SLOTS:
+    void testTreeItemRows();
+    void testRowsOfLargeJournal();
+    void testPartialLoad();
+    void testCompactEntries();
+    void testNumberIndex();
+};
+
+#endif
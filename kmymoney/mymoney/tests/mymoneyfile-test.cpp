@@ -12,6 +12,7 @@
 #include <QDataStream>
 #include <QList>
 #include <QTest>
+#include <QUndoStack>
 
 #include "mymoneytestutils.h"
 #include "mymoneyexception.h"
@@ -24,10 +25,14 @@
 #include "mymoneysplit.h"
 #include "mymoneyprice.h"
 #include "mymoneypayee.h"
+#include "mymoneytag.h"
 #include "mymoneyenums.h"
+#include "mymoneychangeset.h"
 #include "onlinejob.h"
 #include "payeesmodel.h"
 #include "accountsmodel.h"
+#include "journalmodel.h"
+#include "pricemodel.h"
 
 #include "payeeidentifier/ibanbic/ibanbic.h"
 #include "payeeidentifiertyped.h"
@@ -1376,6 +1381,67 @@ void MyMoneyFileTest::testBalanceTotal()
 
 }
 
+void MyMoneyFileTest::testBalanceHistory()
+{
+    testAddTransaction();
+    MyMoneyTransaction t;
+
+    // construct a second transaction which is cleared
+    t.setPostDate(QDate(2002, 3, 1));
+    t.setMemo("Memotext");
+
+    MyMoneySplit split1;
+    MyMoneySplit split2;
+
+    MyMoneyFileTransaction ft;
+    try {
+        split1.setAccountId("A000001");
+        split1.setShares(MyMoneyMoney(-2000, 100));
+        split1.setValue(MyMoneyMoney(-2000, 100));
+        split1.setReconcileFlag(eMyMoney::Split::State::Cleared);
+        split2.setAccountId("A000004");
+        split2.setValue(MyMoneyMoney(2000, 100));
+        split2.setShares(MyMoneyMoney(2000, 100));
+        t.addSplit(split1);
+        t.addSplit(split2);
+        m->addTransaction(t);
+        ft.commit();
+
+        QVERIFY(m->balance("A000001", QDate(2002, 1, 15)).isZero());
+        QCOMPARE(m->balance("A000001", QDate(2002, 2, 1)), MyMoneyMoney(-1000, 100));
+        QCOMPARE(m->balance("A000001", QDate(2002, 2, 15)), MyMoneyMoney(-1000, 100));
+        QCOMPARE(m->balance("A000001", QDate(2002, 3, 1)), MyMoneyMoney(-3000, 100));
+        QVERIFY(m->journalModel()->clearedBalance("A000001", QDate(2002, 2, 15)).isZero());
+        QCOMPARE(m->journalModel()->clearedBalance("A000001", QDate(2002, 3, 1)), MyMoneyMoney(-2000, 100));
+
+        // move the first transaction behind the second one
+        ft.restart();
+        MyMoneyTransaction t1 = m->transaction("T000000000000000001");
+        t1.setPostDate(QDate(2002, 4, 1));
+        m->modifyTransaction(t1);
+        ft.commit();
+
+        QVERIFY(m->balance("A000001", QDate(2002, 2, 15)).isZero());
+        QCOMPARE(m->balance("A000001", QDate(2002, 3, 1)), MyMoneyMoney(-2000, 100));
+        QCOMPARE(m->balance("A000001", QDate(2002, 4, 1)), MyMoneyMoney(-3000, 100));
+        QVERIFY(m->balance("A000003", QDate(2002, 3, 15)).isZero());
+        QCOMPARE(m->balance("A000003", QDate(2002, 4, 1)), MyMoneyMoney(1000, 100));
+
+        // and remove the second one
+        ft.restart();
+        m->removeTransaction(t);
+        ft.commit();
+
+        QVERIFY(m->balance("A000001", QDate(2002, 3, 15)).isZero());
+        QCOMPARE(m->balance("A000001", QDate(2002, 4, 1)), MyMoneyMoney(-1000, 100));
+        QVERIFY(m->balance("A000004", QDate(2002, 4, 1)).isZero());
+        QVERIFY(m->journalModel()->clearedBalance("A000001", QDate(2002, 4, 1)).isZero());
+
+    } catch (const MyMoneyException &) {
+        QFAIL("Unexpected exception!");
+    }
+}
+
 /// @todo cleanup
 #if 0
 void MyMoneyFileTest::testSetAccountName()
@@ -1537,6 +1603,74 @@ void MyMoneyFileTest::testRemovePayee()
     }
 }
 
+void MyMoneyFileTest::testIsReferenced()
+{
+    testAddTransaction();
+
+    MyMoneyPayee payee;
+    payee.setName("Referenced payee");
+    MyMoneyFileTransaction ft;
+    try {
+        m->addPayee(payee);
+        ft.commit();
+    } catch (const MyMoneyException &e) {
+        unexpectedException(e);
+    }
+    QVERIFY(!m->isReferenced(payee));
+    QVERIFY(!m->referencedObjects().contains(payee.id()));
+
+    MyMoneyTransaction t = m->transaction("T000000000000000001");
+    MyMoneyTransaction tPayee(t);
+    for (auto split : t.splits()) {
+        split.setPayeeId(payee.id());
+        tPayee.modifySplit(split);
+    }
+
+    // a modification which is rolled back does not leave a reference
+    ft.restart();
+    try {
+        m->modifyTransaction(tPayee);
+        QVERIFY(m->isReferenced(payee));
+        ft.rollback();
+    } catch (const MyMoneyException &e) {
+        unexpectedException(e);
+    }
+    QVERIFY(!m->isReferenced(payee));
+
+    ft.restart();
+    try {
+        m->modifyTransaction(tPayee);
+        ft.commit();
+    } catch (const MyMoneyException &e) {
+        unexpectedException(e);
+    }
+    QVERIFY(m->isReferenced(payee));
+    QVERIFY(m->referencedObjects().contains(payee.id()));
+
+    // the payee is still referenced by the second split
+    MyMoneySplit split = tPayee.splits().first();
+    split.setPayeeId(QString());
+    tPayee.modifySplit(split);
+    ft.restart();
+    try {
+        m->modifyTransaction(tPayee);
+        ft.commit();
+    } catch (const MyMoneyException &e) {
+        unexpectedException(e);
+    }
+    QVERIFY(m->isReferenced(payee));
+
+    ft.restart();
+    try {
+        m->removeTransaction(tPayee);
+        ft.commit();
+    } catch (const MyMoneyException &e) {
+        unexpectedException(e);
+    }
+    QVERIFY(!m->isReferenced(payee));
+    QVERIFY(!m->referencedObjects().contains(payee.id()));
+}
+
 void MyMoneyFileTest::testPayeeWithIdentifier()
 {
     MyMoneyPayee p;
@@ -1985,6 +2119,55 @@ void MyMoneyFileTest::testAddPrice()
     QCOMPARE(m_valueChanged.count("A000002"), 1);
 }
 
+void MyMoneyFileTest::testAddPrices()
+{
+    testAddPrice();
+
+    const auto today = QDate::currentDate();
+    const auto rowCount = m->priceModel()->rowCount();
+
+    clearObjectLists();
+    MyMoneyFileTransaction ft;
+    m->addPrices({
+        MyMoneyPrice("EUR", "RON", today.addDays(-2), MyMoneyMoney(4.2), "Test source"),
+        MyMoneyPrice("EUR", "RON", today, MyMoneyMoney(4.3), "Test source"),
+        MyMoneyPrice("EUR", "RON", today.addDays(-1), MyMoneyMoney(4.4), "Test source"),
+        MyMoneyPrice("EUR", "RON", today.addDays(-2), MyMoneyMoney(4.5), "Test source"),
+        MyMoneyPrice("EUR", "USD", today.addDays(-1), MyMoneyMoney(), "Test source"),
+    });
+    ft.commit();
+    QCOMPARE(m_balanceChanged.count(), 0);
+    QCOMPARE(m_valueChanged.count(), 1);
+    QCOMPARE(m_valueChanged.count("A000002"), 1);
+
+    // the price of today is replaced, the last one of the
+    // same date wins and prices with a zero rate are ignored
+    QCOMPARE(m->priceModel()->rowCount(), rowCount + 2);
+    QCOMPARE(m->price("EUR", "RON", today, true).rate("RON"), MyMoneyMoney(4.3));
+    QCOMPARE(m->price("EUR", "RON", today.addDays(-1), true).rate("RON"), MyMoneyMoney(4.4));
+    QCOMPARE(m->price("EUR", "RON", today.addDays(-2), true).rate("RON"), MyMoneyMoney(4.5));
+    QVERIFY(!m->price("EUR", "USD", today.addDays(-1), true).isValid());
+
+    // the model is still sorted
+    const auto model = m->priceModel();
+    for (int row = 1; row < model->rowCount(); ++row) {
+        QVERIFY(model->index(row - 1, 0).data(eMyMoney::Model::IdRole).toString() < model->index(row, 0).data(eMyMoney::Model::IdRole).toString());
+    }
+
+    // a rollback removes the new prices and restores the replaced one
+    ft.restart();
+    m->addPrices({
+        MyMoneyPrice("EUR", "RON", today, MyMoneyMoney(4.6), "Test source"),
+        MyMoneyPrice("EUR", "RON", today.addDays(-3), MyMoneyMoney(4.7), "Test source"),
+    });
+    QCOMPARE(m->priceModel()->rowCount(), rowCount + 3);
+    QCOMPARE(m->price("EUR", "RON", today, true).rate("RON"), MyMoneyMoney(4.6));
+    ft.rollback();
+    QCOMPARE(m->priceModel()->rowCount(), rowCount + 2);
+    QCOMPARE(m->price("EUR", "RON", today, true).rate("RON"), MyMoneyMoney(4.3));
+    QVERIFY(!m->price("EUR", "RON", today.addDays(-3), true).isValid());
+}
+
 void MyMoneyFileTest::testRemovePrice()
 {
     testAddPrice();
@@ -2045,6 +2228,170 @@ void MyMoneyFileTest::testGetPrice()
     }
 }
 
+void MyMoneyFileTest::testPriceSeries()
+{
+    testAddPrice();
+    const auto today = QDate::currentDate();
+
+    // add some more prices in both directions
+    MyMoneyFileTransaction ft;
+    m->addPrice(MyMoneyPrice("EUR", "RON", today.addDays(3), MyMoneyMoney(4.2), "Test source"));
+    m->addPrice(MyMoneyPrice("RON", "EUR", today.addDays(5), MyMoneyMoney(1 / 4.3), "Test source"));
+    ft.commit();
+
+    // the dates are not sorted on purpose
+    const QVector<QDate> dates = {
+        today.addDays(6), today.addDays(-1), today, today.addDays(4), today.addDays(3), today.addDays(5),
+    };
+
+    // the series must provide the same results as individual calls to price()
+    for (const auto exactDate : { false, true }) {
+        const auto prices = m->priceSeries("EUR", "RON", dates, exactDate);
+        QCOMPARE(prices.count(), dates.count());
+        for (int i = 0; i < dates.count(); ++i) {
+            const auto price = m->price("EUR", "RON", dates.at(i), exactDate);
+            QCOMPARE(prices.at(i).isValid(), price.isValid());
+            if (price.isValid()) {
+                QCOMPARE(prices.at(i).date(), price.date());
+                QCOMPARE(prices.at(i).from(), price.from());
+                QCOMPARE(prices.at(i).rate("RON"), price.rate("RON"));
+            }
+        }
+    }
+
+    const auto prices = m->priceSeries("EUR", "RON", dates, false);
+    QVERIFY(!prices.at(1).isValid());
+    // on the same date 'from-to' is preferred
+    QCOMPARE(prices.at(2).from(), QLatin1String("EUR"));
+    QCOMPARE(prices.at(3).date(), today.addDays(3));
+    QCOMPARE(prices.at(3).rate("RON"), MyMoneyMoney(4.2));
+    // the reciprocal price is the most recent one
+    QCOMPARE(prices.at(0).date(), today.addDays(5));
+    QCOMPARE(prices.at(0).from(), QLatin1String("RON"));
+}
+
+void MyMoneyFileTest::testUnsavedChanges()
+{
+    // nothing is known about the storage as long as nothing has been loaded or saved
+    QVERIFY(!m->hasCompleteChangeTracking());
+
+    testAddTwoInstitutions();
+    m->fileSaved();
+    QVERIFY(m->hasCompleteChangeTracking());
+    QVERIFY(m->unsavedChanges().isEmpty());
+    QVERIFY(m->unsavedPriceChanges().isEmpty());
+
+    MyMoneyInstitution institution1 = m->institution("I000001");
+    MyMoneyInstitution institution2 = m->institution("I000002");
+    MyMoneyInstitution institution3;
+    institution3.setName("institution3");
+
+    MyMoneyFileTransaction ft;
+    institution1.setName("renamed");
+    m->modifyInstitution(institution1);
+    m->removeInstitution(institution2);
+    m->addInstitution(institution3);
+    m->addPrice(MyMoneyPrice("EUR", "USD", QDate(2020, 1, 1), MyMoneyMoney(1.1), "Test source"));
+    ft.commit();
+
+    auto changes = m->unsavedChanges().value(eMyMoney::File::Object::Institution);
+    QCOMPARE(changes.count(), 3);
+    QCOMPARE(changes.value(institution1.id()), eMyMoney::File::Mode::Modify);
+    QCOMPARE(changes.value(institution2.id()), eMyMoney::File::Mode::Remove);
+    QCOMPARE(changes.value(institution3.id()), eMyMoney::File::Mode::Add);
+    QCOMPARE(m->unsavedPriceChanges().count(), 1);
+    QVERIFY(m->unsavedPriceChanges().contains(qMakePair(QString("EUR"), QString("USD"))));
+
+    // an added object stays added when it is modified
+    ft.restart();
+    institution3.setName("modified");
+    m->modifyInstitution(institution3);
+    ft.commit();
+    changes = m->unsavedChanges().value(eMyMoney::File::Object::Institution);
+    QCOMPARE(changes.value(institution3.id()), eMyMoney::File::Mode::Add);
+
+    // and an added object that is removed again does not need to be saved
+    ft.restart();
+    m->removeInstitution(institution3);
+    ft.commit();
+    changes = m->unsavedChanges().value(eMyMoney::File::Object::Institution);
+    QCOMPARE(changes.count(), 2);
+    QVERIFY(!changes.contains(institution3.id()));
+
+    // a rolled back transaction leaves no traces
+    {
+        MyMoneyFileTransaction rollback;
+        institution1.setName("rolled back");
+        m->modifyInstitution(institution1);
+        m->removePrice(MyMoneyPrice("EUR", "USD", QDate(2020, 1, 1), MyMoneyMoney(1.1), "Test source"));
+    }
+    QCOMPARE(m->unsavedChanges().value(eMyMoney::File::Object::Institution), changes);
+    QCOMPARE(m->unsavedPriceChanges().count(), 1);
+    QVERIFY(m->hasCompleteChangeTracking());
+
+    // using the undo stack directly is not tracked
+    m->undoStack()->undo();
+    QVERIFY(!m->hasCompleteChangeTracking());
+
+    m->fileSaved();
+    QVERIFY(m->hasCompleteChangeTracking());
+    QVERIFY(m->unsavedChanges().isEmpty());
+    QVERIFY(m->unsavedPriceChanges().isEmpty());
+}
+
+void MyMoneyFileTest::testChangesCommitted()
+{
+    testAddTwoInstitutions();
+    clearObjectLists();
+
+    QList<MyMoneyChangeSet> changeSets;
+    const auto connection = connect(m, &MyMoneyFile::changesCommitted, this, [&](const MyMoneyChangeSet& changes) {
+        changeSets.append(changes);
+    });
+
+    MyMoneyInstitution institution1 = m->institution("I000001");
+    MyMoneyInstitution institution2 = m->institution("I000002");
+    MyMoneyInstitution institution3;
+    institution3.setName("institution3");
+    MyMoneyInstitution institution4;
+    institution4.setName("institution4");
+
+    MyMoneyFileTransaction ft;
+    institution1.setName("renamed");
+    m->modifyInstitution(institution1);
+    m->modifyInstitution(institution2);
+    m->removeInstitution(institution2);
+    m->addInstitution(institution3);
+    institution3.setName("modified");
+    m->modifyInstitution(institution3);
+    m->addInstitution(institution4);
+    m->removeInstitution(institution4);
+    ft.commit();
+
+    // all changes are reported at once grouped by type
+    QCOMPARE(changeSets.count(), 1);
+    const auto changes = changeSets.first();
+    QCOMPARE(changes.objectTypes(), QList<eMyMoney::File::Object>({ eMyMoney::File::Object::Institution }));
+    QVERIFY(changes.contains(eMyMoney::File::Object::Institution));
+    QVERIFY(!changes.contains(eMyMoney::File::Object::Account));
+    QCOMPARE(changes.modifiedObjects(eMyMoney::File::Object::Institution), QSet<QString>({ institution1.id() }));
+    QCOMPARE(changes.addedObjects(eMyMoney::File::Object::Institution), QSet<QString>({ institution3.id() }));
+    QCOMPARE(changes.removedObjects(eMyMoney::File::Object::Institution), QSet<QString>({ institution2.id(), institution4.id() }));
+    QVERIFY(changes.balanceChangedAccounts().isEmpty());
+
+    // the signals for the single objects are still sent
+    QCOMPARE(m_objectsAdded, QStringList({ institution3.id() }));
+    QCOMPARE(m_objectsRemoved.count(), 2);
+
+    // nothing is sent for a transaction without changes
+    changeSets.clear();
+    ft.restart();
+    ft.commit();
+    QVERIFY(changeSets.isEmpty());
+
+    disconnect(connection);
+}
+
 void MyMoneyFileTest::testAddAccountMissingCurrency()
 {
     testAddTwoInstitutions();
@@ -2665,6 +3012,78 @@ void MyMoneyFileTest::testAdjustedValues()
     QCOMPARE(t2.splitSum(), MyMoneyMoney());
 }
 
+void MyMoneyFileTest::testInvestmentActivities()
+{
+    // creates a buy transaction for the stock
+    testAdjustedValues();
+
+    const auto stock = m->accountByName("Teststock");
+    auto activities = m->journalModel()->investmentActivities(stock.id());
+    QCOMPARE(activities.count(), 1);
+    QCOMPARE(activities.at(0).type, eMyMoney::Split::InvestmentTransactionType::BuyShares);
+    QCOMPARE(activities.at(0).postDate, QDate::currentDate());
+    QCOMPARE(activities.at(0).shares, MyMoneyMoney(QLatin1String("649/1000")));
+    QCOMPARE(activities.at(0).value, MyMoneyMoney(QLatin1String("-999/10")));
+    QVERIFY(activities.at(0).interestValue.isZero());
+
+    MyMoneyAccount income;
+    income.setAccountType(eMyMoney::Account::Type::Income);
+    income.setName("Dividend");
+    income.setCurrencyId("EUR");
+
+    MyMoneyFileTransaction ft;
+    try {
+        MyMoneyAccount parent = m->income();
+        m->addAccount(income, parent);
+        ft.commit();
+    } catch (const MyMoneyException &e) {
+        unexpectedException(e);
+    }
+
+    MyMoneySplit s1, s2;
+    s1.setAccountId(stock.id());
+    s1.setAction(eMyMoney::Split::InvestmentTransactionType::ReinvestDividend);
+    s1.setShares(MyMoneyMoney(1, 10));
+    s1.setValue(MyMoneyMoney(1000, 100));
+    s2.setAccountId(income.id());
+    s2.setShares(MyMoneyMoney(-1000, 100));
+    s2.setValue(MyMoneyMoney(-1000, 100));
+
+    MyMoneyTransaction t;
+    t.setCommodity(QLatin1String("EUR"));
+    t.setPostDate(QDate::currentDate().addDays(1));
+    t.addSplit(s1);
+    t.addSplit(s2);
+
+    // the activities of the account follow the modification of the journal
+    ft.restart();
+    try {
+        m->addTransaction(t);
+        ft.commit();
+    } catch (const MyMoneyException &e) {
+        unexpectedException(e);
+    }
+
+    activities = m->journalModel()->investmentActivities(stock.id());
+    QCOMPARE(activities.count(), 2);
+    QCOMPARE(activities.at(1).type, eMyMoney::Split::InvestmentTransactionType::ReinvestDividend);
+    QCOMPARE(activities.at(1).shares, MyMoneyMoney(1, 10));
+    QVERIFY(activities.at(1).value.isZero());
+    QCOMPARE(activities.at(1).interestValue, MyMoneyMoney(-1000, 100));
+
+    ft.restart();
+    try {
+        m->removeTransaction(t);
+        ft.commit();
+    } catch (const MyMoneyException &e) {
+        unexpectedException(e);
+    }
+
+    activities = m->journalModel()->investmentActivities(stock.id());
+    QCOMPARE(activities.count(), 1);
+    QCOMPARE(activities.at(0).type, eMyMoney::Split::InvestmentTransactionType::BuyShares);
+}
+
 void MyMoneyFileTest::testVatAssignment()
 {
     MyMoneyAccount acc;
@@ -2764,6 +3183,157 @@ void MyMoneyFileTest::testEmptyFilter()
     }
 }
 
+void MyMoneyFileTest::testFilteredTransactionList()
+{
+    testAddAccounts();
+    setupBaseCurrency();
+
+    MyMoneyAccount category;
+    category.setAccountType(eMyMoney::Account::Type::Expense);
+    category.setName("Expense1");
+    MyMoneyPayee payee1;
+    payee1.setName("Payee1");
+    MyMoneyPayee payee2;
+    payee2.setName("Payee2");
+    MyMoneyTag tag;
+    tag.setName("Tag1");
+
+    QStringList transactionIds;
+    MyMoneyFileTransaction ft;
+    try {
+        MyMoneyAccount parent = m->expense();
+        m->addAccount(category, parent);
+        m->addPayee(payee1);
+        m->addPayee(payee2);
+        m->addTag(tag);
+
+        for (int i = 0; i < 60; ++i) {
+            MyMoneyTransaction t;
+            t.setPostDate(QDate(2020, 1, 1).addDays(6 * i));
+            MyMoneySplit sp;
+            sp.setAccountId((i % 2) ? QStringLiteral("A000002") : QStringLiteral("A000001"));
+            sp.setPayeeId((i % 3) ? payee1.id() : payee2.id());
+            if ((i % 4) == 0) {
+                sp.setTagIdList(QList<QString>() << tag.id());
+            }
+            sp.setShares(MyMoneyMoney(-i - 1, 1));
+            sp.setValue(MyMoneyMoney(-i - 1, 1));
+            t.addSplit(sp);
+            MyMoneySplit sc;
+            sc.setAccountId(category.id());
+            sc.setShares(MyMoneyMoney(i + 1, 1));
+            sc.setValue(MyMoneyMoney(i + 1, 1));
+            t.addSplit(sc);
+            m->addTransaction(t);
+            transactionIds.append(t.id());
+        }
+        ft.commit();
+    } catch (const MyMoneyException &e) {
+        unexpectedException(e);
+    }
+
+    QVector<MyMoneyTransactionFilter> filters;
+    MyMoneyTransactionFilter filter;
+    filter.addAccount(QStringLiteral("A000001"));
+    filters << filter;
+    filter.setDateFilter(QDate(2020, 3, 1), QDate(2020, 4, 30));
+    filters << filter;
+    filter.addPayee(payee2.id());
+    filters << filter;
+    filter.clear();
+    filter.addCategory(category.id());
+    filter.setDateFilter(QDate(2020, 6, 1), QDate());
+    filters << filter;
+    filter.clear();
+    filter.addPayee(payee2.id());
+    filters << filter;
+    filter.clear();
+    filter.addTag(tag.id());
+    filter.setDateFilter(QDate(), QDate(2020, 8, 31));
+    filters << filter;
+    filter.clear();
+    filter.setDateFilter(QDate(2020, 2, 1), QDate(2020, 2, 29));
+    filters << filter;
+    filter.clear();
+    filter.setDateFilter(QDate(2021, 2, 1), QDate(2021, 1, 1));
+    filters << filter;
+
+    // the result must be the same as checking each transaction
+    auto verifyFilters = [&]() {
+        QList<MyMoneyTransaction> allTransactions;
+        MyMoneyTransactionFilter all;
+        all.setReportAllSplits(false);
+        m->transactionList(allTransactions, all);
+        QCOMPARE(allTransactions.count(), static_cast<int>(m->journalModel()->transactionCount(QString())));
+
+        for (auto f : filters) {
+            QList<QPair<MyMoneyTransaction, MyMoneySplit>> expected;
+            for (const auto& t : qAsConst(allTransactions)) {
+                for (const auto& split : f.matchingSplits(t)) {
+                    expected.append(qMakePair(t, split));
+                }
+            }
+            QList<QPair<MyMoneyTransaction, MyMoneySplit>> result;
+            m->transactionList(result, f);
+            QCOMPARE(result.count(), expected.count());
+            for (int i = 0; i < result.count(); ++i) {
+                QCOMPARE(result.at(i).first.id(), expected.at(i).first.id());
+                QCOMPARE(result.at(i).second.id(), expected.at(i).second.id());
+            }
+            QList<MyMoneyTransaction> transactions;
+            m->transactionList(transactions, f);
+            QCOMPARE(transactions.count(), expected.count());
+
+            // the evaluation on the thread pool keeps the journal order
+            const auto threshold = m->journalModel()->parallelEvaluationThreshold();
+            m->journalModel()->setParallelEvaluationThreshold(1);
+            QList<QPair<MyMoneyTransaction, MyMoneySplit>> parallelResult;
+            m->transactionList(parallelResult, f);
+            QList<MyMoneyTransaction> parallelTransactions;
+            m->transactionList(parallelTransactions, f);
+            m->journalModel()->setParallelEvaluationThreshold(threshold);
+            QCOMPARE(parallelResult.count(), result.count());
+            for (int i = 0; i < result.count(); ++i) {
+                QCOMPARE(parallelResult.at(i).first.id(), result.at(i).first.id());
+                QCOMPARE(parallelResult.at(i).second.id(), result.at(i).second.id());
+            }
+            QCOMPARE(parallelTransactions.count(), transactions.count());
+            for (int i = 0; i < transactions.count(); ++i) {
+                QCOMPARE(parallelTransactions.at(i).id(), transactions.at(i).id());
+            }
+        }
+    };
+
+    verifyFilters();
+
+    // the indexes follow modifications of the journal
+    ft.restart();
+    try {
+        auto t = m->transaction(transactionIds.at(3));
+        auto sp = t.splits().first();
+        sp.setPayeeId(payee2.id());
+        sp.setTagIdList(QList<QString>() << tag.id());
+        t.modifySplit(sp);
+        t.setPostDate(QDate(2020, 3, 15));
+        m->modifyTransaction(t);
+
+        t = m->transaction(transactionIds.at(12));
+        sp = t.splits().first();
+        sp.setPayeeId(payee1.id());
+        sp.setTagIdList(QList<QString>());
+        sp.setAccountId(QStringLiteral("A000002"));
+        t.modifySplit(sp);
+        m->modifyTransaction(t);
+
+        m->removeTransaction(m->transaction(transactionIds.at(24)));
+        ft.commit();
+    } catch (const MyMoneyException &e) {
+        unexpectedException(e);
+    }
+
+    verifyFilters();
+}
+
 void MyMoneyFileTest::testAddSecurity()
 {
     // create a checking account, an expense, an investment account and a stock
@@ -53,11 +53,13 @@ private Q_SLOTS:
     void testModifyTransactionNewAccount();
     void testRemoveTransaction();
     void testBalanceTotal();
+    void testBalanceHistory();
     /// @todo cleanup
     // void testSetAccountName();
     void testAddPayee();
     void testModifyPayee();
     void testRemovePayee();
+    void testIsReferenced();
     void testPayeeWithIdentifier();
     void testAddTransactionStd();
     void testAccount2Category();
@@ -69,8 +71,12 @@ private Q_SLOTS:
     void testOpeningBalanceNoBase();
     void testOpeningBalance();
     void testAddPrice();
+    void testAddPrices();
     void testRemovePrice();
     void testGetPrice();
+    void testPriceSeries();
+    void testUnsavedChanges();
+    void testChangesCommitted();
     void testAddAccountMissingCurrency();
     void testAddTransactionToClosedAccount();
     void testRemoveTransactionFromClosedAccount();
@@ -93,8 +99,10 @@ private Q_SLOTS:
     void testModifyOnlineJob();
     void testClearedBalance();
     void testAdjustedValues();
+    void testInvestmentActivities();
     void testVatAssignment();
     void testEmptyFilter();
+    void testFilteredTransactionList();
     void testAddSecurity();
 
 private Q_SLOTS:
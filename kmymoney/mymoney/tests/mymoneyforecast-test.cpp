@@ -971,3 +971,52 @@ void MyMoneyForecastTest::testLinearRegression()
 
 
 }
+
+void MyMoneyForecastTest::testManyAccounts()
+{
+    //set up enough accounts to have the forecast computed on the thread pool
+    QStringList accounts;
+    QList<TransactionHelper*> transactions;
+    for (auto i = 0; i < 20; ++i) {
+        const auto id = makeAccount(QString("Checking %1").arg(i), Account::Type::Checkings, moCheckingOpen, QDate(2004, 5, 15), acAsset, "USD");
+        accounts.append(id);
+        transactions.append(new TransactionHelper(QDate::currentDate().addDays(-1), MyMoneySplit::actionName(eMyMoney::Split::Action::Withdrawal), moT1 * MyMoneyMoney(i + 1, 1), id, acSolo));
+    }
+
+    MyMoneyForecast a;
+    a.setForecastMethod(1);
+    a.setForecastDays(3);
+    a.setAccountsCycle(1);
+    a.setForecastCycles(1);
+    a.setBeginForecastDay(0);
+    a.setHistoryMethod(0); //moving average
+    a.doForecast();
+
+    //the trend is the variation of the only day of history
+    for (const auto& id : qAsConst(accounts)) {
+        const auto acc = file->account(id);
+        const auto balance = file->balance(id, QDate::currentDate());
+        const auto trend = file->balance(id, QDate::currentDate().addDays(-1)) - file->balance(id, QDate::currentDate().addDays(-2));
+        QVERIFY(!trend.isZero());
+        QVERIFY(a.forecastBalance(acc, QDate::currentDate()) == balance);
+        for (auto day = 1; day <= 3; ++day) {
+            QVERIFY(a.forecastBalance(acc, QDate::currentDate().addDays(day)) == balance + trend * MyMoneyMoney(day, 1));
+        }
+        QVERIFY(a.forecastBalance(acc, QDate::currentDate().addDays(4)).isZero());
+    }
+
+    //without scheduled or future transactions the balance stays the same
+    a.setForecastMethod(0);
+    a.setIncludeUnusedAccounts(true);
+    a.doForecast();
+
+    for (const auto& id : qAsConst(accounts)) {
+        const auto acc = file->account(id);
+        const auto balance = file->balance(id, QDate::currentDate());
+        for (auto day = 0; day <= 3; ++day) {
+            QVERIFY(a.forecastBalance(acc, QDate::currentDate().addDays(day)) == balance);
+        }
+    }
+
+    qDeleteAll(transactions);
+}
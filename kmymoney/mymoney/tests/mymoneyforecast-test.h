@@ -43,6 +43,7 @@ private Q_SLOTS:
     void testHistoryDays();
     void testCreateBudget();
     void testLinearRegression();
+    void testManyAccounts();
 
 protected:
     MyMoneyForecast *m;
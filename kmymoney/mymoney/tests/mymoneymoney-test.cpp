@@ -737,3 +737,57 @@ void MyMoneyMoneyTest::testZeroDenominator()
     QVERIFY_EXCEPTION_THROWN(MyMoneyMoney m((int)1, 0), MyMoneyException);
     QVERIFY_EXCEPTION_THROWN(MyMoneyMoney m((signed64)1, 0), MyMoneyException);
 }
+
+void MyMoneyMoneyTest::testSmallValueArithmetic()
+{
+    // the integer arithmetic must produce the same values as the
+    // rational arithmetic of AlkValue, also close to an overflow
+    const auto large = std::numeric_limits<qint64>::max() / 3;
+    const QList<MyMoneyMoney> values = {
+        MyMoneyMoney(),
+        MyMoneyMoney(12, 100),
+        MyMoneyMoney(-10, 100),
+        MyMoneyMoney(1, 2),
+        MyMoneyMoney(-7, 3),
+        MyMoneyMoney(1234, 1000),
+        MyMoneyMoney(static_cast<qint64>(195883), 100000),
+        MyMoneyMoney(static_cast<qint64>(-123456789012), 100),
+        MyMoneyMoney(large, 1),
+        MyMoneyMoney(-large, 1),
+        MyMoneyMoney(large, 100),
+        MyMoneyMoney(large - 1, 99),
+        MyMoneyMoney::maxValue,
+        MyMoneyMoney::minValue,
+        MyMoneyMoney::autoCalc,
+        MyMoneyMoney(QString("1234567890123456789012345.67")),
+    };
+
+    const auto compare = [](const MyMoneyMoney& result, const AlkValue& expected) {
+        return result.valueRef().get_num() == expected.valueRef().get_num()
+               && result.valueRef().get_den() == expected.valueRef().get_den();
+    };
+
+    for (const auto& a : values) {
+        for (const auto& b : values) {
+            const AlkValue alkA(a);
+            const AlkValue alkB(b);
+            QVERIFY(compare(a + b, alkA + alkB));
+            QVERIFY(compare(a - b, alkA - alkB));
+            QVERIFY(compare(a * b, alkA * alkB));
+
+            MyMoneyMoney result(a);
+            result += b;
+            QVERIFY(compare(result, alkA + alkB));
+            result = a;
+            result -= b;
+            QVERIFY(compare(result, alkA - alkB));
+            result = a;
+            result *= b;
+            QVERIFY(compare(result, alkA * alkB));
+        }
+    }
+
+    // construction from 64 bit values must match the one from a string
+    QVERIFY(compare(MyMoneyMoney(static_cast<qint64>(-1234500), 1000), AlkValue(QString("-12345/10"), QLatin1Char('.'))));
+    QVERIFY(compare(MyMoneyMoney(std::numeric_limits<qint64>::min(), 100), AlkValue(QString("%1/100").arg(std::numeric_limits<qint64>::min()), QLatin1Char('.'))));
+}
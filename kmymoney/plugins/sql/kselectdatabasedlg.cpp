@@ -112,7 +112,7 @@ int KSelectDatabaseDlg::exec()
         m_widget->textUserName->setText(platformTools::osUsername());
         m_widget->textPassword->setText(QString());
         connect(m_widget->databaseTypeCombo, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &KSelectDatabaseDlg::slotDriverSelected);
-        m_widget->checkPreLoad->setChecked(false);
+        m_widget->checkPreLoad->setChecked(true);
         // ensure a driver gets selected; pre-select the first one
         if (m_widget->databaseTypeCombo->count() != 0) {
             m_widget->databaseTypeCombo->setCurrentIndex(0);
@@ -138,7 +138,8 @@ int KSelectDatabaseDlg::exec()
         // set password required
         m_requiredFields->add(m_widget->textPassword);
 
-        m_widget->checkPreLoad->setChecked(false);
+        const auto options = QUrlQuery(m_url).queryItemValue("options").split(',');
+        m_widget->checkPreLoad->setChecked(!options.contains(QLatin1String("partial")));
         m_sqliteSelected = !m_widget->urlSqlite->text().isEmpty();
     }
 
@@ -159,8 +160,10 @@ const QUrl KSelectDatabaseDlg::selectedURL()
         url.setPath('/' + m_widget->textDbName->text());
     QString qs = QString("driver=%1")
                  .arg(m_widget->databaseTypeCombo->currentData().toString());
-    if (m_widget->checkPreLoad->isChecked())
-        qs.append("&options=loadAll");
+    // only the transactions of the current and the previous year
+    // are loaded initially in case preloading all data is not wanted
+    if (m_widget->checkPreLoad->isEnabled() && !m_widget->checkPreLoad->isChecked())
+        qs.append("&options=partial");
     if (!m_widget->textPassword->text().isEmpty())
         qs.append("&secure=yes");
     url.setQuery(qs);
@@ -21,6 +21,7 @@
 // QT Includes
 
 #include <QInputDialog>
+#include <QRegExp>
 
 // ----------------------------------------------------------------------------
 // KDE Includes
@@ -68,8 +69,8 @@ int MyMoneyStorageSql::open(const QUrl &url, int openMode, bool clear)
         d->m_driver = MyMoneyDbDriver::create(QUrlQuery(url).queryItemValue("driver"));
         //get the input options
         QStringList options = QUrlQuery(url).queryItemValue("options").split(',');
-        d->m_loadAll = true; // force loading whole database into memory since unification of storages
-        // options.contains("loadAll")/*|| m_mode == 0*/;
+        // load the whole database into memory unless only recent transactions are requested
+        d->m_loadAll = !options.contains("partial");
         d->m_override = options.contains("override");
 
         // create the database connection
@@ -265,7 +266,17 @@ bool MyMoneyStorageSql::readFile()
         file->currenciesModel()->loadCurrencies(fetchCurrencies());
         file->securitiesModel()->load(fetchSecurities());
         file->accountsModel()->load(fetchAccounts());
-        file->journalModel()->load(fetchTransactions());
+        if (d->m_loadAll) {
+            file->journalModel()->load(fetchTransactions());
+        } else {
+            // read the transactions of the current and the previous year and
+            // leave it to the journal model to read older ones when needed
+            const QDate firstDate(QDate::currentDate().year() - 1, 1, 1);
+            const auto dateClause = QString("(postDate >= '%1')").arg(firstDate.toString(Qt::ISODate));
+            file->journalModel()->loadPartial(fetchTransactions(QString(), dateClause),
+                                              firstDate,
+                                              QSharedPointer<JournalLoader>(new MyMoneyStorageSqlJournalLoader(this)));
+        }
         file->schedulesModel()->load(fetchSchedules());
         file->priceModel()->load(fetchPrices());
         file->reportsModel()->load(fetchReports());
@@ -299,6 +310,10 @@ bool MyMoneyStorageSql::writeFile()
     d->m_onlineJobs = d->m_payeeIdentifier = 0;
     d->m_displayStatus = true;
     try {
+        // all transactions need to be in memory before
+        // we start to replace the content of the database
+        d->m_file->journalModel()->loadOlderEntries(QDate());
+
         const auto driverName = this->driverName();
         if (driverName.compare(QLatin1String("QSQLITE")) == 0 ||
                 driverName.compare(QLatin1String("QSQLCIPHER")) == 0) {
@@ -306,20 +321,22 @@ bool MyMoneyStorageSql::writeFile()
             query.exec("PRAGMA foreign_keys = ON"); // this is needed for "ON UPDATE" and "ON DELETE" to work
         }
 
-        MyMoneyDbTransaction t(*this, Q_FUNC_INFO);
-        d->writeInstitutions();
-        d->writePayees();
-        d->writeTags();
-        d->writeAccounts();
-        d->writeTransactions();
-        d->writeSchedules();
-        d->writeSecurities();
-        d->writePrices();
-        d->writeCurrencies();
-        d->writeReports();
-        d->writeBudgets();
-        d->writeOnlineJobs();
-        d->writeFileInfo();
+        {
+            MyMoneyDbTransaction t(*this, Q_FUNC_INFO);
+            d->writeInstitutions();
+            d->writePayees();
+            d->writeTags();
+            d->writeAccounts();
+            d->writeTransactions();
+            d->writeSchedules();
+            d->writeSecurities();
+            d->writePrices();
+            d->writeCurrencies();
+            d->writeReports();
+            d->writeBudgets();
+            d->writeOnlineJobs();
+            d->writeFileInfo();
+        }
         // this seems to be nonsense, but it clears the dirty flag
         // as a side-effect.
         //m_storage->setLastModificationDate(m_storage->lastModificationDate());
@@ -329,8 +346,9 @@ bool MyMoneyStorageSql::writeFile()
         d->signalProgress(-1, -1);
         d->m_displayStatus = false;
 
-        /// @todo the engine needs to reset the dirty flags in all models
-        /// signal fileSaved?
+        // the database now reflects the engine's data which
+        // is the starting point for the next writeChanges()
+        d->m_file->fileSaved();
         return true;
 
     } catch (const QString &) {
@@ -338,6 +356,44 @@ bool MyMoneyStorageSql::writeFile()
     }
 }
 
+bool MyMoneyStorageSql::writeChanges()
+{
+    Q_D(MyMoneyStorageSql);
+    if (!d->m_file->hasCompleteChangeTracking())
+        return writeFile();
+
+    d->m_displayStatus = true;
+    try {
+        const auto driverName = this->driverName();
+        if (driverName.compare(QLatin1String("QSQLITE")) == 0 ||
+                driverName.compare(QLatin1String("QSQLCIPHER")) == 0) {
+            QSqlQuery query(*this);
+            query.exec("PRAGMA foreign_keys = ON"); // this is needed for "ON UPDATE" and "ON DELETE" to work
+        }
+
+        {
+            MyMoneyDbTransaction t(*this, Q_FUNC_INFO);
+            d->writeChanges(d->m_file->unsavedChanges(), d->m_file->unsavedPriceChanges());
+            d->writeFileInfo();
+        }
+
+        // make sure the progress bar is not shown any longer
+        d->signalProgress(-1, -1);
+        d->m_displayStatus = false;
+
+        d->m_file->fileSaved();
+        return true;
+
+    } catch (const MyMoneyException& e) {
+        d->m_error = QString::fromLatin1(e.what());
+    } catch (const QString& s) {
+        d->m_error = s;
+    }
+    d->signalProgress(-1, -1);
+    d->m_displayStatus = false;
+    return false;
+}
+
 QString MyMoneyStorageSql::lastError() const
 {
     Q_D(const MyMoneyStorageSql);
@@ -1731,59 +1787,15 @@ QMap<QString, MyMoneyMoney> MyMoneyStorageSql::fetchBalance(const QStringList& i
 {
     Q_D(const MyMoneyStorageSql);
     QMap<QString, MyMoneyMoney> returnValue;
-    QSqlQuery query(*const_cast <MyMoneyStorageSql*>(this));
-    QString queryString = "SELECT action, shares, accountId, postDate "
-                          "FROM kmmSplits WHERE txType = 'N'";
-
-    if (idList.count() > 0) {
-        queryString += "AND accountId in (";
-
-        for (int i = 0; i < idList.count(); ++i) {
-            queryString += QString(":id%1, ").arg(i);
-        }
-        queryString = queryString.left(queryString.length() - 2) + ')';
-    }
 
     // SQLite stores dates as YYYY-MM-DDTHH:mm:ss with 0s for the time part. This makes
     // the <= operator misbehave when the date matches. To avoid this, add a day to the
     // requested date and use the < operator.
-    if (date.isValid() && !date.isNull())
-        queryString += QString(" AND postDate < '%1'").arg(date.addDays(1).toString(Qt::ISODate));
-
-    queryString += " ORDER BY accountId, postDate;";
-    //DBG(queryString);
-    query.prepare(queryString);
-
-    int i = 0;
-    foreach (const QString& bindVal, idList) {
-        query.bindValue(QString(":id%1").arg(i), bindVal);
-        ++i;
+    const auto history = d->fetchAccountHistory(idList, date.addDays(1));
+    for (auto it = history.constBegin(); it != history.constEnd(); ++it) {
+        returnValue.insert(it.key(), (*it).balance);
     }
 
-    if (!query.exec()) // krazy:exclude=crashy
-        throw MYMONEYEXCEPTIONSQL_D(QString::fromLatin1("fetching balance"));
-    QString id;
-    QString oldId;
-    MyMoneyMoney temp;
-    while (query.next()) {
-        id = query.value(2).toString();
-        // If the old ID does not match the new ID, then the account being summed has changed.
-        // Write the balance into the returnValue map and update the oldId to the current one.
-        if (id != oldId) {
-            if (!oldId.isEmpty()) {
-                returnValue.insert(oldId, temp);
-                temp = 0;
-            }
-            oldId = id;
-        }
-        if (MyMoneySplit::actionName(eMyMoney::Split::Action::SplitShares) == query.value(0).toString())
-            temp *= MyMoneyMoney(query.value(1).toString());
-        else
-            temp += MyMoneyMoney(query.value(1).toString());
-    }
-    // Do not forget the last id in the list.
-    returnValue.insert(id, temp);
-
     // Return the map.
     return returnValue;
 }
@@ -1800,7 +1812,6 @@ void MyMoneyStorageSql::readTransactions(const MyMoneyTransactionFilter& filter)
 }
 #endif
 
-#if 0
 QMap<QString, MyMoneyTransaction> MyMoneyStorageSql::fetchTransactions(const QString& tidList, const QString& dateClause, bool /*forUpdate*/) const
 {
     Q_D(const MyMoneyStorageSql);
@@ -1910,7 +1921,6 @@ QMap<QString, MyMoneyTransaction> MyMoneyStorageSql::fetchTransactions(const QSt
 {
     return fetchTransactions(tidList, QString(), false);
 }
-#endif
 
 QMap<QString, MyMoneyTransaction> MyMoneyStorageSql::fetchTransactions() const
 {
@@ -2026,7 +2036,6 @@ QMap<QString, MyMoneyTransaction> MyMoneyStorageSql::fetchTransactions() const
     return txMap;
 }
 
-#if 0
 QMap<QString, MyMoneyTransaction> MyMoneyStorageSql::fetchTransactions(const MyMoneyTransactionFilter& filter) const
 {
     Q_D(const MyMoneyStorageSql);
@@ -2081,9 +2090,16 @@ QMap<QString, MyMoneyTransaction> MyMoneyStorageSql::fetchTransactions(const MyM
         canImplementFilter = false;
     }
     if (!canImplementFilter) {
-        QMap<QString, MyMoneyTransaction> transactionList =  fetchTransactions();
-
-        std::remove_if(transactionList.begin(), transactionList.end(), FilterFail(filter));
+        // read everything and check the filter in memory
+        auto transactionList = fetchTransactions();
+        MyMoneyTransactionFilter f(filter);
+        for (auto it = transactionList.begin(); it != transactionList.end();) {
+            if (f.match(*it)) {
+                ++it;
+            } else {
+                it = transactionList.erase(it);
+            }
+        }
         return transactionList;
     }
 
@@ -2213,6 +2229,7 @@ QMap<QString, MyMoneyTransaction> MyMoneyStorageSql::fetchTransactions(const MyM
     //FIXME: if we have an accounts-only filter, recalc balances on loaded accounts
 }
 
+#if 0
 ulong MyMoneyStorageSql::transactionCount(const QString& aid) const
 {
     Q_D(const MyMoneyStorageSql);
@@ -68,6 +68,7 @@ class MyMoneyStorageSql : public IMyMoneyOperationsFormat, public QSqlDatabase,
 {
     Q_DISABLE_COPY(MyMoneyStorageSql)
     friend class MyMoneyDbDef;
+    friend class MyMoneyStorageSqlJournalLoader;
     KMM_MYMONEY_UNIT_TESTABLE
 
 public:
@@ -99,6 +100,11 @@ public:
     /**
      * MyMoneyStorageSql read all the database into storage
      *
+     * In case the database has been opened with the @c partial option,
+     * only the transactions posted since the beginning of the previous
+     * year are read. Older transactions are read on demand by the journal
+     * model which keeps a reference to this object for that purpose.
+     *
      * @return void
      *
      */
@@ -110,6 +116,18 @@ public:
      *
      */
     bool writeFile();
+    /**
+     * MyMoneyStorageSql update the database with the objects that have
+     * been added, modified or removed since the database was read or
+     * written the last time (see MyMoneyFile::unsavedChanges()). All
+     * changes are written within a single database transaction.
+     *
+     * In case the engine cannot provide a complete list of changes,
+     * the whole database is written using writeFile().
+     *
+     * @return @c true on success, @c false otherwise
+     */
+    bool writeChanges();
 
     /**
      * MyMoneyStorageSql generalized error routine
@@ -34,6 +34,8 @@
 #include <QColor>
 #include <QDebug>
 #include <QStack>
+#include <QHash>
+#include <QSet>
 
 // ----------------------------------------------------------------------------
 // KDE Includes
@@ -230,6 +232,7 @@ public:
         m_hiIdCostCenter(0),
         m_displayStatus(false),
         m_readingPrices(false),
+        m_changesWritten(0),
         m_newDatabase(false),
         m_progressCallback(nullptr)
     {
@@ -938,6 +941,482 @@ public:
     }
     /** @} */
 
+    /**
+     * @name writeChangesMethods
+     * @{
+     * These methods write only the objects which have been added, modified
+     * or removed since the data was loaded from or saved to the database the
+     * last time (see MyMoneyFile::unsavedChanges()). The database is expected
+     * to contain the data as of that time.
+     */
+    typedef QHash<QString, File::Mode> ObjectChanges;
+
+    void writeChanges(const QMap<File::Object, ObjectChanges>& changes, const QSet<MyMoneySecurityPair>& priceChanges)
+    {
+        int count = priceChanges.count();
+        for (const auto& objectChanges : changes) {
+            count += objectChanges.count();
+        }
+        m_changesWritten = 0;
+        signalProgress(0, count, "Writing changes...");
+
+        // the accounts of a transaction need to be collected
+        // before the splits are modified in the database
+        const auto transactionChanges = changes.value(File::Object::Transaction);
+        const auto accountIds = accountsReferencedBy(transactionChanges);
+
+        writeChangedInstitutions(changes.value(File::Object::Institution));
+        writeChangedPayees(changes.value(File::Object::Payee));
+        writeChangedTags(changes.value(File::Object::Tag));
+        writeChangedAccounts(changes.value(File::Object::Account), accountIds);
+        writeChangedTransactions(transactionChanges);
+        writeChangedSchedules(changes.value(File::Object::Schedule));
+        writeChangedSecurities(changes.value(File::Object::Security));
+        writeChangedPrices(priceChanges);
+        writeChangedCurrencies(changes.value(File::Object::Currency));
+        writeChangedReports(changes.value(File::Object::Report));
+        writeChangedBudgets(changes.value(File::Object::Budget));
+        writeChangedOnlineJobs(changes.value(File::Object::OnlineJob));
+
+        // the user information is not covered by the change
+        // tracking but it is a single record anyway
+        Q_Q(MyMoneyStorageSql);
+        QSqlQuery query(*q);
+        query.prepare(m_db.m_tables["kmmPayees"].updateString());
+        writePayee(m_file->user(), query, true);
+    }
+
+    /**
+     * Distributes the ids found in @a changes to the ones that
+     * need to be inserted, updated and deleted in the database.
+     */
+    static void sortChanges(const ObjectChanges& changes, QStringList& insertIds, QStringList& updateIds, QVariantList& deleteIds)
+    {
+        for (auto it = changes.constBegin(); it != changes.constEnd(); ++it) {
+            switch (*it) {
+            case File::Mode::Add:
+                insertIds << it.key();
+                break;
+            case File::Mode::Modify:
+                updateIds << it.key();
+                break;
+            case File::Mode::Remove:
+                deleteIds << it.key();
+                break;
+            }
+        }
+    }
+
+    /**
+     * Returns the ids of all accounts referenced by the transactions in
+     * @a changes before (as found in the database) and after the change.
+     * Their balance and transaction count need to be updated.
+     */
+    QSet<QString> accountsReferencedBy(const ObjectChanges& changes)
+    {
+        Q_Q(MyMoneyStorageSql);
+        QSet<QString> accountIds;
+        QStringList storedIds;
+        for (auto it = changes.constBegin(); it != changes.constEnd(); ++it) {
+            if (*it != File::Mode::Add)
+                storedIds << it.key();
+            if (*it != File::Mode::Remove) {
+                const auto splits = m_file->transaction(it.key()).splits();
+                for (const auto& split : splits) {
+                    accountIds.insert(split.accountId());
+                }
+            }
+        }
+
+        // some drivers limit the number of values bound to
+        // a single statement, so the ids are queried in chunks
+        const int chunkSize = 500;
+        QSqlQuery query(*q);
+        for (int first = 0; first < storedIds.count(); first += chunkSize) {
+            const auto ids = storedIds.mid(first, chunkSize);
+            QString queryIdSet = QString("?, ").repeated(ids.count());
+            queryIdSet.chop(2);
+            query.prepare(QLatin1String("SELECT DISTINCT accountId FROM kmmSplits WHERE transactionId IN (") + queryIdSet + QLatin1String(");"));
+            for (const auto& id : ids) {
+                query.addBindValue(id);
+            }
+            if (!query.exec()) throw MYMONEYEXCEPTIONSQL("retrieving old splits"); // krazy:exclude=crashy
+            while (query.next())
+                accountIds.insert(query.value(0).toString());
+        }
+        return accountIds;
+    }
+
+    void writeChangedInstitutions(const ObjectChanges& changes)
+    {
+        Q_Q(MyMoneyStorageSql);
+        QStringList insertIds;
+        QStringList updateIds;
+        QVariantList deleteIds;
+        sortChanges(changes, insertIds, updateIds, deleteIds);
+
+        QSqlQuery query(*q);
+        if (!insertIds.isEmpty()) {
+            QList<MyMoneyInstitution> list;
+            for (const auto& id : qAsConst(insertIds))
+                list << m_file->institution(id);
+            query.prepare(m_db.m_tables["kmmInstitutions"].insertString());
+            writeInstitutionList(list, query);
+            m_institutions += list.count();
+        }
+
+        if (!updateIds.isEmpty()) {
+            QList<MyMoneyInstitution> list;
+            for (const auto& id : qAsConst(updateIds))
+                list << m_file->institution(id);
+            query.prepare(m_db.m_tables["kmmInstitutions"].updateString());
+            writeInstitutionList(list, query);
+        }
+
+        if (!deleteIds.isEmpty()) {
+            query.prepare("DELETE FROM kmmInstitutions WHERE id = :id");
+            query.bindValue(":id", deleteIds);
+            if (!query.execBatch()) throw MYMONEYEXCEPTIONSQL("deleting Institution");
+            deleteKeyValuePairs("INSTITUTION", deleteIds);
+            deleteKeyValuePairs("OFXSETTINGS", deleteIds);
+            m_institutions -= deleteIds.count();
+        }
+        signalProgress(m_changesWritten += changes.count(), 0);
+    }
+
+    void writeChangedPayees(const ObjectChanges& changes)
+    {
+        Q_Q(MyMoneyStorageSql);
+        QStringList insertIds;
+        QStringList updateIds;
+        QVariantList deleteIds;
+        sortChanges(changes, insertIds, updateIds, deleteIds);
+
+        // payees come with their identifiers, so we use
+        // the same methods as writePayees() does
+        for (const auto& id : qAsConst(insertIds))
+            q->addPayee(m_file->payee(id));
+
+        for (const auto& id : qAsConst(updateIds))
+            q->modifyPayee(m_file->payee(id));
+
+        if (!deleteIds.isEmpty()) {
+            QStringList idList;
+            for (const auto& id : qAsConst(deleteIds))
+                idList << id.toString();
+            const auto payeesToDelete = q->fetchPayees(idList, true);
+            for (const auto& payee : payeesToDelete) {
+                q->removePayee(payee);
+            }
+        }
+        signalProgress(m_changesWritten += changes.count(), 0);
+    }
+
+    void writeChangedTags(const ObjectChanges& changes)
+    {
+        Q_Q(MyMoneyStorageSql);
+        QStringList insertIds;
+        QStringList updateIds;
+        QVariantList deleteIds;
+        sortChanges(changes, insertIds, updateIds, deleteIds);
+
+        QSqlQuery query(*q);
+        query.prepare(m_db.m_tables["kmmTags"].insertString());
+        for (const auto& id : qAsConst(insertIds)) {
+            writeTag(m_file->tag(id), query);
+            ++m_tags;
+        }
+
+        query.prepare(m_db.m_tables["kmmTags"].updateString());
+        for (const auto& id : qAsConst(updateIds))
+            writeTag(m_file->tag(id), query);
+
+        if (!deleteIds.isEmpty()) {
+            query.prepare(m_db.m_tables["kmmTags"].deleteString());
+            query.bindValue(":id", deleteIds);
+            if (!query.execBatch()) throw MYMONEYEXCEPTIONSQL("deleting Tag");
+            m_tags -= query.numRowsAffected();
+        }
+        signalProgress(m_changesWritten += changes.count(), 0);
+    }
+
+    /**
+     * Besides the changed accounts, this method also updates the
+     * accounts in @a balanceChangedIds, because the balance and the
+     * transaction count are stored with the account.
+     */
+    void writeChangedAccounts(const ObjectChanges& changes, const QSet<QString>& balanceChangedIds)
+    {
+        Q_Q(MyMoneyStorageSql);
+        QStringList insertIds;
+        QStringList updateIds;
+        QVariantList deleteIds;
+        sortChanges(changes, insertIds, updateIds, deleteIds);
+
+        for (const auto& id : balanceChangedIds) {
+            if (!changes.contains(id))
+                updateIds << id;
+        }
+
+        QSqlQuery query(*q);
+        if (!insertIds.isEmpty()) {
+            QList<MyMoneyAccount> list;
+            for (const auto& id : qAsConst(insertIds)) {
+                m_transactionCountMap[id] = m_file->transactionCount(id);
+                list << m_file->account(id);
+            }
+            query.prepare(m_db.m_tables["kmmAccounts"].insertString());
+            writeAccountList(list, query);
+            m_accounts += list.count();
+        }
+
+        if (!updateIds.isEmpty()) {
+            QList<MyMoneyAccount> list;
+            for (const auto& id : qAsConst(updateIds)) {
+                m_transactionCountMap[id] = m_file->transactionCount(id);
+                list << m_file->account(id);
+            }
+            query.prepare(m_db.m_tables["kmmAccounts"].updateString());
+            writeAccountList(list, query);
+        }
+
+        if (!deleteIds.isEmpty()) {
+            query.prepare("DELETE FROM kmmAccounts WHERE id = :id");
+            query.bindValue(":id", deleteIds);
+            if (!query.execBatch()) throw MYMONEYEXCEPTIONSQL("deleting Account");
+            deleteKeyValuePairs("ACCOUNT", deleteIds);
+            deleteKeyValuePairs("ONLINEBANKING", deleteIds);
+            for (const auto& id : qAsConst(deleteIds))
+                m_transactionCountMap.remove(id.toString());
+            m_accounts -= deleteIds.count();
+        }
+        signalProgress(m_changesWritten += changes.count(), 0);
+    }
+
+    void writeChangedTransactions(const ObjectChanges& changes)
+    {
+        Q_Q(MyMoneyStorageSql);
+        QStringList insertIds;
+        QStringList updateIds;
+        QVariantList deleteIds;
+        sortChanges(changes, insertIds, updateIds, deleteIds);
+
+        QSqlQuery query(*q);
+        query.prepare(m_db.m_tables["kmmTransactions"].insertString());
+        for (const auto& id : qAsConst(insertIds)) {
+            writeTransaction(id, m_file->transaction(id), query, "N");
+            ++m_transactions;
+            signalProgress(++m_changesWritten, 0);
+        }
+
+        query.prepare(m_db.m_tables["kmmTransactions"].updateString());
+        for (const auto& id : qAsConst(updateIds)) {
+            writeTransaction(id, m_file->transaction(id), query, "N");
+            signalProgress(++m_changesWritten, 0);
+        }
+
+        for (const auto& id : qAsConst(deleteIds)) {
+            deleteTransaction(id.toString());
+            --m_transactions;
+            signalProgress(++m_changesWritten, 0);
+        }
+    }
+
+    void writeChangedSchedules(const ObjectChanges& changes)
+    {
+        Q_Q(MyMoneyStorageSql);
+        QStringList insertIds;
+        QStringList updateIds;
+        QVariantList deleteIds;
+        sortChanges(changes, insertIds, updateIds, deleteIds);
+
+        // writeSchedule() modifies the query passed to it,
+        // so it has to be prepared for each schedule
+        QSqlQuery query(*q);
+        for (const auto& id : qAsConst(insertIds)) {
+            query.prepare(m_db.m_tables["kmmSchedules"].insertString());
+            writeSchedule(m_file->schedule(id), query, true);
+            ++m_schedules;
+        }
+
+        for (const auto& id : qAsConst(updateIds)) {
+            query.prepare(m_db.m_tables["kmmSchedules"].updateString());
+            writeSchedule(m_file->schedule(id), query, false);
+        }
+
+        for (const auto& id : qAsConst(deleteIds)) {
+            deleteSchedule(id.toString());
+            --m_schedules;
+        }
+        signalProgress(m_changesWritten += changes.count(), 0);
+    }
+
+    void writeChangedSecurities(const ObjectChanges& changes)
+    {
+        Q_Q(MyMoneyStorageSql);
+        QStringList insertIds;
+        QStringList updateIds;
+        QVariantList deleteIds;
+        sortChanges(changes, insertIds, updateIds, deleteIds);
+
+        QSqlQuery query(*q);
+        query.prepare(m_db.m_tables["kmmSecurities"].insertString());
+        for (const auto& id : qAsConst(insertIds)) {
+            writeSecurity(m_file->security(id), query);
+            ++m_securities;
+        }
+
+        query.prepare(m_db.m_tables["kmmSecurities"].updateString());
+        for (const auto& id : qAsConst(updateIds))
+            writeSecurity(m_file->security(id), query);
+
+        if (!deleteIds.isEmpty()) {
+            query.prepare("DELETE FROM kmmSecurities WHERE id = :id");
+            query.bindValue(":id", deleteIds);
+            if (!query.execBatch()) throw MYMONEYEXCEPTIONSQL("deleting Security");
+
+            query.prepare("DELETE FROM kmmPrices WHERE fromId = :fromId OR toId = :toId");
+            query.bindValue(":fromId", deleteIds);
+            query.bindValue(":toId", deleteIds);
+            if (!query.execBatch()) throw MYMONEYEXCEPTIONSQL("deleting Security");
+
+            deleteKeyValuePairs("SECURITY", deleteIds);
+            m_securities -= deleteIds.count();
+        }
+        signalProgress(m_changesWritten += changes.count(), 0);
+    }
+
+    /**
+     * Prices have no id of their own, so all prices of
+     * a changed pair are replaced.
+     */
+    void writeChangedPrices(const QSet<MyMoneySecurityPair>& pairs)
+    {
+        Q_Q(MyMoneyStorageSql);
+        QSqlQuery query(*q);
+        for (const auto& pair : pairs) {
+            query.prepare("DELETE FROM kmmPrices WHERE fromId = :fromId AND toId = :toId");
+            query.bindValue(":fromId", pair.first);
+            query.bindValue(":toId", pair.second);
+            if (!query.exec()) throw MYMONEYEXCEPTIONSQL("deleting Prices"); // krazy:exclude=crashy
+            m_prices -= query.numRowsAffected();
+            writePricePair(m_file->priceModel()->priceEntries(pair.first, pair.second));
+            signalProgress(++m_changesWritten, 0);
+        }
+    }
+
+    void writeChangedCurrencies(const ObjectChanges& changes)
+    {
+        Q_Q(MyMoneyStorageSql);
+        QStringList insertIds;
+        QStringList updateIds;
+        QVariantList deleteIds;
+        sortChanges(changes, insertIds, updateIds, deleteIds);
+
+        QSqlQuery query(*q);
+        query.prepare(m_db.m_tables["kmmCurrencies"].insertString());
+        for (const auto& id : qAsConst(insertIds)) {
+            writeCurrency(m_file->currency(id), query);
+            ++m_currencies;
+        }
+
+        query.prepare(m_db.m_tables["kmmCurrencies"].updateString());
+        for (const auto& id : qAsConst(updateIds))
+            writeCurrency(m_file->currency(id), query);
+
+        if (!deleteIds.isEmpty()) {
+            query.prepare("DELETE FROM kmmCurrencies WHERE ISOCode = :ISOCode");
+            query.bindValue(":ISOCode", deleteIds);
+            if (!query.execBatch()) throw MYMONEYEXCEPTIONSQL("deleting Currency");
+            m_currencies -= deleteIds.count();
+        }
+        signalProgress(m_changesWritten += changes.count(), 0);
+    }
+
+    void writeChangedReports(const ObjectChanges& changes)
+    {
+        Q_Q(MyMoneyStorageSql);
+        QStringList insertIds;
+        QStringList updateIds;
+        QVariantList deleteIds;
+        sortChanges(changes, insertIds, updateIds, deleteIds);
+
+        QSqlQuery query(*q);
+        query.prepare(m_db.m_tables["kmmReportConfig"].insertString());
+        for (const auto& id : qAsConst(insertIds)) {
+            writeReport(m_file->report(id), query);
+            ++m_reports;
+        }
+
+        query.prepare(m_db.m_tables["kmmReportConfig"].updateString());
+        for (const auto& id : qAsConst(updateIds))
+            writeReport(m_file->report(id), query);
+
+        if (!deleteIds.isEmpty()) {
+            query.prepare("DELETE FROM kmmReportConfig WHERE id = :id");
+            query.bindValue(":id", deleteIds);
+            if (!query.execBatch()) throw MYMONEYEXCEPTIONSQL("deleting Report");
+            m_reports -= deleteIds.count();
+        }
+        signalProgress(m_changesWritten += changes.count(), 0);
+    }
+
+    void writeChangedBudgets(const ObjectChanges& changes)
+    {
+        Q_Q(MyMoneyStorageSql);
+        QStringList insertIds;
+        QStringList updateIds;
+        QVariantList deleteIds;
+        sortChanges(changes, insertIds, updateIds, deleteIds);
+
+        QSqlQuery query(*q);
+        query.prepare(m_db.m_tables["kmmBudgetConfig"].insertString());
+        for (const auto& id : qAsConst(insertIds)) {
+            writeBudget(m_file->budget(id), query);
+            ++m_budgets;
+        }
+
+        query.prepare(m_db.m_tables["kmmBudgetConfig"].updateString());
+        for (const auto& id : qAsConst(updateIds))
+            writeBudget(m_file->budget(id), query);
+
+        if (!deleteIds.isEmpty()) {
+            query.prepare("DELETE FROM kmmBudgetConfig WHERE id = :id");
+            query.bindValue(":id", deleteIds);
+            if (!query.execBatch()) throw MYMONEYEXCEPTIONSQL("deleting Budget");
+            m_budgets -= deleteIds.count();
+        }
+        signalProgress(m_changesWritten += changes.count(), 0);
+    }
+
+    void writeChangedOnlineJobs(const ObjectChanges& changes)
+    {
+        Q_Q(MyMoneyStorageSql);
+        QStringList insertIds;
+        QStringList updateIds;
+        QVariantList deleteIds;
+        sortChanges(changes, insertIds, updateIds, deleteIds);
+
+        for (const auto& id : qAsConst(insertIds))
+            q->addOnlineJob(m_file->getOnlineJob(id));
+
+        for (const auto& id : qAsConst(updateIds))
+            q->modifyOnlineJob(m_file->getOnlineJob(id));
+
+        if (!deleteIds.isEmpty()) {
+            // the task of a removed job is only available from the database
+            QStringList idList;
+            for (const auto& id : qAsConst(deleteIds))
+                idList << id.toString();
+            const auto jobsToDelete = q->fetchOnlineJobs(idList, true);
+            for (const auto& job : jobsToDelete) {
+                q->removeOnlineJob(job);
+            }
+        }
+        signalProgress(m_changesWritten += changes.count(), 0);
+    }
+    /** @} */
+
     /**
      * @name writeMethods
      * @{
@@ -1667,6 +2146,111 @@ public:
         m_file->accountsModel()->load(q->fetchAccounts());
     }
 
+    /**
+     * Returns balance, cleared balance and number of splits of all transactions
+     * posted before @a date for the accounts listed in @a idList. All accounts
+     * are returned if @a idList is empty and all transactions are covered
+     * in case @a date is invalid.
+     */
+    QHash<QString, JournalLoader::AccountHistory> fetchAccountHistory(const QStringList& idList, const QDate& date) const
+    {
+        Q_Q(const MyMoneyStorageSql);
+        QHash<QString, JournalLoader::AccountHistory> history;
+        QSqlQuery query(*const_cast <MyMoneyStorageSql*>(q));
+        QString queryString = "SELECT action, shares, accountId, reconcileFlag "
+                              "FROM kmmSplits WHERE txType = 'N'";
+
+        if (!idList.isEmpty()) {
+            queryString += " AND accountId in (";
+            for (int i = 0; i < idList.count(); ++i) {
+                queryString += QString(":id%1, ").arg(i);
+            }
+            queryString = queryString.left(queryString.length() - 2) + ')';
+        }
+
+        if (date.isValid())
+            queryString += QString(" AND postDate < '%1'").arg(date.toString(Qt::ISODate));
+
+        // use the same order as the journal so that stock splits are applied correctly
+        queryString += " ORDER BY accountId, postDate, transactionId;";
+        query.prepare(queryString);
+
+        int i = 0;
+        for (const auto& bindVal : idList) {
+            query.bindValue(QString(":id%1").arg(i), bindVal);
+            ++i;
+        }
+
+        if (!query.exec()) // krazy:exclude=crashy
+            throw MYMONEYEXCEPTIONSQL(QString::fromLatin1("fetching account history"));
+
+        const auto splitSharesAction = MyMoneySplit::actionName(eMyMoney::Split::Action::SplitShares);
+        QString oldId;
+        JournalLoader::AccountHistory* entry = nullptr;
+        while (query.next()) {
+            const auto id = query.value(2).toString();
+            if (id != oldId) {
+                entry = &history[id];
+                oldId = id;
+            }
+            const MyMoneyMoney shares(query.value(1).toString());
+            const auto isCleared = (static_cast<eMyMoney::Split::State>(query.value(3).toInt()) != eMyMoney::Split::State::NotReconciled);
+            if (splitSharesAction == query.value(0).toString()) {
+                entry->balance *= shares;
+                if (isCleared)
+                    entry->clearedBalance *= shares;
+            } else {
+                entry->balance += shares;
+                if (isCleared)
+                    entry->clearedBalance += shares;
+            }
+            ++entry->splitCount;
+        }
+        return history;
+    }
+
+    /**
+     * Returns @c true if a transaction posted before @a date references
+     * the object with @a id. References held by matched transactions,
+     * which are stored as key value pairs, are not covered.
+     */
+    bool hasTransactionReferenceTo(const QString& id, const QDate& date) const
+    {
+        Q_Q(const MyMoneyStorageSql);
+        QSqlQuery query(*const_cast <MyMoneyStorageSql*>(q));
+        const auto dateClause = QString("postDate < '%1'").arg(date.toString(Qt::ISODate));
+        const QStringList queries = {
+            QString("SELECT COUNT(*) FROM kmmSplits WHERE txType = 'N' AND %1 AND (accountId = ? OR payeeId = ? OR costCenterId = ?);").arg(dateClause),
+            QString("SELECT COUNT(*) FROM kmmTagSplits INNER JOIN kmmSplits ON kmmSplits.transactionId = kmmTagSplits.transactionId AND kmmSplits.splitId = kmmTagSplits.splitId "
+                    "WHERE kmmSplits.txType = 'N' AND kmmSplits.%1 AND kmmTagSplits.tagId = ?;").arg(dateClause),
+            QString("SELECT COUNT(*) FROM kmmTransactions WHERE txType = 'N' AND %1 AND currencyId = ?;").arg(dateClause),
+        };
+        for (const auto& queryString : queries) {
+            query.prepare(queryString);
+            for (int i = queryString.count(QLatin1Char('?')); i > 0; --i) {
+                query.addBindValue(id);
+            }
+            if (!query.exec() || !query.next()) // krazy:exclude=crashy
+                throw MYMONEYEXCEPTIONSQL(QString::fromLatin1("checking references"));
+            if (query.value(0).toUInt() > 0)
+                return true;
+        }
+        return false;
+    }
+
+    /**
+     * Returns the number of transactions posted before @a date
+     */
+    unsigned int fetchTransactionCount(const QDate& date) const
+    {
+        Q_Q(const MyMoneyStorageSql);
+        QSqlQuery query(*const_cast <MyMoneyStorageSql*>(q));
+        query.prepare(QString("SELECT COUNT(*) FROM kmmTransactions WHERE txType = 'N' AND postDate < '%1';").arg(date.toString(Qt::ISODate)));
+        if (!query.exec() || !query.next()) // krazy:exclude=crashy
+            throw MYMONEYEXCEPTIONSQL(QString::fromLatin1("counting transactions"));
+        return query.value(0).toUInt();
+    }
+
 #if 0
     void readTransactions(const QString& tidList, const QString& dateClause)
     {
@@ -3328,6 +3912,11 @@ public:
       * the database code has been properly checked out
       */
     QHash<QString, ulong> m_transactionCountMap;
+    /**
+      * This member variable holds the number of changes written
+      * so far by writeChanges() and is used for progress reporting
+      */
+    int m_changesWritten;
     /**
       * These member variables hold the user name and date/time of logon
       */
@@ -3356,4 +3945,70 @@ public:
 
     void (*m_progressCallback)(int, int, const QString&);
 };
+
+/**
+ * The journal loader used when the database has been opened with the
+ * @c partial option. It pages in the transactions not read by
+ * MyMoneyStorageSql::readFile() and keeps the connection of the
+ * storage object used to read the database open while it exists.
+ */
+class MyMoneyStorageSqlJournalLoader : public JournalLoader
+{
+public:
+    explicit MyMoneyStorageSqlJournalLoader(MyMoneyStorageSql* storage)
+        : m_storage(storage)
+    {
+    }
+
+    ~MyMoneyStorageSqlJournalLoader() override
+    {
+        // don't log off here: the logon information is maintained
+        // by the storage objects used to save the data and writing
+        // it from here would overwrite their information
+        m_storage->close(false);
+    }
+
+    QMap<QString, MyMoneyTransaction> transactions(const QDate& from, const QDate& to) const override
+    {
+        QString dateClause = QString("(postDate < '%1')").arg(to.toString(Qt::ISODate));
+        if (from.isValid()) {
+            dateClause += QString(" AND (postDate >= '%1')").arg(from.toString(Qt::ISODate));
+        }
+        return m_storage->fetchTransactions(QString(), dateClause);
+    }
+
+    QMap<QString, MyMoneyTransaction> transactions(const MyMoneyTransactionFilter& filter) const override
+    {
+        return m_storage->fetchTransactions(filter);
+    }
+
+    MyMoneyTransaction transaction(const QString& id) const override
+    {
+        const auto list = m_storage->fetchTransactions(QString("('%1')").arg(QString(id).replace(QLatin1Char('\''), QLatin1String("''"))), QString());
+        return list.isEmpty() ? MyMoneyTransaction() : list.first();
+    }
+
+    bool hasReferenceTo(const QString& id, const QDate& date) const override
+    {
+        return m_storage->d_func()->hasTransactionReferenceTo(id, date);
+    }
+
+    QHash<QString, AccountHistory> history(const QDate& date, const QStringList& accountIds) const override
+    {
+        return m_storage->d_func()->fetchAccountHistory(accountIds, date);
+    }
+
+    unsigned int transactionCount(const QDate& date) const override
+    {
+        return m_storage->d_func()->fetchTransactionCount(date);
+    }
+
+    QString lastTransactionId() const override
+    {
+        return QString("T%1").arg(m_storage->getNextTransactionId() - 1, JournalModel::ID_SIZE, 10, QLatin1Char('0'));
+    }
+
+private:
+    QExplicitlySharedDataPointer<MyMoneyStorageSql> m_storage;
+};
 #endif
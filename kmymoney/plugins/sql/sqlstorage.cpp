@@ -7,11 +7,10 @@
 
 #include <config-kmymoney.h>
 
-#include <memory>
-
 // ----------------------------------------------------------------------------
 // QT Includes
 
+#include <QExplicitlySharedDataPointer>
 #include <QUrlQuery>
 #include <QSqlQuery>
 #include <QTimer>
@@ -98,7 +97,10 @@ bool SQLStorage::open(const QUrl &url)
     if (url.scheme() != QLatin1String("sql"))
         return false;
 
-    auto reader = std::make_unique<MyMoneyStorageSql>(MyMoneyFile::instance(), url);
+    // in case the database is opened partially, the journal
+    // model keeps a reference to the reader to load older
+    // transactions when needed
+    QExplicitlySharedDataPointer<MyMoneyStorageSql> reader(new MyMoneyStorageSql(MyMoneyFile::instance(), url));
 
     dbUrl = url;
     if (dbUrl.password().isEmpty()) {
@@ -183,6 +185,13 @@ QUrl SQLStorage::openUrl() const
 }
 
 bool SQLStorage::save(const QUrl &url)
+{
+    // the database we read from only needs to be updated with the
+    // changes, any other one receives the complete data
+    return saveDatabase(url, url == dbUrl);
+}
+
+bool SQLStorage::saveDatabase(const QUrl &url, bool changesOnly)
 {
     auto rc = false;
     if (!appInterface()->fileOpen()) {
@@ -192,7 +201,8 @@ bool SQLStorage::save(const QUrl &url)
     auto writer = new MyMoneyStorageSql(MyMoneyFile::instance(), url);
     writer->open(url, QIODevice::ReadWrite);
 //  writer->setProgressCallback(&KMyMoneyView::progressCallback);
-    if (!writer->writeFile()) {
+    const auto written = changesOnly ? writer->writeChanges() : writer->writeFile();
+    if (!written) {
         KMessageBox::detailedError(nullptr,
                                    i18n("An unrecoverable error occurred while writing to the database.\n"
                                         "It may well be corrupt."),
@@ -345,7 +355,7 @@ bool SQLStorage::saveAsDatabase(const QUrl &url)
     }
     if (canWrite) {
         delete writer;
-        save(url);
+        saveDatabase(url, false);
         return true;
     } else {
         KMessageBox::detailedError(nullptr,
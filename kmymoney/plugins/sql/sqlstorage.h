@@ -57,6 +57,19 @@ private:
      */
     bool saveAsDatabase(const QUrl &url);
 
+    /**
+     * Writes the data into the database referenced by @a url.
+     *
+     * @param url The pseudo URL of the database
+     * @param changesOnly If @c true, only the objects changed since
+     *                    the database was read or written the last
+     *                    time are written
+     *
+     * @retval false save operation failed
+     * @retval true save operation was successful
+     */
+    bool saveDatabase(const QUrl &url, bool changesOnly);
+
     QUrlQuery convertOldUrl(const QUrl& url);
 
     /**
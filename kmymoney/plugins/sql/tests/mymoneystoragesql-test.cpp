@@ -0,0 +1,458 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "mymoneystoragesql-test.h"
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QTest>
+
+#include "../mymoneystoragesql.h"
+#include "mymoneytestutils.h"
+#include "mymoneyexception.h"
+#include "mymoneyfile.h"
+#include "mymoneyinstitution.h"
+#include "mymoneyaccount.h"
+#include "mymoneysecurity.h"
+#include "mymoneyprice.h"
+#include "mymoneytag.h"
+#include "mymoneypayee.h"
+#include "mymoneyschedule.h"
+#include "mymoneyreport.h"
+#include "mymoneysplit.h"
+#include "mymoneytransaction.h"
+#include "mymoneybudget.h"
+#include "onlinejob.h"
+#include "onlinetasks/sepa/sepaonlinetransferimpl.h"
+#include "misc/platformtools.h"
+
+#include "mymoneyenums.h"
+
+QTEST_GUILESS_MAIN(MyMoneyStorageSqlTest)
+
+namespace {
+MyMoneyTransaction transfer(const QString& fromId, const QString& toId, const MyMoneyMoney& amount, const QDate& date, const QString& payeeId, const QString& tagId)
+{
+    MyMoneyTransaction t;
+    t.setPostDate(date);
+    t.setCommodity(QStringLiteral("USD"));
+
+    MyMoneySplit split;
+    split.setAccountId(fromId);
+    split.setPayeeId(payeeId);
+    split.setShares(-amount);
+    split.setValue(-amount);
+    t.addSplit(split);
+
+    split.clearId();
+    split.setAccountId(toId);
+    split.setShares(amount);
+    split.setValue(amount);
+    if (!tagId.isEmpty())
+        split.setTagIdList(QList<QString>() << tagId);
+    t.addSplit(split);
+    return t;
+}
+
+MyMoneySchedule schedule(const QString& name, const MyMoneyTransaction& t)
+{
+    MyMoneySchedule sch(name,
+                        eMyMoney::Schedule::Type::Bill,
+                        eMyMoney::Schedule::Occurrence::Monthly, 1,
+                        eMyMoney::Schedule::PaymentType::DirectDebit,
+                        t.postDate(),
+                        QDate(),
+                        true,
+                        false);
+    sch.setTransaction(t);
+    return sch;
+}
+
+onlineJob transferJob(const QString& accountId, const QString& purpose)
+{
+    auto task = new sepaOnlineTransferImpl;
+    task->setOriginAccount(accountId);
+    task->setValue(MyMoneyMoney(100, 1));
+    task->setPurpose(purpose);
+    return onlineJob(task);
+}
+
+/**
+ * Returns the rows of all tables found in the SQLite database @a fileName.
+ * The rows of each table are sorted so that the content of two databases
+ * can be compared regardless of the order in which the records were written.
+ */
+QMap<QString, QStringList> databaseContent(const QString& fileName)
+{
+    QMap<QString, QStringList> content;
+    const auto connectionName = QStringLiteral("content:%1").arg(fileName);
+    {
+        auto db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), connectionName);
+        db.setDatabaseName(fileName);
+        if (!db.open())
+            return content;
+
+        // the time of the last logon differs between the two databases
+        // and the record counters are kept for backward compatibility only
+        const QStringList ignoredFileInfo = {
+            QStringLiteral("logonAt"), QStringLiteral("institutions"), QStringLiteral("accounts"),
+            QStringLiteral("payees"), QStringLiteral("tags"), QStringLiteral("transactions"),
+            QStringLiteral("splits"), QStringLiteral("securities"), QStringLiteral("prices"),
+            QStringLiteral("currencies"), QStringLiteral("schedules"), QStringLiteral("reports"),
+            QStringLiteral("kvps"), QStringLiteral("budgets"),
+        };
+
+        const auto tables = db.tables();
+        for (const auto& table : tables) {
+            QStringList rows;
+            QSqlQuery query(db);
+            query.exec(QStringLiteral("SELECT * FROM %1;").arg(table));
+            while (query.next()) {
+                const auto record = query.record();
+                QStringList values;
+                for (int i = 0; i < record.count(); ++i) {
+                    if (table == QLatin1String("kmmFileInfo") && ignoredFileInfo.contains(record.fieldName(i)))
+                        continue;
+                    values << record.fieldName(i) + QLatin1Char('=') + record.value(i).toString();
+                }
+                rows << values.join(QLatin1Char('|'));
+            }
+            rows.sort();
+            content.insert(table, rows);
+        }
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+    return content;
+}
+}
+
+MyMoneyStorageSqlTest::MyMoneyStorageSqlTest() :
+    m_file(nullptr)
+{
+}
+
+QUrl MyMoneyStorageSqlTest::databaseUrl(const QTemporaryFile& file) const
+{
+    return QUrl(QString("sql://%1@localhost/%2?driver=QSQLITE&mode=single").arg(platformTools::osUsername(), file.fileName()));
+}
+
+void MyMoneyStorageSqlTest::init()
+{
+    m_file = MyMoneyFile::instance();
+    m_file->unload();
+
+    // make sure the files exist so that the
+    // databases are created in the same way
+    QVERIFY(m_changesFile.open());
+    m_changesFile.close();
+    QVERIFY(m_completeFile.open());
+    m_completeFile.close();
+}
+
+void MyMoneyStorageSqlTest::cleanup()
+{
+    m_file->unload();
+}
+
+void MyMoneyStorageSqlTest::setupData()
+{
+    MyMoneyFileTransaction ft;
+    m_file->addCurrency(MyMoneySecurity("USD", "US Dollar", "$"));
+    m_file->addCurrency(MyMoneySecurity("EUR", "Euro", QChar(0x20ac)));
+    m_file->addCurrency(MyMoneySecurity("JPY", "Japanese Yen", QChar(0x00A5), 1));
+    m_file->setBaseCurrency(m_file->currency("USD"));
+
+    MyMoneyPayee user;
+    user.setName("Test User");
+    m_file->setUser(user);
+
+    MyMoneyInstitution institution;
+    institution.setName("First Bank");
+    m_file->addInstitution(institution);
+    m_institutionId = institution.id();
+    MyMoneyInstitution unusedInstitution;
+    unusedInstitution.setName("Second Bank");
+    m_file->addInstitution(unusedInstitution);
+    m_unusedInstitutionId = unusedInstitution.id();
+
+    MyMoneyPayee payee;
+    payee.setName("Grocery");
+    m_file->addPayee(payee);
+    m_payeeId = payee.id();
+    MyMoneyPayee unusedPayee;
+    unusedPayee.setName("Landlord");
+    m_file->addPayee(unusedPayee);
+    m_unusedPayeeId = unusedPayee.id();
+
+    MyMoneyTag tag;
+    tag.setName("Vacation");
+    m_file->addTag(tag);
+    m_tagId = tag.id();
+    MyMoneyTag unusedTag;
+    unusedTag.setName("Business");
+    m_file->addTag(unusedTag);
+    m_unusedTagId = unusedTag.id();
+
+    MyMoneyAccount asset = m_file->asset();
+    MyMoneyAccount checking;
+    checking.setName("Checking");
+    checking.setAccountType(eMyMoney::Account::Type::Checkings);
+    checking.setCurrencyId("USD");
+    checking.setOpeningDate(QDate(2020, 1, 1));
+    checking.setInstitutionId(m_institutionId);
+    m_file->addAccount(checking, asset);
+    m_checkingId = checking.id();
+    MyMoneyAccount savings;
+    savings.setName("Savings");
+    savings.setAccountType(eMyMoney::Account::Type::Savings);
+    savings.setCurrencyId("USD");
+    savings.setOpeningDate(QDate(2020, 1, 1));
+    m_file->addAccount(savings, asset);
+    m_savingsId = savings.id();
+    MyMoneyAccount unusedAccount;
+    unusedAccount.setName("Cash");
+    unusedAccount.setAccountType(eMyMoney::Account::Type::Cash);
+    unusedAccount.setCurrencyId("USD");
+    unusedAccount.setOpeningDate(QDate(2020, 1, 1));
+    m_file->addAccount(unusedAccount, asset);
+    m_unusedAccountId = unusedAccount.id();
+
+    MyMoneyAccount expense = m_file->expense();
+    MyMoneyAccount food;
+    food.setName("Food");
+    food.setAccountType(eMyMoney::Account::Type::Expense);
+    food.setCurrencyId("USD");
+    m_file->addAccount(food, expense);
+    m_expenseId = food.id();
+
+    auto t = transfer(m_checkingId, m_expenseId, MyMoneyMoney(2500, 100), QDate(2020, 2, 1), m_payeeId, m_tagId);
+    m_file->addTransaction(t);
+    m_firstTransactionId = t.id();
+    t = transfer(m_checkingId, m_savingsId, MyMoneyMoney(10000, 100), QDate(2020, 2, 15), m_payeeId, QString());
+    m_file->addTransaction(t);
+    m_secondTransactionId = t.id();
+
+    auto sch = schedule("Groceries", transfer(m_checkingId, m_expenseId, MyMoneyMoney(5000, 100), QDate(2020, 3, 1), m_payeeId, QString()));
+    m_file->addSchedule(sch);
+    m_firstScheduleId = sch.id();
+    sch = schedule("Saving", transfer(m_checkingId, m_savingsId, MyMoneyMoney(20000, 100), QDate(2020, 3, 1), QString(), QString()));
+    m_file->addSchedule(sch);
+    m_secondScheduleId = sch.id();
+
+    MyMoneySecurity security;
+    security.setName("First Stock");
+    security.setTradingSymbol("FST");
+    security.setSecurityType(eMyMoney::Security::Type::Stock);
+    security.setTradingCurrency("USD");
+    m_file->addSecurity(security);
+    m_securityId = security.id();
+    MyMoneySecurity unusedSecurity;
+    unusedSecurity.setName("Second Stock");
+    unusedSecurity.setTradingSymbol("SND");
+    unusedSecurity.setSecurityType(eMyMoney::Security::Type::Stock);
+    unusedSecurity.setTradingCurrency("USD");
+    m_file->addSecurity(unusedSecurity);
+    m_unusedSecurityId = unusedSecurity.id();
+
+    m_file->addPrice(MyMoneyPrice(m_securityId, "USD", QDate(2020, 2, 1), MyMoneyMoney(1200, 100), "Test"));
+    m_file->addPrice(MyMoneyPrice(m_securityId, "USD", QDate(2020, 2, 2), MyMoneyMoney(1250, 100), "Test"));
+    m_file->addPrice(MyMoneyPrice("EUR", "USD", QDate(2020, 2, 1), MyMoneyMoney(110, 100), "Test"));
+
+    MyMoneyReport report;
+    report.setName("First Report");
+    m_file->addReport(report);
+    m_reportId = report.id();
+    MyMoneyReport unusedReport;
+    unusedReport.setName("Second Report");
+    m_file->addReport(unusedReport);
+    m_unusedReportId = unusedReport.id();
+
+    MyMoneyBudget budget;
+    budget.setName("First Budget");
+    budget.setBudgetStart(QDate(2020, 1, 1));
+    m_file->addBudget(budget);
+    m_budgetId = budget.id();
+    MyMoneyBudget unusedBudget;
+    unusedBudget.setName("Second Budget");
+    unusedBudget.setBudgetStart(QDate(2021, 1, 1));
+    m_file->addBudget(unusedBudget);
+    m_unusedBudgetId = unusedBudget.id();
+
+    auto job = transferJob(m_checkingId, "First transfer");
+    m_file->addOnlineJob(job);
+    m_onlineJobId = job.id();
+    job = transferJob(m_checkingId, "Second transfer");
+    m_file->addOnlineJob(job);
+    m_unusedOnlineJobId = job.id();
+
+    ft.commit();
+}
+
+void MyMoneyStorageSqlTest::changeData()
+{
+    MyMoneyFileTransaction ft;
+
+    // each object type sees an addition, a modification and a removal
+    auto currency = m_file->currency("EUR");
+    currency.setName("European Euro");
+    m_file->modifyCurrency(currency);
+    m_file->addCurrency(MyMoneySecurity("GBP", "British Pound", "#"));
+    m_file->removeCurrency(m_file->currency("JPY"));
+
+    MyMoneyPayee user = m_file->user();
+    user.setName("Changed User");
+    m_file->setUser(user);
+
+    auto institution = m_file->institution(m_institutionId);
+    institution.setName("First Bank Ltd.");
+    m_file->modifyInstitution(institution);
+    MyMoneyInstitution newInstitution;
+    newInstitution.setName("Third Bank");
+    m_file->addInstitution(newInstitution);
+    m_file->removeInstitution(m_file->institution(m_unusedInstitutionId));
+
+    auto payee = m_file->payee(m_payeeId);
+    payee.setName("Supermarket");
+    m_file->modifyPayee(payee);
+    MyMoneyPayee newPayee;
+    newPayee.setName("Employer");
+    m_file->addPayee(newPayee);
+    m_file->removePayee(m_file->payee(m_unusedPayeeId));
+
+    auto tag = m_file->tag(m_tagId);
+    tag.setName("Holiday");
+    m_file->modifyTag(tag);
+    MyMoneyTag newTag;
+    newTag.setName("Private");
+    m_file->addTag(newTag);
+    m_file->removeTag(m_file->tag(m_unusedTagId));
+
+    auto account = m_file->account(m_savingsId);
+    account.setName("Savings Account");
+    m_file->modifyAccount(account);
+    MyMoneyAccount asset = m_file->asset();
+    MyMoneyAccount newAccount;
+    newAccount.setName("Wallet");
+    newAccount.setAccountType(eMyMoney::Account::Type::Cash);
+    newAccount.setCurrencyId("USD");
+    newAccount.setOpeningDate(QDate(2020, 1, 1));
+    m_file->addAccount(newAccount, asset);
+    m_file->removeAccount(m_file->account(m_unusedAccountId));
+
+    // move the first transaction to another account so that the balance
+    // of the account referenced before and after the change is updated
+    auto t = m_file->transaction(m_firstTransactionId);
+    auto split = t.splits().first();
+    split.setAccountId(m_savingsId);
+    t.modifySplit(split);
+    m_file->modifyTransaction(t);
+    t = transfer(newAccount.id(), m_expenseId, MyMoneyMoney(1500, 100), QDate(2020, 2, 20), newPayee.id(), newTag.id());
+    m_file->addTransaction(t);
+    m_file->removeTransaction(m_file->transaction(m_secondTransactionId));
+
+    auto sch = m_file->schedule(m_firstScheduleId);
+    sch.setName("Supermarket");
+    m_file->modifySchedule(sch);
+    sch = schedule("Pocket money", transfer(m_checkingId, newAccount.id(), MyMoneyMoney(3000, 100), QDate(2020, 3, 5), QString(), QString()));
+    m_file->addSchedule(sch);
+    m_file->removeSchedule(m_file->schedule(m_secondScheduleId));
+
+    auto security = m_file->security(m_securityId);
+    security.setName("First Stock Inc.");
+    m_file->modifySecurity(security);
+    MyMoneySecurity newSecurity;
+    newSecurity.setName("Third Stock");
+    newSecurity.setTradingSymbol("TRD");
+    newSecurity.setSecurityType(eMyMoney::Security::Type::Stock);
+    newSecurity.setTradingCurrency("USD");
+    m_file->addSecurity(newSecurity);
+    m_file->removeSecurity(m_file->security(m_unusedSecurityId));
+
+    m_file->addPrice(MyMoneyPrice(m_securityId, "USD", QDate(2020, 2, 2), MyMoneyMoney(1300, 100), "Test"));
+    m_file->addPrice(MyMoneyPrice(newSecurity.id(), "USD", QDate(2020, 2, 2), MyMoneyMoney(4200, 100), "Test"));
+    m_file->removePrice(m_file->price("EUR", "USD", QDate(2020, 2, 1), true));
+
+    auto report = m_file->report(m_reportId);
+    report.setComment("Changed report");
+    m_file->modifyReport(report);
+    MyMoneyReport newReport;
+    newReport.setName("Third Report");
+    m_file->addReport(newReport);
+    m_file->removeReport(m_file->report(m_unusedReportId));
+
+    auto budget = m_file->budget(m_budgetId);
+    budget.setName("Changed Budget");
+    m_file->modifyBudget(budget);
+    MyMoneyBudget newBudget;
+    newBudget.setName("Third Budget");
+    newBudget.setBudgetStart(QDate(2022, 1, 1));
+    m_file->addBudget(newBudget);
+    m_file->removeBudget(m_file->budget(m_unusedBudgetId));
+
+    auto job = m_file->getOnlineJob(m_onlineJobId);
+    job.task<sepaOnlineTransferImpl>()->setPurpose("Changed transfer");
+    m_file->modifyOnlineJob(job);
+    auto newJob = transferJob(newAccount.id(), "Third transfer");
+    m_file->addOnlineJob(newJob);
+    m_file->removeOnlineJob(m_file->getOnlineJob(m_unusedOnlineJobId));
+
+    ft.commit();
+}
+
+void MyMoneyStorageSqlTest::testWriteChanges()
+{
+    if (!QSqlDatabase::drivers().contains(QLatin1String("QSQLITE")))
+        QSKIP("SQLite driver not available", SkipAll);
+
+    try {
+        setupData();
+
+        // store the initial data in the database
+        {
+            const auto url = databaseUrl(m_changesFile);
+            MyMoneyStorageSql writer(m_file, url);
+            QCOMPARE(writer.open(url, QIODevice::WriteOnly, true), 0);
+            QVERIFY(writer.writeFile());
+            writer.close();
+        }
+        QVERIFY(m_file->hasCompleteChangeTracking());
+
+        changeData();
+
+        // write only the changes to the database
+        {
+            const auto url = databaseUrl(m_changesFile);
+            MyMoneyStorageSql writer(m_file, url);
+            QCOMPARE(writer.open(url, QIODevice::ReadWrite), 0);
+            QVERIFY(m_file->hasCompleteChangeTracking());
+            QVERIFY(!m_file->unsavedChanges().isEmpty());
+            QVERIFY(writer.writeChanges());
+            writer.close();
+        }
+        QVERIFY(m_file->unsavedChanges().isEmpty());
+
+        // and for comparison all data to a fresh one
+        {
+            const auto url = databaseUrl(m_completeFile);
+            MyMoneyStorageSql writer(m_file, url);
+            QCOMPARE(writer.open(url, QIODevice::WriteOnly, true), 0);
+            QVERIFY(writer.writeFile());
+            writer.close();
+        }
+    } catch (const MyMoneyException &e) {
+        unexpectedException(e);
+    }
+
+    const auto changed = databaseContent(m_changesFile.fileName());
+    const auto complete = databaseContent(m_completeFile.fileName());
+    QVERIFY(!complete.isEmpty());
+    QCOMPARE(changed.keys(), complete.keys());
+    for (auto it = complete.constBegin(); it != complete.constEnd(); ++it) {
+        const auto rows = changed.value(it.key());
+        QVERIFY2(rows == *it, qPrintable(QString("Table %1 differs").arg(it.key())));
+    }
+}
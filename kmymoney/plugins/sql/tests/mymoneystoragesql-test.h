@@ -0,0 +1,61 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef MYMONEYSTORAGESQLTEST_H
+#define MYMONEYSTORAGESQLTEST_H
+
+#include <QObject>
+#include <QTemporaryFile>
+#include <QUrl>
+
+class MyMoneyFile;
+
+class MyMoneyStorageSqlTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    MyMoneyStorageSqlTest();
+
+private:
+    QUrl databaseUrl(const QTemporaryFile& file) const;
+    void setupData();
+    void changeData();
+
+    MyMoneyFile* m_file;
+    QTemporaryFile m_changesFile;
+    QTemporaryFile m_completeFile;
+
+    // the ids of the objects created by setupData()
+    QString m_institutionId;
+    QString m_unusedInstitutionId;
+    QString m_payeeId;
+    QString m_unusedPayeeId;
+    QString m_tagId;
+    QString m_unusedTagId;
+    QString m_checkingId;
+    QString m_savingsId;
+    QString m_unusedAccountId;
+    QString m_expenseId;
+    QString m_firstTransactionId;
+    QString m_secondTransactionId;
+    QString m_firstScheduleId;
+    QString m_secondScheduleId;
+    QString m_securityId;
+    QString m_unusedSecurityId;
+    QString m_reportId;
+    QString m_unusedReportId;
+    QString m_budgetId;
+    QString m_unusedBudgetId;
+    QString m_onlineJobId;
+    QString m_unusedOnlineJobId;
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+    void testWriteChanges();
+};
+
+#endif // MYMONEYSTORAGESQLTEST_H
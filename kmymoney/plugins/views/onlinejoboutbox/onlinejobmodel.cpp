@@ -8,10 +8,13 @@
 #include <QIcon>
 #include <QDateTime>
 
+#include <algorithm>
+
 #include <KLocalizedString>
 
 #include "mymoneyobject.h"
 #include "mymoneyfile.h"
+#include "mymoneychangeset.h"
 #include "mymoneyaccount.h"
 #include "mymoneyutils.h"
 #include "onlinetasks/interfaces/tasks/onlinetask.h"
@@ -33,12 +36,8 @@ onlineJobModel::onlineJobModel(QObject *parent) :
     m_jobIdList(QStringList())
 {
     MyMoneyFile *const file = MyMoneyFile::instance();
-    connect(file, &MyMoneyFile::objectAdded,
-            this, &onlineJobModel::slotObjectAdded);
-    connect(file, &MyMoneyFile::objectModified,
-            this, &onlineJobModel::slotObjectModified);
-    connect(file, &MyMoneyFile::objectRemoved,
-            this, &onlineJobModel::slotObjectRemoved);
+    connect(file, &MyMoneyFile::changesCommitted,
+            this, &onlineJobModel::slotChangesCommitted);
 }
 
 void onlineJobModel::load()
@@ -248,34 +247,41 @@ bool onlineJobModel::removeRows(int row, int count, const QModelIndex & parent)
     return true;
 }
 
-void onlineJobModel::slotObjectAdded(eMyMoney::File::Object objType, const QString& id)
+void onlineJobModel::slotChangesCommitted(const MyMoneyChangeSet& changes)
 {
-    if (Q_LIKELY(objType != eMyMoney::File::Object::OnlineJob))
+    if (Q_LIKELY(!changes.contains(eMyMoney::File::Object::OnlineJob)))
         return;
-    beginInsertRows(QModelIndex(), rowCount(), rowCount());
-    m_jobIdList.append(id);
-    endInsertRows();
-}
-
-void onlineJobModel::slotObjectModified(eMyMoney::File::Object objType, const QString& id)
-{
-    if (Q_LIKELY(objType != eMyMoney::File::Object::OnlineJob))
-        return;
-
-    int row = m_jobIdList.indexOf(id);
-    if (row != -1)
-        emit dataChanged(index(row, 0), index(row, columnCount() - 1));
-}
 
-void onlineJobModel::slotObjectRemoved(eMyMoney::File::Object objType, const QString& id)
-{
-    if (Q_LIKELY(objType != eMyMoney::File::Object::OnlineJob))
-        return;
+    const auto removedIds = changes.removedObjects(eMyMoney::File::Object::OnlineJob);
+    for (const auto& id : removedIds) {
+        const int row = m_jobIdList.indexOf(id);
+        if (row != -1) {
+            beginRemoveRows(QModelIndex(), row, row);
+            m_jobIdList.removeAt(row);
+            endRemoveRows();
+        }
+    }
 
-    int row = m_jobIdList.indexOf(id);
-    if (row != -1) {
-        m_jobIdList.removeAll(id);
-        beginRemoveRows(QModelIndex(), row, row);
-        endRemoveRows();
+    // update all modified jobs with a single signal
+    int firstRow = -1;
+    int lastRow = -1;
+    const auto modifiedIds = changes.modifiedObjects(eMyMoney::File::Object::OnlineJob);
+    for (const auto& id : modifiedIds) {
+        const int row = m_jobIdList.indexOf(id);
+        if (row != -1) {
+            firstRow = (firstRow == -1) ? row : qMin(firstRow, row);
+            lastRow = qMax(lastRow, row);
+        }
+    }
+    if (firstRow != -1)
+        emit dataChanged(index(firstRow, 0), index(lastRow, columnCount() - 1));
+
+    // and append the new ones in the order of their creation
+    auto addedIds = changes.addedObjects(eMyMoney::File::Object::OnlineJob).values();
+    if (!addedIds.isEmpty()) {
+        std::sort(addedIds.begin(), addedIds.end());
+        beginInsertRows(QModelIndex(), rowCount(), rowCount() + addedIds.count() - 1);
+        m_jobIdList.append(addedIds);
+        endInsertRows();
     }
 }
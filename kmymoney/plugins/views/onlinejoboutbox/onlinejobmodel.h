@@ -10,12 +10,7 @@
 #include <QStringList>
 
 class MyMoneyObject;
-
-namespace eMyMoney {
-namespace File {
-enum class Object;
-}
-}
+class MyMoneyChangeSet;
 
 class onlineJobModel : public QAbstractTableModel
 {
@@ -55,9 +50,7 @@ Q_SIGNALS:
 public Q_SLOTS:
     void reloadAll();
 
-    void slotObjectAdded(eMyMoney::File::Object objType, const QString &id);
-    void slotObjectModified(eMyMoney::File::Object objType, const QString &id);
-    void slotObjectRemoved(eMyMoney::File::Object objType, const QString& id);
+    void slotChangesCommitted(const MyMoneyChangeSet& changes);
 
     /** @brief Load data from MyMoneyFile */
     void load();
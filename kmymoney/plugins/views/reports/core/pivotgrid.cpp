@@ -31,7 +31,7 @@ PivotCell::~PivotCell()
 {
 }
 
-PivotCell PivotCell::operator += (const PivotCell& right)
+PivotCell& PivotCell::operator += (const PivotCell& right)
 {
     const MyMoneyMoney& r = static_cast<const MyMoneyMoney&>(right);
     *this += r;
@@ -42,7 +42,7 @@ PivotCell PivotCell::operator += (const PivotCell& right)
     return *this;
 }
 
-PivotCell PivotCell::operator += (const MyMoneyMoney& value)
+PivotCell& PivotCell::operator += (const MyMoneyMoney& value)
 {
     m_cellUsed |= !value.isZero();
     if (m_stockSplit != MyMoneyMoney::ONE)
@@ -90,12 +90,12 @@ MyMoneyMoney PivotCell::cellBalance(const MyMoneyMoney& _balance)
 
 PivotGridRowSet::PivotGridRowSet(unsigned _numcolumns)
 {
-    insert(eActual, PivotGridRow(_numcolumns));
-    insert(eBudget, PivotGridRow(_numcolumns));
-    insert(eBudgetDiff, PivotGridRow(_numcolumns));
-    insert(eForecast, PivotGridRow(_numcolumns));
-    insert(eAverage, PivotGridRow(_numcolumns));
-    insert(ePrice, PivotGridRow(_numcolumns));
+    if (_numcolumns) {
+        // all rows share the same empty cells until they are modified
+        const PivotGridRow row(_numcolumns);
+        for (auto& r : m_rows)
+            r = row;
+    }
 }
 
 PivotGridRowSet PivotGrid::rowSet(QString id)
@@ -12,6 +12,7 @@
 
 #include <QMap>
 #include <QList>
+#include <QVector>
 
 // ----------------------------------------------------------------------------
 // KDE Includes
@@ -27,6 +28,9 @@ namespace reports
 
 enum ERowType {eActual, eBudget, eBudgetDiff, eForecast, eAverage, ePrice };
 
+/// number of entries in ERowType
+const int eRowTypeCount = ePrice + 1;
+
 /**
   * The fundamental data construct of this class is a 'grid'.  It is organized as follows:
   *
@@ -50,6 +54,11 @@ enum ERowType {eActual, eBudget, eBudgetDiff, eForecast, eAverage, ePrice };
   *
   * A 'Grid' is the set of all Outer Groups contained in this report.
   *
+  * The cells of a row are kept in one contiguous array and the rows of a
+  * row set are addressed directly by their ERowType, so that the calculation
+  * passes which visit every cell of the grid only walk the group maps once
+  * per row.
+  *
   */
 class PivotCell: public MyMoneyMoney
 {
@@ -60,8 +69,8 @@ public:
     explicit PivotCell(const MyMoneyMoney& value);
     virtual ~PivotCell();
     static PivotCell stockSplit(const MyMoneyMoney& factor);
-    PivotCell operator += (const PivotCell& right);
-    PivotCell operator += (const MyMoneyMoney& value);
+    PivotCell& operator += (const PivotCell& right);
+    PivotCell& operator += (const MyMoneyMoney& value);
     const QString formatMoney(int fraction, bool showThousandSeparator = true) const;
     const QString formatMoney(const QString& currency, const int prec, bool showThousandSeparator = true) const;
     MyMoneyMoney calculateRunningSum(const MyMoneyMoney& runningSum);
@@ -74,21 +83,31 @@ private:
     MyMoneyMoney m_postSplit;
     bool m_cellUsed;
 };
-class PivotGridRow: public QList<PivotCell>
+class PivotGridRow: public QVector<PivotCell>
 {
 public:
 
-    explicit PivotGridRow(unsigned _numcolumns = 0) {
-        for (uint i = 0; i < _numcolumns; i++)
-            append(PivotCell());
-    }
+    explicit PivotGridRow(unsigned _numcolumns = 0) : QVector<PivotCell>(_numcolumns) {}
     MyMoneyMoney m_total;
 };
 
-class PivotGridRowSet: public QMap<ERowType, PivotGridRow>
+class PivotGridRowSet
 {
 public:
     explicit PivotGridRowSet(unsigned _numcolumns = 0);
+
+    PivotGridRow& operator[](ERowType rowType) {
+        return m_rows[rowType];
+    }
+    const PivotGridRow& operator[](ERowType rowType) const {
+        return m_rows[rowType];
+    }
+    const PivotGridRow& value(ERowType rowType) const {
+        return m_rows[rowType];
+    }
+
+private:
+    PivotGridRow m_rows[eRowTypeCount];
 };
 
 class PivotInnerGroup: public QMap<ReportAccount, PivotGridRowSet>
@@ -810,23 +810,26 @@ MyMoneyMoney PivotTable::cellBalance(const QString& outergroup, const ReportAcco
     // Determine the inner group from the top-most parent account
     QString innergroup(row.topParentName());
 
+    // look up the row only once
+    PivotGridRowSet& rowSet = m_grid[outergroup][innergroup][row];
+
     if (m_numColumns <= _column)
         throw MYMONEYEXCEPTION(QString::fromLatin1("Column %1 out of m_numColumns range (%2) in PivotTable::cellBalance").arg(_column).arg(m_numColumns));
-    if (m_grid[outergroup][innergroup][row][eActual].count() <= _column)
-        throw MYMONEYEXCEPTION(QString::fromLatin1("Column %1 out of grid range (%2) in PivotTable::cellBalance").arg(_column).arg(m_grid[outergroup][innergroup][row][eActual].count()));
+    if (rowSet[eActual].count() <= _column)
+        throw MYMONEYEXCEPTION(QString::fromLatin1("Column %1 out of grid range (%2) in PivotTable::cellBalance").arg(_column).arg(rowSet[eActual].count()));
 
     MyMoneyMoney balance;
     if (budget)
-        balance = m_grid[outergroup][innergroup][row][eBudget][0].cellBalance(MyMoneyMoney());
+        balance = rowSet[eBudget][0].cellBalance(MyMoneyMoney());
     else
-        balance = m_grid[outergroup][innergroup][row][eActual][0].cellBalance(MyMoneyMoney());
+        balance = rowSet[eActual][0].cellBalance(MyMoneyMoney());
 
     int column = m_startColumn;
     while (column < _column) {
-        if (m_grid[outergroup][innergroup][row][eActual].count() <= column)
-            throw MYMONEYEXCEPTION(QString::fromLatin1("Column %1 out of grid range (%2) in PivotTable::cellBalance").arg(column).arg(m_grid[outergroup][innergroup][row][eActual].count()));
+        if (rowSet[eActual].count() <= column)
+            throw MYMONEYEXCEPTION(QString::fromLatin1("Column %1 out of grid range (%2) in PivotTable::cellBalance").arg(column).arg(rowSet[eActual].count()));
 
-        balance = m_grid[outergroup][innergroup][row][eActual][column].cellBalance(balance);
+        balance = rowSet[eActual][column].cellBalance(balance);
 
         ++column;
     }
@@ -1035,26 +1038,42 @@ void PivotTable::convertToBaseCurrency()
     QList<ERowType> rowTypeList = m_rowTypeList;
     rowTypeList.removeOne(eAverage);
 
+    // the dates of the columns are the same for all rows
+    QVector<QDate> columnDates(m_numColumns);
+    for (int column = 0; column < m_numColumns; ++column) {
+        columnDates[column] = columnDate(column);
+    }
+
+    // rows using the same currency share the same conversion factors,
+    // so we get them for all columns at once and only once per currency
+    QHash<QString, QVector<MyMoneyMoney>> conversionFactorCache;
+
     PivotGrid::iterator it_outergroup = m_grid.begin();
     while (it_outergroup != m_grid.end()) {
         PivotOuterGroup::iterator it_innergroup = (*it_outergroup).begin();
         while (it_innergroup != (*it_outergroup).end()) {
             PivotInnerGroup::iterator it_row = (*it_innergroup).begin();
             while (it_row != (*it_innergroup).end()) {
+                const auto currencyId = it_row.key().currencyId();
+                auto it_factors = conversionFactorCache.constFind(currencyId);
+                if (it_factors == conversionFactorCache.constEnd()) {
+                    it_factors = conversionFactorCache.insert(currencyId, it_row.key().baseCurrencyPrices(columnDates, m_config.isSkippingZero()));
+                }
+                const auto& conversionfactors = *it_factors;
+
+                int pricePrecision;
+                if (it_row.key().isInvest())
+                    pricePrecision = file->security(it_row.key().currencyId()).pricePrecision();
+                else
+                    pricePrecision = MyMoneyMoney::denomToPrec(fraction);
+
                 auto column = 0;
                 while (column < m_numColumns) {
                     if (it_row.value()[eActual].count() <= column)
                         throw MYMONEYEXCEPTION(QString::fromLatin1("Column %1 out of grid range (%2) in PivotTable::convertToBaseCurrency").arg(column).arg(it_row.value()[eActual].count()));
 
-                    QDate valuedate = columnDate(column);
-
                     //get base price for that date
-                    MyMoneyMoney conversionfactor = it_row.key().baseCurrencyPrice(valuedate, m_config.isSkippingZero());
-                    int pricePrecision;
-                    if (it_row.key().isInvest())
-                        pricePrecision = file->security(it_row.key().currencyId()).pricePrecision();
-                    else
-                        pricePrecision = MyMoneyMoney::denomToPrec(fraction);
+                    const MyMoneyMoney& conversionfactor = conversionfactors.at(column);
 
                     foreach (const auto rowType, rowTypeList) {
                         //calculate base value
@@ -1288,21 +1307,25 @@ void PivotTable::assignCell(const QString& outergroup, const ReportAccount& _row
     // Determine the inner group from the top-most parent account
     QString innergroup(row.topParentName());
 
+    // look up the row only once
+    PivotOuterGroup& outerGroup = m_grid[outergroup];
+    PivotGridRowSet& rowSet = outerGroup[innergroup][row];
+
     if (m_numColumns <= column)
         throw MYMONEYEXCEPTION(QString::fromLatin1("Column %1 out of m_numColumns range (%2) in PivotTable::assignCell").arg(column).arg(m_numColumns));
-    if (m_grid[outergroup][innergroup][row][eActual].count() <= column)
-        throw MYMONEYEXCEPTION(QString::fromLatin1("Column %1 out of grid range (%2) in PivotTable::assignCell").arg(column).arg(m_grid[outergroup][innergroup][row][eActual].count()));
-    if (m_grid[outergroup][innergroup][row][eBudget].count() <= column)
-        throw MYMONEYEXCEPTION(QString::fromLatin1("Column %1 out of grid range (%2) in PivotTable::assignCell").arg(column).arg(m_grid[outergroup][innergroup][row][eBudget].count()));
+    if (rowSet[eActual].count() <= column)
+        throw MYMONEYEXCEPTION(QString::fromLatin1("Column %1 out of grid range (%2) in PivotTable::assignCell").arg(column).arg(rowSet[eActual].count()));
+    if (rowSet[eBudget].count() <= column)
+        throw MYMONEYEXCEPTION(QString::fromLatin1("Column %1 out of grid range (%2) in PivotTable::assignCell").arg(column).arg(rowSet[eBudget].count()));
 
     if (!stockSplit) {
         // Determine whether the value should be inverted before being placed in the row
-        if (m_grid[outergroup].m_inverted)
+        if (outerGroup.m_inverted)
             value = -value;
 
         // Add the value to the grid cell
         if (budget) {
-            m_grid[outergroup][innergroup][row][eBudget][column] += value;
+            rowSet[eBudget][column] += value;
         } else {
             // If it is loading an actual value for a budget report
             // check whether it is a subaccount of a budget account (include subaccounts)
@@ -1312,13 +1335,13 @@ void PivotTable::assignCell(const QString& outergroup, const ReportAccount& _row
                     row.currencyId() != _row.currencyId()) {
                 ReportAccount origAcc = _row;
                 MyMoneyMoney rate = origAcc.foreignCurrencyPrice(row.currencyId(), columnDate(column), false);
-                m_grid[outergroup][innergroup][row][eActual][column] += (value * rate).reduce();
+                rowSet[eActual][column] += (value * rate).reduce();
             } else {
-                m_grid[outergroup][innergroup][row][eActual][column] += value;
+                rowSet[eActual][column] += value;
             }
         }
     } else {
-        m_grid[outergroup][innergroup][row][eActual][column] += PivotCell::stockSplit(value);
+        rowSet[eActual][column] += PivotCell::stockSplit(value);
     }
 
 }
@@ -1330,19 +1353,21 @@ void PivotTable::createRow(const QString& outergroup, const ReportAccount& row,
     // Determine the inner group from the top-most parent account
     QString innergroup(row.topParentName());
 
-    if (! m_grid.contains(outergroup)) {
+    auto it_outergroup = m_grid.find(outergroup);
+    if (it_outergroup == m_grid.end()) {
         DEBUG_OUTPUT(QString("Adding group [%1]").arg(outergroup));
-        m_grid[outergroup] = PivotOuterGroup(m_numColumns);
+        it_outergroup = m_grid.insert(outergroup, PivotOuterGroup(m_numColumns));
     }
 
-    if (! m_grid[outergroup].contains(innergroup)) {
+    auto it_innergroup = (*it_outergroup).find(innergroup);
+    if (it_innergroup == (*it_outergroup).end()) {
         DEBUG_OUTPUT(QString("Adding group [%1][%2]").arg(outergroup).arg(innergroup));
-        m_grid[outergroup][innergroup] = PivotInnerGroup(m_numColumns);
+        it_innergroup = (*it_outergroup).insert(innergroup, PivotInnerGroup(m_numColumns));
     }
 
-    if (! m_grid[outergroup][innergroup].contains(row)) {
+    if (! (*it_innergroup).contains(row)) {
         DEBUG_OUTPUT(QString("Adding row [%1][%2][%3]").arg(outergroup).arg(innergroup).arg(row.debugName()));
-        m_grid[outergroup][innergroup][row] = PivotGridRowSet(m_numColumns);
+        (*it_innergroup).insert(row, PivotGridRowSet(m_numColumns));
 
         if (recursive && !row.isTopLevel())
             createRow(outergroup, row.parent(), recursive);
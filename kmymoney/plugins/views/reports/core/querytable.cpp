@@ -6,6 +6,7 @@
 
 #include "querytable.h"
 
+#include <algorithm>
 #include <cmath>
 
 // ----------------------------------------------------------------------------
@@ -38,6 +39,7 @@
 #include "kmymoneyutils.h"
 #include "reportaccount.h"
 #include "mymoneyenums.h"
+#include "journalmodel.h"
 
 namespace reports
 {
@@ -1169,6 +1171,55 @@ QString QueryTable::helperIRR(const CashFlowList &all) const
     }
 }
 
+namespace
+{
+/**
+ * Returns the activities of @a account in journal order. They are taken
+ * from the ledger kept by the engine unless @a report filters by more than
+ * the account and the date, in which case the matching transactions are
+ * analyzed here.
+ */
+QVector<JournalModel::InvestmentActivity> investmentActivities(const ReportAccount& account, const MyMoneyReport& report)
+{
+    const auto file = MyMoneyFile::instance();
+    const MyMoneyTransactionFilter::FilterSet ledgerFilters(MyMoneyTransactionFilter::accountFilterActive | MyMoneyTransactionFilter::dateFilterActive);
+    if (!(report.filterSet() & ~ledgerFilters)) {
+        return file->journalModel()->investmentActivities(account.id());
+    }
+
+    MyMoneyReport filter = report;
+    QList<MyMoneyTransaction> transactions;
+    file->transactionList(transactions, filter);
+
+    QVector<JournalModel::InvestmentActivity> activities;
+    activities.reserve(transactions.count());
+    for (const auto& transaction : qAsConst(transactions)) {
+        activities.append(JournalModel::investmentActivity(transaction, transaction.splitByAccount(account.id())));
+    }
+    return activities;
+}
+
+/**
+ * Returns the range [@a first, @a last) of @a activities posted between
+ * @a from and @a to (both inclusive). An invalid date does not limit the range.
+ */
+void activityRange(const QVector<JournalModel::InvestmentActivity>& activities, const QDate& from, const QDate& to, int& first, int& last)
+{
+    first = 0;
+    last = activities.count();
+    if (from.isValid()) {
+        first = static_cast<int>(std::lower_bound(activities.constBegin(), activities.constEnd(), from, [](const JournalModel::InvestmentActivity& activity, const QDate& date) {
+            return activity.postDate < date;
+        }) - activities.constBegin());
+    }
+    if (to.isValid()) {
+        last = static_cast<int>(std::upper_bound(activities.constBegin(), activities.constEnd(), to, [](const QDate& date, const JournalModel::InvestmentActivity& activity) {
+            return date < activity.postDate;
+        }) - activities.constBegin());
+    }
+}
+} // namespace
+
 void QueryTable::sumInvestmentValues(const ReportAccount& account, QList<CashFlowList>& cfList, QList<MyMoneyMoney>& shList) const
 {
     for (int i = InvestmentValue::Buys; i < InvestmentValue::End; ++i)
@@ -1215,21 +1266,19 @@ void QueryTable::sumInvestmentValues(const ReportAccount& account, QList<CashFlo
     report.setConsiderCategory(true);
     report.clearAccountFilter();
     report.addAccount(account.id());
-    report.setDateFilter(newStartingDate, newEndingDate);
+
+    // the activities are analyzed once for all date ranges
+    report.setDateFilter(QDate(), newEndingDate);
+    const auto activities = investmentActivities(account, report);
+    int first;
+    int last;
 
     do {
-        QList<MyMoneyTransaction> transactions;
-        file->transactionList(transactions, report);
-        for (QList<MyMoneyTransaction>::const_reverse_iterator  it_t = transactions.crbegin(); it_t != transactions.crend(); ++it_t) {
-            MyMoneySplit shareSplit = (*it_t).splitByAccount(account.id());
-            MyMoneySplit assetAccountSplit;
-            QList<MyMoneySplit> feeSplits;
-            QList<MyMoneySplit> interestSplits;
-            MyMoneySecurity security;
-            MyMoneySecurity currency;
-            eMyMoney::Split::InvestmentTransactionType transactionType;
-            MyMoneyUtils::dissectTransaction((*it_t), shareSplit, assetAccountSplit, feeSplits, interestSplits, security, currency, transactionType);
-            QDate postDate = (*it_t).postDate();
+        activityRange(activities, newStartingDate, newEndingDate, first, last);
+        for (auto row = last - 1; row >= first; --row) {
+            const auto& activity = activities.at(row);
+            const auto transactionType = activity.type;
+            QDate postDate = activity.postDate;
             MyMoneyMoney price;
             //get price for the day of the transaction if we have to calculate base currency
             //we are using the value of the split which is in deep currency
@@ -1237,8 +1286,8 @@ void QueryTable::sumInvestmentValues(const ReportAccount& account, QList<CashFlo
                 price = account.baseCurrencyPrice(postDate); //we only need base currency because the value is in deep currency
             else
                 price = MyMoneyMoney::ONE;
-            MyMoneyMoney value = assetAccountSplit.value() * price;
-            MyMoneyMoney shares = shareSplit.shares();
+            MyMoneyMoney value = activity.value * price;
+            MyMoneyMoney shares = activity.shares;
 
             if (transactionType == eMyMoney::Split::InvestmentTransactionType::BuyShares) {
                 if (reportedDateRange) {
@@ -1309,10 +1358,7 @@ void QueryTable::sumInvestmentValues(const ReportAccount& account, QList<CashFlo
                     shList[BuysOfOwned] = MyMoneyMoney();
                 }
                 if (transactionType == eMyMoney::Split::InvestmentTransactionType::ReinvestDividend) {
-                    value = MyMoneyMoney();
-                    foreach (const auto split, interestSplits)
-                        value += split.value();
-                    value *= price;
+                    value = activity.interestValue * price;
                     cfList[ReinvestIncome].append(CashFlowListItem(postDate, -value));
                 }
             } else if (transactionType == eMyMoney::Split::InvestmentTransactionType::RemoveShares && reportedDateRange) // removed shares give no value in return so no capital gain on them
@@ -1323,8 +1369,7 @@ void QueryTable::sumInvestmentValues(const ReportAccount& account, QList<CashFlo
         }
         reportedDateRange = false;
         newEndingDate = newStartingDate;
-        newStartingDate = newStartingDate.addYears(-1);
-        report.setDateFilter(newStartingDate, newEndingDate); // search for matching buy transactions year earlier
+        newStartingDate = newStartingDate.addYears(-1); // search for matching buy transactions year earlier
 
     } while (
         (
@@ -1338,28 +1383,20 @@ void QueryTable::sumInvestmentValues(const ReportAccount& account, QList<CashFlo
     if (isSTLT && !shList[LongTermBuysOfSells].isZero()) {
         newStartingDate = startingDate;
         newEndingDate = endingDate.addDays(-settlementPeriod);
-        report.setDateFilter(newStartingDate, newEndingDate); // search for matching buy transactions year earlier
-        QList<MyMoneyTransaction> transactions;
-        file->transactionList(transactions, report);
+        activityRange(activities, newStartingDate, newEndingDate, first, last);
         shList[BuysOfOwned] = shList[LongTermBuysOfSells];
 
-        foreach (const auto transaction, transactions) {
-            MyMoneySplit shareSplit = transaction.splitByAccount(account.id());
-            MyMoneySplit assetAccountSplit;
-            QList<MyMoneySplit> feeSplits;
-            QList<MyMoneySplit> interestSplits;
-            MyMoneySecurity security;
-            MyMoneySecurity currency;
-            eMyMoney::Split::InvestmentTransactionType transactionType;
-            MyMoneyUtils::dissectTransaction(transaction, shareSplit, assetAccountSplit, feeSplits, interestSplits, security, currency, transactionType);
-            QDate postDate = transaction.postDate();
+        for (auto row = first; row < last; ++row) {
+            const auto& activity = activities.at(row);
+            const auto transactionType = activity.type;
+            QDate postDate = activity.postDate;
             MyMoneyMoney price;
             if (m_config.isConvertCurrency())
                 price = account.baseCurrencyPrice(postDate); //we only need base currency because the value is in deep currency
             else
                 price = MyMoneyMoney::ONE;
-            MyMoneyMoney value = assetAccountSplit.value() * price;
-            MyMoneyMoney shares = shareSplit.shares();
+            MyMoneyMoney value = activity.value * price;
+            MyMoneyMoney shares = activity.shares;
 
             if (transactionType == eMyMoney::Split::InvestmentTransactionType::SellShares) {
                 if ((shList.at(LongTermSellsOfBuys) + shares).abs() >= shList.at(LongTermBuysOfSells)) { // add partially sold long-term shares
@@ -181,6 +181,44 @@ MyMoneyMoney ReportAccount::foreignCurrencyPrice(const QString foreignCurrency,
     return result;
 }
 
+QVector<MyMoneyMoney> ReportAccount::baseCurrencyPrices(const QVector<QDate>& dates, bool exactDate) const
+{
+    DEBUG_ENTER(Q_FUNC_INFO);
+
+    if (isForeignCurrency()) {
+        return foreignCurrencyPrices(MyMoneyFile::instance()->baseCurrency().id(), dates, exactDate);
+    }
+    return QVector<MyMoneyMoney>(dates.count(), MyMoneyMoney::ONE);
+}
+
+QVector<MyMoneyMoney> ReportAccount::foreignCurrencyPrices(const QString foreignCurrency, const QVector<QDate>& dates, bool exactDate) const
+{
+    DEBUG_ENTER(Q_FUNC_INFO);
+
+    QVector<MyMoneyMoney> result(dates.count(), MyMoneyMoney::ONE);
+    MyMoneyFile* file = MyMoneyFile::instance();
+    MyMoneySecurity security = file->security(foreignCurrency);
+
+    //check whether it is a currency or a commodity. In the latter case case, get the trading currency
+    QString tradingCurrency;
+    if (security.isCurrency()) {
+        tradingCurrency = foreignCurrency;
+    } else {
+        tradingCurrency = security.tradingCurrency();
+    }
+
+    //It makes no sense to get the price if both currencies are the same
+    if (currency().id() != tradingCurrency) {
+        const auto prices = file->priceSeries(currency().id(), tradingCurrency, dates, exactDate);
+        for (int i = 0; i < prices.count(); ++i) {
+            if (prices.at(i).isValid()) {
+                result[i] = prices.at(i).rate(tradingCurrency);
+            }
+        }
+    }
+    return result;
+}
+
 /**
   * Fetch the trading currency of this account's currency
   *
@@ -129,6 +129,33 @@ public:
      */
     MyMoneyMoney foreignCurrencyPrice(const QString foreignCurrency, const QDate& date, bool exactDate = false) const;
 
+    /**
+     * Same as baseCurrencyPrice() but returns the prices for all
+     * @a dates at once. The n-th entry of the result is the price for
+     * the n-th date. This is a lot faster than calling baseCurrencyPrice()
+     * for each date.
+     *
+     * @param dates The dates in question
+     * @param exactDate if @a true, the dates must be exact, otherwise
+     *                  the last known price prior to a date can also be used
+     *                  @a false is the default
+     * @return QVector<MyMoneyMoney> The values of the account's currency on the dates
+     */
+    QVector<MyMoneyMoney> baseCurrencyPrices(const QVector<QDate>& dates, bool exactDate = false) const;
+
+    /**
+     * Same as foreignCurrencyPrice() but returns the prices for all
+     * @a dates at once.
+     *
+     * @param foreignCurrency The currency on which the prices will be returned
+     * @param dates The dates in question
+     * @param exactDate if @a true, the dates must be exact, otherwise
+     *                  the last known price prior to a date can also be used
+     *                  @a false is the default
+     * @return QVector<MyMoneyMoney> The values of the account's currency on the dates
+     */
+    QVector<MyMoneyMoney> foreignCurrencyPrices(const QString foreignCurrency, const QVector<QDate>& dates, bool exactDate = false) const;
+
     /**
       * Fetch the trading symbol of this account's deep currency
       *
@@ -160,3 +160,32 @@ void PivotGridTest::testCellRunningSum()
     QVERIFY(a.m_stockSplit == MyMoneyMoney::ONE);
     QVERIFY(a.m_postSplit == MyMoneyMoney());
 }
+
+void PivotGridTest::testRowSet()
+{
+    PivotGridRowSet empty;
+    for (int i = 0; i < eRowTypeCount; ++i)
+        QVERIFY(empty[static_cast<ERowType>(i)].isEmpty());
+
+    PivotGridRowSet rowSet(3);
+    for (int i = 0; i < eRowTypeCount; ++i)
+        QCOMPARE(rowSet.value(static_cast<ERowType>(i)).count(), 3);
+
+    // the rows of the different types are independent
+    rowSet[eActual][1] += MyMoneyMoney(5, 1);
+    rowSet[eBudget].m_total = MyMoneyMoney(7, 1);
+    QVERIFY(rowSet[eActual][1] == MyMoneyMoney(5, 1));
+    QVERIFY(rowSet[eBudget][1] == MyMoneyMoney());
+    QVERIFY(rowSet[eActual].m_total == MyMoneyMoney());
+    QVERIFY(rowSet[eBudget].m_total == MyMoneyMoney(7, 1));
+
+    // copies are independent as well
+    PivotGridRowSet copy(rowSet);
+    copy[eActual][1] += MyMoneyMoney(1, 1);
+    QVERIFY(copy[eActual][1] == MyMoneyMoney(6, 1));
+    QVERIFY(rowSet[eActual][1] == MyMoneyMoney(5, 1));
+
+    rowSet[eActual].append(PivotCell());
+    QCOMPARE(rowSet[eActual].count(), 4);
+    QCOMPARE(rowSet[eBudget].count(), 3);
+}
@@ -33,6 +33,7 @@ private Q_SLOTS:
     void testCellAddValue();
     void testCellAddCell();
     void testCellRunningSum();
+    void testRowSet();
 };
 
 }
@@ -14,6 +14,7 @@
 
 #include <QMap>
 #include <QXmlLocator>
+#include <QXmlStreamReader>
 #include <QXmlStreamWriter>
 #include <QTextStream>
 #include <QList>
@@ -79,11 +80,17 @@ using namespace eMyMoney;
 unsigned int MyMoneyStorageXML::fileVersionRead = 0;
 unsigned int MyMoneyStorageXML::fileVersionWrite = 0;
 
+bool saveNodeCanonically(QXmlStreamWriter &stream, const QDomNode &domNode);
+void writeStartElementCanonically(QXmlStreamWriter &stream, const QDomElement &domElement);
+
 class MyMoneyStorageXML::Private
 {
     friend class MyMoneyStorageXML;
 public:
-    Private() : m_nextTransactionID(0) {}
+    Private()
+        : m_nextTransactionID(0)
+        , m_stream(nullptr)
+    {}
 
     QMap<QString, MyMoneyInstitution> iList;
     QMap<QString, MyMoneyAccount> aList;
@@ -104,14 +111,185 @@ public:
     unsigned long     m_nextTransactionID;
     static const int  TRANSACTION_ID_SIZE = 18;
 
+    /**
+     * The stream the file is written to while writing a file
+     * in streaming mode. @c nullptr otherwise.
+     */
+    QXmlStreamWriter* m_stream;
+
+    /**
+     * The elements whose start tag has been written to m_stream
+     * but not their end tag. The innermost element is the last one.
+     */
+    QList<QDomElement> m_openElements;
+
     QString nextTransactionID() {
         QString id;
         id.setNum(++m_nextTransactionID);
         id = 'T' + id.rightJustified(TRANSACTION_ID_SIZE, '0');
         return id;
     }
+
+    /**
+     * Loads the global key/value pairs found in @a container together
+     * with the file information collected before into the parameters model.
+     */
+    void loadParameters(MyMoneyFile* file, const MyMoneyKeyValueContainer& container);
+
+    /**
+     * Dumps the objects collected for the container element
+     * @a containerTag (e.g. TRANSACTIONS) into the respective model
+     * of @a file. Tags that do not denote a container are ignored.
+     */
+    void loadCollectedObjects(MyMoneyFile* file, const QString& containerTag);
+
+    /**
+     * In streaming mode, this writes the child elements of @a parent to
+     * m_stream and removes them from @a parent. The start tag of @a parent
+     * is written on the first call, so all its attributes must be set by
+     * then. In document mode, the children remain where they are.
+     */
+    void flushChildren(QDomElement& parent);
+
+    /**
+     * Adds the complete @a section to @a parent. In streaming mode this
+     * flushes the remaining children of @a section and closes it.
+     */
+    void appendSection(QDomElement& parent, QDomElement& section);
+
+    /**
+     * Writes all items of @a model to @a parent using @a writer and
+     * sets the count attribute of @a parent. In streaming mode, each
+     * item is written to m_stream right after it has been created.
+     */
+    template <class T>
+    void writeItems(MyMoneyModel<T>* model, void (*writer)(const T&, QDomDocument&, QDomElement&), QDomDocument& document, QDomElement& parent)
+    {
+        struct StreamWriter : public MyMoneyModel<T>::xmlWriter
+        {
+            StreamWriter(Private* d, void (*writer)(const T&, QDomDocument&, QDomElement&), QDomDocument& document, QDomElement& element)
+                : MyMoneyModel<T>::xmlWriter(writer, document, element)
+                , m_d(d) {}
+            void operator()(const T& item) override {
+                MyMoneyModel<T>::xmlWriter::operator()(item);
+                m_d->flushChildren(this->m_element);
+            }
+            Private* m_d;
+        };
+
+        struct Counter : public MyMoneyModel<T>::Worker
+        {
+            void operator()(const T&) override {}
+        };
+
+        // the count must be known before the first item is streamed
+        Counter counter;
+        parent.setAttribute(attributeName(Attribute::General::Count), model->processItems(&counter));
+        StreamWriter streamWriter(this, writer, document, parent);
+        model->processItems(&streamWriter);
+    }
 };
 
+void MyMoneyStorageXML::Private::flushChildren(QDomElement& parent)
+{
+    if (!m_stream)
+        return;
+
+    if (m_openElements.isEmpty() || m_openElements.last() != parent) {
+        writeStartElementCanonically(*m_stream, parent);
+        m_openElements.append(parent);
+    }
+
+    while (parent.hasChildNodes()) {
+        auto child = parent.firstChild();
+        saveNodeCanonically(*m_stream, child);
+        parent.removeChild(child);
+    }
+}
+
+void MyMoneyStorageXML::Private::appendSection(QDomElement& parent, QDomElement& section)
+{
+    if (!m_stream) {
+        parent.appendChild(section);
+        return;
+    }
+
+    // make sure the parent is open before the section is written
+    flushChildren(parent);
+    flushChildren(section);
+    m_stream->writeEndElement();
+    m_openElements.removeLast();
+}
+
+void MyMoneyStorageXML::Private::loadParameters(MyMoneyFile* file, const MyMoneyKeyValueContainer& container)
+{
+    file->parametersModel()->load(container.pairs());
+    const auto end = fileInfoKvp.constEnd();
+    for (auto it = fileInfoKvp.constBegin(); it != end; ++it) {
+        file->parametersModel()->addItem(it.key(), it.value());
+    }
+    // loading does not count as making dirty
+    file->parametersModel()->setDirty(false);
+    fileInfoKvp.clear();
+}
+
+void MyMoneyStorageXML::Private::loadCollectedObjects(MyMoneyFile* file, const QString& containerTag)
+{
+    const auto& s = containerTag;
+    if (s == tagName(Tag::Payees)) {
+        // last payee read, now dump them into the engine
+        file->payeesModel()->load(pList);
+        pList.clear();
+    } else if (s == tagName(Tag::Schedules)) {
+        // last schedule read, now dump them into the engine
+        file->schedulesModel()->load(sList);
+        sList.clear();
+    } else if (s == tagName(Tag::CostCenters)) {
+        file->costCenterModel()->load(ccList);
+        ccList.clear();
+    } else if (s == tagName(Tag::Tags)) {
+        // last tag read, now dump them into the engine
+        file->tagsModel()->load(taList);
+        taList.clear();
+    } else if (s == tagName(Tag::Securities)) {
+        // last security read, now dump them into the engine
+        file->securitiesModel()->load(secList);
+        secList.clear();
+    } else if (s == tagName(Tag::Currencies)) {
+        // last currency read, now dump them into the engine
+        file->currenciesModel()->loadCurrencies(secList);
+        secList.clear();
+    } else if (s == tagName(Tag::Budgets)) {
+        // last budget read, now dump them into the engine
+        file->budgetsModel()->load(bList);
+        bList.clear();
+    } else if (s == tagName(Tag::Accounts)) {
+        // last account read, now dump them into the engine
+        file->accountsModel()->load(aList);
+        aList.clear();
+    } else if (s == tagName(Tag::Institutions)) {
+        // last institution read, now dump them into the engine
+        file->institutionsModel()->load(iList);
+        iList.clear();
+    } else if (s == tagName(Tag::Transactions)) {
+        // last transaction read, now dump them into the engine
+        file->journalModel()->load(tList);
+        tList.clear();
+    } else if (s == tagName(Tag::Prices)) {
+        // last price read, now dump them into the engine
+        file->priceModel()->load(prList);
+        prList.clear();
+    } else if (s == tagName(Tag::OnlineJobs)) {
+        file->onlineJobsModel()->load(onlineJobList);
+        onlineJobList.clear();
+    } else if (s == tagName(Tag::Reports)) {
+        // last report read, now dump them into the engine
+        file->reportsModel()->load(rList);
+        rList.clear();
+    }
+    /// @note add new models here
+}
+
 namespace test {
 bool readRCFfromXMLDoc(QList<MyMoneyReport>& list, QDomDocument* doc);
 void writeRCFtoXMLDoc(const MyMoneyReport& filter, QDomDocument* doc);
@@ -121,6 +299,7 @@ class MyMoneyXmlContentHandler : public QXmlContentHandler
 {
     friend class MyMoneyXmlContentHandlerTest;
     friend class MyMoneyStorageXML;
+    friend class MyMoneyXmlStreamReader;
     friend bool test::readRCFfromXMLDoc(QList<MyMoneyReport>& list, QDomDocument* doc);
     friend void test::writeRCFtoXMLDoc(const MyMoneyReport& filter, QDomDocument* doc);
 
@@ -191,6 +370,69 @@ private:
     static void writePrice(const PriceEntry& price, QDomDocument &document, QDomElement &parent);
 };
 
+/**
+ * This class reads a KMyMoney XML file using a QXmlStreamReader. The
+ * objects found in large numbers (transactions with their splits, accounts,
+ * securities, tags, prices and key/value pairs) are decoded straight from
+ * the token stream without creating any QDomElement. All other objects are
+ * copied into a DOM subtree covering just that object and passed on
+ * to the readers provided by MyMoneyXmlContentHandler.
+ *
+ * The objects are collected in the lists of MyMoneyStorageXML::Private
+ * and loaded into the models when the end of their container is seen,
+ * exactly as MyMoneyXmlContentHandler does it.
+ */
+class MyMoneyXmlStreamReader
+{
+    friend class MyMoneyXmlContentHandlerTest;
+
+public:
+    explicit MyMoneyXmlStreamReader(MyMoneyStorageXML* reader);
+
+    /**
+     * Reads the whole content of @a device.
+     *
+     * @retval true file was read successfully
+     * @retval false file could not be read, see errorString()
+     */
+    bool read(QIODevice* device);
+
+    QString errorString() const;
+
+private:
+    bool readStartElement();
+
+    /**
+     * Calls @a handler for every element contained in the current element
+     * in document order. In case @a handler returns @c false, the elements
+     * contained in the one passed to @a handler are visited as well. If it
+     * returns @c true, it must have consumed the element up to and including
+     * its end element. This mimics QDomElement::elementsByTagName().
+     */
+    template<typename Handler>
+    static void readDescendants(QXmlStreamReader& xml, const Handler& handler)
+    {
+        while (xml.readNextStartElement()) {
+            if (!handler(xml))
+                readDescendants(xml, handler);
+        }
+    }
+
+    static QDomElement readDomElement(QXmlStreamReader& xml, QDomDocument& document);
+    static void readKeyValueContainer(QXmlStreamReader& xml, MyMoneyKeyValueContainer& container);
+    static MyMoneyTransaction readTransaction(QXmlStreamReader& xml, bool assignEntryDateIfEmpty = true);
+    static MyMoneySplit readSplit(QXmlStreamReader& xml);
+    static MyMoneyAccount readAccount(QXmlStreamReader& xml);
+    static MyMoneySecurity readSecurity(QXmlStreamReader& xml);
+    static MyMoneyTag readTag(QXmlStreamReader& xml);
+    static MyMoneyPrice readPrice(QXmlStreamReader& xml, const QString& from, const QString& to);
+
+    MyMoneyStorageXML* m_reader;
+    QXmlStreamReader   m_xml;
+    int                m_elementCount;
+    QString            m_errMsg;
+};
+
 MyMoneyXmlContentHandler::MyMoneyXmlContentHandler(MyMoneyStorageXML* reader) :
     m_reader(reader),
     m_loc(0),
@@ -371,14 +613,7 @@ bool MyMoneyXmlContentHandler::endElement(const QString& /* namespaceURI */, con
                 } else if (s == nodeName(Node::KeyValuePairs)) {
                     MyMoneyKeyValueContainer container;
                     addToKeyValueContainer(container, m_baseNode);
-                    m_reader->m_file->parametersModel()->load(container.pairs());
-                    const auto end = m_reader->d->fileInfoKvp.constEnd();
-                    for (auto it = m_reader->d->fileInfoKvp.constBegin(); it != end; ++it) {
-                        m_reader->m_file->parametersModel()->addItem(it.key(), it.value());
-                    }
-                    // loading does not count as making dirty
-                    m_reader->m_file->parametersModel()->setDirty(false);
-                    m_reader->d->fileInfoKvp.clear();
+                    m_reader->d->loadParameters(m_reader->m_file, container);
 
                 } else if (s == nodeName(Node::Institution)) {
                     auto i = readInstitution(m_baseNode);
@@ -430,58 +665,7 @@ bool MyMoneyXmlContentHandler::endElement(const QString& /* namespaceURI */, con
             m_doc = QDomDocument();
         }
     } else {
-        if (s == tagName(Tag::Payees)) {
-            // last payee read, now dump them into the engine
-            m_reader->m_file->payeesModel()->load(m_reader->d->pList);
-            m_reader->d->pList.clear();
-        } else if (s == tagName(Tag::Schedules)) {
-            // last schedule read, now dump them into the engine
-            m_reader->m_file->schedulesModel()->load(m_reader->d->sList);
-            m_reader->d->sList.clear();
-        } else if (s == tagName(Tag::CostCenters)) {
-            m_reader->m_file->costCenterModel()->load(m_reader->d->ccList);
-            m_reader->d->ccList.clear();
-        } else if (s == tagName(Tag::Tags)) {
-            // last tag read, now dump them into the engine
-            m_reader->m_file->tagsModel()->load(m_reader->d->taList);
-            m_reader->d->taList.clear();
-        } else if (s == tagName(Tag::Securities)) {
-            // last security read, now dump them into the engine
-            m_reader->m_file->securitiesModel()->load(m_reader->d->secList);
-            m_reader->d->secList.clear();
-        } else if (s == tagName(Tag::Currencies)) {
-            // last currency read, now dump them into the engine
-            m_reader->m_file->currenciesModel()->loadCurrencies(m_reader->d->secList);
-            m_reader->d->secList.clear();
-        } else if (s == tagName(Tag::Budgets)) {
-            // last budget read, now dump them into the engine
-            m_reader->m_file->budgetsModel()->load(m_reader->d->bList);
-            m_reader->d->bList.clear();
-        } else if (s == tagName(Tag::Accounts)) {
-            // last account read, now dump them into the engine
-            m_reader->m_file->accountsModel()->load(m_reader->d->aList);
-            m_reader->d->aList.clear();
-        } else if (s == tagName(Tag::Institutions)) {
-            // last institution read, now dump them into the engine
-            m_reader->m_file->institutionsModel()->load(m_reader->d->iList);
-            m_reader->d->iList.clear();
-        } else if (s == tagName(Tag::Transactions)) {
-            // last transaction read, now dump them into the engine
-            m_reader->m_file->journalModel()->load(m_reader->d->tList);
-            m_reader->d->tList.clear();
-        } else if (s == tagName(Tag::Prices)) {
-            // last price read, now dump them into the engine
-            m_reader->m_file->priceModel()->load(m_reader->d->prList);
-            m_reader->d->prList.clear();
-        } else if (s == tagName(Tag::OnlineJobs)) {
-            m_reader->m_file->onlineJobsModel()->load(m_reader->d->onlineJobList);
-            m_reader->d->onlineJobList.clear();
-        } else if (s == tagName(Tag::Reports)) {
-            // last report read, now dump them into the engine
-            m_reader->m_file->reportsModel()->load(m_reader->d->rList);
-            m_reader->d->rList.clear();
-        }
-        /// @note add new models here
+        m_reader->d->loadCollectedObjects(m_reader->m_file, s);
     }
     return rc;
 }
@@ -1380,6 +1564,502 @@ void MyMoneyXmlContentHandler::writeCostCenter(const MyMoneyCostCenter &costCent
 
 
 
+MyMoneyXmlStreamReader::MyMoneyXmlStreamReader(MyMoneyStorageXML* reader) :
+    m_reader(reader),
+    m_elementCount(0)
+{
+}
+
+QString MyMoneyXmlStreamReader::errorString() const
+{
+    return m_errMsg;
+}
+
+bool MyMoneyXmlStreamReader::read(QIODevice* device)
+{
+    m_xml.setDevice(device);
+
+    while (!m_xml.atEnd()) {
+        switch (m_xml.readNext()) {
+        case QXmlStreamReader::StartElement:
+            if (!readStartElement())
+                return false;
+            break;
+        case QXmlStreamReader::EndElement:
+            m_reader->d->loadCollectedObjects(m_reader->m_file, m_xml.name().toString().toUpper());
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (m_xml.hasError()) {
+        m_errMsg = i18n("%1 in line %2", m_xml.errorString(), m_xml.lineNumber());
+        qWarning() << m_errMsg;
+        return false;
+    }
+    return true;
+}
+
+bool MyMoneyXmlStreamReader::readStartElement()
+{
+    auto rc = true;
+    const auto s = m_xml.name().toString().toUpper();
+    const auto d = m_reader->d;
+    const auto count = [&]() {
+        return m_xml.attributes().value(attributeName(Attribute::General::Count)).toInt();
+    };
+
+    try {
+        if (s == nodeName(Node::Transaction)) {
+            auto t0 = readTransaction(m_xml);
+            if (!t0.id().isEmpty()) {
+                MyMoneyTransaction t1(d->nextTransactionID(), t0);
+                d->tList[t1.uniqueSortKey()] = t1;
+            }
+            m_reader->signalProgress(++m_elementCount, 0);
+        } else if (s == nodeName(Node::Account)) {
+            const auto line = m_xml.lineNumber();
+            auto a = readAccount(m_xml);
+            if (!m_reader->m_file->hasValidId(a)) {
+                throw MYMONEYEXCEPTION(i18n("ID '%1' is invalid in line %2.").arg(a.id()).arg(line));
+            }
+            if (!a.id().isEmpty())
+                d->aList[a.id()] = a;
+            m_reader->signalProgress(++m_elementCount, 0);
+        } else if (s == nodeName(Node::Tag)) {
+            auto ta = readTag(m_xml);
+            if (!ta.id().isEmpty())
+                d->taList[ta.id()] = ta;
+            m_reader->signalProgress(++m_elementCount, 0);
+        } else if (s == nodeName(Node::Currency) || s == nodeName(Node::Security)) {
+            auto sec = readSecurity(m_xml);
+            if (!sec.id().isEmpty())
+                d->secList[sec.id()] = sec;
+            m_reader->signalProgress(++m_elementCount, 0);
+        } else if (s == nodeName(Node::Price)) {
+            auto p = readPrice(m_xml, d->m_fromSecurity, d->m_toSecurity);
+            d->prList[MyMoneySecurityPair(d->m_fromSecurity, d->m_toSecurity)][p.date()] = p;
+            m_reader->signalProgress(++m_elementCount, 0);
+        } else if (s == nodeName(Node::KeyValuePairs)) {
+            MyMoneyKeyValueContainer container;
+            readKeyValueContainer(m_xml, container);
+            d->loadParameters(m_reader->m_file, container);
+
+        } else if (s == nodeName(Node::Payee)
+                   || s == nodeName(Node::CostCenter)
+                   || s == nodeName(Node::Institution)
+                   || s == nodeName(Node::Report)
+                   || s == nodeName(Node::Budget)
+                   || s == tagName(Tag::FileInfo)
+                   || s == tagName(Tag::User)
+                   || s == nodeName(Node::ScheduleTX)
+                   || s == nodeName(Node::OnlineJob)) {
+            // these are rare or depend on plugins that read
+            // from a QDomElement, so we create one just for them
+            const auto line = m_xml.lineNumber();
+            QDomDocument document;
+            const auto node = readDomElement(m_xml, document);
+
+            if (s == nodeName(Node::Payee)) {
+                auto p = MyMoneyXmlContentHandler::readPayee(node);
+                if (!m_reader->m_file->hasValidId(p)) {
+                    throw MYMONEYEXCEPTION(i18n("ID '%1' is invalid in line %2.").arg(p.id()).arg(line));
+                }
+                if (!p.id().isEmpty())
+                    d->pList[p.id()] = p;
+                m_reader->signalProgress(++m_elementCount, 0);
+            } else if (s == nodeName(Node::CostCenter)) {
+                auto c = MyMoneyXmlContentHandler::readCostCenter(node);
+                if (!c.id().isEmpty())
+                    d->ccList[c.id()] = c;
+                m_reader->signalProgress(++m_elementCount, 0);
+            } else if (s == nodeName(Node::Institution)) {
+                auto i = MyMoneyXmlContentHandler::readInstitution(node);
+                if (!i.id().isEmpty())
+                    d->iList[i.id()] = i;
+            } else if (s == nodeName(Node::Report)) {
+                auto r = MyMoneyXmlContentHandler2::readReport(node);
+                if (!r.id().isEmpty())
+                    d->rList[r.id()] = r;
+                m_reader->signalProgress(++m_elementCount, 0);
+            } else if (s == nodeName(Node::Budget)) {
+                auto b = MyMoneyXmlContentHandler2::readBudget(node);
+                if (!b.id().isEmpty())
+                    d->bList[b.id()] = b;
+            } else if (s == tagName(Tag::FileInfo)) {
+                rc = m_reader->readFileInformation(node);
+                m_reader->signalProgress(-1, -1);
+            } else if (s == tagName(Tag::User)) {
+                rc = m_reader->readUserInformation(node);
+                m_reader->signalProgress(-1, -1);
+            } else if (s == nodeName(Node::ScheduleTX)) {
+                auto sch = MyMoneyXmlContentHandler::readSchedule(node);
+                if (!sch.id().isEmpty())
+                    d->sList[sch.id()] = sch;
+            } else if (s == nodeName(Node::OnlineJob)) {
+                auto job = MyMoneyXmlContentHandler::readOnlineJob(node);
+                if (!job.id().isEmpty())
+                    d->onlineJobList[job.id()] = job;
+            }
+
+        } else if (s == tagName(Tag::Transactions)) {
+            m_reader->signalProgress(0, count(), i18n("Loading transactions..."));
+            m_elementCount = 0;
+        } else if (s == tagName(Tag::Accounts)) {
+            m_reader->signalProgress(0, count(), i18n("Loading accounts..."));
+            m_elementCount = 0;
+        } else if (s == tagName(Tag::Securities)) {
+            m_reader->signalProgress(0, count(), i18n("Loading securities..."));
+            m_elementCount = 0;
+        } else if (s == tagName(Tag::Currencies)) {
+            m_reader->signalProgress(0, count(), i18n("Loading currencies..."));
+            m_elementCount = 0;
+        } else if (s == tagName(Tag::Reports)) {
+            m_reader->signalProgress(0, count(), i18n("Loading reports..."));
+            m_elementCount = 0;
+        } else if (s == tagName(Tag::Prices)) {
+            m_reader->signalProgress(0, count(), i18n("Loading prices..."));
+            m_elementCount = 0;
+        } else if (s == nodeName(Node::PricePair)) {
+            const auto attributes = m_xml.attributes();
+            d->m_fromSecurity = attributes.value(attributeName(Attribute::General::From)).toString();
+            d->m_toSecurity = attributes.value(attributeName(Attribute::General::To)).toString();
+        } else if (s == tagName(Tag::CostCenters)) {
+            m_reader->signalProgress(0, count(), i18n("Loading cost center..."));
+            m_elementCount = 0;
+        }
+    } catch (const MyMoneyException &e) {
+        m_errMsg = i18n("Exception while reading %1 element: %2", s, e.what());
+        qWarning() << m_errMsg;
+        rc = false;
+    }
+    return rc;
+}
+
+QDomElement MyMoneyXmlStreamReader::readDomElement(QXmlStreamReader& xml, QDomDocument& document)
+{
+    auto el = document.createElement(xml.qualifiedName().toString());
+    const auto attributes = xml.attributes();
+    for (const auto& attribute : attributes) {
+        el.setAttribute(attribute.qualifiedName().toString(), attribute.value().toString());
+    }
+    // like MyMoneyXmlContentHandler we only keep elements and their attributes
+    while (xml.readNextStartElement()) {
+        el.appendChild(readDomElement(xml, document));
+    }
+    return el;
+}
+
+void MyMoneyXmlStreamReader::readKeyValueContainer(QXmlStreamReader& xml, MyMoneyKeyValueContainer& container)
+{
+    if (xml.name() != nodeName(Node::KeyValuePairs))
+        throw MYMONEYEXCEPTION_CSTRING("Node was not KEYVALUEPAIRS");
+
+    static const auto pairTag = elementName(Element::KVP::Pair);
+    static const auto keyAttribute = attributeName(Attribute::KVP::Key);
+    static const auto valueAttribute = attributeName(Attribute::KVP::Value);
+
+    readDescendants(xml, [&](QXmlStreamReader& r) {
+        if (r.name() == pairTag) {
+            const auto attributes = r.attributes();
+            container.setValue(attributes.value(keyAttribute).toString(), attributes.value(valueAttribute).toString());
+        }
+        return false;
+    });
+}
+
+MyMoneyTransaction MyMoneyXmlStreamReader::readTransaction(QXmlStreamReader& xml, bool assignEntryDateIfEmpty)
+{
+    static const auto transactionTag = nodeName(Node::Transaction);
+    static const auto splitsTag = elementName(Element::Transaction::Splits);
+    static const auto splitTag = elementName(Element::Transaction::Split);
+    static const auto kvpTag = nodeName(Node::KeyValuePairs);
+
+    if (xml.name() != transactionTag)
+        throw MYMONEYEXCEPTION_CSTRING("Node was not TRANSACTION");
+
+    const auto attributes = xml.attributes();
+    const auto attribute = [&](Attribute::Transaction id) {
+        return attributes.value(attributeName(id)).toString();
+    };
+
+    MyMoneyTransaction transaction(attributes.value(attributeName(Attribute::Account::ID)).toString());
+
+    transaction.setPostDate(QDate::fromString(attribute(Attribute::Transaction::PostDate), Qt::ISODate));
+    auto entryDate = QDate::fromString(attribute(Attribute::Transaction::EntryDate), Qt::ISODate);
+    if (!entryDate.isValid() && assignEntryDateIfEmpty)
+        entryDate = QDate::currentDate();
+    transaction.setEntryDate(entryDate);
+    transaction.setBankID(attribute(Attribute::Transaction::BankID));
+    transaction.setMemo(attribute(Attribute::Transaction::Memo));
+    transaction.setCommodity(attribute(Attribute::Transaction::Commodity));
+
+    while (xml.readNextStartElement()) {
+        if (xml.name() == splitsTag) {
+            // Process any split information found inside the transaction entry.
+            readDescendants(xml, [&](QXmlStreamReader& r) {
+                if (r.name() != splitTag)
+                    return false;
+
+                auto s = readSplit(r);
+                if (!transaction.bankID().isEmpty())
+                    s.setBankID(transaction.bankID());
+                if (!s.accountId().isEmpty())
+                    transaction.addSplit(s);
+                else
+                    qDebug("Dropped split because it did not have an account id");
+                return true;
+            });
+
+        } else if (xml.name() == kvpTag) {
+            readKeyValueContainer(xml, transaction);
+
+        } else {
+            xml.skipCurrentElement();
+        }
+    }
+    transaction.setBankID(QString());
+
+    return transaction;
+}
+
+MyMoneySplit MyMoneyXmlStreamReader::readSplit(QXmlStreamReader& xml)
+{
+    static const auto splitTag = nodeName(Node::Split);
+    static const auto tagTag = elementName(Element::Split::Tag);
+    static const auto kvpTag = nodeName(Node::KeyValuePairs);
+
+    if (xml.name() != splitTag)
+        throw MYMONEYEXCEPTION_CSTRING("Node was not SPLIT");
+
+    const auto attributes = xml.attributes();
+    const auto attribute = [&](Attribute::Split id) {
+        return attributes.value(attributeName(id)).toString();
+    };
+
+    MyMoneySplit split;
+
+    QList<QString> tagList;
+    auto kvpFound = false;
+    readDescendants(xml, [&](QXmlStreamReader& r) {
+        if (!kvpFound && r.name() == kvpTag) {
+            kvpFound = true;
+            readKeyValueContainer(r, split);
+            return true;
+        }
+        if (r.name() == tagTag)
+            tagList << r.attributes().value(attributeName(Attribute::Split::ID)).toString();
+        return false;
+    });
+
+    split.setPayeeId(attribute(Attribute::Split::Payee));
+    split.setTagIdList(tagList);
+    split.setReconcileDate(QDate::fromString(attribute(Attribute::Split::ReconcileDate), Qt::ISODate));
+    split.setAction(attribute(Attribute::Split::Action));
+    split.setReconcileFlag(static_cast<eMyMoney::Split::State>(attribute(Attribute::Split::ReconcileFlag).toInt()));
+    split.setMemo(attribute(Attribute::Split::Memo));
+    split.setValue(MyMoneyMoney(attribute(Attribute::Split::Value)));
+    split.setShares(MyMoneyMoney(attribute(Attribute::Split::Shares)));
+    split.setPrice(MyMoneyMoney(attribute(Attribute::Split::Price)));
+    split.setAccountId(attribute(Attribute::Split::Account));
+    split.setCostCenterId(attribute(Attribute::Split::CostCenter));
+    split.setNumber(attribute(Attribute::Split::Number));
+    split.setBankID(attribute(Attribute::Split::BankID));
+
+    auto matchXml = split.value(attributeName(Attribute::Split::KMMatchedTx));
+    if (!matchXml.isEmpty()) {
+        // determine between the new and old method to escap the less than symbol
+        if (matchXml.contains(QLatin1String("&#60;"))) {
+            matchXml.replace(QLatin1String("&#60;"), QLatin1String("<"));
+        } else {
+            matchXml.replace(QLatin1String("&lt;"), QLatin1String("<"));
+        }
+        // skip the container and position on the matched transaction
+        QXmlStreamReader matchReader(matchXml);
+        matchReader.readNextStartElement();
+        matchReader.readNextStartElement();
+        split.addMatch(readTransaction(matchReader));
+    }
+
+    return split;
+}
+
+MyMoneyAccount MyMoneyXmlStreamReader::readAccount(QXmlStreamReader& xml)
+{
+    if (xml.name() != nodeName(Node::Account))
+        throw MYMONEYEXCEPTION_CSTRING("Node was not ACCOUNT");
+
+    const auto attributes = xml.attributes();
+    const auto attribute = [&](Attribute::Account id) {
+        return attributes.value(attributeName(id)).toString();
+    };
+
+    MyMoneyAccount acc(attribute(Attribute::Account::ID));
+
+    QStringList subAccountIds;
+    MyMoneyKeyValueContainer onlineBankingSettings;
+    auto kvpFound = false;
+    auto subAccountsFound = false;
+    auto onlineBankingFound = false;
+    readDescendants(xml, [&](QXmlStreamReader& r) {
+        if (!kvpFound && r.name() == nodeName(Node::KeyValuePairs)) {
+            kvpFound = true;
+            readKeyValueContainer(r, acc);
+            return true;
+        }
+        if (!subAccountsFound && r.name() == elementName(Element::Account::SubAccounts)) {
+            subAccountsFound = true;
+            readDescendants(r, [&](QXmlStreamReader& sub) {
+                if (sub.name() == elementName(Element::Account::SubAccount))
+                    subAccountIds.append(sub.attributes().value(attributeName(Attribute::Account::ID)).toString());
+                return false;
+            });
+            return true;
+        }
+        if (!onlineBankingFound && r.name() == elementName(Element::Account::OnlineBanking)) {
+            onlineBankingFound = true;
+            const auto settings = r.attributes();
+            for (const auto& setting : settings) {
+                onlineBankingSettings.setValue(setting.qualifiedName().toString(), setting.value().toString());
+            }
+        }
+        return false;
+    });
+
+    acc.setName(attribute(Attribute::Account::Name));
+    acc.setParentAccountId(attribute(Attribute::Account::ParentAccount));
+    acc.setLastModified(QDate::fromString(attribute(Attribute::Account::LastModified), Qt::ISODate));
+    acc.setLastReconciliationDate(QDate::fromString(attribute(Attribute::Account::LastReconciled), Qt::ISODate));
+
+    // see MyMoneyXmlContentHandler::readAccount() for the
+    // reasoning behind the following fixups of old data
+    acc.deletePair(QStringLiteral("lastStatementDate"));
+
+    acc.setInstitutionId(attribute(Attribute::Account::Institution));
+    acc.setNumber(attribute(Attribute::Account::Number));
+    acc.setOpeningDate(QDate::fromString(attribute(Attribute::Account::Opened), Qt::ISODate));
+    acc.setCurrencyId(attribute(Attribute::Account::Currency));
+
+    auto bOK = false;
+    auto type = attribute(Attribute::Account::Type).toInt(&bOK);
+    if (bOK) {
+        acc.setAccountType(static_cast<Account::Type>(type));
+    } else {
+        qWarning("XMLREADER: Account %s had invalid or no account type information.", qPrintable(acc.name()));
+    }
+
+    const auto openingBalance = attribute(Attribute::Account::OpeningBalance);
+    if (!openingBalance.isEmpty())
+        if (!MyMoneyMoney(openingBalance).isZero())
+            throw MYMONEYEXCEPTION(QString::fromLatin1("Account %1 contains an opening balance. Please use KMyMoney version 0.8 or later and earlier than version 0.9 to correct the problem.").arg(acc.name()));
+
+    acc.setDescription(attribute(Attribute::Account::Description));
+
+    acc.removeAccountIds();
+    for (const auto& accountId : qAsConst(subAccountIds))
+        acc.addAccountId(accountId);
+
+    if (onlineBankingFound) {
+        if (onlineBankingSettings.value(QStringLiteral("provider")).toLower().compare(QLatin1String("kmymoney ofx")) == 0) {
+            onlineBankingSettings.setValue(QStringLiteral("provider"), QStringLiteral("ofximporter"));
+        }
+        acc.setOnlineBankingSettings(onlineBankingSettings);
+    }
+
+    if (!acc.value("IBAN").isEmpty()) {
+        if (acc.value(attributeName(Attribute::Account::IBAN)).isEmpty())
+            acc.setValue(attributeName(Attribute::Account::IBAN), acc.value("IBAN"));
+        acc.deletePair("IBAN");
+    }
+    return acc;
+}
+
+MyMoneySecurity MyMoneyXmlStreamReader::readSecurity(QXmlStreamReader& xml)
+{
+    const auto tag = xml.name();
+    if ((nodeName(Node::Security) != tag)
+            && (nodeName(Node::Equity) != tag)
+            && (nodeName(Node::Currency) != tag))
+        throw MYMONEYEXCEPTION_CSTRING("Node was not SECURITY or CURRENCY");
+
+    const auto attributes = xml.attributes();
+    const auto attribute = [&](Attribute::Security id) {
+        return attributes.value(attributeName(id)).toString();
+    };
+
+    MyMoneySecurity security(attributes.value(attributeName(Attribute::Account::ID)).toString());
+
+    auto kvpFound = false;
+    readDescendants(xml, [&](QXmlStreamReader& r) {
+        if (!kvpFound && r.name() == nodeName(Node::KeyValuePairs)) {
+            kvpFound = true;
+            readKeyValueContainer(r, security);
+            return true;
+        }
+        return false;
+    });
+
+    security.setName(attribute(Attribute::Security::Name));
+    security.setTradingSymbol(attribute(Attribute::Security::Symbol));
+    security.setSecurityType(static_cast<eMyMoney::Security::Type>(attribute(Attribute::Security::Type).toInt()));
+    security.setRoundingMethod(static_cast<AlkValue::RoundingMethod>(attribute(Attribute::Security::RoundingMethod).toInt()));
+    security.setSmallestAccountFraction(attribute(Attribute::Security::SAF).toUInt());
+    security.setPricePrecision(attribute(Attribute::Security::PP).toUInt());
+
+    if (security.smallestAccountFraction() == 0)
+        security.setSmallestAccountFraction(100);
+    if (security.pricePrecision() == 0 || security.pricePrecision() > 10)
+        security.setPricePrecision(4);
+
+    if (security.isCurrency()) {
+        security.setSmallestCashFraction(attribute(Attribute::Security::SCF).toUInt());
+        if (security.smallestCashFraction() == 0)
+            security.setSmallestCashFraction(100);
+    } else {
+        security.setTradingCurrency(attribute(Attribute::Security::TradingCurrency));
+        security.setTradingMarket(attribute(Attribute::Security::TradingMarket));
+    }
+
+    return security;
+}
+
+MyMoneyTag MyMoneyXmlStreamReader::readTag(QXmlStreamReader& xml)
+{
+    if (xml.name() != nodeName(Node::Tag))
+        throw MYMONEYEXCEPTION_CSTRING("Node was not TAG");
+
+    const auto attributes = xml.attributes();
+    MyMoneyTag tag(attributes.value(attributeName(Attribute::Account::ID)).toString());
+
+    tag.setName(attributes.value(attributeName(Attribute::Tag::Name)).toString());
+    if (attributes.hasAttribute(attributeName(Attribute::Tag::TagColor))) {
+        tag.setTagColor(attributes.value(attributeName(Attribute::Tag::TagColor)).toString());
+    }
+    if (attributes.hasAttribute(attributeName(Attribute::Tag::Notes))) {
+        tag.setNotes(attributes.value(attributeName(Attribute::Tag::Notes)).toString());
+    }
+    tag.setClosed(attributes.value(attributeName(Attribute::Tag::Closed)).toUInt());
+
+    xml.skipCurrentElement();
+    return tag;
+}
+
+MyMoneyPrice MyMoneyXmlStreamReader::readPrice(QXmlStreamReader& xml, const QString& from, const QString& to)
+{
+    if (xml.name() != nodeName(Node::Price))
+        throw MYMONEYEXCEPTION_CSTRING("Node was not PRICE");
+
+    const auto attributes = xml.attributes();
+    const MyMoneyPrice price(from, to,
+                             QDate::fromString(attributes.value(attributeName(Attribute::General::Date)).toString(), Qt::ISODate),
+                             MyMoneyMoney(attributes.value(attributeName(Attribute::General::Price)).toString()),
+                             attributes.value(attributeName(Attribute::General::Source)).toString());
+
+    xml.skipCurrentElement();
+    return price;
+}
+
 MyMoneyStorageXML::MyMoneyStorageXML() :
     m_progressCallback(nullptr),
     m_doc(nullptr),
@@ -1417,21 +2097,12 @@ void MyMoneyStorageXML::readFile(QIODevice* pDevice, MyMoneyFile* file)
 
     m_file = file;
 
-    qDebug("reading file");
-    // creating the QXmlInputSource object based on a QIODevice object
-    // reads all data of the underlying object into memory. I have not
-    // found an object that reads on the fly. I tried to derive one myself,
-    // but there could be a severe problem with decoding when reading
-    // blocks of data and not a stream. So I left it the way it is. (ipwizard)
-    QXmlInputSource xml(pDevice);
-
     qDebug("start parsing file");
-    MyMoneyXmlContentHandler mmxml(this);
-    QXmlSimpleReader reader;
-    reader.setContentHandler(&mmxml);
-
-    if (!reader.parse(&xml, false)) {
-        throw MYMONEYEXCEPTION(i18n("File was not parsable. Reason: %1").arg(mmxml.errorString()));
+    // the stream reader processes the data on the fly and does
+    // not keep more than the object currently read in memory
+    MyMoneyXmlStreamReader reader(this);
+    if (!reader.read(pDevice)) {
+        throw MYMONEYEXCEPTION(i18n("File was not parsable. Reason: %1").arg(reader.errorString()));
     }
     qDebug("done parsing file");
 
@@ -1446,13 +2117,35 @@ void MyMoneyStorageXML::readFile(QIODevice* pDevice, MyMoneyFile* file)
     signalProgress(-1, -1);
 }
 
-bool saveNodeCanonically(QXmlStreamWriter &stream, const QDomNode &domNode)
+void writeStartElementCanonically(QXmlStreamWriter &stream, const QDomElement &domElement)
 {
     // [#x1-#x8], [#xB-#xC], [#xE-#x1F], [#x7F-#x84], [#x86-#x9F], [#xFDD0-#xFDDF]
     // taken from https://www.w3.org/TR/xml11/#charsets
-    QRegularExpression removeInvaldCharsExpr(
+    static const QRegularExpression removeInvaldCharsExpr(
         QStringLiteral("[\\x{00}-\\x{08}]|[\\x{0B}-\\x{0C}]|[\\x{0E}-\\x{1F}]|[\\x{7F}-\\x{84}]|[\\x{86}-\\x{9F}]|[\\x{FDD0}-\\x{FDDF}]|"));
 
+    stream.writeStartElement(domElement.tagName());
+
+    if (domElement.hasAttributes()) {
+        QMap<QString, QString> attributes;
+        const QDomNamedNodeMap attributeMap = domElement.attributes();
+        for (int i = 0; i < attributeMap.count(); ++i)
+        {
+            const QDomNode attribute = attributeMap.item(i);
+            attributes.insert(attribute.nodeName(), attribute.nodeValue().remove(removeInvaldCharsExpr));
+        }
+
+        QMap<QString, QString>::const_iterator i = attributes.constBegin();
+        while (i != attributes.constEnd())
+        {
+            stream.writeAttribute(i.key(), i.value());
+            ++i;
+        }
+    }
+}
+
+bool saveNodeCanonically(QXmlStreamWriter &stream, const QDomNode &domNode)
+{
     if (stream.hasError()) {
         return false;
     }
@@ -1460,24 +2153,7 @@ bool saveNodeCanonically(QXmlStreamWriter &stream, const QDomNode &domNode)
     if (domNode.isElement()) {
       const QDomElement domElement = domNode.toElement();
       if (!domElement.isNull()) {
-          stream.writeStartElement(domElement.tagName());
-
-          if (domElement.hasAttributes()) {
-              QMap<QString, QString> attributes;
-              const QDomNamedNodeMap attributeMap = domElement.attributes();
-              for (int i = 0; i < attributeMap.count(); ++i)
-              {
-                  const QDomNode attribute = attributeMap.item(i);
-                  attributes.insert(attribute.nodeName(), attribute.nodeValue().remove(removeInvaldCharsExpr));
-              }
-
-              QMap<QString, QString>::const_iterator i = attributes.constBegin();
-              while (i != attributes.constEnd())
-              {
-                  stream.writeAttribute(i.key(), i.value());
-                  ++i;
-              }
-          }
+          writeStartElementCanonically(stream, domElement);
 
           if (domElement.hasChildNodes()) {
               QDomNode elementChild = domElement.firstChild();
@@ -1499,13 +2175,18 @@ bool saveNodeCanonically(QXmlStreamWriter &stream, const QDomNode &domNode)
     return true;
 }
 
-bool saveCanonicalXML(const QDomNode &doc, QIODevice *file, int indent)
+void startCanonicalXML(QXmlStreamWriter &stream, int indent)
 {
-    QXmlStreamWriter stream(file);
     stream.setAutoFormatting(true);
     stream.setAutoFormattingIndent(indent);
     stream.writeStartDocument();
     stream.writeDTD(QString("<!DOCTYPE %1>").arg(tagName(Tag::KMMFile)));
+}
+
+bool saveCanonicalXML(const QDomNode &doc, QIODevice *file, int indent)
+{
+    QXmlStreamWriter stream(file);
+    startCanonicalXML(stream, indent);
 
     QDomNode root = doc;
     while (!root.isNull())
@@ -1519,6 +2200,11 @@ bool saveCanonicalXML(const QDomNode &doc, QIODevice *file, int indent)
 }
 
 void MyMoneyStorageXML::writeFile(QIODevice* qf, MyMoneyFile* file)
+{
+    writeDocument(qf, file, true);
+}
+
+void MyMoneyStorageXML::writeDocument(QIODevice* qf, MyMoneyFile* file, bool streaming)
 {
     Q_CHECK_PTR(qf);
 
@@ -1529,6 +2215,22 @@ void MyMoneyStorageXML::writeFile(QIODevice* qf, MyMoneyFile* file)
     Q_CHECK_PTR(m_doc);
     ScopeHelper<QDomDocument> helper(&m_doc);
 
+    // In streaming mode each object is written to the stream as soon as
+    // its element is complete and removed from m_doc afterwards. This way
+    // the document never contains more than a single object.
+    QXmlStreamWriter stream(qf);
+    struct StreamGuard {
+        ~StreamGuard() {
+            m_d->m_stream = nullptr;
+            m_d->m_openElements.clear();
+        }
+        Private* m_d;
+    } guard { d };
+    if (streaming) {
+        startCanonicalXML(stream, 1);
+        d->m_stream = &stream;
+    }
+
     /// @note add new models here
 
     QDomProcessingInstruction instruct = m_doc->createProcessingInstruction("xml", "version=\"1.0\" encoding=\"utf-8\"");
@@ -1539,68 +2241,74 @@ void MyMoneyStorageXML::writeFile(QIODevice* qf, MyMoneyFile* file)
 
     QDomElement fileInfo = m_doc->createElement(tagName(Tag::FileInfo));
     writeFileInformation(fileInfo);
-    mainElement.appendChild(fileInfo);
+    d->appendSection(mainElement, fileInfo);
 
     QDomElement userInfo = m_doc->createElement(tagName(Tag::User));
     writeUserInformation(userInfo);
-    mainElement.appendChild(userInfo);
+    d->appendSection(mainElement, userInfo);
 
     QDomElement institutions = m_doc->createElement(tagName(Tag::Institutions));
     writeInstitutions(institutions);
-    mainElement.appendChild(institutions);
+    d->appendSection(mainElement, institutions);
 
     QDomElement payees = m_doc->createElement(tagName(Tag::Payees));
     writePayees(payees);
-    mainElement.appendChild(payees);
+    d->appendSection(mainElement, payees);
 
     QDomElement costCenters = m_doc->createElement(tagName(Tag::CostCenters));
     writeCostCenters(costCenters);
-    mainElement.appendChild(costCenters);
+    d->appendSection(mainElement, costCenters);
 
     QDomElement tags = m_doc->createElement(tagName(Tag::Tags));
     writeTags(tags);
-    mainElement.appendChild(tags);
+    d->appendSection(mainElement, tags);
 
     QDomElement accounts = m_doc->createElement(tagName(Tag::Accounts));
     writeAccounts(accounts);
-    mainElement.appendChild(accounts);
+    d->appendSection(mainElement, accounts);
 
     QDomElement transactions = m_doc->createElement(tagName(Tag::Transactions));
     writeTransactions(transactions);
-    mainElement.appendChild(transactions);
+    d->appendSection(mainElement, transactions);
 
     QDomElement keyvalpairs = writeKeyValuePairs(m_file->parametersModel()->pairs());
-    mainElement.appendChild(keyvalpairs);
+    d->appendSection(mainElement, keyvalpairs);
 
     QDomElement schedules = m_doc->createElement(tagName(Tag::Schedules));
     writeSchedules(schedules);
-    mainElement.appendChild(schedules);
+    d->appendSection(mainElement, schedules);
 
     QDomElement equities = m_doc->createElement(tagName(Tag::Securities));
     writeSecurities(equities);
-    mainElement.appendChild(equities);
+    d->appendSection(mainElement, equities);
 
     QDomElement currencies = m_doc->createElement(tagName(Tag::Currencies));
     writeCurrencies(currencies);
-    mainElement.appendChild(currencies);
+    d->appendSection(mainElement, currencies);
 
     QDomElement prices = m_doc->createElement(tagName(Tag::Prices));
     writePrices(prices);
-    mainElement.appendChild(prices);
+    d->appendSection(mainElement, prices);
 
     QDomElement reports = m_doc->createElement(tagName(Tag::Reports));
     writeReports(reports);
-    mainElement.appendChild(reports);
+    d->appendSection(mainElement, reports);
 
     QDomElement budgets = m_doc->createElement(tagName(Tag::Budgets));
     writeBudgets(budgets);
-    mainElement.appendChild(budgets);
+    d->appendSection(mainElement, budgets);
 
     QDomElement onlineJobs = m_doc->createElement(tagName(Tag::OnlineJobs));
     writeOnlineJobs(onlineJobs);
-    mainElement.appendChild(onlineJobs);
+    d->appendSection(mainElement, onlineJobs);
 
-    saveCanonicalXML(m_doc->documentElement(), qf, 1);
+    if (streaming) {
+        d->flushChildren(mainElement);
+        stream.writeEndElement();
+        stream.writeEndDocument();
+    } else {
+        saveCanonicalXML(m_doc->documentElement(), qf, 1);
+    }
 
     //hides the progress bar.
     signalProgress(-1, -1);
@@ -1730,9 +2438,7 @@ bool MyMoneyStorageXML::readUserInformation(const QDomElement& userElement)
 
 void MyMoneyStorageXML::writeInstitutions(QDomElement& parent)
 {
-    InstitutionsModel::xmlWriter writer(&MyMoneyXmlContentHandler::writeInstitution, *m_doc, parent);
-    const auto count = m_file->institutionsModel()->processItems(&writer);
-    parent.setAttribute(attributeName(Attribute::General::Count), count);
+    d->writeItems(m_file->institutionsModel(), &MyMoneyXmlContentHandler::writeInstitution, *m_doc, parent);
 }
 
 void MyMoneyStorageXML::writeInstitution(QDomElement& institution, const MyMoneyInstitution& i)
@@ -1742,9 +2448,7 @@ void MyMoneyStorageXML::writeInstitution(QDomElement& institution, const MyMoney
 
 void MyMoneyStorageXML::writePayees(QDomElement& parent)
 {
-    PayeesModel::xmlWriter writer(&MyMoneyXmlContentHandler::writePayee, *m_doc, parent);
-    const auto count = m_file->payeesModel()->processItems(&writer);
-    parent.setAttribute(attributeName(Attribute::General::Count), count);
+    d->writeItems(m_file->payeesModel(), &MyMoneyXmlContentHandler::writePayee, *m_doc, parent);
 }
 
 void MyMoneyStorageXML::writePayee(QDomElement& payee, const MyMoneyPayee& p)
@@ -1754,9 +2458,7 @@ void MyMoneyStorageXML::writePayee(QDomElement& payee, const MyMoneyPayee& p)
 
 void MyMoneyStorageXML::writeTags(QDomElement& parent)
 {
-    TagsModel::xmlWriter writer(&MyMoneyXmlContentHandler::writeTag, *m_doc, parent);
-    const auto count = m_file->tagsModel()->processItems(&writer);
-    parent.setAttribute(attributeName(Attribute::General::Count), count);
+    d->writeItems(m_file->tagsModel(), &MyMoneyXmlContentHandler::writeTag, *m_doc, parent);
 }
 
 void MyMoneyStorageXML::writeTag(QDomElement& tag, const MyMoneyTag& ta)
@@ -1784,8 +2486,11 @@ void MyMoneyStorageXML::writeAccounts(QDomElement& accounts)
     } );
 #endif
 
+    d->flushChildren(accounts);
+
     for (it = list.constBegin(); it != list.constEnd(); ++it) {
         writeAccount(accounts, *it);
+        d->flushChildren(accounts);
     }
 }
 
@@ -1815,6 +2520,7 @@ void MyMoneyStorageXML::writeTransactions(QDomElement& transactions)
 
     for (auto it = list.constBegin(); it != list.constEnd(); ++it) {
         writeTransaction(transactions, *it);
+        d->flushChildren(transactions);
     }
 }
 
@@ -1835,10 +2541,12 @@ void MyMoneyStorageXML::writeSchedules(QDomElement& parent)
     } );
 #endif
 
+    parent.setAttribute(attributeName(Attribute::General::Count), list.count());
+
     for (auto it = list.constBegin(); it != list.constEnd(); ++it) {
         writeSchedule(parent, *it);
+        d->flushChildren(parent);
     }
-    parent.setAttribute(attributeName(Attribute::General::Count), list.count());
 }
 
 void MyMoneyStorageXML::writeSchedule(QDomElement& scheduledTx, const MyMoneySchedule& tx)
@@ -1848,9 +2556,7 @@ void MyMoneyStorageXML::writeSchedule(QDomElement& scheduledTx, const MyMoneySch
 
 void MyMoneyStorageXML::writeSecurities(QDomElement& parent)
 {
-    SecuritiesModel::xmlWriter writer(&MyMoneyXmlContentHandler::writeSecurity, *m_doc, parent);
-    const auto count = m_file->securitiesModel()->processItems(&writer);
-    parent.setAttribute(attributeName(Attribute::General::Count), count);
+    d->writeItems(m_file->securitiesModel(), &MyMoneyXmlContentHandler::writeSecurity, *m_doc, parent);
 }
 
 void MyMoneyStorageXML::writeSecurity(QDomElement& securityElement, const MyMoneySecurity& security)
@@ -1860,16 +2566,12 @@ void MyMoneyStorageXML::writeSecurity(QDomElement& securityElement, const MyMone
 
 void MyMoneyStorageXML::writeCurrencies(QDomElement& parent)
 {
-    SecuritiesModel::xmlWriter writer(&MyMoneyXmlContentHandler::writeSecurity, *m_doc, parent);
-    const auto count = m_file->currenciesModel()->processItems(&writer);
-    parent.setAttribute(attributeName(Attribute::General::Count), count);
+    d->writeItems(m_file->currenciesModel(), &MyMoneyXmlContentHandler::writeSecurity, *m_doc, parent);
 }
 
 void MyMoneyStorageXML::writeReports(QDomElement& parent)
 {
-    ReportsModel::xmlWriter writer(&MyMoneyXmlContentHandler2::writeReport, *m_doc, parent);
-    const auto count = m_file->reportsModel()->processItems(&writer);
-    parent.setAttribute(attributeName(Attribute::General::Count), count);
+    d->writeItems(m_file->reportsModel(), &MyMoneyXmlContentHandler2::writeReport, *m_doc, parent);
 }
 
 void MyMoneyStorageXML::writeReport(QDomElement& report, const MyMoneyReport& r)
@@ -1879,9 +2581,7 @@ void MyMoneyStorageXML::writeReport(QDomElement& report, const MyMoneyReport& r)
 
 void MyMoneyStorageXML::writeBudgets(QDomElement& parent)
 {
-    BudgetsModel::xmlWriter writer(&MyMoneyXmlContentHandler2::writeBudget, *m_doc, parent);
-    const auto count = m_file->budgetsModel()->processItems(&writer);
-    parent.setAttribute(attributeName(Attribute::General::Count), count);
+    d->writeItems(m_file->budgetsModel(), &MyMoneyXmlContentHandler2::writeBudget, *m_doc, parent);
 }
 
 void MyMoneyStorageXML::writeBudget(QDomElement& budget, const MyMoneyBudget& b)
@@ -1891,9 +2591,7 @@ void MyMoneyStorageXML::writeBudget(QDomElement& budget, const MyMoneyBudget& b)
 
 void MyMoneyStorageXML::writeOnlineJobs(QDomElement& parent)
 {
-    OnlineJobsModel::xmlWriter writer(&MyMoneyXmlContentHandler::writeOnlineJob, *m_doc, parent);
-    const auto count = m_file->onlineJobsModel()->processItems(&writer);
-    parent.setAttribute(attributeName(Attribute::General::Count), count);
+    d->writeItems(m_file->onlineJobsModel(), &MyMoneyXmlContentHandler::writeOnlineJob, *m_doc, parent);
 }
 
 void MyMoneyStorageXML::writeOnlineJob(QDomElement& onlineJobs, const onlineJob& job)
@@ -1903,9 +2601,7 @@ void MyMoneyStorageXML::writeOnlineJob(QDomElement& onlineJobs, const onlineJob&
 
 void MyMoneyStorageXML::writeCostCenters(QDomElement& parent)
 {
-    CostCenterModel::xmlWriter writer(&MyMoneyXmlContentHandler::writeCostCenter, *m_doc, parent);
-    const auto count = m_file->costCenterModel()->processItems(&writer);
-    parent.setAttribute(attributeName(Attribute::General::Count), count);
+    d->writeItems(m_file->costCenterModel(), &MyMoneyXmlContentHandler::writeCostCenter, *m_doc, parent);
 }
 
 void MyMoneyStorageXML::writeCostCenter(QDomElement& costCenters, const MyMoneyCostCenter& costCenter)
@@ -1955,19 +2651,29 @@ void MyMoneyStorageXML::writePrices(QDomElement& prices)
 
     PriceModel* model = m_file->priceModel();
 
-    pricePair.clear();
-
     auto const rows = model->rowCount();
-    QModelIndex idx;
 
+    // the model is sorted by price pair, so we can count the pairs
+    // up front which allows to stream them as soon as they are complete
     for (auto row = 0; row < rows; ++row) {
-        idx = model->index(row, 0);
-        PriceEntry entry = model->itemByIndex(idx);
-
+        const auto& entry = model->constItemAt(row);
         if ((entry.from() != from) || (entry.to() != to)) {
             ++pricePairCount;
+            from = entry.from();
+            to = entry.to();
+        }
+    }
+    prices.setAttribute(attributeName(Attribute::General::Count), pricePairCount);
+
+    from.clear();
+    to.clear();
+    for (auto row = 0; row < rows; ++row) {
+        const auto& entry = model->constItemAt(row);
+
+        if ((entry.from() != from) || (entry.to() != to)) {
             if (!pricePair.isNull()) {
                 prices.appendChild(pricePair);
+                d->flushChildren(prices);
             }
             pricePair = m_doc->createElement(nodeName(Node::PricePair));
             pricePair.setAttribute(attributeName(Attribute::General::From), entry.from());
@@ -1984,8 +2690,8 @@ void MyMoneyStorageXML::writePrices(QDomElement& prices)
 
     if (!pricePair.isNull()) {
         prices.appendChild(pricePair);
+        d->flushChildren(prices);
     }
-    prices.setAttribute(attributeName(Attribute::General::Count), pricePairCount);
 }
 
 void MyMoneyStorageXML::setProgressCallback(void(*callback)(int, int, const QString&))
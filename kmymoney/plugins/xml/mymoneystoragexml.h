@@ -21,6 +21,7 @@
 // Project Includes
 
 #include "imymoneystorageformat.h"
+#include "mymoneyunittestable.h"
 
 /**
   *@author Kevin Tambascio (ktambascio@users.sourceforge.net)
@@ -58,6 +59,9 @@ typedef QMap<MyMoneySecurityPair, MyMoneyPriceEntries> MyMoneyPriceList;
 class MyMoneyStorageXML : public IMyMoneyOperationsFormat
 {
     friend class MyMoneyXmlContentHandler;
+    friend class MyMoneyXmlStreamReader;
+    KMM_MYMONEY_UNIT_TESTABLE
+
 public:
     MyMoneyStorageXML();
     virtual ~MyMoneyStorageXML();
@@ -146,6 +150,14 @@ protected:
     QDomElement findChildElement(const QString& name, const QDomElement& root);
 
 private:
+    /**
+     * Writes the file to @a qf. With @a streaming set, every object is
+     * written to @a qf as soon as it has been created and dropped
+     * afterwards. Otherwise, the complete QDomDocument is built first
+     * and written at the end. Both produce identical output.
+     */
+    void writeDocument(QIODevice* qf, MyMoneyFile* file, bool streaming);
+
     void (*m_progressCallback)(int, int, const QString&);
 
 protected:
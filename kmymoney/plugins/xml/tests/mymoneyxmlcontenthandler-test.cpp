@@ -13,7 +13,9 @@
 #include "mymoneyxmlcontenthandler-test.h"
 
 #include <QTest>
+#include <QBuffer>
 #include "../mymoneystoragexml.cpp"
+#include "mymoneytransactionfilter.h"
 #include "mymoneyobject_p.h"
 #include "mymoneyobject.h"
 #include "mymoneyexception.h"
@@ -1862,3 +1864,358 @@ void MyMoneyXmlContentHandlerTest::testReplaceId()
     }
 
 }
+
+namespace {
+/**
+ * Positions @a xml on the first child element of the document element
+ * which is where the QDomElement based tests also start reading.
+ */
+void readToFirstObject(QXmlStreamReader& xml)
+{
+    xml.readNextStartElement();
+    xml.readNextStartElement();
+}
+
+QDomElement firstObject(QDomDocument& doc, const QString& content)
+{
+    doc.setContent(content);
+    return doc.documentElement().firstChild().toElement();
+}
+
+/**
+ * Reads a file using the QXmlSimpleReader and MyMoneyXmlContentHandler
+ * combination which is the reference for MyMoneyXmlStreamReader.
+ */
+class ContentHandlerStorageXML : public MyMoneyStorageXML
+{
+public:
+    bool readWithContentHandler(QIODevice* device, MyMoneyFile* file)
+    {
+        m_file = file;
+        QXmlInputSource xml(device);
+        MyMoneyXmlContentHandler handler(this);
+        QXmlSimpleReader reader;
+        reader.setContentHandler(&handler);
+        return reader.parse(&xml, false);
+    }
+};
+
+struct FileSnapshot {
+    QList<MyMoneyAccount> accounts;
+    QList<MyMoneyTransaction> transactions;
+    QList<MyMoneyPayee> payees;
+    QList<MyMoneyTag> tags;
+    QList<MyMoneySecurity> securities;
+    QList<MyMoneySecurity> currencies;
+    QList<MyMoneyPrice> prices;
+    QMap<QString, QString> parameters;
+
+    explicit FileSnapshot(MyMoneyFile* file)
+    {
+        file->accountList(accounts);
+        MyMoneyTransactionFilter filter;
+        file->transactionList(transactions, filter);
+        payees = file->payeeList();
+        tags = file->tagList();
+        securities = file->securityList();
+        currencies = file->currencyList();
+        const auto model = file->priceModel();
+        for (auto row = 0; row < model->rowCount(); ++row) {
+            const auto entry = model->itemByIndex(model->index(row, 0));
+            prices.append(file->price(entry.from(), entry.to(), entry.date(), true));
+        }
+        parameters = file->parametersModel()->pairs();
+    }
+};
+}
+
+void MyMoneyXmlContentHandlerTest::testStreamReaderObjects()
+{
+    const QString transactionXml(
+        "<!DOCTYPE TEST>\n"
+        "<TRANSACTION-CONTAINER>\n"
+        "<TRANSACTION postdate=\"2010-03-05\" memo=\"\" id=\"T000000000000004189\" commodity=\"EUR\" entrydate=\"2010-03-08\" >\n"
+        " <SPLITS>\n"
+        "  <SPLIT payee=\"P000010\" reconciledate=\"\" shares=\"-125000/100\" action=\"Transfer\" bankid=\"A000076-2010-03-05-b6850c0-1\" number=\"\" reconcileflag=\"1\" memo=\"UMBUCHUNG\" value=\"-125000/100\" id=\"S0001\" account=\"A000076\" >\n"
+        "   <TAG id=\"G000001\" />\n"
+        "   <TAG id=\"G000002\" />\n"
+        "   <KEYVALUEPAIRS>\n"
+        "    <PAIR key=\"kmm-match-split\" value=\"S0002\" />\n"
+        "    <PAIR key=\"kmm-matched-tx\" value=\"&#60;!DOCTYPE MATCH>\n"
+        "    &#60;CONTAINER>\n"
+        "     &#60;TRANSACTION postdate=&quot;2010-03-05&quot; memo=&quot;UMBUCHUNG&quot; id=&quot;&quot; commodity=&quot;EUR&quot; entrydate=&quot;2010-03-08&quot; >\n"
+        "      &#60;SPLITS>\n"
+        "       &#60;SPLIT payee=&quot;P000010&quot; reconciledate=&quot;&quot; shares=&quot;125000/100&quot; action=&quot;Transfer&quot; bankid=&quot;&quot; number=&quot;&quot; reconcileflag=&quot;0&quot; memo=&quot;UMBUCHUNG&quot; value=&quot;125000/100&quot; id=&quot;S0001&quot; account=&quot;A000087&quot; />\n"
+        "       &#60;SPLIT payee=&quot;P000010&quot; reconciledate=&quot;&quot; shares=&quot;-125000/100&quot; action=&quot;&quot; bankid=&quot;A000076-2010-03-05-b6850c0-1&quot; number=&quot;&quot; reconcileflag=&quot;0&quot; memo=&quot;UMBUCHUNG&quot; value=&quot;-125000/100&quot; id=&quot;S0002&quot; account=&quot;A000076&quot; />\n"
+        "      &#60;/SPLITS>\n"
+        "      &#60;KEYVALUEPAIRS>\n"
+        "       &#60;PAIR key=&quot;Imported&quot; value=&quot;true&quot; />\n"
+        "      &#60;/KEYVALUEPAIRS>\n"
+        "     &#60;/TRANSACTION>\n"
+        "    &#60;/CONTAINER>\n"
+        "\" />\n"
+        "   </KEYVALUEPAIRS>\n"
+        "  </SPLIT>\n"
+        "  <SPLIT payee=\"P000010\" reconciledate=\"2010-03-10\" shares=\"125000/100\" action=\"Transfer\" bankid=\"\" number=\"12\" reconcileflag=\"2\" memo=\"\" value=\"125000/100\" price=\"1/1\" costcenter=\"C000001\" id=\"S0002\" account=\"A000087\" />\n"
+        "  <SPLIT payee=\"P000010\" shares=\"0/1\" value=\"0/1\" id=\"S0003\" account=\"\" />\n"
+        " </SPLITS>\n"
+        " <KEYVALUEPAIRS>\n"
+        "  <PAIR key=\"key\" value=\"value\" />\n"
+        " </KEYVALUEPAIRS>\n"
+        "</TRANSACTION>\n"
+        "</TRANSACTION-CONTAINER>\n");
+
+    const QString accountXml(
+        "<!DOCTYPE TEST>\n"
+        "<ACCOUNT-CONTAINER>\n"
+        " <ACCOUNT parentaccount=\"Parent\" lastmodified=\"2020-01-02\" lastreconciled=\"2019-12-31\" institution=\"B000001\" number=\"465500\" opened=\"2019-01-01\" type=\"1\" id=\"A000001\" name=\"AccountName\" description=\"Desc\" currency=\"EUR\" >\n"
+        "  <SUBACCOUNTS>\n"
+        "   <SUBACCOUNT id=\"A000002\" />\n"
+        "   <SUBACCOUNT id=\"A000003\" />\n"
+        "  </SUBACCOUNTS>\n"
+        "  <ONLINEBANKING provider=\"KMyMoney OFX\" url=\"https://bank.example\" />\n"
+        "  <KEYVALUEPAIRS>\n"
+        "   <PAIR key=\"key\" value=\"value\" />\n"
+        "   <PAIR key=\"IBAN\" value=\"DE12345\" />\n"
+        "   <PAIR key=\"lastStatementDate\" value=\"2011-01-01\"/>\n"
+        "  </KEYVALUEPAIRS>\n"
+        " </ACCOUNT>\n"
+        "</ACCOUNT-CONTAINER>\n");
+
+    const QString securityXml(
+        "<!DOCTYPE TEST>\n"
+        "<SECURITY-CONTAINER>\n"
+        " <SECURITY id=\"E000001\" name=\"Stock\" symbol=\"STK\" type=\"0\" rounding-method=\"7\" saf=\"1000\" pp=\"6\" trading-currency=\"EUR\" trading-market=\"XETRA\" >\n"
+        "  <KEYVALUEPAIRS>\n"
+        "   <PAIR key=\"kmm-online-source\" value=\"Yahoo\" />\n"
+        "  </KEYVALUEPAIRS>\n"
+        " </SECURITY>\n"
+        "</SECURITY-CONTAINER>\n");
+
+    const QString tagXml(
+        "<!DOCTYPE TEST>\n"
+        "<TAG-CONTAINER>\n"
+        " <TAG id=\"G000001\" name=\"Vacation\" closed=\"1\" tagcolor=\"#ff0000\" notes=\"Some notes\" />\n"
+        "</TAG-CONTAINER>\n");
+
+    QDomDocument doc;
+
+    QXmlStreamReader transactionReader(transactionXml);
+    readToFirstObject(transactionReader);
+    const auto t = MyMoneyXmlStreamReader::readTransaction(transactionReader);
+    const auto tDom = MyMoneyXmlContentHandler::readTransaction(firstObject(doc, transactionXml));
+    QCOMPARE(t.splitCount(), 2);
+    QVERIFY(t.splits().at(0).isMatched());
+    QCOMPARE(t.splits().at(0).tagIdList(), QList<QString>({QStringLiteral("G000001"), QStringLiteral("G000002")}));
+    QCOMPARE(t.splits().at(0).matchedTransaction(), tDom.splits().at(0).matchedTransaction());
+    QVERIFY(t == tDom);
+
+    QXmlStreamReader accountReader(accountXml);
+    readToFirstObject(accountReader);
+    const auto a = MyMoneyXmlStreamReader::readAccount(accountReader);
+    const auto aDom = MyMoneyXmlContentHandler::readAccount(firstObject(doc, accountXml));
+    QCOMPARE(a.accountList(), QStringList({QStringLiteral("A000002"), QStringLiteral("A000003")}));
+    QCOMPARE(a.onlineBankingSettings().value(QStringLiteral("provider")), QStringLiteral("ofximporter"));
+    QCOMPARE(a.value(QStringLiteral("iban")), QStringLiteral("DE12345"));
+    QVERIFY(a.value(QStringLiteral("lastStatementDate")).isEmpty());
+    QVERIFY(a == aDom);
+    QCOMPARE(a.onlineBankingSettings().pairs(), aDom.onlineBankingSettings().pairs());
+
+    QXmlStreamReader securityReader(securityXml);
+    readToFirstObject(securityReader);
+    const auto sec = MyMoneyXmlStreamReader::readSecurity(securityReader);
+    QVERIFY(sec == MyMoneyXmlContentHandler::readSecurity(firstObject(doc, securityXml)));
+    QCOMPARE(sec.value(QStringLiteral("kmm-online-source")), QStringLiteral("Yahoo"));
+
+    QXmlStreamReader tagReader(tagXml);
+    readToFirstObject(tagReader);
+    const auto ta = MyMoneyXmlStreamReader::readTag(tagReader);
+    QVERIFY(ta == MyMoneyXmlContentHandler::readTag(firstObject(doc, tagXml)));
+    QVERIFY(ta.isClosed());
+
+    // the reader complains about wrong elements the same way
+    QXmlStreamReader wrongReader(tagXml);
+    readToFirstObject(wrongReader);
+    QVERIFY_EXCEPTION_THROWN(MyMoneyXmlStreamReader::readTransaction(wrongReader), MyMoneyException);
+}
+
+void MyMoneyXmlContentHandlerTest::testStreamReaderFile()
+{
+    const QByteArray fileXml(
+        "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+        "<!DOCTYPE KMYMONEY-FILE>\n"
+        "<KMYMONEY-FILE>\n"
+        " <FILEINFO>\n"
+        "  <CREATION_DATE date=\"2020-01-01\"/>\n"
+        "  <LAST_MODIFIED_DATE date=\"2020-02-01\"/>\n"
+        "  <VERSION id=\"1\"/>\n"
+        "  <FIXVERSION id=\"5\"/>\n"
+        " </FILEINFO>\n"
+        " <USER name=\"Jane Doe\" email=\"jane@example.com\">\n"
+        "  <ADDRESS street=\"Street 1\" city=\"Town\" county=\"State\" zipcode=\"12345\" telephone=\"555\"/>\n"
+        " </USER>\n"
+        " <INSTITUTIONS count=\"0\"/>\n"
+        " <PAYEES count=\"1\">\n"
+        "  <PAYEE id=\"P000001\" name=\"Payee 1\" email=\"\" reference=\"\" matchingenabled=\"0\">\n"
+        "   <ADDRESS street=\"\" city=\"\" postcode=\"\" state=\"\" telephone=\"\"/>\n"
+        "  </PAYEE>\n"
+        " </PAYEES>\n"
+        " <COSTCENTERS count=\"0\"/>\n"
+        " <TAGS count=\"1\">\n"
+        "  <TAG id=\"G000001\" name=\"Tag 1\" closed=\"0\"/>\n"
+        " </TAGS>\n"
+        " <ACCOUNTS count=\"7\">\n"
+        "  <ACCOUNT id=\"AStd::Asset\" name=\"Asset\" type=\"9\" parentaccount=\"\" currency=\"EUR\" institution=\"\" number=\"\" opened=\"\" lastmodified=\"\" lastreconciled=\"\" description=\"\">\n"
+        "   <SUBACCOUNTS>\n"
+        "    <SUBACCOUNT id=\"A000001\"/>\n"
+        "   </SUBACCOUNTS>\n"
+        "  </ACCOUNT>\n"
+        "  <ACCOUNT id=\"AStd::Equity\" name=\"Equity\" type=\"16\" parentaccount=\"\" currency=\"EUR\" institution=\"\" number=\"\" opened=\"\" lastmodified=\"\" lastreconciled=\"\" description=\"\"/>\n"
+        "  <ACCOUNT id=\"AStd::Expense\" name=\"Expense\" type=\"13\" parentaccount=\"\" currency=\"EUR\" institution=\"\" number=\"\" opened=\"\" lastmodified=\"\" lastreconciled=\"\" description=\"\">\n"
+        "   <SUBACCOUNTS>\n"
+        "    <SUBACCOUNT id=\"A000002\"/>\n"
+        "   </SUBACCOUNTS>\n"
+        "  </ACCOUNT>\n"
+        "  <ACCOUNT id=\"AStd::Income\" name=\"Income\" type=\"12\" parentaccount=\"\" currency=\"EUR\" institution=\"\" number=\"\" opened=\"\" lastmodified=\"\" lastreconciled=\"\" description=\"\"/>\n"
+        "  <ACCOUNT id=\"AStd::Liability\" name=\"Liability\" type=\"10\" parentaccount=\"\" currency=\"EUR\" institution=\"\" number=\"\" opened=\"\" lastmodified=\"\" lastreconciled=\"\" description=\"\"/>\n"
+        "  <ACCOUNT id=\"A000001\" name=\"Checking\" type=\"1\" parentaccount=\"AStd::Asset\" currency=\"EUR\" institution=\"\" number=\"\" opened=\"2020-01-01\" lastmodified=\"\" lastreconciled=\"\" description=\"\">\n"
+        "   <KEYVALUEPAIRS>\n"
+        "    <PAIR key=\"mm-closed\" value=\"no\"/>\n"
+        "   </KEYVALUEPAIRS>\n"
+        "  </ACCOUNT>\n"
+        "  <ACCOUNT id=\"A000002\" name=\"Food\" type=\"13\" parentaccount=\"AStd::Expense\" currency=\"EUR\" institution=\"\" number=\"\" opened=\"2020-01-01\" lastmodified=\"\" lastreconciled=\"\" description=\"\"/>\n"
+        " </ACCOUNTS>\n"
+        " <TRANSACTIONS count=\"2\">\n"
+        "  <TRANSACTION id=\"T000000000000000001\" postdate=\"2020-01-15\" entrydate=\"2020-01-16\" commodity=\"EUR\" memo=\"Groceries\">\n"
+        "   <SPLITS>\n"
+        "    <SPLIT id=\"S0001\" payee=\"P000001\" account=\"A000001\" value=\"-1250/100\" shares=\"-1250/100\" reconcileflag=\"1\" reconciledate=\"\" action=\"\" memo=\"\" number=\"\" bankid=\"\">\n"
+        "     <TAG id=\"G000001\"/>\n"
+        "    </SPLIT>\n"
+        "    <SPLIT id=\"S0002\" payee=\"P000001\" account=\"A000002\" value=\"1250/100\" shares=\"1250/100\" reconcileflag=\"0\" reconciledate=\"\" action=\"\" memo=\"\" number=\"\" bankid=\"\"/>\n"
+        "   </SPLITS>\n"
+        "  </TRANSACTION>\n"
+        "  <TRANSACTION id=\"T000000000000000002\" postdate=\"2020-01-10\" entrydate=\"2020-01-10\" commodity=\"EUR\" memo=\"\">\n"
+        "   <SPLITS>\n"
+        "    <SPLIT id=\"S0001\" payee=\"\" account=\"A000001\" value=\"-500/100\" shares=\"-500/100\" reconcileflag=\"2\" reconciledate=\"2020-01-31\" action=\"\" memo=\"Cash\" number=\"100\" bankid=\"\"/>\n"
+        "    <SPLIT id=\"S0002\" payee=\"\" account=\"A000002\" value=\"500/100\" shares=\"500/100\" reconcileflag=\"0\" reconciledate=\"\" action=\"\" memo=\"\" number=\"\" bankid=\"\"/>\n"
+        "   </SPLITS>\n"
+        "   <KEYVALUEPAIRS>\n"
+        "    <PAIR key=\"Imported\" value=\"true\"/>\n"
+        "   </KEYVALUEPAIRS>\n"
+        "  </TRANSACTION>\n"
+        " </TRANSACTIONS>\n"
+        " <KEYVALUEPAIRS>\n"
+        "  <PAIR key=\"kmm-baseCurrency\" value=\"EUR\"/>\n"
+        " </KEYVALUEPAIRS>\n"
+        " <SCHEDULES count=\"0\"/>\n"
+        " <SECURITIES count=\"1\">\n"
+        "  <SECURITY id=\"E000001\" name=\"Stock\" symbol=\"STK\" type=\"0\" rounding-method=\"7\" saf=\"100\" pp=\"4\" trading-currency=\"EUR\" trading-market=\"\"/>\n"
+        " </SECURITIES>\n"
+        " <CURRENCIES count=\"1\">\n"
+        "  <CURRENCY id=\"EUR\" name=\"Euro\" symbol=\"€\" type=\"3\" rounding-method=\"7\" saf=\"100\" pp=\"4\" scf=\"100\"/>\n"
+        " </CURRENCIES>\n"
+        " <PRICES count=\"1\">\n"
+        "  <PRICEPAIR from=\"E000001\" to=\"EUR\">\n"
+        "   <PRICE date=\"2020-01-01\" price=\"10/1\" source=\"User\"/>\n"
+        "   <PRICE date=\"2020-01-15\" price=\"21/2\" source=\"Yahoo\"/>\n"
+        "  </PRICEPAIR>\n"
+        " </PRICES>\n"
+        " <REPORTS count=\"0\"/>\n"
+        " <BUDGETS count=\"0\"/>\n"
+        " <ONLINEJOBS count=\"0\"/>\n"
+        "</KMYMONEY-FILE>\n");
+
+    auto file = MyMoneyFile::instance();
+
+    QBuffer contentHandlerBuffer;
+    contentHandlerBuffer.setData(fileXml);
+    contentHandlerBuffer.open(QIODevice::ReadOnly);
+    ContentHandlerStorageXML contentHandlerStorage;
+    QVERIFY(contentHandlerStorage.readWithContentHandler(&contentHandlerBuffer, file));
+    const FileSnapshot expected(file);
+    file->unload();
+
+    QBuffer streamBuffer;
+    streamBuffer.setData(fileXml);
+    streamBuffer.open(QIODevice::ReadOnly);
+    MyMoneyStorageXML streamStorage;
+    try {
+        streamStorage.readFile(&streamBuffer, file);
+    } catch (const MyMoneyException& e) {
+        QFAIL(e.what());
+    }
+    const FileSnapshot actual(file);
+
+    QCOMPARE(actual.transactions.count(), 2);
+    QCOMPARE(actual.prices.count(), 2);
+    QCOMPARE(actual.transactions.at(0).postDate(), QDate(2020, 1, 10));
+    QCOMPARE(file->user().name(), QStringLiteral("Jane Doe"));
+    QCOMPARE(file->payee(QStringLiteral("P000001")).name(), QStringLiteral("Payee 1"));
+
+    QVERIFY(actual.accounts == expected.accounts);
+    QVERIFY(actual.transactions == expected.transactions);
+    QVERIFY(actual.payees == expected.payees);
+    QVERIFY(actual.tags == expected.tags);
+    QVERIFY(actual.securities == expected.securities);
+    QVERIFY(actual.currencies == expected.currencies);
+    QVERIFY(actual.prices == expected.prices);
+    QCOMPARE(actual.parameters, expected.parameters);
+
+    // a broken file is reported
+    QBuffer brokenBuffer;
+    brokenBuffer.setData(fileXml.left(fileXml.indexOf("</TRANSACTIONS>")));
+    brokenBuffer.open(QIODevice::ReadOnly);
+    MyMoneyStorageXML brokenStorage;
+    QVERIFY_EXCEPTION_THROWN(brokenStorage.readFile(&brokenBuffer, file), MyMoneyException);
+}
+
+void MyMoneyXmlContentHandlerTest::testStreamingWriter()
+{
+    setupAccounts();
+    const auto acFood = makeAccount("A000100", "Food", eMyMoney::Account::Type::Expense, moZero, QDate(2014, 5, 15), acExpense);
+    const auto equity = makeEquity("Stock", "STK");
+    makeEquityPrice(equity, QDate(2014, 5, 15), MyMoneyMoney(10, 1));
+    makeEquityPrice(equity, QDate(2014, 6, 15), MyMoneyMoney(21, 2));
+
+    auto file = MyMoneyFile::instance();
+    QByteArray output;
+    {
+        const auto action = MyMoneySplit::actionName(eMyMoney::Split::Action::Withdrawal);
+        TransactionHelper t1(QDate(2014, 6, 1), action, MyMoneyMoney(1250, 100), acChecking, acFood, QString(), QString());
+        TransactionHelper t2(QDate(2014, 6, 2), action, MyMoneyMoney(500, 100), acChecking, acTransfer, QString(), QString());
+
+        QBuffer documentBuffer;
+        documentBuffer.open(QIODevice::WriteOnly);
+        MyMoneyStorageXML documentWriter;
+        documentWriter.writeDocument(&documentBuffer, file, false);
+
+        QBuffer streamBuffer;
+        streamBuffer.open(QIODevice::WriteOnly);
+        MyMoneyStorageXML streamWriter;
+        streamWriter.writeFile(&streamBuffer, file);
+
+        output = streamBuffer.data();
+        QVERIFY(!documentBuffer.data().isEmpty());
+        QCOMPARE(output, documentBuffer.data());
+    }
+
+    QVERIFY(output.startsWith("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<!DOCTYPE KMYMONEY-FILE>\n<KMYMONEY-FILE>\n"));
+    QVERIFY(output.endsWith("</KMYMONEY-FILE>\n"));
+    QVERIFY(output.contains("<TRANSACTIONS count=\"2\">"));
+    QVERIFY(output.contains("<PRICES count=\"1\">"));
+    QVERIFY(output.contains("<INSTITUTIONS count=\"0\"/>"));
+
+    // what we wrote can be read back
+    file->unload();
+    QBuffer readBuffer;
+    readBuffer.setData(output);
+    readBuffer.open(QIODevice::ReadOnly);
+    MyMoneyStorageXML reader;
+    try {
+        reader.readFile(&readBuffer, file);
+    } catch (const MyMoneyException& e) {
+        QFAIL(e.what());
+    }
+    QCOMPARE(file->account(acFood).name(), QStringLiteral("Food"));
+    QCOMPARE(file->priceModel()->rowCount(), 2);
+}
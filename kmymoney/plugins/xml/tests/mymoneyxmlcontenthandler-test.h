@@ -13,6 +13,8 @@
 #ifndef MYMONEYXMLCONTENTHANDLERTEST_H
 #define MYMONEYXMLCONTENTHANDLERTEST_H
 
+#define KMM_MYMONEY_UNIT_TESTABLE friend class MyMoneyXmlContentHandlerTest;
+
 #include <QObject>
 
 class MyMoneyXmlContentHandlerTest : public QObject
@@ -46,6 +48,9 @@ private Q_SLOTS:
     void testHasReferenceTo();
     void testPaidEarlyOneTime();
     void testReplaceId();
+    void testStreamReaderObjects();
+    void testStreamReaderFile();
+    void testStreamingWriter();
 
 private:
     void setupAccounts();
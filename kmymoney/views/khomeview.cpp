@@ -82,6 +82,8 @@ void KHomeView::executeAction(eMenu::Action action, const SelectedObjects& selec
         }
         break;
     case eMenu::Action::FileClose:
+        d->cancelUpdate();
+        d->invalidateAllSections();
         d->m_view->setHtml(KWelcomePage::welcomePage(), QUrl("file://"));
         break;
     default:
@@ -104,12 +106,8 @@ void KHomeView::executeCustomAction(eView::Action action)
 void KHomeView::refresh()
 {
     Q_D(KHomeView);
-    if (isVisible()) {
-        d->loadView();
-        d->m_needsRefresh = false;
-    } else {
-        d->m_needsRefresh = true;
-    }
+    d->invalidateAllSections();
+    d->updateView();
 }
 
 void KHomeView::showEvent(QShowEvent* event)
@@ -119,7 +117,7 @@ void KHomeView::showEvent(QShowEvent* event)
         d->init();
 
     if (d->m_needsRefresh)
-        refresh();
+        d->updateView();
 
     QWidget::showEvent(event);
 }
@@ -182,10 +180,12 @@ void KHomeView::slotOpenUrl(const QUrl &url)
 
             } else if (mode == QLatin1String("full")) {
                 d->m_showAllSchedules = true;
+                d->m_sectionHtml.remove(1);
                 d->loadView();
 
             } else if (mode == QLatin1String("reduced")) {
                 d->m_showAllSchedules = false;
+                d->m_sectionHtml.remove(1);
                 d->loadView();
             }
 
@@ -213,6 +213,7 @@ void KHomeView::slotOpenUrl(const QUrl &url)
             if (list.count() == 0) {
                 KMessageBox::information(this, i18n("Before KMyMoney can give you detailed information about your financial status, you need to create at least one account. Until then, KMyMoney shows the welcome page instead."));
             }
+            d->invalidateAllSections();
             d->loadView();
 
         } else {
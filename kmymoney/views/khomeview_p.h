@@ -30,6 +30,7 @@
 #include <QVBoxLayout>
 #include <QPrinter>
 #include <QElapsedTimer>
+#include <QTimer>
 #ifdef ENABLE_WEBENGINE
 #include <QWebEngineView>
 #else
@@ -66,6 +67,7 @@
 #include "mymoneyschedule.h"
 #include "mymoneysecurity.h"
 #include "mymoneyexception.h"
+#include "mymoneychangeset.h"
 #include "kmymoneyplugin.h"
 #include "mymoneyenums.h"
 #include "menuenums.h"
@@ -114,6 +116,10 @@ public:
         , m_showAllSchedules(false)
         , m_needLoad(true)
         , m_netWorthGraphLastValidSize(400, 300)
+        , m_transactionStatsValid(false)
+        , m_changeSetReceived(false)
+        , m_updateRunning(false)
+        , m_updateGeneration(0)
         , m_scrollBarPos(0)
     {
     }
@@ -163,7 +169,110 @@ public:
                    q, &KHomeView::slotOpenUrl);
 #endif
 
-        q->connect(MyMoneyFile::instance(), &MyMoneyFile::dataChanged, q, &KHomeView::refresh);
+        // only the sections affected by a change are recalculated. In case
+        // the data changed without a change set (e.g. a file was loaded)
+        // all of them are outdated.
+        q->connect(MyMoneyFile::instance(), &MyMoneyFile::changesCommitted, q, [this](const MyMoneyChangeSet& changes) {
+            m_changeSetReceived = true;
+            invalidateSections(changes);
+        });
+        q->connect(MyMoneyFile::instance(), &MyMoneyFile::dataChanged, q, [this]() {
+            if (!m_changeSetReceived) {
+                invalidateAllSections();
+            }
+            m_changeSetReceived = false;
+            updateView();
+        });
+    }
+
+    /**
+     * Loads the view if it is visible or marks it for
+     * loading once it is shown
+     */
+    void updateView()
+    {
+        Q_Q(KHomeView);
+        if (q->isVisible()) {
+            loadView();
+            m_needsRefresh = false;
+        } else {
+            m_needsRefresh = true;
+        }
+    }
+
+    /**
+     * Returns @c true if the section @a option of the home page
+     * (see KMyMoneySettings::listOfItems()) shows information
+     * that depends on the objects changed in @a changes.
+     */
+    static bool sectionDependsOn(int option, const MyMoneyChangeSet& changes)
+    {
+        // almost all sections show balances or values of accounts
+        const auto valuesChanged = !changes.balanceChangedAccounts().isEmpty()
+                                   || !changes.valueChangedAccounts().isEmpty()
+                                   || changes.contains(File::Object::Account)
+                                   || changes.contains(File::Object::Transaction)
+                                   || changes.contains(File::Object::Price)
+                                   || changes.contains(File::Object::Security)
+                                   || changes.contains(File::Object::Currency)
+                                   || changes.contains(File::Object::BaseCurrency)
+                                   || changes.contains(File::Object::Parameter);
+
+        switch (option) {
+        case 1:         // payments
+            return valuesChanged || changes.contains(File::Object::Schedule) || changes.contains(File::Object::Payee);
+        case 2:         // preferred accounts
+        case 3:         // payment accounts
+        case 8:         // assets and liabilities
+            return valuesChanged;
+        case 4:         // favorite reports
+            return changes.contains(File::Object::Report);
+        case 5:         // forecast
+        case 6:         // net worth graph over all accounts
+        case 10:        // cash flow summary
+            return valuesChanged || changes.contains(File::Object::Schedule);
+        case 9:         // budget
+            return valuesChanged || changes.contains(File::Object::Budget);
+        default:
+            break;
+        }
+        return false;
+    }
+
+    /**
+     * Removes the cached sections which depend on @a changes
+     */
+    void invalidateSections(const MyMoneyChangeSet& changes)
+    {
+        auto invalidated = false;
+        for (auto it = m_sectionHtml.begin(); it != m_sectionHtml.end();) {
+            if (sectionDependsOn(it.key(), changes)) {
+                it = m_sectionHtml.erase(it);
+                invalidated = true;
+            } else {
+                ++it;
+            }
+        }
+        if (invalidated) {
+            resetSectionData();
+        }
+    }
+
+    void invalidateAllSections()
+    {
+        m_sectionHtml.clear();
+        resetSectionData();
+    }
+
+    /**
+     * Forces the data shared by multiple sections to be
+     * reloaded when it is needed the next time
+     */
+    void resetSectionData()
+    {
+        //clear the forecast flag so it will be reloaded
+        m_forecast.setForecastDone(false);
+        m_transactionStatsValid = false;
     }
 
     /**
@@ -219,6 +328,11 @@ public:
         int countNotMarked = 0, countCleared = 0, countNotReconciled = 0;
         QString countStr;
 
+        if (!m_transactionStatsValid) {
+            m_transactionStats = MyMoneyFile::instance()->countTransactionsWithSpecificReconciliationState();
+            m_transactionStatsValid = true;
+        }
+
         if (KMyMoneySettings::showCountOfUnmarkedTransactions() || KMyMoneySettings::showCountOfNotReconciledTransactions())
             countNotMarked = m_transactionStats[acc.id()][(int)Split::State::NotReconciled];
 
@@ -404,6 +518,13 @@ public:
         return m_accountList[acc.id()][paymentDate];
     }
 
+    /**
+     * Shows the home page. Sections whose information did not change
+     * since they have been generated are taken from the cache. The
+     * others are generated one at a time returning to the event loop
+     * in between so that the application stays responsive. Once all
+     * sections are available, the page is updated.
+     */
     void loadView()
     {
         Q_Q(KHomeView);
@@ -412,110 +533,180 @@ public:
         QList<MyMoneyAccount> list;
         MyMoneyFile::instance()->accountList(list);
         if (list.isEmpty()) {
+            cancelUpdate();
+            invalidateAllSections();
             m_view->setHtml(KWelcomePage::welcomePage(), QUrl("file://"));
-        } else {
-            // preload transaction statistics
-            m_transactionStats = MyMoneyFile::instance()->countTransactionsWithSpecificReconciliationState();
+            return;
+        }
 
-            // keep current location on page
-            m_scrollBarPos = 0;
-#ifndef ENABLE_WEBENGINE
-            m_scrollBarPos = m_view->page()->mainFrame()->scrollBarValue(Qt::Vertical);
-#endif
+        // the information shown depends on the current date
+        if (m_sectionDate != QDate::currentDate()) {
+            m_sectionDate = QDate::currentDate();
+            invalidateAllSections();
+        }
+
+        if (!m_updateRunning) {
+            m_updateRunning = true;
+            const auto generation = m_updateGeneration;
+            QTimer::singleShot(0, q, [this, generation]() {
+                updateNextSection(generation);
+            });
+        }
+    }
 
-            //clear the forecast flag so it will be reloaded
-            m_forecast.setForecastDone(false);
+    /**
+     * Stops generating the sections, e.g. because the file is closed
+     */
+    void cancelUpdate()
+    {
+        ++m_updateGeneration;
+        m_updateRunning = false;
+    }
 
-            const QString filename = QStandardPaths::locate(QStandardPaths::AppConfigLocation, "html/kmymoney.css");
-            QString header = QString("<!DOCTYPE HTML PUBLIC \"-//W3C//DTD HTML 4.0//EN\">\n<html><head>\n");
+    /**
+     * Generates the next section of the home page that is not
+     * cached or shows the page if all sections are available.
+     * Nothing is done if the update has been cancelled since
+     * it started with @a generation.
+     */
+    void updateNextSection(int generation)
+    {
+        Q_Q(KHomeView);
+        if (generation != m_updateGeneration) {
+            return;
+        }
+        const auto settings = KMyMoneySettings::listOfItems();
+        for (const auto& item : settings) {
+            const auto option = item.toInt();
+            if (option > 0 && !m_sectionHtml.contains(option)) {
+                QElapsedTimer t;
+                t.start();
+                m_sectionHtml.insert(option, sectionHtml(option, settings));
+                qDebug() << "Processed home view section" << option << "in" << t.elapsed() << "ms";
+
+                // continue with the next section once pending events are processed
+                QTimer::singleShot(0, q, [this, generation]() {
+                    updateNextSection(generation);
+                });
+                return;
+            }
+        }
+        m_updateRunning = false;
+        showSections(settings);
+    }
 
-            // inline the CSS
-            header += "<style type=\"text/css\">\n<!--\n";
-            header += KMyMoneyUtils::variableCSS();
-            QFile cssFile(filename);
-            if (cssFile.open(QIODevice::ReadOnly)) {
-                QTextStream cssStream(&cssFile);
-                header += cssStream.readAll();
-                cssFile.close();
+    /**
+     * Returns the HTML code of section @a option. @a settings
+     * contains all sections selected for the home page.
+     */
+    QString sectionHtml(int option, const QStringList& settings)
+    {
+        // the show* methods add their output to m_html
+        QString html;
+        std::swap(html, m_html);
+
+        switch (option) {
+        case 1:         // payments
+            showPayments();
+            break;
+
+        case 2:         // preferred accounts
+            showAccounts(Preferred, i18n("Preferred Accounts"));
+            break;
+
+        case 3:         // payment accounts
+            // Check if preferred accounts are shown separately
+            if (settings.contains("2")) {
+                showAccounts(static_cast<paymentTypeE>(Payment | Preferred),
+                             i18n("Payment Accounts"));
+            } else {
+                showAccounts(Payment, i18n("Payment Accounts"));
             }
-            header += "-->\n</style>\n";
+            break;
+        case 4:         // favorite reports
+            showFavoriteReports();
+            break;
+        case 5:         // forecast
+            showForecast();
+            break;
+        case 6:         // net worth graph over all accounts
+            showNetWorthGraph();
+            break;
+        case 7:         // forecast (history) - currently unused
+            break;
+        case 8:         // assets and liabilities
+            showAssetsLiabilities();
+            break;
+        case 9:         // budget
+            showBudget();
+            break;
+        case 10:         // cash flow summary
+            showCashFlowSummary();
+            break;
+        }
+        m_html += "<div class=\"gap\">&nbsp;</div>\n";
 
-            header += "</head><body id=\"summaryview\">\n";
+        std::swap(html, m_html);
+        return html;
+    }
 
-            QString footer = "</body></html>\n";
+    /**
+     * Puts the page together from the cached sections
+     * selected in @a settings and shows it
+     */
+    void showSections(const QStringList& settings)
+    {
+        Q_Q(KHomeView);
 
-            m_html.clear();
-            m_html += header;
+        // keep current location on page
+        m_scrollBarPos = 0;
+#ifndef ENABLE_WEBENGINE
+        m_scrollBarPos = m_view->page()->mainFrame()->scrollBarValue(Qt::Vertical);
+#endif
 
-            m_html += QString("<div id=\"summarytitle\">%1</div>").arg(i18n("Your Financial Summary"));
+        const QString filename = QStandardPaths::locate(QStandardPaths::AppConfigLocation, "html/kmymoney.css");
+        QString header = QString("<!DOCTYPE HTML PUBLIC \"-//W3C//DTD HTML 4.0//EN\">\n<html><head>\n");
+
+        // inline the CSS
+        header += "<style type=\"text/css\">\n<!--\n";
+        header += KMyMoneyUtils::variableCSS();
+        QFile cssFile(filename);
+        if (cssFile.open(QIODevice::ReadOnly)) {
+            QTextStream cssStream(&cssFile);
+            header += cssStream.readAll();
+            cssFile.close();
+        }
+        header += "-->\n</style>\n";
 
-            QStringList settings = KMyMoneySettings::listOfItems();
+        header += "</head><body id=\"summaryview\">\n";
 
-            QStringList::ConstIterator it;
+        QString footer = "</body></html>\n";
 
-            QElapsedTimer t;
-            t.start();
-            for (it = settings.constBegin(); it != settings.constEnd(); ++it) {
-                int option = (*it).toInt();
-                if (option > 0) {
-                    switch (option) {
-                    case 1:         // payments
-                        showPayments();
-                        break;
+        m_html.clear();
+        m_html += header;
 
-                    case 2:         // preferred accounts
-                        showAccounts(Preferred, i18n("Preferred Accounts"));
-                        break;
+        m_html += QString("<div id=\"summarytitle\">%1</div>").arg(i18n("Your Financial Summary"));
 
-                    case 3:         // payment accounts
-                        // Check if preferred accounts are shown separately
-                        if (settings.contains("2")) {
-                            showAccounts(static_cast<paymentTypeE>(Payment | Preferred),
-                                         i18n("Payment Accounts"));
-                        } else {
-                            showAccounts(Payment, i18n("Payment Accounts"));
-                        }
-                        break;
-                    case 4:         // favorite reports
-                        showFavoriteReports();
-                        break;
-                    case 5:         // forecast
-                        showForecast();
-                        break;
-                    case 6:         // net worth graph over all accounts
-                        showNetWorthGraph();
-                        break;
-                    case 7:         // forecast (history) - currently unused
-                        break;
-                    case 8:         // assets and liabilities
-                        showAssetsLiabilities();
-                        break;
-                    case 9:         // budget
-                        showBudget();
-                        break;
-                    case 10:         // cash flow summary
-                        showCashFlowSummary();
-                        break;
-                    }
-                    m_html += "<div class=\"gap\">&nbsp;</div>\n";
-                    qDebug() << "Processed home view section" << option << "in" << t.restart() << "ms";
-                }
+        for (const auto& item : settings) {
+            const auto option = item.toInt();
+            if (option > 0) {
+                m_html += m_sectionHtml.value(option);
             }
+        }
 
-            m_html += "<div id=\"returnlink\">";
-            m_html += link(VIEW_WELCOME, QString()) + i18n("Show KMyMoney welcome page") + linkend();
-            m_html += "</div>";
-            m_html += "<div id=\"vieweffect\"></div>";
-            m_html += footer;
+        m_html += "<div id=\"returnlink\">";
+        m_html += link(VIEW_WELCOME, QString()) + i18n("Show KMyMoney welcome page") + linkend();
+        m_html += "</div>";
+        m_html += "<div id=\"vieweffect\"></div>";
+        m_html += footer;
 
-            m_view->setHtml(m_html, QUrl("file://"));
+        m_view->setHtml(m_html, QUrl("file://"));
 
 #ifndef ENABLE_WEBENGINE
-            if (m_scrollBarPos) {
-                QMetaObject::invokeMethod(q, "slotAdjustScrollPos", Qt::QueuedConnection);
-            }
-#endif
+        if (m_scrollBarPos) {
+            QMetaObject::invokeMethod(q, "slotAdjustScrollPos", Qt::QueuedConnection);
         }
+#endif
     }
 
     void showNetWorthGraph()
@@ -1858,6 +2049,17 @@ public:
     QSize           m_netWorthGraphLastValidSize;
 
     QMap< QString, QVector<int> > m_transactionStats;
+    bool      m_transactionStatsValid;
+
+    /**
+      * The HTML code of the sections of the home page
+      * which are up to date and the date they are valid for
+      */
+    QHash<int, QString> m_sectionHtml;
+    QDate     m_sectionDate;
+    bool      m_changeSetReceived;
+    bool      m_updateRunning;
+    int       m_updateGeneration;
 
     /**
       * daily forecast balance of accounts
@@ -10,6 +10,9 @@
 // ----------------------------------------------------------------------------
 // QT Includes
 
+#include <QSet>
+#include <QVector>
+
 // ----------------------------------------------------------------------------
 // KDE Includes
 
@@ -28,21 +31,49 @@
 class LedgerAccountFilterPrivate : public LedgerFilterBasePrivate
 {
 public:
+    /**
+     * The running balance after a row of the ledger. @a accountId is
+     * empty for rows that do not contribute to the balance. The
+     * balances are kept here and not in the journal entries, as the
+     * entries are shared with the other ledgers showing them.
+     */
+    struct RowBalance
+    {
+        QString         accountId;
+        MyMoneyMoney    balance;
+    };
+
     explicit LedgerAccountFilterPrivate(LedgerAccountFilter* qq)
         : LedgerFilterBasePrivate(qq)
         , onlinebalanceproxymodel(nullptr)
         , balanceCalculationPending(false)
         , sortPending(false)
+        , firstDirtyRow(0)
     {}
 
     ~LedgerAccountFilterPrivate()
     {
     }
 
+    /**
+     * Marks the balances starting at @a row as outdated
+     */
+    void markDirty(int row)
+    {
+        firstDirtyRow = (firstDirtyRow < 0) ? row : qMin(firstDirtyRow, row);
+    }
+
     OnlineBalanceProxyModel*    onlinebalanceproxymodel;
     MyMoneyAccount              account;
     bool                        balanceCalculationPending;
     bool                        sortPending;
+
+    /**
+     * The first row whose balance needs to be recalculated
+     * or -1 if all balances are up to date
+     */
+    int                         firstDirtyRow;
+    QVector<RowBalance>         rowBalances;
 };
 
 
@@ -89,6 +120,43 @@ LedgerAccountFilter::LedgerAccountFilter(QObject* parent, QVector<QAbstractItemM
             QMetaObject::invokeMethod(this, &LedgerAccountFilter::sortView, Qt::QueuedConnection);
         }
     });
+
+    // keep track of the first row whose balance is affected by a change
+    // so that only the balances from there on need to be recalculated
+    // and keep the balances aligned with the rows until then
+    connect(this, &QAbstractItemModel::rowsInserted, this, [&](const QModelIndex& parent, int first, int last) {
+        Q_UNUSED(parent)
+        Q_D(LedgerAccountFilter);
+        if (first <= d->rowBalances.count()) {
+            d->rowBalances.insert(first, last - first + 1, LedgerAccountFilterPrivate::RowBalance());
+        }
+        d->markDirty(first);
+    });
+    connect(this, &QAbstractItemModel::rowsRemoved, this, [&](const QModelIndex& parent, int first, int last) {
+        Q_UNUSED(parent)
+        Q_D(LedgerAccountFilter);
+        if (first < d->rowBalances.count()) {
+            d->rowBalances.remove(first, qMin(last, d->rowBalances.count() - 1) - first + 1);
+        }
+        d->markDirty(first);
+    });
+    connect(this, &QAbstractItemModel::dataChanged, this, [&](const QModelIndex& topLeft, const QModelIndex& bottomRight) {
+        Q_D(LedgerAccountFilter);
+        // skip the notification about the balances we calculated ourselves
+        if (topLeft.column() == JournalModel::Column::Balance && bottomRight.column() == JournalModel::Column::Balance) {
+            return;
+        }
+        d->markDirty(topLeft.row());
+    });
+    // the position of the rows is unknown after sorting
+    connect(this, &QAbstractItemModel::layoutChanged, this, [&]() {
+        Q_D(LedgerAccountFilter);
+        d->markDirty(0);
+    });
+    connect(this, &QAbstractItemModel::modelReset, this, [&]() {
+        Q_D(LedgerAccountFilter);
+        d->markDirty(0);
+    });
 }
 
 LedgerAccountFilter::~LedgerAccountFilter()
@@ -119,6 +187,11 @@ void LedgerAccountFilter::recalculateBalancesOnIdle(const QString& accountId)
         // make sure the balances are recalculated but trigger only once
         // if sorting is pending, we don't trigger recalc as it is part of sorting
         if(!d->balanceCalculationPending && !d->sortPending) {
+            // in case we don't know which rows have been modified
+            // we have to recalculate all of them
+            if (d->firstDirtyRow < 0) {
+                d->markDirty(0);
+            }
             d->balanceCalculationPending = true;
             QMetaObject::invokeMethod(this, "recalculateBalances", Qt::QueuedConnection);
         }
@@ -152,13 +225,37 @@ void LedgerAccountFilter::recalculateBalances()
         accountIds << d->account.accountList();
     }
 
-    QHash<QString, MyMoneyMoney> balances;
     const auto rows = rowCount();
+    // the balances of the rows before the first modified one can be reused
+    const auto firstRow = (d->firstDirtyRow < 0) ? rows : qMin(d->firstDirtyRow, qMin(rows, d->rowBalances.count()));
+    d->rowBalances.resize(rows);
+
+    // start with the balance of the journal entries not loaded into memory
+    QHash<QString, MyMoneyMoney> balances;
+    const auto journalModel = MyMoneyFile::instance()->journalModel();
+    for (const auto& id : qAsConst(accountIds)) {
+        const auto openingBalance = journalModel->openingBalance(id);
+        if (!openingBalance.isZero()) {
+            balances[id] = (!isInvestmentAccount && d->showValuesInverted) ? -openingBalance : openingBalance;
+        }
+    }
+
+    // and continue with the last balance of each account before firstRow
+    QSet<QString> foundAccounts;
+    for (int row = firstRow - 1; (row >= 0) && (foundAccounts.count() < accountIds.count()); --row) {
+        const auto& rowBalance = d->rowBalances.at(row);
+        if (!rowBalance.accountId.isEmpty() && !foundAccounts.contains(rowBalance.accountId)) {
+            foundAccounts.insert(rowBalance.accountId);
+            balances[rowBalance.accountId] = rowBalance.balance;
+        }
+    }
+
     QModelIndex idx;
     QString accountId;
-    for (int row = 0; row < rows; ++row) {
+    for (int row = firstRow; row < rows; ++row) {
         idx = index(row, 0);
         accountId = idx.data(eMyMoney::Model::SplitAccountIdRole).toString();
+        auto& rowBalance = d->rowBalances[row];
         if (accountIds.contains(accountId)) {
             if (isInvestmentAccount) {
                 if (idx.data(eMyMoney::Model::TransactionIsStockSplitRole).toBool()) {
@@ -174,12 +271,17 @@ void LedgerAccountFilter::recalculateBalances()
                     balances[accountId] += idx.data(eMyMoney::Model::SplitSharesRole).value<MyMoneyMoney>();
                 }
             }
-            const auto dispIndex = index(row, JournalModel::Column::Balance);
-            setData(dispIndex, QVariant::fromValue(balances[accountId]), Qt::DisplayRole);
+            rowBalance.accountId = accountId;
+            rowBalance.balance = balances[accountId];
+        } else {
+            rowBalance.accountId.clear();
         }
     }
 
-    emit dataChanged(index(0, JournalModel::Column::Balance), index(rows - 1, JournalModel::Column::Balance));
+    if (firstRow < rows) {
+        emit dataChanged(index(firstRow, JournalModel::Column::Balance), index(rows - 1, JournalModel::Column::Balance));
+    }
+    d->firstDirtyRow = -1;
     d->balanceCalculationPending = false;
 }
 
@@ -198,6 +300,10 @@ void LedgerAccountFilter::setAccount(const MyMoneyAccount& acc)
     setAccountType(d->account.accountType());
     setFilterFixedString(d->account.id());
 
+    // the balances of another account cannot be reused
+    d->rowBalances.clear();
+    d->markDirty(0);
+
     invalidateFilter();
     setSortRole(eMyMoney::Model::TransactionPostDateRole);
     sort(JournalModel::Column::Date);
@@ -206,6 +312,23 @@ void LedgerAccountFilter::setAccount(const MyMoneyAccount& acc)
     recalculateBalancesOnIdle(d->account.id());
 }
 
+QVariant LedgerAccountFilter::data(const QModelIndex& idx, int role) const
+{
+    Q_D(const LedgerAccountFilter);
+    const auto isBalance = ((role == Qt::DisplayRole) && (idx.column() == JournalModel::Column::Balance)) || (role == eMyMoney::Model::JournalBalanceRole);
+    if (isBalance && idx.isValid() && (idx.row() < d->rowBalances.count())) {
+        const auto& rowBalance = d->rowBalances.at(idx.row());
+        if (!rowBalance.accountId.isEmpty()) {
+            if (role == eMyMoney::Model::JournalBalanceRole) {
+                return QVariant::fromValue(rowBalance.balance);
+            }
+            const auto acc = MyMoneyFile::instance()->accountsModel()->itemById(rowBalance.accountId);
+            return rowBalance.balance.formatMoney(acc.fraction());
+        }
+    }
+    return LedgerFilterBase::data(idx, role);
+}
+
 bool LedgerAccountFilter::filterAcceptsRow(int source_row, const QModelIndex& source_parent) const
 {
     Q_D(const LedgerAccountFilter);
@@ -33,6 +33,12 @@ public:
 
     void setAccount(const MyMoneyAccount& acc);
 
+    /**
+     * Overridden to provide the running balance of the
+     * account for the JournalModel::Column::Balance column
+     */
+    QVariant data(const QModelIndex& idx, int role) const override;
+
 public Q_SLOTS:
     void recalculateBalancesOnIdle(const QString& accountId);
 
@@ -339,18 +339,9 @@ bool NewTransactionEditor::Private::numberChanged(const QString& newNumber)
     bool rc = true; // number did change
     WidgetHintFrame::hide(ui->numberEdit, i18n("The check number used for this transaction."));
     if (!newNumber.isEmpty()) {
-        auto model = MyMoneyFile::instance()->journalModel();
-        const QModelIndexList list = model->match(model->index(0, 0), eMyMoney::Model::SplitNumberRole,
-                                     QVariant(newNumber),
-                                     -1,                         // all splits
-                                     Qt::MatchFlags(Qt::MatchExactly | Qt::MatchCaseSensitive | Qt::MatchRecursive));
-        for (const auto& idx : list) {
-            if (idx.data(eMyMoney::Model::SplitAccountIdRole).toString() == m_account.id()
-                    && idx.data(eMyMoney::Model::JournalTransactionIdRole).toString().compare(transaction.id())) {
-                WidgetHintFrame::show(ui->numberEdit, i18n("The check number <b>%1</b> has already been used in this account.", newNumber));
-                rc = false;
-                break;
-            }
+        if (MyMoneyFile::instance()->journalModel()->isNumberUsed(m_account.id(), newNumber, transaction.id())) {
+            WidgetHintFrame::show(ui->numberEdit, i18n("The check number <b>%1</b> has already been used in this account.", newNumber));
+            rc = false;
         }
     }
     return rc;
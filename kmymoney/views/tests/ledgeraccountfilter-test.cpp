@@ -0,0 +1,139 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "ledgeraccountfilter-test.h"
+
+#include <QAbstractItemModel>
+#include <QCoreApplication>
+#include <QTest>
+#include <QVector>
+
+#include "tests/testutilities.h"
+#include "ledgeraccountfilter.h"
+#include "journalmodel.h"
+#include "mymoneyaccount.h"
+#include "mymoneyenums.h"
+#include "mymoneyfile.h"
+#include "mymoneymoney.h"
+#include "mymoneysplit.h"
+#include "mymoneytransaction.h"
+
+using namespace test;
+
+QTEST_GUILESS_MAIN(LedgerAccountFilterTest)
+
+void LedgerAccountFilterTest::init()
+{
+    const auto file = MyMoneyFile::instance();
+    file->unload();
+    makeBaseCurrency();
+    m_checkingId = makeAccount(QStringLiteral("Checking"), eMyMoney::Account::Type::Checkings, MyMoneyMoney(), QDate(2020, 1, 1), file->asset().id());
+    m_expenseId = makeAccount(QStringLiteral("Expense"), eMyMoney::Account::Type::Expense, MyMoneyMoney(), QDate(2020, 1, 1), file->expense().id());
+}
+
+void LedgerAccountFilterTest::cleanup()
+{
+    MyMoneyFile::instance()->unload();
+}
+
+QString LedgerAccountFilterTest::addTransaction(const QDate& date, const MyMoneyMoney& amount)
+{
+    MyMoneyTransaction t;
+    t.setPostDate(date);
+    t.setCommodity(MyMoneyFile::instance()->baseCurrency().id());
+    MyMoneySplit sp1;
+    sp1.setAccountId(m_checkingId);
+    sp1.setShares(amount);
+    sp1.setValue(amount);
+    t.addSplit(sp1);
+    MyMoneySplit sp2;
+    sp2.setAccountId(m_expenseId);
+    sp2.setShares(-amount);
+    sp2.setValue(-amount);
+    t.addSplit(sp2);
+
+    MyMoneyFileTransaction ft;
+    MyMoneyFile::instance()->addTransaction(t);
+    ft.commit();
+    return t.id();
+}
+
+void LedgerAccountFilterTest::recalculate(LedgerAccountFilter& filter)
+{
+    filter.recalculateBalancesOnIdle(m_checkingId);
+    // sorting queues the balance calculation
+    QCoreApplication::processEvents();
+    QCoreApplication::processEvents();
+}
+
+void LedgerAccountFilterTest::verifyBalances(const LedgerAccountFilter& filter)
+{
+    LedgerAccountFilter completeFilter(nullptr, QVector<QAbstractItemModel*>());
+    completeFilter.setAccount(MyMoneyFile::instance()->account(m_checkingId));
+    recalculate(completeFilter);
+
+    QCOMPARE(filter.rowCount(), completeFilter.rowCount());
+    for (int row = 0; row < filter.rowCount(); ++row) {
+        const auto idx = filter.index(row, JournalModel::Column::Balance);
+        const auto completeIdx = completeFilter.index(row, JournalModel::Column::Balance);
+        QCOMPARE(idx.data(eMyMoney::Model::IdRole).toString(), completeIdx.data(eMyMoney::Model::IdRole).toString());
+        QCOMPARE(idx.data(eMyMoney::Model::JournalBalanceRole).value<MyMoneyMoney>(), completeIdx.data(eMyMoney::Model::JournalBalanceRole).value<MyMoneyMoney>());
+        QCOMPARE(idx.data(Qt::DisplayRole).toString(), completeIdx.data(Qt::DisplayRole).toString());
+    }
+}
+
+void LedgerAccountFilterTest::testIncrementalBalances()
+{
+    QStringList ids;
+    for (int i = 0; i < 10; ++i) {
+        ids << addTransaction(QDate(2021, 1, 1).addDays(7 * i), MyMoneyMoney(i + 1, 1));
+    }
+
+    LedgerAccountFilter filter(nullptr, QVector<QAbstractItemModel*>());
+    filter.setAccount(MyMoneyFile::instance()->account(m_checkingId));
+    recalculate(filter);
+    QCOMPARE(filter.rowCount(), 10);
+    QCOMPARE(filter.index(9, 0).data(eMyMoney::Model::JournalBalanceRole).value<MyMoneyMoney>(), MyMoneyMoney(55, 1));
+    verifyBalances(filter);
+
+    // another ledger showing the same entries keeps its own balances
+    const auto journalModel = MyMoneyFile::instance()->journalModel();
+    const auto journalIdx = journalModel->indexById(filter.index(0, 0).data(eMyMoney::Model::IdRole).toString());
+    journalModel->setData(journalIdx.sibling(journalIdx.row(), JournalModel::Column::Balance), QVariant::fromValue(MyMoneyMoney(999, 1)), Qt::DisplayRole);
+
+    // insert a transaction in the middle of the ledger
+    addTransaction(QDate(2021, 2, 10), MyMoneyMoney(100, 1));
+    recalculate(filter);
+    verifyBalances(filter);
+
+    // remove one
+    {
+        MyMoneyFileTransaction ft;
+        MyMoneyFile::instance()->removeTransaction(MyMoneyFile::instance()->transaction(ids.at(6)));
+        ft.commit();
+    }
+    recalculate(filter);
+    verifyBalances(filter);
+
+    // and modify the amount of another one
+    {
+        auto t = MyMoneyFile::instance()->transaction(ids.at(8));
+        auto split = t.splits().at(0);
+        split.setShares(MyMoneyMoney(-20, 1));
+        split.setValue(MyMoneyMoney(-20, 1));
+        t.modifySplit(split);
+        split = t.splits().at(1);
+        split.setShares(MyMoneyMoney(20, 1));
+        split.setValue(MyMoneyMoney(20, 1));
+        t.modifySplit(split);
+        MyMoneyFileTransaction ft;
+        MyMoneyFile::instance()->modifyTransaction(t);
+        ft.commit();
+    }
+    recalculate(filter);
+    verifyBalances(filter);
+
+    QCOMPARE(filter.index(0, 0).data(eMyMoney::Model::JournalBalanceRole).value<MyMoneyMoney>(), MyMoneyMoney(1, 1));
+}
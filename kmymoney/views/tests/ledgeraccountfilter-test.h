@@ -0,0 +1,48 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef LEDGERACCOUNTFILTERTEST_H
+#define LEDGERACCOUNTFILTERTEST_H
+
+#include <QObject>
+#include <QString>
+
+class QDate;
+class MyMoneyMoney;
+class LedgerAccountFilter;
+
+class LedgerAccountFilterTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    /**
+     * Adds a transaction moving @a amount from the expense
+     * category into the checking account and returns its id
+     */
+    QString addTransaction(const QDate& date, const MyMoneyMoney& amount);
+
+    /**
+     * Processes the sorting and balance calculation
+     * queued by @a filter
+     */
+    void recalculate(LedgerAccountFilter& filter);
+
+    /**
+     * Compares the balances shown by @a filter with the ones
+     * of a new filter which calculates all of them
+     */
+    void verifyBalances(const LedgerAccountFilter& filter);
+
+    QString m_checkingId;
+    QString m_expenseId;
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+    void testIncrementalBalances();
+};
+
+#endif // LEDGERACCOUNTFILTERTEST_H